@@ -206,6 +206,13 @@ public:
             qmlRegisterUncreatableType<QDeclarativeGeoMapItemBase, 14>(uri, major, minor, "GeoMapItemBase",
                                         QStringLiteral("GeoMapItemBase is not intended instantiable by developer."));
 
+            minor = 15;
+            qmlRegisterType<QDeclarativeGeoMap, 15>(uri, major, minor, "Map");
+            qmlRegisterType<QDeclarativeGeoServiceProvider, 15>(uri, major, minor, "Plugin");
+            qmlRegisterType<QDeclarativePolylineMapItem, 15>(uri, major, minor, "MapPolyline");
+            qmlRegisterType<QDeclarativeRouteMapItem, 15>(uri, major, minor, "MapRoute");
+            qmlRegisterType<QDeclarativeGeoMapItemView, 15>(uri, major, minor, "MapItemView");
+
             // The minor version used to be the current Qt 5 minor. For compatibility it is the last
             // Qt 5 release.
             qmlRegisterModule(uri, 5, 15);
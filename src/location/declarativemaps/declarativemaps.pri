@@ -10,6 +10,7 @@ PRIVATE_HEADERS += \
         declarativemaps/qdeclarativegeomaneuver_p.h \
         declarativemaps/qdeclarativegeomapcopyrightsnotice_p.h \
         declarativemaps/qdeclarativegeomapitembase_p.h \
+        declarativemaps/qdeclarativegeomapitembatcher_p.h \
         declarativemaps/qdeclarativegeomapitemgroup_p.h \
         declarativemaps/qdeclarativegeomapitemtransitionmanager_p.h \
         declarativemaps/qdeclarativegeomapitemview_p.h \
@@ -28,6 +29,7 @@ PRIVATE_HEADERS += \
         declarativemaps/qgeomapitemgeometry_p.h \
         declarativemaps/qgeomapobject_p.h \
         declarativemaps/qgeomapobject_p_p.h \
+        declarativemaps/qgeopathlevelofdetail_p.h \
         declarativemaps/qparameterizableobject_p.h \
         declarativemaps/qquickgeomapgesturearea_p.h
 
@@ -40,6 +42,7 @@ SOURCES += \
         declarativemaps/qdeclarativegeomapcopyrightsnotice.cpp \
         declarativemaps/qdeclarativegeomap.cpp \
         declarativemaps/qdeclarativegeomapitembase.cpp \
+        declarativemaps/qdeclarativegeomapitembatcher.cpp \
         declarativemaps/qdeclarativegeomapitemgroup.cpp \
         declarativemaps/qdeclarativegeomapitemtransitionmanager.cpp \
         declarativemaps/qdeclarativegeomapitemview.cpp \
@@ -56,6 +59,7 @@ SOURCES += \
         declarativemaps/qdeclarativeroutemapitem.cpp \
         declarativemaps/qgeomapitemgeometry.cpp \
         declarativemaps/qgeomapobject.cpp \
+        declarativemaps/qgeopathlevelofdetail.cpp \
         declarativemaps/qparameterizableobject.cpp \
         declarativemaps/qquickgeomapgesturearea.cpp
 
@@ -42,6 +42,7 @@
 
 #include <qmath.h>
 #include <algorithm>
+#include <cmath>
 
 #include <QtCore/QScopedValueRollback>
 #include <QPen>
@@ -98,7 +99,9 @@ QT_BEGIN_NAMESPACE
 
     MapCircle performance is almost equivalent to that of a MapPolygon with
     the same number of vertices. There is a small amount of additional
-    overhead with respect to calculating the vertices first.
+    overhead with respect to calculating the vertices first. On an untilted
+    map, circles that do not cross a pole are filled without tessellation,
+    and panning does not recompute their fill.
 
     Like the other map objects, MapCircle is normally drawn without a smooth
     appearance. Setting the opacity property will force the object to be
@@ -158,6 +161,7 @@ void QGeoMapCircleGeometry::updateScreenPointsInvert(const QList<QDoubleVector2D
     const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map.geoProjection());
     // Not checking for !screenDirty anymore, as everything is now recalculated.
     clear();
+    isFan_ = false;
     if (map.viewportWidth() == 0 || map.viewportHeight() == 0 || circlePath.size() < 3) // a circle requires at least 3 points;
         return;
 
@@ -274,6 +278,105 @@ void QGeoMapCircleGeometry::updateScreenPointsInvert(const QList<QDoubleVector2D
     sourceBounds_ = screenBounds_;
 }
 
+/*!
+    \internal
+
+    Fills the circle with a triangle fan around its \a center, both in mercator space, without
+    clipping or tessellating it. The ring is only projected again when the zoom level or the
+    bearing change: panning just moves the item.
+
+    Returns false when a fan cannot fill the circle: the map is tilted, and the circle has to
+    be clipped against the projectable region, or the ring is not star-shaped around its
+    center. Circles crossing a pole are filled with updateScreenPointsInvert() instead.
+*/
+bool QGeoMapCircleGeometry::updateCircle(const QGeoMap &map, const QList<QDoubleVector2D> &circlePath,
+                                         const QDoubleVector2D &center, qreal strokeWidth)
+{
+    if (!sourceDirty_ && !screenDirty_)
+        return isFan_;
+
+    isFan_ = false;
+    if (map.viewportWidth() == 0 || map.viewportHeight() == 0 || circlePath.size() < 3
+            || map.cameraData().tilt() != 0.0) {
+        return false;
+    }
+
+    // An untilted camera is an affine transformation of the mercator plane. The geometry is
+    // relative to the left bound, and unwrapped eastwards of it as in updateSourcePoints(),
+    // so only the linear part of that transformation matters.
+    const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map.geoProjection());
+    const QDoubleVector2D leftBound = p.geoToMapProjection(geoLeftBound_);
+    const QDoubleVector2D leftBoundWrapped = p.wrapMapProjection(leftBound);
+    const QDoubleVector2D origin = p.wrappedMapProjectionToItemPosition(leftBoundWrapped);
+    const QDoubleVector2D xAxis = p.wrappedMapProjectionToItemPosition(leftBoundWrapped + QDoubleVector2D(1.0, 0.0)) - origin;
+    const QDoubleVector2D yAxis = p.wrappedMapProjectionToItemPosition(leftBoundWrapped + QDoubleVector2D(0.0, 1.0)) - origin;
+    if (!qIsFinite(xAxis.x()) || !qIsFinite(xAxis.y()) || !qIsFinite(yAxis.x()) || !qIsFinite(yAxis.y()))
+        return false;
+
+    if (circlePath != fanPath_ || center != fanCenter_ || xAxis != fanXAxis_ || yAxis != fanYAxis_) {
+        const auto toSource = [&](const QDoubleVector2D &point) {
+            double dx = point.x() - leftBound.x();
+            dx -= std::floor(dx);
+            const double dy = point.y() - leftBound.y();
+            return (xAxis * dx + yAxis * dy).toPointF();
+        };
+
+        fanPath_.clear();
+        fanRing_.clear();
+        fanRing_.reserve(circlePath.size());
+        for (const QDoubleVector2D &point : circlePath)
+            fanRing_ << toSource(point);
+        fanCenterPoint_ = toSource(center);
+
+        // The fan covers the ring only if every triangle turns the same way
+        double orientation = 0.0;
+        for (int i = 0; i < fanRing_.size(); ++i) {
+            const QPointF a = fanRing_.at(i) - fanCenterPoint_;
+            const QPointF b = fanRing_.at((i + 1) % fanRing_.size()) - fanCenterPoint_;
+            const double cross = a.x() * b.y() - a.y() * b.x();
+            if (cross == 0.0 || (orientation != 0.0 && (cross > 0.0) != (orientation > 0.0)))
+                return false;
+            orientation = cross;
+        }
+
+        fanPath_ = circlePath;
+        fanCenter_ = center;
+        fanXAxis_ = xAxis;
+        fanYAxis_ = yAxis;
+    }
+
+    clear();
+    srcOrigin_ = geoLeftBound_;
+    sourceBounds_ = fanRing_.boundingRect();
+    firstPointOffset_ = -1 * sourceBounds_.topLeft();
+    screenBounds_ = sourceBounds_.translated(firstPointOffset_);
+    screenOutline_ = QPainterPath();
+
+    const quint32 count = quint32(fanRing_.size());
+    screenVertices_.reserve(fanRing_.size() + 1);
+    screenVertices_ << fanCenterPoint_ + firstPointOffset_;
+    for (const QPointF &point : qAsConst(fanRing_))
+        screenVertices_ << point + firstPointOffset_;
+    screenIndices_.reserve(fanRing_.size() * 3);
+    for (quint32 i = 1; i <= count; ++i)
+        screenIndices_ << 0 << i << (i % count) + 1;
+
+    if (strokeWidth != 0.0)
+        this->translate(QPointF(strokeWidth, strokeWidth));
+    isFan_ = true;
+    return true;
+}
+
+/*!
+    \internal
+*/
+bool QGeoMapCircleGeometry::contains(const QPointF &screenPoint) const
+{
+    if (isFan_)
+        return fanRing_.containsPoint(screenPoint - firstPointOffset_, Qt::OddEvenFill);
+    return QGeoMapPolygonGeometry::contains(screenPoint);
+}
+
 bool QDeclarativeCircleMapItem::crossEarthPole(const QGeoCoordinate &center, qreal distance)
 {
     qreal poleLat = 90;
@@ -425,7 +528,7 @@ void QDeclarativeCircleMapItem::setColor(const QColor &color)
         return;
     color_ = color;
     dirtyMaterial_ = true;
-    update();
+    updateAppearance();
     emit colorChanged(color_);
 }
 
@@ -494,22 +597,35 @@ QSGNode *QDeclarativeCircleMapItem::updateMapItemPaintNode(QSGNode *oldNode, Upd
 /*!
     \internal
 */
-void QDeclarativeCircleMapItem::updatePolish()
+bool QDeclarativeCircleMapItem::updateBatchedGeometry(QDeclarativeGeoMapItemBatcher *batcher)
+{
+    const QPointF offset = mapToItem(quickMap(), QPointF());
+    batcher->setGeometry(this, QDeclarativeGeoMapItemBatcher::FillLayer, color_, geometry_,
+                         QSGGeometry::DrawTriangles, offset);
+    batcher->setGeometry(this, QDeclarativeGeoMapItemBatcher::BorderLayer, border_.color(),
+                         borderGeometry_, QSGGeometry::DrawTriangleStrip, offset);
+    geometry_.setPreserveGeometry(false);
+    borderGeometry_.setPreserveGeometry(false);
+    geometry_.markClean();
+    borderGeometry_.markClean();
+    dirtyMaterial_ = true; // a paint node created after unbatching must be filled
+    return true;
+}
+
+/*!
+    \internal
+*/
+bool QDeclarativeCircleMapItem::computeGeometry()
 {
     if (!map() || map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
-        return;
+        return false;
     if (!circle_.isValid()) {
         geometry_.clear();
         borderGeometry_.clear();
-        setWidth(0);
-        setHeight(0);
-        return;
+        return true;
     }
 
     const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map()->geoProjection());
-    QScopedValueRollback<bool> rollback(updatingGeometry_);
-    updatingGeometry_ = true;
-
     QList<QDoubleVector2D> circlePath = circlePath_;
 
     int pathCount = circlePath.size();
@@ -523,7 +639,7 @@ void QDeclarativeCircleMapItem::updatePolish()
     if (crossEarthPole(circle_.center(), circle_.radius()) && circlePath.size() == pathCount) {
         geometry_.updateScreenPointsInvert(circlePath, *map()); // invert fill area for really huge circles
         invertedCircle = true;
-    } else {
+    } else if (!geometry_.updateCircle(*map(), circlePath, p.geoToMapProjection(circle_.center()), border_.width())) {
         geometry_.updateSourcePoints(*map(), circlePath);
         geometry_.updateScreenPoints(*map(), border_.width());
     }
@@ -563,17 +679,31 @@ void QDeclarativeCircleMapItem::updatePolish()
         }
     }
 
-    QRectF combined = QGeoMapItemGeometry::translateToCommonOrigin(geoms);
+    geometryBounds_ = QGeoMapItemGeometry::translateToCommonOrigin(geoms);
+    if (!invertedCircle && preserve)
+        geometryBounds_.adjust(0, 0, 2 * border_.width(), 2 * border_.width());
+    return true;
+}
 
-    if (invertedCircle || !preserve) {
-        setWidth(combined.width());
-        setHeight(combined.height());
-        setPositionOnMap(geometry_.origin(), geometry_.firstPointOffset());
-    } else {
-        setWidth(combined.width() + 2 * border_.width());
-        setHeight(combined.height() + 2 * border_.width());
+/*!
+    \internal
+*/
+void QDeclarativeCircleMapItem::updatePolish()
+{
+    if (!takePrecomputedGeometry() && !computeGeometry())
+        return;
+    if (!circle_.isValid()) {
+        setWidth(0);
+        setHeight(0);
+        return;
     }
 
+    QScopedValueRollback<bool> rollback(updatingGeometry_);
+    updatingGeometry_ = true;
+
+    setWidth(geometryBounds_.width());
+    setHeight(geometryBounds_.height());
+
     // No offsetting here, even in normal case, because first point offset is already translated
     setPositionOnMap(geometry_.origin(), geometry_.firstPointOffset());
 }
@@ -54,6 +54,7 @@
 #include <QtLocation/private/qdeclarativepolygonmapitem_p.h>
 #include <QSGGeometryNode>
 #include <QSGFlatColorMaterial>
+#include <QPolygonF>
 #include <QtPositioning/QGeoCircle>
 
 QT_BEGIN_NAMESPACE
@@ -64,6 +65,20 @@ public:
     QGeoMapCircleGeometry();
 
     void updateScreenPointsInvert(const QList<QDoubleVector2D> &circlePath, const QGeoMap &map);
+    bool updateCircle(const QGeoMap &map, const QList<QDoubleVector2D> &circlePath,
+                      const QDoubleVector2D &center, qreal strokeWidth = 0.0);
+
+    bool contains(const QPointF &screenPoint) const override;
+
+private:
+    // The fan of the last updateCircle(), relative to the origin, and what it depends on
+    QList<QDoubleVector2D> fanPath_;
+    QDoubleVector2D fanCenter_;
+    QDoubleVector2D fanXAxis_;
+    QDoubleVector2D fanYAxis_;
+    QPolygonF fanRing_;
+    QPointF fanCenterPoint_;
+    bool isFan_ = false;
 };
 
 class Q_LOCATION_PRIVATE_EXPORT QDeclarativeCircleMapItem : public QDeclarativeGeoMapItemBase
@@ -112,6 +127,8 @@ Q_SIGNALS:
 protected:
     void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
     void updatePolish() override;
+    bool computeGeometry() override;
+    bool updateBatchedGeometry(QDeclarativeGeoMapItemBatcher *batcher) override;
 
 protected Q_SLOTS:
     void markSourceDirtyAndUpdate();
@@ -129,6 +146,7 @@ private:
     bool dirtyMaterial_;
     QGeoMapCircleGeometry geometry_;
     QGeoMapPolylineGeometry borderGeometry_;
+    QRectF geometryBounds_; // of fill and border, padded for the border unless inverted
     bool updatingGeometry_;
 };
 
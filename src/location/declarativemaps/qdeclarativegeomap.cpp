@@ -36,6 +36,7 @@
 
 #include "qdeclarativegeomap_p.h"
 #include "qdeclarativegeomapquickitem_p.h"
+#include "qdeclarativepolylinemapitem_p.h"
 #include "qdeclarativegeomapcopyrightsnotice_p.h"
 #include "qdeclarativegeoserviceprovider_p.h"
 #include "qdeclarativegeomaptype_p.h"
@@ -53,6 +54,7 @@
 #include <QtQuick/private/qquickwindow_p.h>
 #include <QtQml/qqmlinfo.h>
 #include <QtQuick/private/qquickitem_p.h>
+#include <QtCore/QThread>
 #include <cmath>
 
 #ifndef M_PI
@@ -490,8 +492,12 @@ void QDeclarativeGeoMap::setupMapView(QDeclarativeGeoMapItemView *view)
  */
 QSGNode *QDeclarativeGeoMap::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
 {
+    if (!oldNode)
+        m_itemBatchNode = nullptr; // Deleted together with the previous root
+
     if (!m_map) {
         delete oldNode;
+        m_itemBatchNode = nullptr;
         return 0;
     }
 
@@ -502,14 +508,69 @@ QSGNode *QDeclarativeGeoMap::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeDa
     root->setRect(boundingRect());
     root->setColor(m_color);
 
-    QSGNode *content = root->childCount() ? root->firstChild() : 0;
+    QSGNode *content = root->firstChild() != m_itemBatchNode ? root->firstChild() : 0;
     content = m_map->updateSceneGraph(content, window());
-    if (content && root->childCount() == 0)
-        root->appendChildNode(content);
+    if (content && !content->parent())
+        root->prependChildNode(content);
+
+    // Batched map items are drawn on top of the map, below the unbatched items.
+    if (m_itemBatcher) {
+        m_itemBatchNode = m_itemBatcher->updateNode(m_itemBatchNode);
+        if (!m_itemBatchNode->parent())
+            root->appendChildNode(m_itemBatchNode);
+    } else if (m_itemBatchNode) {
+        root->removeChildNode(m_itemBatchNode);
+        delete m_itemBatchNode;
+        m_itemBatchNode = nullptr;
+    }
 
     return root;
 }
 
+/*!
+    \internal
+
+    With map item batching, items schedule their polish on the map, so that a camera
+    change costs one polish pass instead of one per item.
+*/
+void QDeclarativeGeoMap::updatePolish()
+{
+    if (m_scheduledItemPolish.isEmpty())
+        return;
+
+    QVector<QDeclarativeGeoMapItemBase *> items(m_scheduledItemPolish.cbegin(), m_scheduledItemPolish.cend());
+    m_scheduledItemPolish.clear();
+
+    if (m_itemPolishPool && m_map && items.size() > 1) {
+        // The regions of the projection are computed lazily: compute them now, so that the
+        // items only read the projection while their geometry is computed concurrently.
+        if (m_map->geoProjection().projectionType() == QGeoProjection::ProjectionWebMercator)
+            static_cast<const QGeoProjectionWebMercator &>(m_map->geoProjection()).visibleGeometry();
+
+        // One chunk per worker, and one for the GUI thread, which is blocked anyway
+        const int chunks = m_itemPolishPool->maxThreadCount() + 1;
+        const int chunkSize = (items.size() + chunks - 1) / chunks;
+        for (int first = chunkSize; first < items.size(); first += chunkSize) {
+            const int last = qMin(first + chunkSize, items.size());
+            m_itemPolishPool->start(QRunnable::create([&items, first, last]() {
+                for (int i = first; i < last; ++i)
+                    items.at(i)->precomputeGeometry();
+            }));
+        }
+        for (int i = 0; i < chunkSize; ++i)
+            items.at(i)->precomputeGeometry();
+        m_itemPolishPool->waitForDone();
+    }
+
+    for (QDeclarativeGeoMapItemBase *item : qAsConst(items)) {
+        item->updatePolish();
+        if (m_itemBatcher)
+            item->updateBatchState();
+        else
+            item->update();
+    }
+}
+
 /*!
     \qmlproperty Plugin QtLocation::Map::plugin
 
@@ -1461,6 +1522,83 @@ void QDeclarativeGeoMap::setVisibleArea(const QRectF &visibleArea)
     }
 }
 
+/*!
+    \qmlproperty bool QtLocation::Map::mapItemBatching
+
+    This property holds whether the map draws its items in batches.
+
+    When enabled, the geometry of \l MapPolyline, \l MapPolygon, \l MapCircle and
+    \l MapRectangle items is collected into a shared vertex buffer per color, instead
+    of one scene graph node per item. This greatly reduces the rendering cost of maps
+    showing thousands of items, and items are updated in a single polish pass when
+    the camera changes.
+
+    Items that are semi-transparent, fading in, rendered by the plugin, or that use the
+    \l {MapPolyline::backend}{Transformed} polyline backend are drawn as usual.
+    Batched items are drawn below all other map items, fills before borders, so
+    their stacking order (\c z) is not respected. The default value is \c false.
+
+    \since QtLocation 5.15
+*/
+bool QDeclarativeGeoMap::mapItemBatching() const
+{
+    return !m_itemBatcher.isNull();
+}
+
+void QDeclarativeGeoMap::setMapItemBatching(bool enabled)
+{
+    if (enabled == mapItemBatching())
+        return;
+
+    if (enabled)
+        m_itemBatcher.reset(new QDeclarativeGeoMapItemBatcher);
+    else
+        m_itemBatcher.reset();
+
+    for (const QPointer<QDeclarativeGeoMapItemBase> &i: qAsConst(m_mapItems)) {
+        if (!i)
+            continue;
+        i->batched_ = false;
+        i->polishAndUpdate();
+    }
+    update();
+    emit mapItemBatchingChanged(enabled);
+}
+
+/*!
+    \qmlproperty bool QtLocation::Map::parallelMapItemPolish
+
+    This property holds whether the geometry of the map items is computed in parallel.
+
+    When enabled, the map polishes its items itself, and computes the geometry of the
+    \l MapPolyline, \l MapPolygon, \l MapCircle and \l MapRectangle items that changed,
+    for instance after a camera change, on a pool of worker threads. The items are then
+    resized and moved on the GUI thread, before the scene graph is synchronized.
+    This spreads the cost of updating large numbers of items over all the cores.
+    The default value is \c false.
+
+    \since QtLocation 5.15
+*/
+bool QDeclarativeGeoMap::parallelMapItemPolish() const
+{
+    return !m_itemPolishPool.isNull();
+}
+
+void QDeclarativeGeoMap::setParallelMapItemPolish(bool enabled)
+{
+    if (enabled == parallelMapItemPolish())
+        return;
+
+    if (enabled) {
+        m_itemPolishPool.reset(new QThreadPool);
+        // the GUI thread computes its share as well
+        m_itemPolishPool->setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+    } else {
+        m_itemPolishPool.reset();
+    }
+    emit parallelMapItemPolishChanged(enabled);
+}
+
 /*!
     \qmlproperty bool QtLocation::Map::mapReady
 
@@ -2384,7 +2522,16 @@ void QDeclarativeGeoMap::fitViewportToMapItemsRefine(const QList<QPointer<QDecla
         if (item->isPolishScheduled())
            item->updatePolish();
 
-        if (quickItem && quickItem->matrix_ && !quickItem->matrix_->m_matrix.isIdentity()) {
+        QDeclarativePolylineMapItem *polylineItem = qobject_cast<QDeclarativePolylineMapItem *>(item);
+        if (polylineItem && polylineItem->transformed_) {
+            // the item covers the map, use the bounds of the transformed geometry instead
+            const QRectF brect = polylineItem->mercatorTransform_.mapRect(
+                        polylineItem->mercatorGeometry_.screenBoundingBox());
+            topLeftX = item->position().x() + brect.left();
+            topLeftY = item->position().y() + brect.top();
+            bottomRightX = item->position().x() + brect.right();
+            bottomRightY = item->position().y() + brect.bottom();
+        } else if (quickItem && quickItem->matrix_ && !quickItem->matrix_->m_matrix.isIdentity()) {
             // TODO: recalculate the center/zoom level so that the item becomes projectable again
             if (quickItem->zoomLevel() == 0.0) // the item is unprojectable, should be skipped.
                 continue;
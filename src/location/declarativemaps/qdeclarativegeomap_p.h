@@ -58,9 +58,12 @@
 #include <QtQuick/QQuickItem>
 #include <QtCore/QList>
 #include <QtCore/QPointer>
+#include <QtCore/QSet>
+#include <QtCore/QThreadPool>
 #include <QtGui/QColor>
 #include <QtPositioning/qgeorectangle.h>
 #include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qdeclarativegeomapitembatcher_p.h>
 #include <QtQuick/private/qquickitemchangelistener_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -102,6 +105,8 @@ class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMap : public QQuickItem
     Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
     Q_PROPERTY(bool mapReady READ mapReady NOTIFY mapReadyChanged)
     Q_PROPERTY(QRectF visibleArea READ visibleArea WRITE setVisibleArea NOTIFY visibleAreaChanged  REVISION 12)
+    Q_PROPERTY(bool mapItemBatching READ mapItemBatching WRITE setMapItemBatching NOTIFY mapItemBatchingChanged REVISION 15)
+    Q_PROPERTY(bool parallelMapItemPolish READ parallelMapItemPolish WRITE setParallelMapItemPolish NOTIFY parallelMapItemPolishChanged REVISION 15)
     Q_INTERFACES(QQmlParserStatus)
 
 public:
@@ -158,6 +163,12 @@ public:
     QRectF visibleArea() const;
     void setVisibleArea(const QRectF &visibleArea);
 
+    bool mapItemBatching() const;
+    void setMapItemBatching(bool enabled);
+
+    bool parallelMapItemPolish() const;
+    void setParallelMapItemPolish(bool enabled);
+
     bool mapReady() const;
 
     QQmlListProperty<QDeclarativeGeoMapType> supportedMapTypes();
@@ -234,6 +245,8 @@ Q_SIGNALS:
     Q_REVISION(11) void mapObjectsChanged();
     void visibleAreaChanged();
     Q_REVISION(14) void visibleRegionChanged();
+    Q_REVISION(15) void mapItemBatchingChanged(bool enabled);
+    Q_REVISION(15) void parallelMapItemPolishChanged(bool enabled);
 
 protected:
     void mousePressEvent(QMouseEvent *event) override ;
@@ -252,6 +265,7 @@ protected:
 
     void componentComplete() override;
     QSGNode *updatePaintNode(QSGNode *, UpdatePaintNodeData *) override;
+    void updatePolish() override;
     void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
 
     void setError(QGeoServiceProvider::Error error, const QString &errorString);
@@ -327,9 +341,16 @@ private:
     int m_copyNoticesVisible = 0;
     qreal m_maxChildZ = 0;
     QRectF m_visibleArea;
+    QScopedPointer<QDeclarativeGeoMapItemBatcher> m_itemBatcher;
+    QSGNode *m_itemBatchNode = nullptr; // Only accessed in updatePaintNode
+    QScopedPointer<QThreadPool> m_itemPolishPool; // Set when polishing the items in parallel
+    QSet<QDeclarativeGeoMapItemBase *> m_scheduledItemPolish; // Items polished in updatePolish()
+
+    inline bool polishesMapItems() const { return m_itemBatcher || m_itemPolishPool; }
 
 
     friend class QDeclarativeGeoMapItem;
+    friend class QDeclarativeGeoMapItemBase;
     friend class QDeclarativeGeoMapItemView;
     friend class QQuickGeoMapGestureArea;
     friend class QDeclarativeGeoMapCopyrightNotice;
@@ -85,6 +85,10 @@ QDeclarativeGeoMapItemBase::QDeclarativeGeoMapItemBase(QQuickItem *parent)
     // Changing opacity on a mapItemGroup should affect also the opacity on the children.
     // This must be notified to plugins, if they are to render the item.
     connect(this, &QQuickItem::opacityChanged, this, &QDeclarativeGeoMapItemBase::mapItemOpacityChanged);
+    connect(this, &QDeclarativeGeoMapItemBase::mapItemOpacityChanged,
+            this, &QDeclarativeGeoMapItemBase::batchingConditionChanged);
+    connect(this, &QQuickItem::visibleChanged,
+            this, &QDeclarativeGeoMapItemBase::batchingConditionChanged);
 }
 
 QDeclarativeGeoMapItemBase::~QDeclarativeGeoMapItemBase()
@@ -127,6 +131,15 @@ void QDeclarativeGeoMapItemBase::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *m
     if (quickMap && quickMap_)
         return; // don't allow association to more than one map
 
+    if (quickMap_ && quickMap_->m_itemBatcher) {
+        quickMap_->m_itemBatcher->removeItem(this);
+        quickMap_->update();
+    }
+    if (quickMap_)
+        quickMap_->m_scheduledItemPolish.remove(this);
+    batched_ = false;
+    geometryPrecomputed_ = false;
+
     quickMap_ = quickMap;
     map_ = map;
 
@@ -256,7 +269,7 @@ bool QDeclarativeGeoMapItemBase::childMouseEventFilter(QQuickItem *item, QEvent
 */
 QSGNode *QDeclarativeGeoMapItemBase::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *pd)
 {
-    if (!map_ || !quickMap_ || map_->supportedMapItemTypes() & itemType()) {
+    if (!map_ || !quickMap_ || map_->supportedMapItemTypes() & itemType() || batched_) {
         if (oldNode)
             delete oldNode;
         oldNode = 0;
@@ -320,13 +333,114 @@ void QDeclarativeGeoMapItemBase::setParentGroup(QDeclarativeGeoMapItemGroup &par
 
 bool QDeclarativeGeoMapItemBase::isPolishScheduled() const
 {
+    if (quickMap_ && quickMap_->m_scheduledItemPolish.contains(const_cast<QDeclarativeGeoMapItemBase *>(this)))
+        return true;
     return QQuickItemPrivate::get(this)->polishScheduled;
 }
 
 void QDeclarativeGeoMapItemBase::polishAndUpdate()
 {
+    if (quickMap_ && quickMap_->polishesMapItems()) {
+        // Polished by the map, see QDeclarativeGeoMap::updatePolish()
+        quickMap_->m_scheduledItemPolish.insert(this);
+        quickMap_->polish();
+        return;
+    }
     polish();
     update();
 }
 
+/*!
+    \internal
+
+    Requests a repaint after a change that does not affect the geometry, such as a
+    color. Batched items have no paint node and are handed to the batcher again.
+*/
+void QDeclarativeGeoMapItemBase::updateAppearance()
+{
+    if (batched_)
+        polishAndUpdate();
+    else
+        update();
+}
+
+/*!
+    \internal
+
+    Computes the geometry of the item for the current camera, leaving to updatePolish()
+    what changes the item itself, such as its size and position. The map may call it from
+    a worker thread, concurrently for several items: implementations must only read the
+    map and the item, and only write their geometry. Returns false if the item does not
+    support it. The default implementation returns false.
+*/
+bool QDeclarativeGeoMapItemBase::computeGeometry()
+{
+    return false;
+}
+
+/*!
+    \internal
+
+    Returns true, once, if computeGeometry() has already been called by the map for the
+    pending polish.
+*/
+bool QDeclarativeGeoMapItemBase::takePrecomputedGeometry()
+{
+    const bool precomputed = geometryPrecomputed_;
+    geometryPrecomputed_ = false;
+    return precomputed;
+}
+
+void QDeclarativeGeoMapItemBase::precomputeGeometry()
+{
+    geometryPrecomputed_ = computeGeometry();
+}
+
+/*!
+    \internal
+
+    Hands the current geometry of the item to \a batcher. Returns false if the item
+    cannot be batched, in which case it keeps its own paint node. The default
+    implementation returns false.
+*/
+bool QDeclarativeGeoMapItemBase::updateBatchedGeometry(QDeclarativeGeoMapItemBatcher *batcher)
+{
+    Q_UNUSED(batcher);
+    return false;
+}
+
+/*!
+    \internal
+
+    Called by the map after polishing the item while map item batching is enabled.
+*/
+void QDeclarativeGeoMapItemBase::updateBatchState()
+{
+    QDeclarativeGeoMapItemBatcher *batcher = quickMap_ ? quickMap_->m_itemBatcher.data() : nullptr;
+    if (!batcher)
+        return;
+
+    const bool batched = map_
+            && !(map_->supportedMapItemTypes() & itemType())
+            && isVisible()
+            && mapItemOpacity() >= 1.0
+            && zoomLevelOpacity() >= 1.0
+            && updateBatchedGeometry(batcher);
+
+    if (batched || batched_) {
+        if (!batched)
+            batcher->removeItem(this);
+        quickMap_->update();
+    }
+    if (!batched || !batched_)
+        update(); // Creates or drops the paint node of the item
+    batched_ = batched;
+}
+
+void QDeclarativeGeoMapItemBase::batchingConditionChanged()
+{
+    if (quickMap_ && quickMap_->m_itemBatcher)
+        polishAndUpdate();
+}
+
 QT_END_NAMESPACE
@@ -122,14 +122,23 @@ protected:
     float zoomLevelOpacity() const;
     bool childMouseEventFilter(QQuickItem *item, QEvent *event);
     bool isPolishScheduled() const;
+    bool isBatched() const { return batched_; }
+    void updateAppearance();
+    virtual bool updateBatchedGeometry(QDeclarativeGeoMapItemBatcher *batcher);
+    virtual bool computeGeometry();
+    bool takePrecomputedGeometry();
 
     QGeoMap::ItemType m_itemType = QGeoMap::NoItem;
 
 private Q_SLOTS:
     void baseCameraDataChanged(const QGeoCameraData &camera);
     void visibleAreaChanged();
+    void batchingConditionChanged();
 
 private:
+    void updateBatchState();
+    void precomputeGeometry();
+
     QPointer<QGeoMap> map_;
     QDeclarativeGeoMap *quickMap_;
 
@@ -140,6 +149,8 @@ private:
 
     QScopedPointer<QDeclarativeGeoMapItemTransitionManager> m_transitionManager;
     bool m_autoFadeIn = true;
+    bool batched_ = false;
+    bool geometryPrecomputed_ = false; // by the map, see QDeclarativeGeoMap::updatePolish()
 
     friend class QDeclarativeGeoMap;
     friend class QDeclarativeGeoMapItemView;
@@ -0,0 +1,298 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qdeclarativegeomapitembatcher_p.h"
+#include "qgeomapitemgeometry_p.h"
+
+#include <QtQuick/QSGGeometryNode>
+#include <QtQuick/QSGFlatColorMaterial>
+
+#include <algorithm>
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+class BatchNode : public QSGGeometryNode
+{
+public:
+    BatchNode(int layer, const QColor &color)
+        : layer_(layer), geometry_(QSGGeometry::defaultAttributes_Point2D(), 0)
+    {
+        geometry_.setDrawingMode(QSGGeometry::DrawTriangles);
+        geometry_.setVertexDataPattern(QSGGeometry::DynamicPattern);
+        setGeometry(&geometry_);
+        material_.setColor(color);
+        setMaterial(&material_);
+    }
+
+    int layer_;
+    QSGGeometry geometry_;
+    QSGFlatColorMaterial material_;
+};
+
+inline bool isDegenerate(const QPointF &a, const QPointF &b, const QPointF &c)
+{
+    return a == b || b == c || a == c;
+}
+
+void appendTriangles(QVector<QSGGeometry::Point2D> &out, const QGeoMapItemGeometry &geometry,
+                     QSGGeometry::DrawingMode mode, const QPointF &offset)
+{
+    const QVector<QPointF> vx = geometry.vertices();
+    QSGGeometry::Point2D p;
+    const auto append = [&](const QPointF &v) {
+        p.set(v.x() + offset.x(), v.y() + offset.y());
+        out.append(p);
+    };
+
+    if (geometry.isIndexed()) {
+        const QVector<quint32> ix = geometry.indices();
+        out.reserve(out.size() + ix.size());
+        for (quint32 i : ix)
+            append(vx.at(i));
+    } else if (mode == QSGGeometry::DrawTriangleStrip) {
+        // Unroll the strip, dropping the degenerate triangles used to join its parts.
+        out.reserve(out.size() + 3 * qMax(0, vx.size() - 2));
+        for (int i = 2; i < vx.size(); ++i) {
+            if (isDegenerate(vx.at(i - 2), vx.at(i - 1), vx.at(i)))
+                continue;
+            append(vx.at(i - 2));
+            append(vx.at(i - 1));
+            append(vx.at(i));
+        }
+    } else {
+        out.reserve(out.size() + vx.size());
+        for (const QPointF &v : vx)
+            append(v);
+    }
+}
+
+} // namespace
+
+QDeclarativeGeoMapItemBatcher::QDeclarativeGeoMapItemBatcher()
+{
+}
+
+QDeclarativeGeoMapItemBatcher::~QDeclarativeGeoMapItemBatcher()
+{
+}
+
+/*
+    Replaces the triangles \a item contributes to \a layer. \a geometry is in item
+    coordinates, \a offset is the position of the item within the map.
+*/
+void QDeclarativeGeoMapItemBatcher::setGeometry(const QDeclarativeGeoMapItemBase *item, Layer layer,
+                                                const QColor &color,
+                                                const QGeoMapItemGeometry &geometry,
+                                                QSGGeometry::DrawingMode mode,
+                                                const QPointF &offset)
+{
+    triangles_.clear();
+    if (color.alpha() != 0)
+        appendTriangles(triangles_, geometry, mode, offset);
+    if (triangles_.isEmpty()) {
+        removeGeometry(item, layer);
+        return;
+    }
+
+    const ItemKey itemKey(item, layer);
+    const BucketKey key(layer, color.rgba());
+    const auto current = itemBuckets_.constFind(itemKey);
+    if (current != itemBuckets_.constEnd() && current.value() != key)
+        removeGeometry(item, layer);
+
+    auto bucketIt = buckets_.find(key);
+    if (bucketIt == buckets_.end()) {
+        bucketIt = buckets_.insert(key, Bucket());
+        structureDirty_ = true;
+    }
+    Bucket &bucket = bucketIt.value();
+
+    const auto range = bucket.ranges.constFind(item);
+    if (range != bucket.ranges.constEnd() && range->count == triangles_.size()) {
+        std::copy(triangles_.cbegin(), triangles_.cend(), bucket.vertices.begin() + range->offset);
+    } else {
+        if (range != bucket.ranges.constEnd())
+            eraseRange(bucket, item);
+        bucket.ranges.insert(item, Range{bucket.vertices.size(), triangles_.size()});
+        bucket.vertices += triangles_;
+    }
+    bucket.dirty = true;
+    itemBuckets_.insert(itemKey, key);
+}
+
+void QDeclarativeGeoMapItemBatcher::removeGeometry(const QDeclarativeGeoMapItemBase *item, Layer layer)
+{
+    const auto it = itemBuckets_.find(ItemKey(item, layer));
+    if (it == itemBuckets_.end())
+        return;
+
+    const auto bucketIt = buckets_.find(it.value());
+    itemBuckets_.erase(it);
+    if (bucketIt == buckets_.end())
+        return;
+
+    eraseRange(bucketIt.value(), item);
+    if (bucketIt->ranges.isEmpty()) {
+        buckets_.erase(bucketIt);
+        structureDirty_ = true;
+    }
+}
+
+/*
+    Drops everything the batcher knows about \a item.
+*/
+void QDeclarativeGeoMapItemBatcher::removeItem(QDeclarativeGeoMapItemBase *item)
+{
+    removeGeometry(item, FillLayer);
+    removeGeometry(item, BorderLayer);
+}
+
+void QDeclarativeGeoMapItemBatcher::eraseRange(Bucket &bucket, const QDeclarativeGeoMapItemBase *item)
+{
+    const auto it = bucket.ranges.find(item);
+    if (it == bucket.ranges.end())
+        return;
+
+    bucket.holes += it->count;
+    bucket.ranges.erase(it);
+    bucket.dirty = true;
+    // Keeps the memory of buckets that are not uploaded for a while bounded
+    if (2 * bucket.holes > bucket.vertices.size())
+        compact(bucket);
+}
+
+/*
+    Moves the ranges of \a bucket together, in their current order, dropping the holes.
+*/
+void QDeclarativeGeoMapItemBatcher::compact(Bucket &bucket)
+{
+    if (!bucket.holes)
+        return;
+
+    QVector<Range *> ranges;
+    ranges.reserve(bucket.ranges.size());
+    for (Range &range : bucket.ranges)
+        ranges.append(&range);
+    std::sort(ranges.begin(), ranges.end(), [](const Range *l, const Range *r) {
+        return l->offset < r->offset;
+    });
+
+    int offset = 0;
+    for (Range *range : qAsConst(ranges)) {
+        if (range->offset != offset) {
+            std::copy(bucket.vertices.cbegin() + range->offset,
+                      bucket.vertices.cbegin() + range->offset + range->count,
+                      bucket.vertices.begin() + offset);
+            range->offset = offset;
+        }
+        offset += range->count;
+    }
+    bucket.vertices.resize(offset);
+    bucket.holes = 0;
+}
+
+int QDeclarativeGeoMapItemBatcher::bucketCount() const
+{
+    return buckets_.size();
+}
+
+int QDeclarativeGeoMapItemBatcher::vertexCount() const
+{
+    int count = 0;
+    for (const Bucket &bucket : buckets_)
+        count += bucket.vertices.size() - bucket.holes;
+    return count;
+}
+
+/*
+    Returns a node holding one geometry node per bucket, in bucket order: fills of all
+    colors first, then borders. Only the buckets changed since the last call are copied.
+*/
+QSGNode *QDeclarativeGeoMapItemBatcher::updateNode(QSGNode *oldNode)
+{
+    QSGNode *root = oldNode;
+    if (!root) {
+        root = new QSGNode;
+        structureDirty_ = true;
+        for (Bucket &bucket : buckets_)
+            bucket.dirty = true;
+    }
+
+    if (structureDirty_) {
+        // Keep the nodes of surviving buckets, so that their vertices are not uploaded again.
+        QHash<QRgb, BatchNode *> oldNodes[2];
+        while (QSGNode *child = root->firstChild()) {
+            root->removeChildNode(child);
+            BatchNode *node = static_cast<BatchNode *>(child);
+            oldNodes[node->layer_].insert(node->material_.color().rgba(), node);
+        }
+        for (auto it = buckets_.begin(); it != buckets_.end(); ++it) {
+            BatchNode *node = oldNodes[it.key().first].take(it.key().second);
+            if (!node) {
+                node = new BatchNode(it.key().first, QColor::fromRgba(it.key().second));
+                it->dirty = true;
+            }
+            root->appendChildNode(node);
+        }
+        for (const QHash<QRgb, BatchNode *> &nodes : oldNodes)
+            qDeleteAll(nodes);
+        structureDirty_ = false;
+    }
+
+    QSGNode *child = root->firstChild();
+    for (Bucket &bucket : buckets_) {
+        if (bucket.dirty) {
+            compact(bucket);
+            BatchNode *node = static_cast<BatchNode *>(child);
+            node->geometry_.allocate(bucket.vertices.size());
+            std::memcpy(node->geometry_.vertexDataAsPoint2D(), bucket.vertices.constData(),
+                        bucket.vertices.size() * sizeof(QSGGeometry::Point2D));
+            node->markDirty(QSGNode::DirtyGeometry);
+            bucket.dirty = false;
+        }
+        child = child->nextSibling();
+    }
+
+    return root;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,132 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QDECLARATIVEGEOMAPITEMBATCHER_P_H
+#define QDECLARATIVEGEOMAPITEMBATCHER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+
+#include <QtQuick/QSGGeometry>
+#include <QtGui/QColor>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+class QSGNode;
+class QGeoMapItemGeometry;
+class QDeclarativeGeoMapItemBase;
+
+/*
+    Collects the triangles of many map items into one vertex buffer per (layer, color)
+    bucket, so that thousands of polylines and polygons sharing a style are drawn with
+    a handful of geometry nodes instead of one node per item.
+
+    Every item owns a contiguous range of its bucket. An update with the same vertex
+    count overwrites the range in place, anything else moves the range to the end of
+    the bucket and leaves a hole behind. Holes are compacted once per bucket, when it
+    is uploaded or when they take up half of it. Only buckets touched since the last
+    sync are uploaded again.
+
+    The setters are called on the GUI thread, updateNode() during the scene graph sync.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMapItemBatcher
+{
+public:
+    enum Layer {
+        FillLayer = 0,
+        BorderLayer = 1
+    };
+
+    QDeclarativeGeoMapItemBatcher();
+    ~QDeclarativeGeoMapItemBatcher();
+
+    void setGeometry(const QDeclarativeGeoMapItemBase *item, Layer layer, const QColor &color,
+                     const QGeoMapItemGeometry &geometry, QSGGeometry::DrawingMode mode,
+                     const QPointF &offset);
+    void removeGeometry(const QDeclarativeGeoMapItemBase *item, Layer layer);
+    void removeItem(QDeclarativeGeoMapItemBase *item);
+
+    int bucketCount() const;
+    int vertexCount() const;
+
+    QSGNode *updateNode(QSGNode *oldNode);
+
+private:
+    struct Range {
+        int offset;
+        int count;
+    };
+
+    struct Bucket {
+        QVector<QSGGeometry::Point2D> vertices;
+        QHash<const QDeclarativeGeoMapItemBase *, Range> ranges;
+        int holes = 0; // vertices of erased ranges still in vertices
+        bool dirty = true;
+    };
+
+    typedef QPair<int, QRgb> BucketKey;
+    typedef QPair<const QDeclarativeGeoMapItemBase *, int> ItemKey;
+
+    static void eraseRange(Bucket &bucket, const QDeclarativeGeoMapItemBase *item);
+    static void compact(Bucket &bucket);
+
+    QMap<BucketKey, Bucket> buckets_;
+    QHash<ItemKey, BucketKey> itemBuckets_;
+    QVector<QSGGeometry::Point2D> triangles_;
+    bool structureDirty_ = true;
+
+    Q_DISABLE_COPY(QDeclarativeGeoMapItemBatcher)
+};
+
+QT_END_NAMESPACE
+
+#endif // QDECLARATIVEGEOMAPITEMBATCHER_P_H
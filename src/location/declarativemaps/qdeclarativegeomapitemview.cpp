@@ -45,6 +45,8 @@
 #include <QtQml/private/qqmlopenmetaobject_p.h>
 #include <QtQuick/private/qquickanimation_p.h>
 #include <QtQml/QQmlListProperty>
+#include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeocameracapabilities_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -71,6 +73,14 @@ QT_BEGIN_NAMESPACE
     \snippet declarative/maps.qml QtLocation import
     \codeline
     \snippet declarative/maps.qml MapRoute
+
+    \section2 Clustering
+
+    When \l clusterDelegate and \l clusterRole are set, the rows of the model are grouped
+    into clusters, for each zoom level, by the coordinate held in \l clusterRole. The
+    delegate is then only instantiated for the rows that stand alone in the viewport,
+    and \l clusterDelegate for the clusters in the viewport. This keeps large models
+    cheap to display, as most of their rows are never instantiated at low zoom levels.
 */
 
 /*!
@@ -165,6 +175,8 @@ void QDeclarativeGeoMapItemView::createdItem(int index, QObject * /*object*/)
         // Falling into case 1. or 3. Returning early to prevent double referencing the delegate instance.
         return;
     }
+    if (clustering() && !isClusterLeaf(index)) // clustered away while incubating
+        return;
 
     QQuickItem *item = qobject_cast<QQuickItem *>(m_delegateModel->object(index, m_incubationMode));
     if (item)
@@ -177,6 +189,10 @@ void QDeclarativeGeoMapItemView::modelUpdated(const QQmlChangeSet &changeSet, bo
 {
     if (!m_map) // everything will be done in instantiateAllItems. Removal is done by declarativegeomap.
         return;
+    if (clustering()) {
+        updateClusteredRows(changeSet, reset);
+        return;
+    }
 
     // move changes are expressed as one remove + one insert, with the same moveId.
     // For simplicity, they will be treated as remove + insert.
@@ -298,6 +314,16 @@ void QDeclarativeGeoMapItemView::setMap(QDeclarativeGeoMap *map)
     if (!map || m_map) // changing map on the fly not supported
         return;
     m_map = map;
+
+    // The clusters in view depend on the camera and on the size of the map
+    connect(map, &QDeclarativeGeoMap::mapReadyChanged, this, &QDeclarativeGeoMapItemView::updateClusters, Qt::UniqueConnection);
+    connect(map, &QDeclarativeGeoMap::zoomLevelChanged, this, &QDeclarativeGeoMapItemView::updateClusters, Qt::UniqueConnection);
+    connect(map, &QDeclarativeGeoMap::centerChanged, this, &QDeclarativeGeoMapItemView::updateClusters, Qt::UniqueConnection);
+    connect(map, &QDeclarativeGeoMap::bearingChanged, this, &QDeclarativeGeoMapItemView::updateClusters, Qt::UniqueConnection);
+    connect(map, &QDeclarativeGeoMap::tiltChanged, this, &QDeclarativeGeoMapItemView::updateClusters, Qt::UniqueConnection);
+    connect(map, &QDeclarativeGeoMap::fieldOfViewChanged, this, &QDeclarativeGeoMapItemView::updateClusters, Qt::UniqueConnection);
+    connect(map, &QQuickItem::widthChanged, this, &QDeclarativeGeoMapItemView::updateClusters, Qt::UniqueConnection);
+    connect(map, &QQuickItem::heightChanged, this, &QDeclarativeGeoMapItemView::updateClusters, Qt::UniqueConnection);
     instantiateAllItems();
 }
 
@@ -313,6 +339,9 @@ void QDeclarativeGeoMapItemView::removeInstantiatedItems(bool transition)
     // Backward as removeItemFromMap modifies m_instantiatedItems
     for (int i = m_instantiatedItems.size() -1; i >= 0 ; i--)
         removeDelegateFromMap(i, transition);
+
+    removeClusters(0);
+    resetClusterRows();
 }
 
 /*!
@@ -326,6 +355,16 @@ void QDeclarativeGeoMapItemView::instantiateAllItems()
     if (!m_componentCompleted || !m_map || !m_delegate || m_itemModel.isNull() || !m_instantiatedItems.isEmpty())
         return;
 
+    if (clustering()) {
+        // Rows are only instantiated once they stand alone in the viewport
+        for (int i = 0; i < m_delegateModel->count(); i++)
+            m_instantiatedItems.append(nullptr);
+        resetClusterRows(m_delegateModel->count());
+        updateClusters();
+        fitViewport();
+        return;
+    }
+
     // If here, m_delegateModel may contain data, but QQmlInstanceModel::object for each row hasn't been called yet.
     QBoolBlocker createBlocker(m_creatingObject, true);
     for (int i = 0; i < m_delegateModel->count(); i++) {
@@ -356,6 +395,93 @@ QList<QQuickItem *> QDeclarativeGeoMapItemView::mapItems()
     return m_instantiatedItems;
 }
 
+/*!
+    \qmlproperty Component QtLocation::MapItemView::clusterDelegate
+
+    This property holds the delegate which defines how the clusters of rows are displayed,
+    when \l clusterRole is set as well. The Component must contain exactly one MapItem
+    -derived object as the root object, such as a \l MapQuickItem. The delegate can use
+    the \c clusterCoordinate and \c clusterCount context properties, which hold the
+    center of the cluster and the number of rows in it.
+
+    The instances of this delegate are reused as the clusters in view change.
+
+    \since QtLocation 5.15
+*/
+QQmlComponent *QDeclarativeGeoMapItemView::clusterDelegate() const
+{
+    return m_clusterDelegate;
+}
+
+void QDeclarativeGeoMapItemView::setClusterDelegate(QQmlComponent *delegate)
+{
+    if (m_clusterDelegate == delegate)
+        return;
+
+    const bool wasClustering = clustering();
+    removeClusters(0);
+    m_clusterDelegate = delegate;
+    if (clustering() != wasClustering)
+        restartClustering();
+    else
+        updateClusters();
+
+    emit clusterDelegateChanged();
+}
+
+/*!
+    \qmlproperty string QtLocation::MapItemView::clusterRole
+
+    This property holds the name of the role of the model holding the coordinate of each
+    row, by which the rows are clustered. Rows without a valid coordinate are never
+    instantiated while clustering.
+
+    \since QtLocation 5.15
+*/
+QString QDeclarativeGeoMapItemView::clusterRole() const
+{
+    return m_clusterRole;
+}
+
+void QDeclarativeGeoMapItemView::setClusterRole(const QString &role)
+{
+    if (m_clusterRole == role)
+        return;
+
+    const bool wasClustering = clustering();
+    m_clusterRole = role;
+    invalidateClusterIndex();
+    if (clustering() || wasClustering)
+        restartClustering();
+
+    emit clusterRoleChanged();
+}
+
+/*!
+    \qmlproperty real QtLocation::MapItemView::clusterRadius
+
+    This property holds the distance, in pixels, within which rows are grouped into a
+    cluster. The default value is 60.
+
+    \since QtLocation 5.15
+*/
+qreal QDeclarativeGeoMapItemView::clusterRadius() const
+{
+    return m_clusterRadius;
+}
+
+void QDeclarativeGeoMapItemView::setClusterRadius(qreal radius)
+{
+    if (radius <= 0 || m_clusterRadius == radius)
+        return;
+
+    m_clusterRadius = radius;
+    invalidateClusterIndex();
+    updateClusters();
+
+    emit clusterRadiusChanged();
+}
+
 QQmlInstanceModel::ReleaseFlags QDeclarativeGeoMapItemView::disposeDelegate(QQuickItem *item)
 {
     disconnect(item, 0, this, 0);
@@ -572,6 +698,133 @@ void QDeclarativeGeoMapItemView::addDelegateToMap(QQuickItem *object, int index,
     qWarning() << "addDelegateToMap called with a "<< object->metaObject()->className();
 }
 
+bool QDeclarativeGeoMapItemView::clustering() const
+{
+    return m_clusterDelegate && !m_clusterRole.isEmpty();
+}
+
+/*!
+    \internal
+
+    Instantiates the items again, when switching between clustering and instantiating
+    every row.
+*/
+void QDeclarativeGeoMapItemView::restartClustering()
+{
+    if (!m_componentCompleted || !m_map)
+        return;
+    removeInstantiatedItems(false);
+    instantiateAllItems();
+}
+
+/*!
+    \internal
+
+    Keeps one placeholder per row, as without clustering, and regroups the rows.
+*/
+void QDeclarativeGeoMapItemView::updateClusteredRows(const QQmlChangeSet &changeSet, bool reset)
+{
+    if (reset)
+        removeInstantiatedItems();
+    updateClusterRows(changeSet);
+    updateClusters();
+    fitViewport();
+}
+
+QGeoCoordinate QDeclarativeGeoMapItemView::clusterRowCoordinate(int row) const
+{
+    return m_delegateModel->variantValue(row, m_clusterRole).value<QGeoCoordinate>();
+}
+
+void QDeclarativeGeoMapItemView::clusterRowInserted(int row)
+{
+    m_instantiatedItems.insert(row, nullptr);
+}
+
+void QDeclarativeGeoMapItemView::clusterRowRemoved(int row)
+{
+    m_instantiatedItems.removeAt(row);
+}
+
+/*!
+    \internal
+
+    Lays the clusters out for the current camera of the map.
+*/
+void QDeclarativeGeoMapItemView::updateClusters()
+{
+    if (!clustering() || !m_componentCompleted || !m_map || !m_map->m_map || !m_map->mapReady())
+        return;
+    if (clusterRowCount() != m_delegateModel->count())
+        return; // not instantiated yet
+    layoutClusters(*m_map->m_map, m_clusterRadius);
+}
+
+void QDeclarativeGeoMapItemView::instantiateClusterLeaf(int row)
+{
+    QBoolBlocker createBlocker(m_creatingObject, true);
+    QObject *delegateInstance = m_delegateModel->object(row, m_incubationMode);
+    if (delegateInstance) // else createdItem will add it
+        addDelegateToMap(qobject_cast<QQuickItem *>(delegateInstance), row, true);
+}
+
+void QDeclarativeGeoMapItemView::releaseClusterLeaf(int row)
+{
+    QQuickItem *item = m_instantiatedItems.at(row);
+    if (!item) { // still incubating
+        m_delegateModel->cancel(row);
+        return;
+    }
+    m_instantiatedItems[row] = nullptr;
+    if (m_exit)
+        terminateExitTransition(item);
+    disposeDelegate(item);
+}
+
+bool QDeclarativeGeoMapItemView::placeCluster(int index, const QGeoCoordinate &coordinate, int count)
+{
+    if (index < m_clusterItems.size()) {
+        setClusterContext(m_clusterItems.at(index).context, coordinate, count);
+        return true;
+    }
+
+    QQmlContext *context = createClusterContext(m_clusterDelegate, this, coordinate, count);
+    QObject *object = m_clusterDelegate->create(context);
+    QDeclarativeGeoMapItemBase *item = qobject_cast<QDeclarativeGeoMapItemBase *>(object);
+    if (!item) {
+        qWarning() << "MapItemView clusterDelegate must have a map item as root object";
+        delete object;
+        delete context;
+        return false;
+    }
+
+    item->setParent(this);
+    context->setParent(item);
+    item->setParentItem(this);
+    m_map->addMapItem(item);
+
+    ClusterItem clusterItem;
+    clusterItem.item = item;
+    clusterItem.context = context;
+    m_clusterItems.append(clusterItem);
+    return true;
+}
+
+/*!
+    \internal
+
+    Removes the cluster items from first on.
+*/
+void QDeclarativeGeoMapItemView::removeClusters(int first)
+{
+    while (m_clusterItems.size() > first) {
+        QDeclarativeGeoMapItemBase *item = m_clusterItems.takeLast().item;
+        if (m_map)
+            m_map->removeMapItem(item);
+        item->deleteLater(); // may be running one of its handlers, such as onClicked
+    }
+}
+
 QT_END_NAMESPACE
 
 
@@ -59,11 +59,13 @@
 #include <private/qqmldelegatemodel_p.h>
 #include <QtQuick/private/qquicktransition_p.h>
 #include <QtLocation/private/qdeclarativegeomapitemgroup_p.h>
+#include <QtLocation/private/qgeoclusteredview_p.h>
 
 QT_BEGIN_NAMESPACE
 
 class QAbstractItemModel;
 class QQmlComponent;
+class QQmlContext;
 class QQuickItem;
 class QDeclarativeGeoMap;
 class QDeclarativeGeoMapItemBase;
@@ -74,7 +76,8 @@ class QDeclarativeGeoMapItemViewItemData;
 class QDeclarativeGeoMapItemView;
 class QDeclarativeGeoMapItemGroup;
 
-class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMapItemView : public QDeclarativeGeoMapItemGroup
+class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMapItemView : public QDeclarativeGeoMapItemGroup,
+                                                              private QGeoClusteredView
 {
     Q_OBJECT
 
@@ -85,6 +88,9 @@ class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMapItemView : public QDeclarative
     Q_PROPERTY(QQuickTransition *remove MEMBER m_exit REVISION 12)
     Q_PROPERTY(QList<QQuickItem *> mapItems READ mapItems REVISION 12)
     Q_PROPERTY(bool incubateDelegates READ incubateDelegates WRITE setIncubateDelegates NOTIFY incubateDelegatesChanged REVISION 12)
+    Q_PROPERTY(QQmlComponent *clusterDelegate READ clusterDelegate WRITE setClusterDelegate NOTIFY clusterDelegateChanged REVISION 15)
+    Q_PROPERTY(QString clusterRole READ clusterRole WRITE setClusterRole NOTIFY clusterRoleChanged REVISION 15)
+    Q_PROPERTY(qreal clusterRadius READ clusterRadius WRITE setClusterRadius NOTIFY clusterRadiusChanged REVISION 15)
 
 public:
     explicit QDeclarativeGeoMapItemView(QQuickItem *parent = 0);
@@ -108,6 +114,15 @@ public:
 
     QList<QQuickItem *> mapItems();
 
+    QQmlComponent *clusterDelegate() const;
+    void setClusterDelegate(QQmlComponent *delegate);
+
+    QString clusterRole() const;
+    void setClusterRole(const QString &role);
+
+    qreal clusterRadius() const;
+    void setClusterRadius(qreal radius);
+
     // From QQmlParserStatus
     void componentComplete() override;
     void classBegin() override;
@@ -117,6 +132,9 @@ Q_SIGNALS:
     void delegateChanged();
     void autoFitViewportChanged();
     void incubateDelegatesChanged();
+    Q_REVISION(15) void clusterDelegateChanged();
+    Q_REVISION(15) void clusterRoleChanged();
+    Q_REVISION(15) void clusterRadiusChanged();
 
 private Q_SLOTS:
     void destroyingItem(QObject *object);
@@ -124,6 +142,7 @@ private Q_SLOTS:
     void createdItem(int index, QObject *object);
     void modelUpdated(const QQmlChangeSet &changeSet, bool reset);
     void exitTransitionFinished();
+    void updateClusters();
 
 private:
     void fitViewport();
@@ -139,6 +158,23 @@ private:
     void addItemGroupToMap(QDeclarativeGeoMapItemGroup *item, int index, bool createdItem);
     void addDelegateToMap(QQuickItem *object, int index, bool createdItem = false);
 
+    struct ClusterItem {
+        QDeclarativeGeoMapItemBase *item = nullptr;
+        QQmlContext *context = nullptr;
+    };
+    bool clustering() const;
+    void restartClustering();
+    void updateClusteredRows(const QQmlChangeSet &changeSet, bool reset);
+
+    // From QGeoClusteredView
+    QGeoCoordinate clusterRowCoordinate(int row) const override;
+    void clusterRowInserted(int row) override;
+    void clusterRowRemoved(int row) override;
+    void instantiateClusterLeaf(int row) override;
+    void releaseClusterLeaf(int row) override;
+    bool placeCluster(int index, const QGeoCoordinate &coordinate, int count) override;
+    void removeClusters(int first) override;
+
     bool m_componentCompleted;
     QQmlIncubator::IncubationMode m_incubationMode = QQmlIncubator::Asynchronous;
     QQmlComponent *m_delegate;
@@ -151,6 +187,11 @@ private:
     QQuickTransition *m_enter = nullptr;
     QQuickTransition *m_exit = nullptr;
 
+    QQmlComponent *m_clusterDelegate = nullptr;
+    QString m_clusterRole;
+    qreal m_clusterRadius = 60.0;
+    QVector<ClusterItem> m_clusterItems; // reused for the clusters in view
+
     friend class QDeclarativeGeoMap;
     friend class QDeclarativeGeoMapItemBase;
     friend class QDeclarativeGeoMapItemTransitionManager;
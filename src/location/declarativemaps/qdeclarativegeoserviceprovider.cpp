@@ -35,6 +35,7 @@
 ****************************************************************************/
 
 #include "qdeclarativegeoserviceprovider_p.h"
+#include <QtLocation/private/qgeomappingmanager_p.h>
 #include <QtQml/QQmlInfo>
 #include <QtQml/QQmlEngine>
 
@@ -451,6 +452,41 @@ bool QDeclarativeGeoServiceProvider::supportsNavigation(const QDeclarativeGeoSer
         return (sp && (sp->navigationFeatures() & f) == f);
 }
 
+/*!
+    \qmlmethod var Plugin::mappingStatistics()
+
+    This method returns the runtime statistics of the mapping engine as a map.
+    For tile based plugins it contains the hit, miss, insert and eviction counts
+    of the \c texture, \c memory and \c disk tile cache layers, the bytes read
+    from and written to disk, a histogram of tile decoding times and the number
+    of queued and in-flight tile requests.
+
+    An empty map is returned if the plugin does not support mapping.
+
+    \since QtLocation 5.15
+*/
+QVariantMap QDeclarativeGeoServiceProvider::mappingStatistics() const
+{
+    QGeoServiceProvider *sp = sharedGeoServiceProvider();
+    QGeoMappingManager *manager = sp ? sp->mappingManager() : nullptr;
+    return manager ? manager->statistics() : QVariantMap();
+}
+
+/*!
+    \qmlmethod void Plugin::resetMappingStatistics()
+
+    This method resets the counters returned by \l mappingStatistics().
+
+    \since QtLocation 5.15
+*/
+void QDeclarativeGeoServiceProvider::resetMappingStatistics()
+{
+    QGeoServiceProvider *sp = sharedGeoServiceProvider();
+    QGeoMappingManager *manager = sp ? sp->mappingManager() : nullptr;
+    if (manager)
+        manager->resetStatistics();
+}
+
 /*!
     \qmlproperty enumeration Plugin::required
 
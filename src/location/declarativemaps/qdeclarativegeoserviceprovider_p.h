@@ -179,6 +179,8 @@ public:
     Q_INVOKABLE bool supportsMapping(const MappingFeatures &feature = AnyMappingFeatures) const;
     Q_INVOKABLE bool supportsPlaces(const PlacesFeatures &feature = AnyPlacesFeatures) const;
     Q_REVISION(11) Q_INVOKABLE bool supportsNavigation(const NavigationFeature &feature = AnyNavigationFeatures) const;
+    Q_REVISION(15) Q_INVOKABLE QVariantMap mappingStatistics() const;
+    Q_REVISION(15) Q_INVOKABLE void resetMappingStatistics();
 
     QStringList locales() const;
     void setLocales(const QStringList &locales);
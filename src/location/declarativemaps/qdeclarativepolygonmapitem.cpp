@@ -85,6 +85,9 @@ QT_BEGIN_NAMESPACE
     Coordinates can also be added and removed at any time using the \l addCoordinate and
     \l removeCoordinate methods.
 
+    The holes of a \l {geopolygon} assigned to the \c geoShape
+    property are left unfilled, and are outlined by the border.
+
     For drawing rectangles with "straight" edges (same latitude across one
     edge, same latitude across the other), the \l MapRectangle type provides
     a simpler, two-point API.
@@ -151,16 +154,37 @@ QGeoMapPolygonGeometry::QGeoMapPolygonGeometry()
 {
 }
 
+/*
+    Appends the polygons of a clipper result, each as its outer ring followed by its holes.
+    Polygons nested inside holes are children of the hole nodes.
+*/
+static void appendPolygons(const QtClipperLib::PolyNode &node,
+                           QList<QList<QList<QDoubleVector2D> > > &polygons)
+{
+    for (const QtClipperLib::PolyNode *outer : node.Childs) {
+        QList<QList<QDoubleVector2D> > polygon;
+        polygon.reserve(outer->ChildCount() + 1);
+        polygon << QClipperUtils::pathToQList(outer->Contour);
+        for (const QtClipperLib::PolyNode *hole : outer->Childs) {
+            polygon << QClipperUtils::pathToQList(hole->Contour);
+            appendPolygons(*hole, polygons);
+        }
+        polygons << polygon;
+    }
+}
+
 /*!
     \internal
 */
 void QGeoMapPolygonGeometry::updateSourcePoints(const QGeoMap &map,
-                                                const QList<QDoubleVector2D> &path)
+                                                const QList<QDoubleVector2D> &path,
+                                                const QList<QList<QDoubleVector2D> > &holes)
 {
     if (!sourceDirty_)
         return;
     const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map.geoProjection());
     srcPath_ = QPainterPath();
+    srcRingCounts_.clear();
 
     // build the actual path
     // The approach is the same as described in QGeoMapPolylineGeometry::updateSourcePoints
@@ -170,47 +194,74 @@ void QGeoMapPolygonGeometry::updateSourcePoints(const QGeoMap &map,
     if (preserveGeometry_)
         unwrapBelowX = leftBoundWrapped.x();
 
-    QList<QDoubleVector2D> wrappedPath;
-    wrappedPath.reserve(path.size());
     QDoubleVector2D wrappedLeftBound(qInf(), qInf());
-    // 1)
-    for (int i = 0; i < path.size(); ++i) {
-        const QDoubleVector2D &coord = path.at(i);
-        QDoubleVector2D wrappedProjection = p.wrapMapProjection(coord);
+    const auto wrapRing = [&](const QList<QDoubleVector2D> &ring, QList<QDoubleVector2D> &wrappedRing) {
+        wrappedRing.reserve(ring.size());
+        for (const QDoubleVector2D &coord : ring) {
+            QDoubleVector2D wrappedProjection = p.wrapMapProjection(coord);
+
+            // We can get NaN if the map isn't set up correctly, or the projection
+            // is faulty -- probably best thing to do is abort
+            if (!qIsFinite(wrappedProjection.x()) || !qIsFinite(wrappedProjection.y()))
+                return false;
+
+            const bool isPointLessThanUnwrapBelowX = (wrappedProjection.x() < leftBoundWrapped.x());
+            // unwrap x to preserve geometry if moved to border of map
+            if (preserveGeometry_ && isPointLessThanUnwrapBelowX) {
+                double distance = wrappedProjection.x() - unwrapBelowX;
+                if (distance < 0.0)
+                    distance += 1.0;
+                wrappedProjection.setX(unwrapBelowX + distance);
+            }
+            if (wrappedProjection.x() < wrappedLeftBound.x() || (wrappedProjection.x() == wrappedLeftBound.x() && wrappedProjection.y() < wrappedLeftBound.y())) {
+                wrappedLeftBound = wrappedProjection;
+            }
+            wrappedRing.append(wrappedProjection);
+        }
+        return true;
+    };
 
-        // We can get NaN if the map isn't set up correctly, or the projection
-        // is faulty -- probably best thing to do is abort
-        if (!qIsFinite(wrappedProjection.x()) || !qIsFinite(wrappedProjection.y()))
+    // 1)
+    QList<QDoubleVector2D> wrappedPath;
+    if (!wrapRing(path, wrappedPath))
+        return;
+    QList<QList<QDoubleVector2D> > wrappedHoles;
+    for (const QList<QDoubleVector2D> &hole : holes) {
+        if (hole.size() < 3)
+            continue;
+        const QDoubleVector2D outerLeftBound = wrappedLeftBound; // holes lie within the outer ring
+        wrappedHoles.append(QList<QDoubleVector2D>());
+        if (!wrapRing(hole, wrappedHoles.last()))
             return;
+        wrappedLeftBound = outerLeftBound;
+    }
 
-        const bool isPointLessThanUnwrapBelowX = (wrappedProjection.x() < leftBoundWrapped.x());
-        // unwrap x to preserve geometry if moved to border of map
-        if (preserveGeometry_ && isPointLessThanUnwrapBelowX) {
-            double distance = wrappedProjection.x() - unwrapBelowX;
-            if (distance < 0.0)
-                distance += 1.0;
-            wrappedProjection.setX(unwrapBelowX + distance);
-        }
-        if (wrappedProjection.x() < wrappedLeftBound.x() || (wrappedProjection.x() == wrappedLeftBound.x() && wrappedProjection.y() < wrappedLeftBound.y())) {
-            wrappedLeftBound = wrappedProjection;
+    // 2) Clip the rings, or just resolve self-intersections and holes, with the even-odd
+    //    rule. The result is a tree of simple polygons with their holes.
+    QList<QList<QList<QDoubleVector2D> > > polygons;
+    const QList<QDoubleVector2D> &visibleRegion = p.projectableGeometry();
+    if (assumeSimple_ && wrappedHoles.isEmpty() && visibleRegion.isEmpty()) {
+        polygons << (QList<QList<QDoubleVector2D> >() << wrappedPath);
+    } else {
+        QtClipperLib::Clipper clipper;
+        clipper.AddPath(QClipperUtils::qListToPath(wrappedPath), QtClipperLib::ptSubject, true);
+        for (const QList<QDoubleVector2D> &hole : qAsConst(wrappedHoles))
+            clipper.AddPath(QClipperUtils::qListToPath(hole), QtClipperLib::ptSubject, true);
+        QtClipperLib::PolyTree tree;
+        if (visibleRegion.size()) {
+            clipper.AddPath(QClipperUtils::qListToPath(visibleRegion), QtClipperLib::ptClip, true);
+            clipper.Execute(QtClipperLib::ctIntersection, tree, QtClipperLib::pftEvenOdd, QtClipperLib::pftEvenOdd);
+        } else {
+            clipper.Execute(QtClipperLib::ctUnion, tree, QtClipperLib::pftEvenOdd, QtClipperLib::pftEvenOdd);
         }
-        wrappedPath.append(wrappedProjection);
+        appendPolygons(tree, polygons);
     }
 
-    // 2)
-    QList<QList<QDoubleVector2D> > clippedPaths;
-    const QList<QDoubleVector2D> &visibleRegion = p.projectableGeometry();
     if (visibleRegion.size()) {
-        c2t::clip2tri clipper;
-        clipper.addSubjectPath(QClipperUtils::qListToPath(wrappedPath), true);
-        clipper.addClipPolygon(QClipperUtils::qListToPath(visibleRegion));
-        Paths res = clipper.execute(c2t::clip2tri::Intersection, QtClipperLib::pftEvenOdd, QtClipperLib::pftEvenOdd);
-        clippedPaths = QClipperUtils::pathsToQList(res);
-
         // 2.1) update srcOrigin_ and leftBoundWrapped with the point with minimum X
         QDoubleVector2D lb(qInf(), qInf());
-        for (const QList<QDoubleVector2D> &path: clippedPaths)
-            for (const QDoubleVector2D &p: path)
+        for (const QList<QList<QDoubleVector2D> > &polygon: qAsConst(polygons))
+            for (const QDoubleVector2D &p: polygon.first()) // holes lie within the outer ring
                 if (p.x() < lb.x() || (p.x() == lb.x() && p.y() < lb.y()))
                     // y-minimization needed to find the same point on polygon and border
                     lb = p;
@@ -223,35 +274,33 @@ void QGeoMapPolygonGeometry::updateSourcePoints(const QGeoMap &map,
         lb.setX(qMax(wrappedLeftBound.x(), lb.x()));
         leftBoundWrapped = lb;
         srcOrigin_ = p.mapProjectionToGeo(p.unwrapMapProjection(lb));
-    } else {
-        clippedPaths.append(wrappedPath);
     }
 
     // 3)
     QDoubleVector2D origin = p.wrappedMapProjectionToItemPosition(leftBoundWrapped);
-    for (const QList<QDoubleVector2D> &path: clippedPaths) {
-        QDoubleVector2D lastAddedPoint;
-        for (int i = 0; i < path.size(); ++i) {
-            QDoubleVector2D point = p.wrappedMapProjectionToItemPosition(path.at(i));
-            point = point - origin; // (0,0) if point == geoLeftBound_
-
-            if (i == 0) {
-                srcPath_.moveTo(point.toPointF());
-                lastAddedPoint = point;
-            } else {
-                if ((point - lastAddedPoint).manhattanLength() > 3 ||
-                        i == path.size() - 1) {
-                    srcPath_.lineTo(point.toPointF());
+    for (const QList<QList<QDoubleVector2D> > &polygon: qAsConst(polygons)) {
+        for (const QList<QDoubleVector2D> &ring: polygon) {
+            QDoubleVector2D lastAddedPoint;
+            for (int i = 0; i < ring.size(); ++i) {
+                QDoubleVector2D point = p.wrappedMapProjectionToItemPosition(ring.at(i));
+                point = point - origin; // (0,0) if point == geoLeftBound_
+
+                if (i == 0) {
+                    srcPath_.moveTo(point.toPointF());
                     lastAddedPoint = point;
+                } else {
+                    if ((point - lastAddedPoint).manhattanLength() > 3 ||
+                            i == ring.size() - 1) {
+                        srcPath_.lineTo(point.toPointF());
+                        lastAddedPoint = point;
+                    }
                 }
             }
+            srcPath_.closeSubpath();
         }
-        srcPath_.closeSubpath();
+        srcRingCounts_ << polygon.size();
     }
 
-    if (!assumeSimple_)
-        srcPath_ = srcPath_.simplified();
-
     sourceBounds_ = srcPath_.boundingRect();
 }
 
@@ -288,37 +337,42 @@ void QGeoMapPolygonGeometry::updateScreenPoints(const QGeoMap &map, qreal stroke
     using N = uint32_t;
     using Point = std::array<Coord, 2>;
 
+    // Tessellate every polygon with its holes. The ring and index buffers are reused
+    // from one polygon to the next.
+    qt_mapbox::detail::Earcut<N> earcut;
     std::vector<std::vector<Point>> polygon;
-    polygon.push_back(std::vector<Point>());
-    std::vector<Point> &poly = polygon.front();
-    // ... fill polygon structure with actual data
-
-    for (int i = 0; i < ppi.elementCount(); ++i) {
-        const QPainterPath::Element e = ppi.elementAt(i);
-        if (e.isMoveTo() || i == ppi.elementCount() - 1
-                || (qAbs(e.x - poly.front()[0]) < 0.1
-                    && qAbs(e.y - poly.front()[1]) < 0.1)) {
-            Point p = {{ e.x, e.y }};
-            poly.push_back( p );
-        } else if (e.isLineTo()) {
-            Point p = {{ e.x, e.y }};
-            poly.push_back( p );
-        } else {
-            qWarning("Unhandled element type in polygon painterpath");
+    screenVertices_.reserve(ppi.elementCount());
+
+    int element = 0;
+    for (int ringCount : qAsConst(srcRingCounts_)) {
+        polygon.resize(ringCount);
+        for (std::vector<Point> &ring : polygon) {
+            ring.clear();
+            for (; element < ppi.elementCount(); ++element) {
+                const QPainterPath::Element e = ppi.elementAt(element);
+                if (e.isMoveTo() && !ring.empty())
+                    break; // next ring
+                if (e.isCurveTo()) {
+                    qWarning("Unhandled element type in polygon painterpath");
+                    continue;
+                }
+                Point p = {{ e.x, e.y }};
+                ring.push_back( p );
+            }
         }
-    }
 
-    if (poly.size() > 2) {
-        // Run tessellation
-        // Returns array of indices that refer to the vertices of the input polygon.
+        // Returns array of indices that refer to the vertices of the rings, in order.
         // Three subsequent indices form a triangle.
-        screenVertices_.clear();
-        screenIndices_.clear();
-        for (const auto &p : poly)
-            screenVertices_ << QPointF(p[0], p[1]);
-        std::vector<N> indices = qt_mapbox::earcut<N>(polygon);
-        for (const auto &i: indices)
-            screenIndices_ << quint32(i);
+        earcut(polygon);
+        if (earcut.indices.empty())
+            continue;
+
+        const quint32 base = quint32(screenVertices_.size());
+        for (const std::vector<Point> &ring : polygon)
+            for (const Point &p : ring)
+                screenVertices_ << QPointF(p[0], p[1]);
+        for (const N i : earcut.indices)
+            screenIndices_ << base + quint32(i);
     }
 
     screenBounds_ = ppi.boundingRect();
@@ -475,7 +529,7 @@ void QDeclarativePolygonMapItem::setColor(const QColor &color)
 
     color_ = color;
     dirtyMaterial_ = true;
-    update();
+    updateAppearance();
     emit colorChanged(color_);
 }
 
@@ -505,23 +559,50 @@ QSGNode *QDeclarativePolygonMapItem::updateMapItemPaintNode(QSGNode *oldNode, Up
 /*!
     \internal
 */
-void QDeclarativePolygonMapItem::updatePolish()
+bool QDeclarativePolygonMapItem::updateBatchedGeometry(QDeclarativeGeoMapItemBatcher *batcher)
+{
+    const QPointF offset = mapToItem(quickMap(), QPointF());
+    batcher->setGeometry(this, QDeclarativeGeoMapItemBatcher::FillLayer, color_, geometry_,
+                         QSGGeometry::DrawTriangles, offset);
+    batcher->setGeometry(this, QDeclarativeGeoMapItemBatcher::BorderLayer, border_.color(),
+                         borderGeometry_, QSGGeometry::DrawTriangleStrip, offset);
+    geometry_.setPreserveGeometry(false);
+    borderGeometry_.setPreserveGeometry(false);
+    geometry_.markClean();
+    borderGeometry_.markClean();
+    dirtyMaterial_ = true; // a paint node created after unbatching must be filled
+    return true;
+}
+
+/*!
+    \internal
+*/
+bool QDeclarativePolygonMapItem::computeGeometry()
 {
     if (!map() || map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
-        return;
+        return false;
     if (geopath_.path().length() == 0) { // Possibly cleared
         geometry_.clear();
         borderGeometry_.clear();
-        setWidth(0);
-        setHeight(0);
-        return;
+        return true;
     }
 
     const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map()->geoProjection());
-    QScopedValueRollback<bool> rollback(updatingGeometry_);
-    updatingGeometry_ = true;
+    if (simplifiedPath_.isEmpty())
+        simplifiedPath_.setPath(geopathProjected_, true);
+    const QList<QDoubleVector2D> &path = simplifiedPath_.path(map()->cameraData().zoomLevel(), p.mapWidth());
+
+    if (simplifiedHoles_.size() != holesProjected_.size()) {
+        simplifiedHoles_.resize(holesProjected_.size());
+        for (int i = 0; i < holesProjected_.size(); ++i)
+            simplifiedHoles_[i].setPath(holesProjected_.at(i), true);
+    }
+    QList<QList<QDoubleVector2D> > holes;
+    holes.reserve(simplifiedHoles_.size());
+    for (QGeoPathLevelOfDetail &hole : simplifiedHoles_)
+        holes << hole.path(map()->cameraData().zoomLevel(), p.mapWidth());
 
-    geometry_.updateSourcePoints(*map(), geopathProjected_);
+    geometry_.updateSourcePoints(*map(), path, holes);
     geometry_.updateScreenPoints(*map(), border_.width());
 
     QList<QGeoMapItemGeometry *> geoms;
@@ -529,7 +610,7 @@ void QDeclarativePolygonMapItem::updatePolish()
     borderGeometry_.clear();
 
     if (border_.color() != Qt::transparent && border_.width() > 0) {
-        QList<QDoubleVector2D> closedPath = geopathProjected_;
+        QList<QDoubleVector2D> closedPath = path;
         closedPath << closedPath.first();
 
         borderGeometry_.setPreserveGeometry(true, geopath_.boundingGeoRectangle().topLeft());
@@ -541,6 +622,12 @@ void QDeclarativePolygonMapItem::updatePolish()
 
         QDoubleVector2D borderLeftBoundWrapped;
         QList<QList<QDoubleVector2D > > clippedPaths = borderGeometry_.clipPath(*map(), closedPath, borderLeftBoundWrapped);
+        for (QList<QDoubleVector2D> closedHole : qAsConst(holes)) {
+            if (closedHole.size() < 3)
+                continue;
+            closedHole << closedHole.first();
+            clippedPaths << borderGeometry_.clipPath(*map(), closedHole, borderLeftBoundWrapped);
+        }
         if (clippedPaths.size()) {
             borderLeftBoundWrapped = p.geoToWrappedMapProjection(geometryOrigin);
             borderGeometry_.pathToScreen(*map(), clippedPaths, borderLeftBoundWrapped);
@@ -552,9 +639,28 @@ void QDeclarativePolygonMapItem::updatePolish()
         }
     }
 
-    QRectF combined = QGeoMapItemGeometry::translateToCommonOrigin(geoms);
-    setWidth(combined.width() + 2 * border_.width());
-    setHeight(combined.height() + 2 * border_.width());
+    geometryBounds_ = QGeoMapItemGeometry::translateToCommonOrigin(geoms);
+    return true;
+}
+
+/*!
+    \internal
+*/
+void QDeclarativePolygonMapItem::updatePolish()
+{
+    if (!takePrecomputedGeometry() && !computeGeometry())
+        return;
+    if (geopath_.path().length() == 0) { // Possibly cleared
+        setWidth(0);
+        setHeight(0);
+        return;
+    }
+
+    QScopedValueRollback<bool> rollback(updatingGeometry_);
+    updatingGeometry_ = true;
+
+    setWidth(geometryBounds_.width() + 2 * border_.width());
+    setHeight(geometryBounds_.height() + 2 * border_.width());
 
     setPositionOnMap(geometry_.origin(), -1 * geometry_.sourceBoundingBox().topLeft()
                                             + QPointF(border_.width(), border_.width()));
@@ -594,6 +700,16 @@ void QDeclarativePolygonMapItem::regenerateCache()
     geopathProjected_.reserve(geopath_.path().size());
     for (const QGeoCoordinate &c : geopath_.path())
         geopathProjected_ << p.geoToMapProjection(c);
+    simplifiedPath_.clear();
+
+    holesProjected_.clear();
+    for (int i = 0; i < geopath_.holesCount(); ++i) {
+        QList<QDoubleVector2D> hole;
+        for (const QGeoCoordinate &c : geopath_.holePath(i))
+            hole << p.geoToMapProjection(c);
+        holesProjected_ << hole;
+    }
+    simplifiedHoles_.clear();
 }
 
 /*!
@@ -605,6 +721,7 @@ void QDeclarativePolygonMapItem::updateCache()
         return;
     const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map()->geoProjection());
     geopathProjected_ << p.geoToMapProjection(geopath_.path().last());
+    simplifiedPath_.clear();
 }
 
 /*!
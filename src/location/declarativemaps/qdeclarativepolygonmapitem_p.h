@@ -69,12 +69,14 @@ public:
     inline void setAssumeSimple(bool value) { assumeSimple_ = value; }
 
     void updateSourcePoints(const QGeoMap &map,
-                            const QList<QDoubleVector2D> &path);
+                            const QList<QDoubleVector2D> &path,
+                            const QList<QList<QDoubleVector2D> > &holes = QList<QList<QDoubleVector2D> >());
 
     void updateScreenPoints(const QGeoMap &map, qreal strokeWidth = 0.0);
 
 protected:
     QPainterPath srcPath_;
+    QVector<int> srcRingCounts_; // number of subpaths of srcPath_ per polygon: the outer ring, then its holes
     bool assumeSimple_;
 };
 
@@ -116,6 +118,8 @@ Q_SIGNALS:
 protected:
     void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
     void updatePolish() override;
+    bool updateBatchedGeometry(QDeclarativeGeoMapItemBatcher *batcher) override;
+    bool computeGeometry() override;
 
 protected Q_SLOTS:
     void markSourceDirtyAndUpdate();
@@ -127,11 +131,15 @@ private:
 
     QGeoPolygon geopath_;
     QList<QDoubleVector2D> geopathProjected_;
+    QGeoPathLevelOfDetail simplifiedPath_; // ranked lazily, on the first polish after a change
+    QList<QList<QDoubleVector2D> > holesProjected_;
+    QVector<QGeoPathLevelOfDetail> simplifiedHoles_;
     QDeclarativeMapLineProperties border_;
     QColor color_;
     bool dirtyMaterial_;
     QGeoMapPolygonGeometry geometry_;
     QGeoMapPolylineGeometry borderGeometry_;
+    QRectF geometryBounds_; // of fill and border, in the common origin
     bool updatingGeometry_;
 };
 
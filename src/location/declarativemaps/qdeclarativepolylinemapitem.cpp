@@ -40,14 +40,17 @@
 #include "locationvaluetypehelper_p.h"
 #include "qdoublevector2d_p.h"
 #include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
 
 #include <QtCore/QScopedValueRollback>
+#include <QtQuick/QSGTransformNode>
 #include <QtQml/QQmlInfo>
 #include <QtQml/private/qqmlengine_p.h>
 #include <QPainter>
 #include <QPainterPath>
 #include <QPainterPathStroker>
 #include <qnumeric.h>
+#include <qmath.h>
 
 #include <QtGui/private/qvectorpath_p.h>
 #include <QtGui/private/qtriangulatingstroker_p.h>
@@ -56,6 +59,7 @@
 #include <QtPositioning/private/qclipperutils_p.h>
 #include <QtPositioning/private/qgeopath_p.h>
 #include <array>
+#include <cmath>
 
 QT_BEGIN_NAMESPACE
 
@@ -308,6 +312,24 @@ static QList<QList<QDoubleVector2D> > clipLine(
     \since 5.14
 */
 
+/*!
+    \qmlproperty enumeration QtLocation::MapPolyline::backend
+
+    This property holds which backend is used to render the MapPolyline.
+
+    \list
+    \li MapPolyline.Software - The polyline is stroked in screen space whenever the map
+        changes. This is the default.
+    \li MapPolyline.Transformed - The polyline is stroked once for each integer zoom level,
+        and the camera is applied to it as a transformation. Panning, rotating and zooming
+        within the same integer zoom level cost no tessellation, which benefits long paths.
+        As a trade off, the width of the line scales by up to a factor of \c {sqrt(2)}
+        while zooming. When the map is tilted the software backend is used.
+    \endlist
+
+    \since 5.15
+*/
+
 QDeclarativeMapLineProperties::QDeclarativeMapLineProperties(QObject *parent) :
     QObject(parent),
     width_(1.0),
@@ -523,6 +545,8 @@ void QGeoMapPolylineGeometry::updateSourcePoints(const QGeoMap &map,
 
     // 3)
     pathToScreen(map, clippedPaths, leftBoundWrapped);
+    srcLeftBoundWrapped_ = leftBoundWrapped;
+    appendedPoints_ = 0;
 }
 
 // ***  SCREEN CLIPPING *** //
@@ -723,17 +747,128 @@ void QGeoMapPolylineGeometry::updateScreenPoints(const QGeoMap &map,
     this->translate( -1 * sourceBounds_.topLeft() + strokeOffset);
 }
 
+/*!
+    \internal
+
+    Extends the geometry with the last \a count vertices of \a path, added since the last
+    update, projecting and stroking only the new segments. Returns false, leaving the
+    geometry untouched, when it has to be rebuilt with updateSourcePoints() instead.
+*/
+bool QGeoMapPolylineGeometry::appendPoints(const QGeoMap &map,
+                                           const QList<QDoubleVector2D> &path,
+                                           int count,
+                                           qreal strokeWidth)
+{
+    // The camera must not have changed since the last update, and a tilted camera
+    // would need the new segments to be clipped against the projectable region.
+    if (sourceDirty_ || count <= 0 || count >= path.size() || srcPointTypes_.size() < 2
+            || screenVertices_.isEmpty() || map.cameraData().tilt() != 0.0) {
+        return false;
+    }
+    // Each appended piece is stroked with its own caps, and without the decimation of
+    // pathToScreen(): rebuild once the appended points outnumber the others.
+    if (2 * (appendedPoints_ + count) > srcPointTypes_.size() + count)
+        return false;
+
+    const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map.geoProjection());
+    const QDoubleVector2D origin = p.wrappedMapProjectionToItemPosition(srcLeftBoundWrapped_);
+    const int last = srcPointTypes_.size() - 1;
+    QDoubleVector2D lastAddedPoint(srcPoints_.at(last * 2), srcPoints_.at(last * 2 + 1));
+
+    // Same as clipPath() and pathToScreen(), preserving the geometry across the map border
+    QVector<qreal> points;
+    points.reserve(count * 2);
+    QRectF bounds = sourceBounds_;
+    for (int i = path.size() - count; i < path.size(); ++i) {
+        QDoubleVector2D wrappedProjection = p.wrapMapProjection(path.at(i));
+        if (!qIsFinite(wrappedProjection.x()) || !qIsFinite(wrappedProjection.y()))
+            return false;
+        if (wrappedProjection.x() < srcLeftBoundWrapped_.x()) {
+            double distance = wrappedProjection.x() - srcLeftBoundWrapped_.x();
+            if (distance < 0.0)
+                distance += 1.0;
+            wrappedProjection.setX(srcLeftBoundWrapped_.x() + distance);
+        }
+
+        const QDoubleVector2D point = p.wrappedMapProjectionToItemPosition(wrappedProjection) - origin;
+        if ((point - lastAddedPoint).manhattanLength() > 3 || i == path.size() - 1) {
+            points << point.x() << point.y();
+            bounds.setLeft(qMin(point.x(), bounds.left()));
+            bounds.setTop(qMin(point.y(), bounds.top()));
+            bounds.setRight(qMax(point.x(), bounds.right()));
+            bounds.setBottom(qMax(point.y(), bounds.bottom()));
+            lastAddedPoint = point;
+        }
+    }
+
+    // Stroke from the previous segment, so that the join at the former last point is drawn
+    const int first = last - 1;
+    QVector<qreal> tailPoints = srcPoints_.mid(first * 2);
+    tailPoints << points;
+    QVector<QPainterPath::ElementType> tailTypes(tailPoints.size() / 2, QPainterPath::LineToElement);
+    tailTypes[0] = QPainterPath::MoveToElement;
+
+    if (clipToViewport_) {
+        const QPointF screenOrigin = map.geoProjection().coordinateToItemPosition(srcOrigin_, false).toPointF();
+        if (!qIsFinite(screenOrigin.x()) || !qIsFinite(screenOrigin.y()))
+            return false;
+        QRectF viewport(0, 0, map.viewportWidth(), map.viewportHeight());
+        viewport.adjust(-strokeWidth, -strokeWidth, strokeWidth, strokeWidth);
+        viewport.translate(-1 * screenOrigin);
+
+        QVector<qreal> clippedPoints;
+        QVector<QPainterPath::ElementType> clippedTypes;
+        clipPathToRect(tailPoints, tailTypes, viewport, clippedPoints, clippedTypes);
+        tailPoints = clippedPoints;
+        tailTypes = clippedTypes;
+    }
+
+    // The screen vertices are relative to the top left of the source bounds
+    if (bounds.topLeft() != sourceBounds_.topLeft())
+        translate(sourceBounds_.topLeft() - bounds.topLeft());
+    const QPointF offset = -1 * bounds.topLeft() + QPointF(strokeWidth, strokeWidth);
+    for (int i = 0; i < points.size(); i += 2)
+        srcPointTypes_ << QPainterPath::LineToElement;
+    srcPoints_ << points;
+    sourceBounds_ = bounds;
+    appendedPoints_ += points.size() / 2;
+    screenDirty_ = true;
+
+    if (tailTypes.size() < 2)
+        return true;
+
+    QVectorPath vp(tailPoints.data(), tailTypes.size(), tailTypes.data());
+    QTriangulatingStroker ts;
+    ts.process(vp, QPen(QBrush(Qt::black), strokeWidth), QRectF(), QPainter::Qt4CompatiblePainting);
+    if (ts.vertexCount() < 2)
+        return true;
+
+    // Join the two triangle strips with degenerate triangles
+    const float *vs = ts.vertices();
+    screenVertices_.reserve(screenVertices_.size() + ts.vertexCount() / 2 + 2);
+    screenVertices_ << screenVertices_.last();
+    screenVertices_ << QPointF(vs[0], vs[1]) + offset;
+    for (int i = 0; i < (ts.vertexCount()/2*2); i += 2) {
+        const QPointF pt = QPointF(vs[i], vs[i + 1]) + offset;
+        if (!qIsFinite(pt.x()) || !qIsFinite(pt.y()))
+            break;
+        screenVertices_ << pt;
+        screenBounds_.setLeft(qMin(pt.x(), screenBounds_.left()));
+        screenBounds_.setTop(qMin(pt.y(), screenBounds_.top()));
+        screenBounds_.setRight(qMax(pt.x(), screenBounds_.right()));
+        screenBounds_.setBottom(qMax(pt.y(), screenBounds_.bottom()));
+    }
+    return true;
+}
+
 void QGeoMapPolylineGeometry::clearSource()
 {
     srcPoints_.clear();
     srcPointTypes_.clear();
 }
 
-bool QGeoMapPolylineGeometry::contains(const QPointF &point) const
+static bool triangleStripContains(const QVector<QPointF> &verts, const QPointF &point)
 {
-    // screenOutline_.contains(screenPoint) doesn't work, as, it appears, that
-    // screenOutline_ for QGeoMapPolylineGeometry is empty (QRectF(0,0 0x0))
-    const QVector<QPointF> &verts = vertices();
     QPolygonF tri;
     for (int i = 0; i < verts.size(); ++i) {
         tri << verts[i];
@@ -747,8 +882,144 @@ bool QGeoMapPolylineGeometry::contains(const QPointF &point) const
     return false;
 }
 
+bool QGeoMapPolylineGeometry::contains(const QPointF &point) const
+{
+    // screenOutline_.contains(screenPoint) doesn't work, as, it appears, that
+    // screenOutline_ for QGeoMapPolylineGeometry is empty (QRectF(0,0 0x0))
+    return triangleStripContains(vertices(), point);
+}
+
+// Beyond this size, in pixels, single precision vertices lose sub-pixel accuracy
+static const double kMaxMercatorGeometryExtent = 4194304.0; // 2^22
+
+QGeoMapPolylineMercatorGeometry::QGeoMapPolylineMercatorGeometry()
+    : zoomBucket_(-1), strokeWidth_(0), sideLength_(0)
+{
+}
+
+/*!
+    \internal
+*/
+bool QGeoMapPolylineMercatorGeometry::updateGeometry(const QGeoMap &map,
+                                                     const QList<QDoubleVector2D> &path,
+                                                     const QGeoCoordinate &geoLeftBound,
+                                                     qreal strokeWidth)
+{
+    // A tilted camera needs the path to be clipped against the projectable region,
+    // which depends on the camera.
+    if (map.cameraData().tilt() != 0.0 || path.size() < 2)
+        return false;
+
+    const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map.geoProjection());
+    const double zoomLevel = map.cameraData().zoomLevel();
+    const int zoomBucket = int(std::floor(zoomLevel));
+    if (!sourceDirty_ && zoomBucket == zoomBucket_ && strokeWidth == strokeWidth_)
+        return !screenVertices_.isEmpty();
+
+    const double sideLength = p.mapWidth() * std::pow(2.0, zoomBucket - zoomLevel);
+
+    // Same unwrapping as QGeoMapPolylineGeometry::clipPath(): the path extends eastwards
+    // from its left bound.
+    const double leftBoundX = p.geoToMapProjection(geoLeftBound).x();
+    double minY = qInf();
+    for (const QDoubleVector2D &coord : path)
+        minY = qMin(minY, coord.y());
+    const QDoubleVector2D origin(leftBoundX, minY);
+
+    QVector<qreal> points;
+    QVector<QPainterPath::ElementType> types;
+    points.reserve(path.size() * 2);
+    types.reserve(path.size());
+
+    double minX = qInf();
+    double minPointY = qInf();
+    double maxX = -qInf();
+    double maxY = -qInf();
+    QDoubleVector2D lastAddedPoint;
+    for (int i = 0; i < path.size(); ++i) {
+        QDoubleVector2D coord = path.at(i);
+        if (coord.x() < leftBoundX)
+            coord.setX(coord.x() + 1.0);
+        const QDoubleVector2D point = (coord - origin) * sideLength;
+        if (!qIsFinite(point.x()) || !qIsFinite(point.y()))
+            return false;
+
+        // Within the zoom level the geometry is magnified up to twice, hence half the
+        // screen space threshold of QGeoMapPolylineGeometry::pathToScreen()
+        if (i > 0 && (point - lastAddedPoint).manhattanLength() <= 1.5 && i < path.size() - 1)
+            continue;
+
+        points << point.x() << point.y();
+        types << (i == 0 ? QPainterPath::MoveToElement : QPainterPath::LineToElement);
+        lastAddedPoint = point;
+        minX = qMin(minX, point.x());
+        minPointY = qMin(minPointY, point.y());
+        maxX = qMax(maxX, point.x());
+        maxY = qMax(maxY, point.y());
+    }
+
+    const QRectF bounds(QPointF(minX, minPointY), QPointF(maxX, maxY));
+    if (bounds.width() > kMaxMercatorGeometryExtent || bounds.height() > kMaxMercatorGeometryExtent)
+        return false;
+
+    // The width is exact in the middle of the zoom level, and scales by up to sqrt(2) either side.
+    const qreal width = strokeWidth * M_SQRT1_2;
+    QVectorPath vp(points.data(), types.size(), types.data());
+    QTriangulatingStroker ts;
+    ts.process(vp, QPen(QBrush(Qt::black), width), QRectF(), QPainter::Qt4CompatiblePainting);
+
+    clear();
+    screenVertices_.reserve(ts.vertexCount() / 2);
+    const float *vs = ts.vertices();
+    for (int i = 0; i < (ts.vertexCount()/2*2); i += 2)
+        screenVertices_ << QPointF(vs[i], vs[i + 1]);
+
+    zoomBucket_ = zoomBucket;
+    strokeWidth_ = strokeWidth;
+    sideLength_ = sideLength;
+    mercatorOrigin_ = origin;
+    sourceBounds_ = bounds;
+    screenBounds_ = bounds.adjusted(-width, -width, width, width);
+    srcOrigin_ = p.mapProjectionToGeo(origin);
+    sourceDirty_ = false;
+    screenDirty_ = true;
+    return !screenVertices_.isEmpty();
+}
+
+/*!
+    \internal
+
+    Returns the transformation from the geometry to the item position on \a map.
+*/
+QTransform QGeoMapPolylineMercatorGeometry::transform(const QGeoMap &map) const
+{
+    const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map.geoProjection());
+
+    // Use the copy of the path that is closest to the camera
+    QDoubleVector2D origin = mercatorOrigin_;
+    const double centerX = p.geoToMapProjection(map.cameraData().center()).x();
+    const double pathCenterX = origin.x() + sourceBounds_.center().x() / sideLength_;
+    origin.setX(origin.x() + std::round(centerX - pathCenterX));
+
+    // Without tilt the camera is an affine transformation. Derive it from the projection
+    // of three points, a large step keeps it accurate at high zoom levels.
+    const double step = 1024.0;
+    const QDoubleVector2D o = p.wrappedMapProjectionToItemPosition(origin);
+    const QDoubleVector2D dx = (p.wrappedMapProjectionToItemPosition(
+                                    origin + QDoubleVector2D(step / sideLength_, 0.0)) - o) / step;
+    const QDoubleVector2D dy = (p.wrappedMapProjectionToItemPosition(
+                                    origin + QDoubleVector2D(0.0, step / sideLength_)) - o) / step;
+    return QTransform(dx.x(), dx.y(), dy.x(), dy.y(), o.x(), o.y());
+}
+
+bool QGeoMapPolylineMercatorGeometry::contains(const QPointF &point) const
+{
+    return triangleStripContains(vertices(), point);
+}
+
 QDeclarativePolylineMapItem::QDeclarativePolylineMapItem(QQuickItem *parent)
-:   QDeclarativeGeoMapItemBase(parent), line_(this), dirtyMaterial_(true), updatingGeometry_(false)
+:   QDeclarativeGeoMapItemBase(parent), appendedCoordinates_(0), line_(this), dirtyMaterial_(true), updatingGeometry_(false),
+    backend_(Software), transformed_(false)
 {
     m_itemType = QGeoMap::MapPolyline;
     geopath_ = QGeoPathEager();
@@ -770,9 +1041,24 @@ void QDeclarativePolylineMapItem::updateAfterLinePropertiesChanged()
 {
     // mark dirty just in case we're a width change
     geometry_.markSourceDirty();
+    dirtyMaterial_ = true;
     polishAndUpdate();
 }
 
+QDeclarativePolylineMapItem::Backend QDeclarativePolylineMapItem::backend() const
+{
+    return backend_;
+}
+
+void QDeclarativePolylineMapItem::setBackend(Backend backend)
+{
+    if (backend == backend_)
+        return;
+    backend_ = backend;
+    markSourceDirtyAndUpdate();
+    emit backendChanged();
+}
+
 /*!
     \internal
 */
@@ -781,8 +1067,7 @@ void QDeclarativePolylineMapItem::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *
     QDeclarativeGeoMapItemBase::setMap(quickMap,map);
     if (map) {
         regenerateCache();
-        geometry_.markSourceDirty();
-        polishAndUpdate();
+        markSourceDirtyAndUpdate();
     }
 }
 
@@ -871,9 +1156,19 @@ void QDeclarativePolylineMapItem::addCoordinate(const QGeoCoordinate &coordinate
 
     geopath_.addCoordinate(coordinate);
 
+    // In an untilted map the origin of the geometry is its westernmost point: the new
+    // coordinate can be appended to it unless it moves that origin.
+    const QGeoCoordinate geoLeftBound = geopath_.boundingGeoRectangle().topLeft();
+    const bool appendable = !transformed_ && geometry_.geoLeftBound().longitude() == geoLeftBound.longitude();
     updateCache();
-    geometry_.setPreserveGeometry(true, geopath_.boundingGeoRectangle().topLeft());
-    markSourceDirtyAndUpdate();
+    geometry_.setPreserveGeometry(true, geoLeftBound);
+    if (appendable) {
+        ++appendedCoordinates_;
+        mercatorGeometry_.markSourceDirty();
+        polishAndUpdate();
+    } else {
+        markSourceDirtyAndUpdate();
+    }
     emit pathChanged();
 }
 
@@ -1054,7 +1349,9 @@ void QDeclarativePolylineMapItem::afterViewportChanged(const QGeoMapViewportChan
         return;
 
     geometry_.setPreserveGeometry(true, geometry_.geoLeftBound());
-    markSourceDirtyAndUpdate();
+    // The transformed geometry only depends on the zoom level, see updatePolish()
+    geometry_.markSourceDirty();
+    polishAndUpdate();
 }
 
 /*!
@@ -1069,6 +1366,7 @@ void QDeclarativePolylineMapItem::regenerateCache()
     geopathProjected_.reserve(geopath_.path().size());
     for (const QGeoCoordinate &c : geopath_.path())
         geopathProjected_ << p.geoToMapProjection(c);
+    simplifiedPath_.clear();
 }
 
 /*!
@@ -1080,17 +1378,71 @@ void QDeclarativePolylineMapItem::updateCache()
         return;
     const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map()->geoProjection());
     geopathProjected_ << p.geoToMapProjection(geopath_.path().last());
+    if (!simplifiedPath_.isEmpty())
+        simplifiedPath_.append(geopathProjected_.last());
 }
 
 /*!
     \internal
 */
-void QDeclarativePolylineMapItem::updatePolish()
+bool QDeclarativePolylineMapItem::computeGeometry()
 {
     if (!map() || map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
-        return;
+        return false;
     if (geopath_.path().length() == 0) { // Possibly cleared
+        transformed_ = false;
         geometry_.clear();
+        return true;
+    }
+
+    // Coordinates appended with addCoordinate() extend the current geometry, if it is up to
+    // date. They are kept at the end of every simplified path until the next full update.
+    int appended = appendedCoordinates_;
+    appendedCoordinates_ = 0;
+    if (simplifiedPath_.isEmpty()
+            || (simplifiedPath_.appendedCount() && (!appended || geometry_.isSourceDirty() || backend_ == Transformed))) {
+        simplifiedPath_.setPath(geopathProjected_);
+        if (appended) {
+            geometry_.markSourceDirty();
+            appended = 0;
+        }
+    }
+
+    const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map()->geoProjection());
+    const double zoomLevel = map()->cameraData().zoomLevel();
+    const QList<QDoubleVector2D> &path = simplifiedPath_.path(zoomLevel, p.mapWidth());
+
+    transformed_ = backend_ == Transformed
+            && mercatorGeometry_.updateGeometry(*map(), path,
+                                                geopath_.boundingGeoRectangle().topLeft(), line_.width());
+    if (transformed_) {
+        mercatorTransform_ = mercatorGeometry_.transform(*map());
+        return true;
+    }
+
+    if (!appended) {
+        geometry_.updateSourcePoints(*map(), path, geopath_.boundingGeoRectangle().topLeft());
+        geometry_.updateScreenPoints(*map(), line_.width());
+    } else if (!geometry_.appendPoints(*map(), path, appended, line_.width())) {
+        // Simplify the appended coordinates as well
+        if (simplifiedPath_.appendedCount())
+            simplifiedPath_.setPath(geopathProjected_);
+        geometry_.markSourceDirty();
+        geometry_.updateSourcePoints(*map(), simplifiedPath_.path(zoomLevel, p.mapWidth()),
+                                     geopath_.boundingGeoRectangle().topLeft());
+        geometry_.updateScreenPoints(*map(), line_.width());
+    }
+    return true;
+}
+
+/*!
+    \internal
+*/
+void QDeclarativePolylineMapItem::updatePolish()
+{
+    if (!takePrecomputedGeometry() && !computeGeometry())
+        return;
+    if (geopath_.path().length() == 0) { // Possibly cleared
         setWidth(0);
         setHeight(0);
         return;
@@ -1099,8 +1451,13 @@ void QDeclarativePolylineMapItem::updatePolish()
     QScopedValueRollback<bool> rollback(updatingGeometry_);
     updatingGeometry_ = true;
 
-    geometry_.updateSourcePoints(*map(), geopathProjected_, geopath_.boundingGeoRectangle().topLeft());
-    geometry_.updateScreenPoints(*map(), line_.width());
+    if (transformed_) {
+        // The item covers the map, and the camera is applied by the transform node
+        setWidth(map()->viewportWidth());
+        setHeight(map()->viewportHeight());
+        setPosition(QPointF(0, 0));
+        return;
+    }
 
     setWidth(geometry_.sourceBoundingBox().width() + 2 * line_.width());
     setHeight(geometry_.sourceBoundingBox().height() + 2 * line_.width());
@@ -1111,6 +1468,7 @@ void QDeclarativePolylineMapItem::updatePolish()
 void QDeclarativePolylineMapItem::markSourceDirtyAndUpdate()
 {
     geometry_.markSourceDirty();
+    mercatorGeometry_.markSourceDirty();
     polishAndUpdate();
 }
 
@@ -1121,6 +1479,31 @@ QSGNode *QDeclarativePolylineMapItem::updateMapItemPaintNode(QSGNode *oldNode, U
 {
     Q_UNUSED(data);
 
+    if (transformed_) {
+        QSGTransformNode *transformNode = nullptr;
+        if (oldNode && oldNode->type() == QSGNode::TransformNodeType) {
+            transformNode = static_cast<QSGTransformNode *>(oldNode);
+        } else {
+            delete oldNode;
+            transformNode = new QSGTransformNode();
+            transformNode->appendChildNode(new MapPolylineNode());
+            dirtyMaterial_ = true;
+        }
+
+        MapPolylineNode *node = static_cast<MapPolylineNode *>(transformNode->firstChild());
+        if (mercatorGeometry_.isScreenDirty() || dirtyMaterial_) {
+            node->update(line_.color(), &mercatorGeometry_);
+            mercatorGeometry_.markClean();
+            dirtyMaterial_ = false;
+        }
+        transformNode->setMatrix(QMatrix4x4(mercatorTransform_));
+        return transformNode;
+    }
+
+    if (oldNode && oldNode->type() != QSGNode::GeometryNodeType) {
+        delete oldNode;
+        oldNode = nullptr;
+    }
     MapPolylineNode *node = static_cast<MapPolylineNode *>(oldNode);
 
     if (!node) {
@@ -1137,8 +1520,26 @@ QSGNode *QDeclarativePolylineMapItem::updateMapItemPaintNode(QSGNode *oldNode, U
     return node;
 }
 
+/*!
+    \internal
+*/
+bool QDeclarativePolylineMapItem::updateBatchedGeometry(QDeclarativeGeoMapItemBatcher *batcher)
+{
+    if (transformed_)
+        return false;
+
+    batcher->setGeometry(this, QDeclarativeGeoMapItemBatcher::BorderLayer, line_.color(), geometry_,
+                         QSGGeometry::DrawTriangleStrip, mapToItem(quickMap(), QPointF()));
+    geometry_.setPreserveGeometry(false);
+    geometry_.markClean();
+    dirtyMaterial_ = true; // a paint node created after unbatching must be filled
+    return true;
+}
+
 bool QDeclarativePolylineMapItem::contains(const QPointF &point) const
 {
+    if (transformed_)
+        return mercatorGeometry_.contains(mercatorTransform_.inverted().map(point));
     return geometry_.contains(point);
 }
 
@@ -51,11 +51,13 @@
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/private/qdeclarativegeomapitembase_p.h>
 #include <QtLocation/private/qgeomapitemgeometry_p.h>
+#include <QtLocation/private/qgeopathlevelofdetail_p.h>
 
 #include <QtPositioning/QGeoPath>
 #include <QtPositioning/private/qdoublevector2d_p.h>
 #include <QSGGeometryNode>
 #include <QSGFlatColorMaterial>
+#include <QTransform>
 
 QT_BEGIN_NAMESPACE
 
@@ -99,6 +101,11 @@ public:
                             qreal strokeWidth,
                             bool adjustTranslation = true);
 
+    bool appendPoints(const QGeoMap &map,
+                      const QList<QDoubleVector2D> &path,
+                      int count,
+                      qreal strokeWidth);
+
     void clearSource();
 
     bool contains(const QPointF &point) const override;
@@ -114,6 +121,8 @@ public:
 public:
     QVector<qreal> srcPoints_;
     QVector<QPainterPath::ElementType> srcPointTypes_;
+    QDoubleVector2D srcLeftBoundWrapped_;
+    int appendedPoints_ = 0; // source points added by appendPoints() since updateSourcePoints()
 
 #ifdef QT_LOCATION_DEBUG
     QList<QDoubleVector2D> m_wrappedPath;
@@ -125,14 +134,51 @@ public:
     friend class QDeclarativeRectangleMapItem;
 };
 
+/*
+    Polyline stroked once per integer zoom level, in the pixel space of that zoom level and
+    relative to the top left of the path in mercator space. The camera is applied afterwards
+    with transform(), so panning, rotating and zooming within the same integer zoom level
+    do not require a new tessellation.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapPolylineMercatorGeometry : public QGeoMapItemGeometry
+{
+public:
+    QGeoMapPolylineMercatorGeometry();
+
+    // Returns false if the map cannot be drawn with a 2D transformation of the geometry,
+    // i.e. when it is tilted, or when the geometry is too large for single precision.
+    bool updateGeometry(const QGeoMap &map,
+                        const QList<QDoubleVector2D> &path,
+                        const QGeoCoordinate &geoLeftBound,
+                        qreal strokeWidth);
+
+    QTransform transform(const QGeoMap &map) const;
+    inline int zoomBucket() const { return zoomBucket_; }
+
+    bool contains(const QPointF &point) const override;
+
+private:
+    int zoomBucket_;
+    qreal strokeWidth_;
+    double sideLength_; // map width at zoomBucket_
+    QDoubleVector2D mercatorOrigin_;
+};
+
 class Q_LOCATION_PRIVATE_EXPORT QDeclarativePolylineMapItem : public QDeclarativeGeoMapItemBase
 {
     Q_OBJECT
 
     Q_PROPERTY(QJSValue path READ path WRITE setPath NOTIFY pathChanged)
     Q_PROPERTY(QDeclarativeMapLineProperties *line READ line CONSTANT)
+    Q_PROPERTY(Backend backend READ backend WRITE setBackend NOTIFY backendChanged REVISION 15)
 
 public:
+    enum Backend {
+        Software = 0,
+        Transformed = 1
+    };
+    Q_ENUM(Backend)
+
     explicit QDeclarativePolylineMapItem(QQuickItem *parent = 0);
     ~QDeclarativePolylineMapItem();
 
@@ -159,13 +205,19 @@ public:
 
     QDeclarativeMapLineProperties *line();
 
+    Backend backend() const;
+    void setBackend(Backend backend);
+
 Q_SIGNALS:
     void pathChanged();
+    Q_REVISION(15) void backendChanged();
 
 protected:
     void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
     void setPathFromGeoList(const QList<QGeoCoordinate> &path);
     void updatePolish() override;
+    bool updateBatchedGeometry(QDeclarativeGeoMapItemBatcher *batcher) override;
+    bool computeGeometry() override;
 
 protected Q_SLOTS:
     void markSourceDirtyAndUpdate();
@@ -181,11 +233,20 @@ public:
 #endif
     QGeoPath geopath_;
     QList<QDoubleVector2D> geopathProjected_;
+    QGeoPathLevelOfDetail simplifiedPath_; // ranked lazily, on the first polish after a change
+    int appendedCoordinates_; // added by addCoordinate() since the last polish, see updatePolish()
     QDeclarativeMapLineProperties line_;
     QColor color_;
     bool dirtyMaterial_;
     QGeoMapPolylineGeometry geometry_;
     bool updatingGeometry_;
+
+    Backend backend_;
+    QGeoMapPolylineMercatorGeometry mercatorGeometry_;
+    QTransform mercatorTransform_;
+    bool transformed_; // the last polish used mercatorGeometry_
+
+    friend class QDeclarativeGeoMap;
 };
 
 //////////////////////////////////////////////////////////////////////
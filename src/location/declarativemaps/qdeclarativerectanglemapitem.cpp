@@ -283,23 +283,36 @@ QSGNode *QDeclarativeRectangleMapItem::updateMapItemPaintNode(QSGNode *oldNode,
 /*!
     \internal
 */
-void QDeclarativeRectangleMapItem::updatePolish()
+bool QDeclarativeRectangleMapItem::updateBatchedGeometry(QDeclarativeGeoMapItemBatcher *batcher)
+{
+    const QPointF offset = mapToItem(quickMap(), QPointF());
+    batcher->setGeometry(this, QDeclarativeGeoMapItemBatcher::FillLayer, color_, geometry_,
+                         QSGGeometry::DrawTriangles, offset);
+    batcher->setGeometry(this, QDeclarativeGeoMapItemBatcher::BorderLayer, border_.color(),
+                         borderGeometry_, QSGGeometry::DrawTriangleStrip, offset);
+    geometry_.setPreserveGeometry(false);
+    borderGeometry_.setPreserveGeometry(false);
+    geometry_.markClean();
+    borderGeometry_.markClean();
+    dirtyMaterial_ = true; // a paint node created after unbatching must be filled
+    return true;
+}
+
+/*!
+    \internal
+*/
+bool QDeclarativeRectangleMapItem::computeGeometry()
 {
     if (!map() || map()->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
-        return;
+        return false;
     if (!topLeft().isValid() || !bottomRight().isValid()) {
         geometry_.clear();
         borderGeometry_.clear();
-        setWidth(0);
-        setHeight(0);
-        return;
+        return true;
     }
 
     const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator&>(map()->geoProjection());
 
-    QScopedValueRollback<bool> rollback(updatingGeometry_);
-    updatingGeometry_ = true;
-
     geometry_.setPreserveGeometry(true, rectangle_.topLeft());
     geometry_.updateSourcePoints(*map(), pathMercator_);
     geometry_.updateScreenPoints(*map(), border_.width());
@@ -331,9 +344,28 @@ void QDeclarativeRectangleMapItem::updatePolish()
         }
     }
 
-    QRectF combined = QGeoMapItemGeometry::translateToCommonOrigin(geoms);
-    setWidth(combined.width()  + 2 * border_.width());
-    setHeight(combined.height()  + 2 * border_.width());
+    geometryBounds_ = QGeoMapItemGeometry::translateToCommonOrigin(geoms);
+    return true;
+}
+
+/*!
+    \internal
+*/
+void QDeclarativeRectangleMapItem::updatePolish()
+{
+    if (!takePrecomputedGeometry() && !computeGeometry())
+        return;
+    if (!topLeft().isValid() || !bottomRight().isValid()) {
+        setWidth(0);
+        setHeight(0);
+        return;
+    }
+
+    QScopedValueRollback<bool> rollback(updatingGeometry_);
+    updatingGeometry_ = true;
+
+    setWidth(geometryBounds_.width()  + 2 * border_.width());
+    setHeight(geometryBounds_.height()  + 2 * border_.width());
 
     setPositionOnMap(geometry_.origin(), geometry_.firstPointOffset());
 }
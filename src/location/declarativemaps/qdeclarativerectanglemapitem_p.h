@@ -101,6 +101,8 @@ protected:
     void updatePath();
     void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
     void updatePolish() override;
+    bool computeGeometry() override;
+    bool updateBatchedGeometry(QDeclarativeGeoMapItemBatcher *batcher) override;
 
 protected Q_SLOTS:
     void markSourceDirtyAndUpdate();
@@ -113,6 +115,7 @@ private:
     bool dirtyMaterial_;
     QGeoMapPolygonGeometry geometry_;
     QGeoMapPolylineGeometry borderGeometry_;
+    QRectF geometryBounds_; // of fill and border, in the common origin
     bool updatingGeometry_;
     QList<QDoubleVector2D> pathMercator_;
 };
@@ -0,0 +1,216 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeopathlevelofdetail_p.h"
+
+#include <QtCore/qnumeric.h>
+
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+// Vertices deviating less than this, in pixels, are dropped
+static const double kPixelTolerance = 0.5;
+
+static double segmentDistance(const QDoubleVector2D &p, const QDoubleVector2D &a, const QDoubleVector2D &b)
+{
+    const QDoubleVector2D ab = b - a;
+    const double lengthSquared = ab.lengthSquared();
+    double t = 0.0;
+    if (lengthSquared > 0.0)
+        t = qBound(0.0, QDoubleVector2D::dotProduct(p - a, ab) / lengthSquared, 1.0);
+    return (a + ab * t - p).length();
+}
+
+namespace {
+struct VertexRange
+{
+    int first;
+    int last;
+    double tolerance; // of the vertex that split the parent range
+};
+}
+
+/*
+    Douglas-Peucker, recording for each vertex the tolerance at which it stops being kept.
+    A vertex never outlives the vertex that split its parent range, so that the vertices
+    kept at any tolerance are those that the plain algorithm would keep.
+*/
+static void rankVertices(const QVector<QDoubleVector2D> &points, QVector<double> &tolerances,
+                         bool keepFirstSplit)
+{
+    QVector<VertexRange> stack;
+    stack.append({0, points.size() - 1, qInf()});
+    while (!stack.isEmpty()) {
+        const VertexRange range = stack.takeLast();
+        if (range.last - range.first < 2)
+            continue;
+
+        int split = range.first + 1;
+        double maxDistance = -1.0;
+        const QDoubleVector2D &a = points.at(range.first);
+        const QDoubleVector2D &b = points.at(range.last);
+        for (int i = range.first + 1; i < range.last; ++i) {
+            const double distance = segmentDistance(points.at(i), a, b);
+            if (distance > maxDistance) {
+                maxDistance = distance;
+                split = i;
+            }
+        }
+
+        double tolerance = qMin(maxDistance, range.tolerance);
+        if (keepFirstSplit) {
+            // closed paths keep at least three vertices
+            tolerance = qInf();
+            keepFirstSplit = false;
+        }
+        tolerances[split] = tolerance;
+        stack.append({range.first, split, tolerance});
+        stack.append({split, range.last, tolerance});
+    }
+}
+
+QGeoPathLevelOfDetail::QGeoPathLevelOfDetail()
+{
+}
+
+/*!
+    \internal
+
+    Ranks the vertices of \a path, a list of mercator coordinates.
+*/
+void QGeoPathLevelOfDetail::setPath(const QList<QDoubleVector2D> &path, bool closed)
+{
+    clear();
+    path_ = path;
+    const int size = path_.size();
+    if (!size)
+        return;
+
+    // Measure the distances along the shortest way across the antimeridian
+    QVector<QDoubleVector2D> unwrapped;
+    unwrapped.reserve(size);
+    unwrapped.append(path_.first());
+    for (int i = 1; i < size; ++i) {
+        QDoubleVector2D point = path_.at(i);
+        const double dx = point.x() - unwrapped.last().x();
+        if (dx > 0.5)
+            point.setX(point.x() - 1.0);
+        else if (dx < -0.5)
+            point.setX(point.x() + 1.0);
+        unwrapped.append(point);
+    }
+
+    tolerances_.fill(0.0, size);
+    tolerances_[0] = qInf();
+    tolerances_[size - 1] = qInf();
+    rankVertices(unwrapped, tolerances_, closed);
+    rankedCount_ = size;
+}
+
+/*!
+    \internal
+
+    Appends \a point to the end of the path, and to the levels already built, in constant
+    time. The point is not ranked: call setPath() once the appended vertices outnumber the
+    others, to simplify them too.
+*/
+void QGeoPathLevelOfDetail::append(const QDoubleVector2D &point)
+{
+    path_.append(point);
+    tolerances_.append(qInf());
+    for (int i = 0; i < levelsBuilt_.size(); ++i) {
+        if (levelsBuilt_.at(i))
+            levels_[i].append(point);
+    }
+}
+
+void QGeoPathLevelOfDetail::clear()
+{
+    path_.clear();
+    tolerances_.clear();
+    rankedCount_ = 0;
+    levels_.clear();
+    levelsBuilt_.clear();
+}
+
+/*!
+    \internal
+
+    Returns the integer zoom level whose simplification is used at \a zoomLevel. It is
+    the next one, so that the simplification also holds when the geometry of a zoom
+    level is magnified.
+*/
+int QGeoPathLevelOfDetail::level(double zoomLevel)
+{
+    return qBound(0, int(std::floor(zoomLevel)) + 1, int(MaxLevel));
+}
+
+/*!
+    \internal
+
+    Returns the path simplified for \a zoomLevel, where the map is \a mapWidth pixels wide.
+*/
+const QList<QDoubleVector2D> &QGeoPathLevelOfDetail::path(double zoomLevel, double mapWidth)
+{
+    const int lvl = level(zoomLevel);
+    if (levelsBuilt_.isEmpty()) {
+        levels_.resize(MaxLevel + 1);
+        levelsBuilt_.fill(false, MaxLevel + 1);
+    }
+    if (levelsBuilt_.at(lvl))
+        return levels_.at(lvl);
+
+    const double levelWidth = mapWidth * std::pow(2.0, lvl - zoomLevel);
+    const double tolerance = kPixelTolerance / levelWidth;
+
+    // A single walk, in path order. Appended vertices have an infinite tolerance.
+    QList<QDoubleVector2D> &simplified = levels_[lvl];
+    simplified.clear();
+    for (int i = 0; i < path_.size(); ++i) {
+        if (tolerances_.at(i) >= tolerance)
+            simplified.append(path_.at(i));
+    }
+    if (simplified.size() == path_.size())
+        simplified = path_; // shares the data
+    levelsBuilt_[lvl] = true;
+    return simplified;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOPATHLEVELOFDETAIL_P_H
+#define QGEOPATHLEVELOFDETAIL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+
+#include <QList>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Multi-resolution simplification of a path in mercator space.
+
+    setPath() ranks every vertex once with the Douglas-Peucker algorithm: the rank is
+    the largest tolerance at which the vertex is kept. path() then returns, for each
+    integer zoom level, the vertices that deviate from the path by more than a fraction
+    of a pixel. Each level is built in one walk over the path, and cached until the path
+    changes.
+    Vertices added with append() are not ranked, and are kept at every level.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoPathLevelOfDetail
+{
+public:
+    enum { MaxLevel = 30 };
+
+    QGeoPathLevelOfDetail();
+
+    void setPath(const QList<QDoubleVector2D> &path, bool closed = false);
+    void append(const QDoubleVector2D &point);
+    void clear();
+    inline bool isEmpty() const { return path_.isEmpty(); }
+    inline int appendedCount() const { return path_.size() - rankedCount_; }
+
+    // mapWidth is the size of the map at zoomLevel, in pixels
+    const QList<QDoubleVector2D> &path(double zoomLevel, double mapWidth);
+    static int level(double zoomLevel);
+
+    inline double tolerance(int index) const { return tolerances_.at(index); }
+
+private:
+    QList<QDoubleVector2D> path_;
+    QVector<double> tolerances_; // in mercator units, per vertex
+    int rankedCount_ = 0;        // vertices ranked by setPath(), the others were appended
+    QVector<QList<QDoubleVector2D> > levels_;
+    QVector<bool> levelsBuilt_;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOPATHLEVELOFDETAIL_P_H
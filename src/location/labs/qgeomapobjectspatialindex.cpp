@@ -0,0 +1,234 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeomapobjectspatialindex_p.h"
+
+#include <QtPositioning/QGeoRectangle>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+
+#include <algorithm>
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+static inline quint64 cellKey(qint64 x, qint64 y)
+{
+    return (quint64(quint32(x)) << 32) | quint32(y);
+}
+
+static inline bool overlaps(const QRectF &a, const QRectF &b)
+{
+    // QRectF::intersects() is false for empty rectangles, such as points
+    return a.left() <= b.right() && b.left() <= a.right()
+            && a.top() <= b.bottom() && b.top() <= a.bottom();
+}
+
+QGeoMapObjectSpatialIndex::QGeoMapObjectSpatialIndex()
+    : cells_(MaxDepth + 1)
+{
+}
+
+/*
+    Returns the bounding box of \a shape in map projection coordinates. The box of a shape
+    crossing the antimeridian starts in [0, 1] and ends beyond 1.
+*/
+QRectF QGeoMapObjectSpatialIndex::mapProjectionBounds(const QGeoShape &shape)
+{
+    const QGeoRectangle box = shape.boundingGeoRectangle();
+    if (!box.isValid())
+        return QRectF();
+
+    const QDoubleVector2D topLeft = QWebMercator::coordToMercator(box.topLeft());
+    const QDoubleVector2D bottomRight = QWebMercator::coordToMercator(box.bottomRight());
+    double right = bottomRight.x();
+    if (right < topLeft.x())
+        right += 1.0;
+    return QRectF(QPointF(topLeft.x(), topLeft.y()), QPointF(right, bottomRight.y()));
+}
+
+void QGeoMapObjectSpatialIndex::insert(QGeoMapObject *object, const QGeoShape &shape)
+{
+    insert(object, mapProjectionBounds(shape));
+}
+
+/*
+    Inserts \a object with \a bounds, or moves it if it is already indexed. Objects without
+    valid bounds are removed.
+*/
+void QGeoMapObjectSpatialIndex::insert(QGeoMapObject *object, const QRectF &bounds)
+{
+    if (!qIsFinite(bounds.left()) || !qIsFinite(bounds.top())
+            || !qIsFinite(bounds.right()) || !qIsFinite(bounds.bottom())
+            || bounds.width() < 0 || bounds.height() < 0) {
+        remove(object);
+        return;
+    }
+
+    const double size = qMax(bounds.width(), bounds.height());
+    int depth = MaxDepth;
+    if (size >= 1.0)
+        depth = 0;
+    else if (size > 0.0)
+        depth = qMin(int(MaxDepth), int(std::floor(-std::log2(size))));
+
+    const double n = std::ldexp(1.0, depth);
+    const QPointF center = bounds.center();
+    const quint64 cell = cellKey(qint64(std::floor(center.x() * n)), qint64(std::floor(center.y() * n)));
+
+    auto it = entries_.find(object);
+    if (it != entries_.end()) {
+        if (it->depth == depth && it->cell == cell) {
+            it->bounds = bounds;
+            return;
+        }
+        QHash<quint64, QVector<QGeoMapObject *> > &level = cells_[it->depth];
+        const auto old = level.find(it->cell);
+        old->removeOne(object);
+        if (old->isEmpty())
+            level.erase(old);
+    } else {
+        it = entries_.insert(object, Entry{QRectF(), 0, 0, nextOrder_++});
+    }
+
+    it->bounds = bounds;
+    it->depth = depth;
+    it->cell = cell;
+    cells_[depth][cell].append(object);
+}
+
+void QGeoMapObjectSpatialIndex::remove(QGeoMapObject *object)
+{
+    const auto it = entries_.find(object);
+    if (it == entries_.end())
+        return;
+
+    QHash<quint64, QVector<QGeoMapObject *> > &level = cells_[it->depth];
+    const auto cell = level.find(it->cell);
+    cell->removeOne(object);
+    if (cell->isEmpty())
+        level.erase(cell);
+    entries_.erase(it);
+}
+
+void QGeoMapObjectSpatialIndex::clear()
+{
+    entries_.clear();
+    for (auto &level : cells_)
+        level.clear();
+}
+
+bool QGeoMapObjectSpatialIndex::contains(QGeoMapObject *object) const
+{
+    return entries_.contains(object);
+}
+
+int QGeoMapObjectSpatialIndex::size() const
+{
+    return entries_.size();
+}
+
+/*
+    Returns the objects whose bounding box intersects \a rect, in map projection
+    coordinates. Rectangles extending beyond [0, 1] horizontally wrap around.
+*/
+QList<QGeoMapObject *> QGeoMapObjectSpatialIndex::intersecting(const QRectF &rect) const
+{
+    QVector<Match> matches;
+    collect(rect, matches);
+    collect(rect.translated(1.0, 0.0), matches);
+    collect(rect.translated(-1.0, 0.0), matches);
+
+    std::sort(matches.begin(), matches.end());
+    matches.erase(std::unique(matches.begin(), matches.end()), matches.end());
+
+    QList<QGeoMapObject *> res;
+    res.reserve(matches.size());
+    for (const Match &m : qAsConst(matches))
+        res.append(m.second);
+    return res;
+}
+
+void QGeoMapObjectSpatialIndex::collect(const QRectF &rect, QVector<Match> &matches) const
+{
+    if (rect.right() < -0.5 || rect.left() > 2.5)
+        return;
+
+    const auto visit = [&](const QVector<QGeoMapObject *> &objects) {
+        for (QGeoMapObject *object : objects) {
+            const Entry &e = entries_.find(object).value();
+            if (overlaps(e.bounds, rect))
+                matches.append(Match(e.order, object));
+        }
+    };
+
+    for (int depth = 0; depth <= MaxDepth; ++depth) {
+        const QHash<quint64, QVector<QGeoMapObject *> > &level = cells_.at(depth);
+        if (level.isEmpty())
+            continue;
+
+        // Cells are enlarged by half their size on each side
+        const double n = std::ldexp(1.0, depth);
+        const qint64 x0 = qMax(qint64(0), qint64(std::ceil(rect.left() * n - 1.5)));
+        const qint64 x1 = qMin(qint64(2 * n), qint64(std::floor(rect.right() * n + 0.5)));
+        const qint64 y0 = qMax(qint64(0), qint64(std::ceil(rect.top() * n - 1.5)));
+        const qint64 y1 = qMin(qint64(n), qint64(std::floor(rect.bottom() * n + 0.5)));
+        if (x1 < x0 || y1 < y0)
+            continue;
+
+        if ((x1 - x0 + 1) * (y1 - y0 + 1) <= level.size()) {
+            for (qint64 x = x0; x <= x1; ++x) {
+                for (qint64 y = y0; y <= y1; ++y) {
+                    const auto cell = level.constFind(cellKey(x, y));
+                    if (cell != level.constEnd())
+                        visit(cell.value());
+                }
+            }
+        } else {
+            for (auto cell = level.cbegin(); cell != level.cend(); ++cell) {
+                const qint64 x = qint64(cell.key() >> 32);
+                const qint64 y = qint64(cell.key() & 0xffffffff);
+                if (x >= x0 && x <= x1 && y >= y0 && y <= y1)
+                    visit(cell.value());
+            }
+        }
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,115 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOMAPOBJECTSPATIALINDEX_P_H
+#define QGEOMAPOBJECTSPATIALINDEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QRectF>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoShape;
+class QGeoMapObject;
+
+/*
+    Loose quadtree over the bounding boxes of map objects, in map projection coordinates
+    (web mercator, [0, 1] on both axes).
+
+    Every object is stored in a single cell: the one containing the center of its box, at
+    the deepest level whose cells are at least as large as the box. Cells are looked up
+    with their bounds enlarged by half a cell on each side, so that objects never have to
+    be split. Boxes crossing the antimeridian extend beyond x = 1.
+
+    Inserting, moving and removing an object are O(1). A query visits a few cells per
+    level, and returns the objects in the order they were first inserted.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapObjectSpatialIndex
+{
+public:
+    enum { MaxDepth = 24 };
+
+    QGeoMapObjectSpatialIndex();
+
+    void insert(QGeoMapObject *object, const QGeoShape &shape);
+    void insert(QGeoMapObject *object, const QRectF &bounds);
+    void remove(QGeoMapObject *object);
+    void clear();
+
+    bool contains(QGeoMapObject *object) const;
+    int size() const;
+
+    QList<QGeoMapObject *> intersecting(const QRectF &rect) const;
+
+    static QRectF mapProjectionBounds(const QGeoShape &shape);
+
+private:
+    struct Entry {
+        QRectF bounds;
+        int depth;
+        quint64 cell;
+        quint64 order;
+    };
+    typedef QPair<quint64, QGeoMapObject *> Match;
+
+    void collect(const QRectF &rect, QVector<Match> &matches) const;
+
+    QHash<QGeoMapObject *, Entry> entries_;
+    QVector<QHash<quint64, QVector<QGeoMapObject *> > > cells_; // per depth
+    quint64 nextOrder_ = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOMAPOBJECTSPATIALINDEX_P_H
@@ -100,30 +100,7 @@ void QGeoTiledMapLabsPrivate::removeMapObject(QGeoMapObject *obj)
 
 QList<QObject *> QGeoTiledMapLabsPrivate::mapObjectsAt(const QGeoCoordinate &coordinate) const
 {
-    // ToDo: use a space partitioning strategy
-    QList<QObject *> res;
-    for (const auto o: mapObjects()) {
-        // explicitly handle lines
-        bool contains = false;
-        if (o->type() == QGeoMapObject::PolylineType ) {
-            QMapPolylineObject *mpo = static_cast<QMapPolylineObject *>(o);
-            qreal mpp = QLocationUtils::metersPerPixel(m_cameraData.zoomLevel(), coordinate);
-            QGeoPath path = o->geoShape();
-            path.setWidth(mpp * mpo->border()->width());
-            contains = path.contains(coordinate);
-        } else if (o->type() == QGeoMapObject::RouteType) {
-            qreal mpp = QLocationUtils::metersPerPixel(m_cameraData.zoomLevel(), coordinate);
-            QGeoPath path = o->geoShape();
-            path.setWidth(mpp * 4); // MapRouteObjectQSG has a hardcoded 4 pixels width;
-            contains = path.contains(coordinate);
-        } else {
-            contains = o->geoShape().contains(coordinate);
-        }
-
-        if (contains)
-            res.append(o);
-    }
-    return res;
+    return m_qsgSupport.mapObjectsAt(coordinate, m_cameraData.zoomLevel());
 }
 
 void QGeoTiledMapLabsPrivate::updateMapObjects(QSGNode *root, QQuickWindow *window)
@@ -38,6 +38,8 @@
 #include "qmapobjectview_p_p.h"
 #include <private/qqmldelegatemodel_p.h>
 #include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeocameracapabilities_p.h>
+#include <QtQml/QQmlContext>
 
 QT_BEGIN_NAMESPACE
 
@@ -56,6 +58,10 @@ QT_BEGIN_NAMESPACE
     The MapObjectView type only makes sense when contained in a Map, meaning that it will not work when added inside
     other QML elements.
     This can also be intended as an object layer on top of a Map.
+
+    When \l clusterDelegate and \l clusterRole are set, the rows of the model are grouped
+    into clusters, for each zoom level, and the delegate is only instantiated for the rows
+    that stand alone in the viewport. See \l MapItemView for the details.
 */
 
 /*
@@ -192,6 +198,8 @@ QList<QGeoMapObject *> QMapObjectView::geoMapObjectChildren() const
         if (obj)
             kids << obj;
     }
+    for (const ClusterObject &cluster : m_clusterObjects)
+        kids << cluster.object;
     return kids;
 }
 
@@ -270,6 +278,83 @@ void QMapObjectView::setDelegate(QQmlComponent *delegate)
     emit delegateChanged(delegate);
 }
 
+/*!
+    \qmlproperty Component Qt.labs.location::MapObjectView::clusterDelegate
+
+    This property holds the delegate which defines how the clusters of rows are displayed,
+    when \l clusterRole is set as well. The Component must contain exactly one
+    QGeoMapObject -derived object as the root object, such as a MapIconObject. The delegate
+    can use the \c clusterCoordinate and \c clusterCount context properties.
+*/
+QQmlComponent *QMapObjectView::clusterDelegate() const
+{
+    return m_clusterDelegate;
+}
+
+void QMapObjectView::setClusterDelegate(QQmlComponent *delegate)
+{
+    if (m_clusterDelegate == delegate)
+        return;
+
+    const bool wasClustering = clustering();
+    removeClusters(0);
+    m_clusterDelegate = delegate;
+    if (clustering() != wasClustering)
+        restartClustering();
+    else
+        updateClusters();
+
+    emit clusterDelegateChanged(delegate);
+}
+
+/*!
+    \qmlproperty string Qt.labs.location::MapObjectView::clusterRole
+
+    This property holds the name of the role of the model holding the coordinate of each
+    row, by which the rows are clustered.
+*/
+QString QMapObjectView::clusterRole() const
+{
+    return m_clusterRole;
+}
+
+void QMapObjectView::setClusterRole(const QString &role)
+{
+    if (m_clusterRole == role)
+        return;
+
+    const bool wasClustering = clustering();
+    m_clusterRole = role;
+    invalidateClusterIndex();
+    if (clustering() || wasClustering)
+        restartClustering();
+
+    emit clusterRoleChanged(role);
+}
+
+/*!
+    \qmlproperty real Qt.labs.location::MapObjectView::clusterRadius
+
+    This property holds the distance, in pixels, within which rows are grouped into a
+    cluster. The default value is 60.
+*/
+qreal QMapObjectView::clusterRadius() const
+{
+    return m_clusterRadius;
+}
+
+void QMapObjectView::setClusterRadius(qreal radius)
+{
+    if (radius <= 0 || m_clusterRadius == radius)
+        return;
+
+    m_clusterRadius = radius;
+    invalidateClusterIndex();
+    updateClusters();
+
+    emit clusterRadiusChanged(radius);
+}
+
 /*!
     \qmlmethod void Qt.labs.location::MapObjectView::addMapObject(MapObject object)
 
@@ -315,6 +400,11 @@ void QMapObjectView::initItem(int /*index*/, QObject * /*object*/)
 
 void QMapObjectView::modelUpdated(const QQmlChangeSet &changeSet, bool reset)
 {
+    if (clustering()) {
+        updateClusteredRows(changeSet, reset);
+        return;
+    }
+
     // move changes are expressed as one remove + one insert, with the same moveId.
     // For simplicity, they will be treated as remove + insert.
     // Changes will be also ignored, as they represent only data changes, not layout changes
@@ -392,6 +482,8 @@ void QMapObjectView::createdItem(int index, QObject * /*object*/)
         // see QDeclarativeGeoMapItemView::createdItem
         return;
     }
+    if (clustering() && !isClusterLeaf(index)) // clustered away while incubating
+        return;
 
     // If here, according to the documentation above, object() should be called again for index,
     // or else, it will be destroyed exiting this scope
@@ -428,6 +520,12 @@ void QMapObjectView::setMap(QGeoMap *map)
     if (d->m_map == map)
         return;
 
+    // The clusters in view depend on the camera
+    if (d->m_map)
+        disconnect(d->m_map, &QGeoMap::cameraDataChanged, this, &QMapObjectView::updateClusters);
+    if (map)
+        connect(map, &QGeoMap::cameraDataChanged, this, &QMapObjectView::updateClusters);
+
     QGeoMapObject::setMap(map); // This is where the specialized pimpl gets created and injected
 
     for (int i = 0; i < m_userAddedMapObjects.size(); ++i) {
@@ -438,7 +536,13 @@ void QMapObjectView::setMap(QGeoMap *map)
 
     if (!map) {
         // Map was set, now it has ben re-set to NULL
-        flushDelegateModel();
+        if (clustering()) {
+            // Keep the rows, the leaves in view of the next map get instantiated again
+            releaseClusterLeaves();
+            removeClusters(0);
+        } else {
+            flushDelegateModel();
+        }
         flushUserAddedMapObjects();
         bool oldVisible = d_ptr->m_visible;
         bool oldCmponentCompleted = d_ptr->m_componentCompleted;
@@ -454,6 +558,132 @@ void QMapObjectView::setMap(QGeoMap *map)
                 obj->setMap(map);
         }
         m_pendingMapObjects.clear();
+        updateClusters();
+    }
+}
+
+bool QMapObjectView::clustering() const
+{
+    return m_clusterDelegate && !m_clusterRole.isEmpty();
+}
+
+/*
+    Instantiates the rows again, when switching between clustering and instantiating
+    every row.
+*/
+void QMapObjectView::restartClustering()
+{
+    if (!d_ptr->m_componentCompleted)
+        return;
+    flushDelegateModel();
+    removeClusters(0);
+    resetClusterRows();
+
+    QQmlChangeSet changeSet;
+    changeSet.insert(0, m_delegateModel->count());
+    modelUpdated(changeSet, false);
+}
+
+/*
+    Keeps one placeholder per row, and regroups the rows.
+*/
+void QMapObjectView::updateClusteredRows(const QQmlChangeSet &changeSet, bool reset)
+{
+    if (reset) {
+        flushDelegateModel();
+        removeClusters(0);
+        resetClusterRows();
+    }
+    updateClusterRows(changeSet);
+    updateClusters();
+}
+
+QGeoCoordinate QMapObjectView::clusterRowCoordinate(int row) const
+{
+    return m_delegateModel->variantValue(row, m_clusterRole).value<QGeoCoordinate>();
+}
+
+void QMapObjectView::clusterRowInserted(int row)
+{
+    m_instantiatedMapObjects.insert(row, nullptr);
+}
+
+void QMapObjectView::clusterRowRemoved(int row)
+{
+    m_instantiatedMapObjects.remove(row);
+}
+
+/*
+    Lays the clusters out for the current camera of the map.
+*/
+void QMapObjectView::updateClusters()
+{
+    if (!clustering() || !d_ptr->m_componentCompleted || !map())
+        return;
+    if (clusterRowCount() != m_delegateModel->count())
+        return; // not instantiated yet
+    layoutClusters(*map(), m_clusterRadius);
+}
+
+void QMapObjectView::instantiateClusterLeaf(int row)
+{
+    QBoolBlocker createBlocker(m_creatingObject, true);
+    QGeoMapObject *mo = qobject_cast<QGeoMapObject *>(m_delegateModel->object(row, incubationMode));
+    if (mo) { // else createdItem will add it
+        mo->setParent(this);
+        addMapObjectToMap(mo, row);
+    }
+}
+
+void QMapObjectView::releaseClusterLeaf(int row)
+{
+    QGeoMapObject *mo = m_instantiatedMapObjects.at(row);
+    if (!mo) { // still incubating
+        m_delegateModel->cancel(row);
+        return;
+    }
+    m_instantiatedMapObjects[row] = nullptr;
+    mo->setMap(nullptr);
+    m_delegateModel->release(mo);
+}
+
+bool QMapObjectView::placeCluster(int index, const QGeoCoordinate &coordinate, int count)
+{
+    if (index < m_clusterObjects.size()) {
+        setClusterContext(m_clusterObjects.at(index).context, coordinate, count);
+        return true;
+    }
+
+    QQmlContext *context = createClusterContext(m_clusterDelegate, this, coordinate, count);
+    QObject *object = m_clusterDelegate->create(context);
+    QGeoMapObject *mo = qobject_cast<QGeoMapObject *>(object);
+    if (!mo) {
+        qWarning() << "MapObjectView clusterDelegate must have a map object as root object";
+        delete object;
+        delete context;
+        return false;
+    }
+
+    mo->setParent(this);
+    context->setParent(mo);
+    mo->setMap(map());
+
+    ClusterObject clusterObject;
+    clusterObject.object = mo;
+    clusterObject.context = context;
+    m_clusterObjects.append(clusterObject);
+    return true;
+}
+
+/*
+    Removes the cluster objects from first on.
+*/
+void QMapObjectView::removeClusters(int first)
+{
+    while (m_clusterObjects.size() > first) {
+        QGeoMapObject *mo = m_clusterObjects.takeLast().object;
+        mo->setMap(nullptr);
+        mo->deleteLater(); // may be running one of its handlers
     }
 }
 
@@ -50,6 +50,7 @@
 
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/private/qgeomapobject_p.h>
+#include <QtLocation/private/qgeoclusteredview_p.h>
 #include <QQmlComponent>
 #include <QVector>
 
@@ -58,11 +59,15 @@ QT_BEGIN_NAMESPACE
 class QQmlDelegateModel;
 class QMapObjectViewPrivate;
 class QQmlChangeSet;
-class Q_LOCATION_PRIVATE_EXPORT QMapObjectView : public QGeoMapObject
+class QQmlContext;
+class Q_LOCATION_PRIVATE_EXPORT QMapObjectView : public QGeoMapObject, protected QGeoClusteredView
 {
     Q_OBJECT
     Q_PROPERTY(QVariant model READ model WRITE setModel NOTIFY modelChanged)
     Q_PROPERTY(QQmlComponent *delegate READ delegate WRITE setDelegate NOTIFY delegateChanged)
+    Q_PROPERTY(QQmlComponent *clusterDelegate READ clusterDelegate WRITE setClusterDelegate NOTIFY clusterDelegateChanged)
+    Q_PROPERTY(QString clusterRole READ clusterRole WRITE setClusterRole NOTIFY clusterRoleChanged)
+    Q_PROPERTY(qreal clusterRadius READ clusterRadius WRITE setClusterRadius NOTIFY clusterRadiusChanged)
     Q_INTERFACES(QQmlParserStatus)
 public:
     QMapObjectView(QObject *parent = nullptr);
@@ -82,6 +87,15 @@ public:
     QQmlComponent *delegate() const;
     void setDelegate(QQmlComponent * delegate);
 
+    QQmlComponent *clusterDelegate() const;
+    void setClusterDelegate(QQmlComponent *delegate);
+
+    QString clusterRole() const;
+    void setClusterRole(const QString &role);
+
+    qreal clusterRadius() const;
+    void setClusterRadius(qreal radius);
+
 public Q_SLOTS:
     // The dynamic API that matches Map.add/remove MapItem
     void addMapObject(QGeoMapObject *object);
@@ -90,12 +104,16 @@ public Q_SLOTS:
 signals:
     void modelChanged(QVariant model);
     void delegateChanged(QQmlComponent * delegate);
+    void clusterDelegateChanged(QQmlComponent *delegate);
+    void clusterRoleChanged(const QString &role);
+    void clusterRadiusChanged(qreal radius);
 
 protected Q_SLOTS:
     void destroyingItem(QObject *object);
     void initItem(int index, QObject *object);
     void createdItem(int index, QObject *object);
     void modelUpdated(const QQmlChangeSet &changeSet, bool reset);
+    void updateClusters();
 
 protected:
     void addMapObjectToMap(QGeoMapObject *object, int index);
@@ -103,11 +121,33 @@ protected:
     void flushDelegateModel();
     void flushUserAddedMapObjects();
 
+    struct ClusterObject {
+        QGeoMapObject *object = nullptr;
+        QQmlContext *context = nullptr;
+    };
+    bool clustering() const;
+    void restartClustering();
+    void updateClusteredRows(const QQmlChangeSet &changeSet, bool reset);
+
+    // From QGeoClusteredView
+    QGeoCoordinate clusterRowCoordinate(int row) const override;
+    void clusterRowInserted(int row) override;
+    void clusterRowRemoved(int row) override;
+    void instantiateClusterLeaf(int row) override;
+    void releaseClusterLeaf(int row) override;
+    bool placeCluster(int index, const QGeoCoordinate &coordinate, int count) override;
+    void removeClusters(int first) override;
+
     QQmlDelegateModel *m_delegateModel = nullptr;
     QVector<QPointer<QGeoMapObject>> m_instantiatedMapObjects;
     QVector<QPointer<QGeoMapObject>> m_pendingMapObjects; // for items instantiated before the map is set
     QVector<QPointer<QGeoMapObject>> m_userAddedMapObjects; // A third list containing the objects dynamically added through addMapObject
     bool m_creatingObject = false;
+
+    QQmlComponent *m_clusterDelegate = nullptr;
+    QString m_clusterRole;
+    qreal m_clusterRadius = 60.0;
+    QVector<ClusterObject> m_clusterObjects; // reused for the clusters in view
 };
 
 QT_END_NAMESPACE
@@ -36,6 +36,17 @@
 
 #include "qgeomapobjectqsgsupport_p.h"
 #include <QtLocation/private/qgeomap_p_p.h>
+#include <QtLocation/private/qmappolylineobject_p.h>
+#include <QtLocation/private/qmappolygonobject_p.h>
+#include <QtLocation/private/qmapcircleobject_p.h>
+#include <QtLocation/private/qmapiconobject_p.h>
+#include <QtLocation/private/qmaprouteobject_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtPositioning/private/qlocationutils_p.h>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioning/QGeoPath>
+
+#include <cmath>
 
 QT_BEGIN_NAMESPACE
 
@@ -139,6 +150,7 @@ void QGeoMapObjectQSGSupport::removeMapObject(QGeoMapObject *obj)
     if (idx >= 0) {
         const MapObject &mo = m_mapObjects.takeAt(idx);
         obj->disconnect(m_map);
+        m_index.remove(obj);
         m_removedMapObjects << mo;
         emit m_map->sgNodeChanged();
     } else {
@@ -166,6 +178,13 @@ void QGeoMapObjectQSGSupport::updateMapObjects(QSGNode *root, QQuickWindow *wind
     }
     m_removedMapObjects.clear();
 
+    QRectF viewport;
+    QSet<QGeoMapObject *> visible;
+    if (cullingRect(&viewport)) {
+        const QList<QGeoMapObject *> inView = m_index.intersecting(viewport);
+        visible = QSet<QGeoMapObject *>(inView.cbegin(), inView.cend());
+    }
+
     for (int i = 0; i < m_mapObjects.size(); ++i) {
         // already added as node
         if (Q_UNLIKELY(!m_mapObjects.at(i).object)) {
@@ -174,7 +193,22 @@ void QGeoMapObjectQSGSupport::updateMapObjects(QSGNode *root, QQuickWindow *wind
         }
 
         MapObject &mo = m_mapObjects[i];
+        if (isCulled(mo, viewport, visible)) {
+            // Leave the node, and its stale geometry, alone until the object comes back into view
+            if (!mo.culled && mo.visibleNode && mo.qsgNode && mo.visibleNode->visible()) {
+                mo.visibleNode->setVisible(false);
+                mo.qsgNode->markDirty(QSGNode::DirtySubtreeBlocked);
+            }
+            mo.culled = true;
+            continue;
+        }
+
         QQSGMapObject *sgo = mo.sgObject;
+        if (mo.geometryDirty) {
+            sgo->updateGeometry();
+            mo.geometryDirty = false;
+        }
+        mo.culled = false;
         QSGNode *oldNode = mo.qsgNode;
         mo.qsgNode = sgo->updateMapObjectNode(oldNode, &mo.visibleNode, root, window);
         if (Q_UNLIKELY(!mo.qsgNode)) {
@@ -201,6 +235,7 @@ void QGeoMapObjectQSGSupport::updateMapObjects(QSGNode *root, QQuickWindow *wind
             m_mapObjects << mo;
             toRemove.push_front(i);
             QObject::connect(mo.object, SIGNAL(visibleChanged()), m_map, SIGNAL(sgNodeChanged()));
+            trackMapObject(mo.object);
         } else {
             // leave it to be processed, don't spit warnings
         }
@@ -210,8 +245,19 @@ void QGeoMapObjectQSGSupport::updateMapObjects(QSGNode *root, QQuickWindow *wind
         m_pendingMapObjects.removeAt(i);
 }
 
+/*
+    Regenerates the geometry of the objects in view. The others are only flagged, and
+    regenerated by updateMapObjects() once they come back into view.
+*/
 void QGeoMapObjectQSGSupport::updateObjectsGeometry()
 {
+    QRectF viewport;
+    QSet<QGeoMapObject *> visible;
+    if (cullingRect(&viewport)) {
+        const QList<QGeoMapObject *> inView = m_index.intersecting(viewport);
+        visible = QSet<QGeoMapObject *>(inView.cbegin(), inView.cend());
+    }
+
     for (int i = 0; i < m_mapObjects.size(); ++i) {
         // already added as node
         if (Q_UNLIKELY(!m_mapObjects.at(i).object)) {
@@ -219,10 +265,133 @@ void QGeoMapObjectQSGSupport::updateObjectsGeometry()
             continue;
         }
 
-        QQSGMapObject *sgo = m_mapObjects.at(i).sgObject;
-        sgo->updateGeometry();
+        MapObject &mo = m_mapObjects[i];
+        if (isCulled(mo, viewport, visible)) {
+            mo.geometryDirty = true;
+            continue;
+        }
+        mo.sgObject->updateGeometry();
+        mo.geometryDirty = false;
     }
     emit m_map->sgNodeChanged();
 }
 
+/*
+    Keeps the spatial index up to date with the geometry of \a obj. The connections use
+    m_map as context, so they are dropped by removeMapObject().
+*/
+void QGeoMapObjectQSGSupport::trackMapObject(QGeoMapObject *obj)
+{
+    const auto reindex = [this, obj]() { indexMapObject(obj); };
+    switch (obj->type()) {
+    case QGeoMapObject::PolylineType: {
+        QMapPolylineObject *polyline = static_cast<QMapPolylineObject *>(obj);
+        QObject::connect(polyline, &QMapPolylineObject::pathChanged, m_map, reindex);
+        QObject::connect(polyline->border(), &QDeclarativeMapLineProperties::widthChanged, m_map, reindex);
+        break;
+    }
+    case QGeoMapObject::PolygonType:
+        QObject::connect(static_cast<QMapPolygonObject *>(obj), &QMapPolygonObject::pathChanged, m_map, reindex);
+        break;
+    case QGeoMapObject::CircleType:
+        QObject::connect(static_cast<QMapCircleObject *>(obj), &QMapCircleObject::centerChanged, m_map, reindex);
+        QObject::connect(static_cast<QMapCircleObject *>(obj), &QMapCircleObject::radiusChanged, m_map, reindex);
+        break;
+    case QGeoMapObject::RouteType:
+        QObject::connect(static_cast<QMapRouteObject *>(obj), &QMapRouteObject::routeChanged, m_map, reindex);
+        break;
+    case QGeoMapObject::IconType:
+        QObject::connect(static_cast<QMapIconObject *>(obj), &QMapIconObject::coordinateChanged, m_map, reindex);
+        break;
+    default:
+        break;
+    }
+    indexMapObject(obj);
+}
+
+void QGeoMapObjectQSGSupport::indexMapObject(QGeoMapObject *obj)
+{
+    if (obj->type() == QGeoMapObject::PolylineType)
+        m_maxLineWidth = qMax(m_maxLineWidth, static_cast<QMapPolylineObject *>(obj)->border()->width());
+    else if (obj->type() == QGeoMapObject::RouteType)
+        m_maxLineWidth = qMax(m_maxLineWidth, qreal(4)); // MapRouteObjectQSG has a hardcoded 4 pixels width
+    m_index.insert(obj, obj->geoShape());
+}
+
+/*
+    Stores in \a rect the bounding box of the visible region in map projection coordinates,
+    padded by the widest line. Returns false when objects cannot be culled.
+*/
+bool QGeoMapObjectQSGSupport::cullingRect(QRectF *rect) const
+{
+    if (m_map->geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator)
+        return false;
+    const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator &>(m_map->geoProjection());
+    const QList<QDoubleVector2D> region = p.visibleGeometryExpanded();
+    if (region.isEmpty() || p.mapWidth() <= 0)
+        return false;
+
+    double minX = region.first().x(), maxX = minX;
+    double minY = region.first().y(), maxY = minY;
+    for (const QDoubleVector2D &v : region) {
+        minX = qMin(minX, v.x());
+        maxX = qMax(maxX, v.x());
+        minY = qMin(minY, v.y());
+        maxY = qMax(maxY, v.y());
+    }
+    // The region is wrapped around the camera center, the index takes care of the other worlds
+    const double margin = m_maxLineWidth / p.mapWidth();
+    *rect = QRectF(QPointF(minX - margin, minY - margin), QPointF(maxX + margin, maxY + margin));
+    return true;
+}
+
+/*
+    Icons are sized in pixels, so their geographic shape says nothing about their extent
+    on screen: they are never culled. Neither are the objects missing from the index.
+*/
+bool QGeoMapObjectQSGSupport::isCulled(const MapObject &mo, const QRectF &rect, const QSet<QGeoMapObject *> &visible) const
+{
+    if (rect.isNull() || mo.object->type() == QGeoMapObject::IconType)
+        return false;
+    return m_index.contains(mo.object) && !visible.contains(mo.object);
+}
+
+/*
+    Returns the objects containing \a coordinate. The candidates are looked up in the
+    spatial index, padded by the widest line, before testing their exact shape.
+*/
+QList<QObject *> QGeoMapObjectQSGSupport::mapObjectsAt(const QGeoCoordinate &coordinate, qreal zoomLevel) const
+{
+    QList<QObject *> res;
+    if (!coordinate.isValid())
+        return res;
+
+    const QDoubleVector2D point = QWebMercator::coordToMercator(coordinate);
+    const double margin = m_maxLineWidth / (256.0 * std::pow(2.0, zoomLevel));
+    const QRectF rect(point.x() - margin, point.y() - margin, 2 * margin, 2 * margin);
+    const QList<QGeoMapObject *> candidates = m_index.intersecting(rect);
+    for (QGeoMapObject *o : candidates) {
+        // explicitly handle lines
+        bool contains = false;
+        if (o->type() == QGeoMapObject::PolylineType ) {
+            QMapPolylineObject *mpo = static_cast<QMapPolylineObject *>(o);
+            qreal mpp = QLocationUtils::metersPerPixel(zoomLevel, coordinate);
+            QGeoPath path = o->geoShape();
+            path.setWidth(mpp * mpo->border()->width());
+            contains = path.contains(coordinate);
+        } else if (o->type() == QGeoMapObject::RouteType) {
+            qreal mpp = QLocationUtils::metersPerPixel(zoomLevel, coordinate);
+            QGeoPath path = o->geoShape();
+            path.setWidth(mpp * 4); // MapRouteObjectQSG has a hardcoded 4 pixels width;
+            contains = path.contains(coordinate);
+        } else {
+            contains = o->geoShape().contains(coordinate);
+        }
+
+        if (contains)
+            res.append(o);
+    }
+    return res;
+}
+
 QT_END_NAMESPACE
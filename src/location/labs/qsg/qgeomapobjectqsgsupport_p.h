@@ -57,7 +57,9 @@
 #include <QtLocation/private/qmaprouteobjectqsg_p_p.h>
 #include <QtLocation/private/qmapiconobjectqsg_p_p.h>
 #include <QtLocation/private/qdeclarativepolylinemapitem_p.h>
+#include <QtLocation/private/qgeomapobjectspatialindex_p.h>
 #include <QtCore/qpointer.h>
+#include <QtCore/qset.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -69,6 +71,8 @@ struct Q_LOCATION_PRIVATE_EXPORT MapObject {
     QQSGMapObject *sgObject = nullptr; // this is a QMap*ObjectPrivateQSG. it becomes invalid when the pimpl is destroyed
     VisibleNode *visibleNode = nullptr; // This is a Map*Node (like a MapPolygonNode) that is a QSGNode. This doesn't disappear by itself
     QSGNode *qsgNode = nullptr;
+    bool geometryDirty = false; // updateGeometry() was skipped while the object was culled
+    bool culled = false; // visibleNode is hidden because the object is out of the viewport
 };
 
 class Q_LOCATION_PRIVATE_EXPORT QGeoMapObjectQSGSupport
@@ -80,11 +84,21 @@ public:
     void removeMapObject(QGeoMapObject *obj);
     void updateMapObjects(QSGNode *root, QQuickWindow *window);
     void updateObjectsGeometry();
+    QList<QObject *> mapObjectsAt(const QGeoCoordinate &coordinate, qreal zoomLevel) const;
 
     QList<MapObject> m_mapObjects;
     QList<MapObject> m_pendingMapObjects;
     QList<MapObject> m_removedMapObjects;
     QGeoMap *m_map = nullptr;
+
+private:
+    void trackMapObject(QGeoMapObject *obj);
+    void indexMapObject(QGeoMapObject *obj);
+    bool cullingRect(QRectF *rect) const;
+    bool isCulled(const MapObject &mo, const QRectF &rect, const QSet<QGeoMapObject *> &visible) const;
+
+    QGeoMapObjectSpatialIndex m_index; // m_mapObjects by bounding box
+    qreal m_maxLineWidth = 0; // in pixels, of the widest polyline or route ever indexed
 };
 
 QT_END_NAMESPACE
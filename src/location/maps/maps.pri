@@ -51,6 +51,9 @@ PRIVATE_HEADERS += \
                     maps/qgeoserviceprovider_p.h \
                     maps/qabstractgeotilecache_p.h \
                     maps/qgeofiletilecache_p.h \
+                    maps/qgeotilepackstore_p.h \
+                    maps/qgeotileslabarena_p.h \
+                    maps/qgeoofflineregionmanager_p.h \
                     maps/qgeotiledmapreply_p.h \
                     maps/qgeotiledmapreply_p_p.h \
                     maps/qgeotilespec_p.h \
@@ -60,6 +63,8 @@ PRIVATE_HEADERS += \
                     maps/qgeorouteparserosrmv5_p.h \
                     maps/qgeorouteparserosrmv4_p.h \
                     maps/qgeoprojection_p.h \
+                    maps/qgeoclusterindex_p.h \
+                    maps/qgeoclusteredview_p.h \
                     maps/qnavigationmanagerengine_p.h \
                     maps/qnavigationmanager_p.h \
                     maps/qgeocameratiles_p_p.h \
@@ -91,6 +96,9 @@ SOURCES += \
             maps/qgeoserviceproviderfactory.cpp \
             maps/qabstractgeotilecache.cpp \
             maps/qgeofiletilecache.cpp \
+            maps/qgeotilepackstore.cpp \
+            maps/qgeotileslabarena.cpp \
+            maps/qgeoofflineregionmanager.cpp \
             maps/qgeotiledmapreply.cpp \
             maps/qgeotilespec.cpp \
             maps/qgeotiledmap.cpp \
@@ -101,5 +109,7 @@ SOURCES += \
             maps/qgeomapparameter.cpp \
             maps/qnavigationmanagerengine.cpp \
             maps/qnavigationmanager.cpp \
-            maps/qgeoprojection.cpp
+            maps/qgeoprojection.cpp \
+            maps/qgeoclusterindex.cpp \
+            maps/qgeoclusteredview.cpp
 
@@ -57,6 +57,64 @@ QGeoTileTexture::~QGeoTileTexture()
 {
 }
 
+QGeoTileCacheLayerStatistics::QGeoTileCacheLayerStatistics()
+    : hits(0), misses(0), inserts(0), evictions(0), bytesRead(0), bytesWritten(0),
+      usage(0), maxUsage(0)
+{
+}
+
+QVariantMap QGeoTileCacheLayerStatistics::toVariantMap() const
+{
+    QVariantMap map;
+    map.insert(QStringLiteral("hits"), hits);
+    map.insert(QStringLiteral("misses"), misses);
+    map.insert(QStringLiteral("inserts"), inserts);
+    map.insert(QStringLiteral("evictions"), evictions);
+    map.insert(QStringLiteral("bytesRead"), bytesRead);
+    map.insert(QStringLiteral("bytesWritten"), bytesWritten);
+    map.insert(QStringLiteral("usage"), usage);
+    map.insert(QStringLiteral("maxUsage"), maxUsage);
+    return map;
+}
+
+QGeoTileCacheStatistics::QGeoTileCacheStatistics()
+    : decodeTimes(DecodeTimeBuckets, 0), decodes(0), totalDecodeTime(0),
+      queuedTiles(0), inFlightTiles(0)
+{
+}
+
+void QGeoTileCacheStatistics::addDecodeTime(qint64 usecs)
+{
+    int bucket = 0;
+    while (bucket < DecodeTimeBuckets - 1 && usecs >= (qint64(2) << bucket))
+        ++bucket;
+    ++decodeTimes[bucket];
+    ++decodes;
+    totalDecodeTime += usecs;
+}
+
+/*
+    Returns the statistics in a form suitable for QML: a map with a map for each of
+    the "texture", "memory" and "disk" levels, and "decodeTimes" as a list of counts.
+*/
+QVariantMap QGeoTileCacheStatistics::toVariantMap() const
+{
+    QVariantList histogram;
+    for (quint64 count : decodeTimes)
+        histogram.append(count);
+
+    QVariantMap map;
+    map.insert(QStringLiteral("texture"), texture.toVariantMap());
+    map.insert(QStringLiteral("memory"), memory.toVariantMap());
+    map.insert(QStringLiteral("disk"), disk.toVariantMap());
+    map.insert(QStringLiteral("decodeTimes"), histogram);
+    map.insert(QStringLiteral("decodes"), decodes);
+    map.insert(QStringLiteral("totalDecodeTime"), totalDecodeTime);
+    map.insert(QStringLiteral("queuedTiles"), queuedTiles);
+    map.insert(QStringLiteral("inFlightTiles"), inFlightTiles);
+    return map;
+}
+
 QAbstractGeoTileCache::QAbstractGeoTileCache(QObject *parent)
     : QObject(parent)
 {
@@ -73,6 +131,79 @@ void QAbstractGeoTileCache::printStats()
 {
 }
 
+/*
+    Returns the texture for \a spec if it can be provided without blocking. Otherwise, if the
+    tile is cached but still has to be loaded and decoded, this is done in the background,
+    \a scheduled is set to true and tilesDecoded() is emitted later on.
+    The default implementation is synchronous and simply calls get().
+*/
+QSharedPointer<QGeoTileTexture> QAbstractGeoTileCache::getAsync(const QGeoTileSpec &spec, bool *scheduled)
+{
+    *scheduled = false;
+    return get(spec);
+}
+
+/*
+    Returns the texture for \a spec only if it is already decoded and in memory, without
+    reading the disk, decoding or scheduling anything. Used for the lower zoom level tiles
+    shown while a tile is being fetched.
+    The default implementation returns a null texture.
+*/
+QSharedPointer<QGeoTileTexture> QAbstractGeoTileCache::cachedTexture(const QGeoTileSpec &spec)
+{
+    Q_UNUSED(spec);
+    return QSharedPointer<QGeoTileTexture>();
+}
+
+/*
+    Pins \a tiles in the disk cache: once stored, they are never evicted to make room for
+    other tiles, until unpinTiles() is called. Tiles may be pinned before they are inserted.
+    The default implementation does nothing.
+*/
+void QAbstractGeoTileCache::pinTiles(const QSet<QGeoTileSpec> &tiles)
+{
+    Q_UNUSED(tiles);
+}
+
+/*
+    Releases \a tiles pinned with pinTiles(), so that they are evicted like any other tile.
+    The default implementation does nothing.
+*/
+void QAbstractGeoTileCache::unpinTiles(const QSet<QGeoTileSpec> &tiles)
+{
+    Q_UNUSED(tiles);
+}
+
+/*
+    Returns whether \a spec is stored in the disk cache.
+    The default implementation returns false.
+*/
+bool QAbstractGeoTileCache::isTileStored(const QGeoTileSpec &spec) const
+{
+    Q_UNUSED(spec);
+    return false;
+}
+
+/*
+    Returns the counters of the cache since the last call to resetStatistics().
+    The default implementation only reports the usage of each level.
+*/
+QGeoTileCacheStatistics QAbstractGeoTileCache::statistics() const
+{
+    QGeoTileCacheStatistics stats;
+    stats.texture.usage = textureUsage();
+    stats.texture.maxUsage = maxTextureUsage();
+    stats.memory.usage = memoryUsage();
+    stats.memory.maxUsage = maxMemoryUsage();
+    stats.disk.usage = diskUsage();
+    stats.disk.maxUsage = maxDiskUsage();
+    return stats;
+}
+
+void QAbstractGeoTileCache::resetStatistics()
+{
+}
+
 void QAbstractGeoTileCache::handleError(const QGeoTileSpec &, const QString &error)
 {
     qWarning() << "tile request error " << error;
@@ -59,6 +59,8 @@
 #include "qgeotilespec_p.h"
 
 #include <QImage>
+#include <QVariantMap>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 
@@ -83,6 +85,49 @@ public:
     bool textureBound;
 };
 
+/* Counters of one level of a tile cache, since the last reset */
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileCacheLayerStatistics
+{
+public:
+    QGeoTileCacheLayerStatistics();
+
+    QVariantMap toVariantMap() const;
+
+    quint64 hits;
+    quint64 misses;
+    quint64 inserts;
+    quint64 evictions;
+    qint64 bytesRead;
+    qint64 bytesWritten;
+    int usage;      // in the unit of the cost strategy of the level
+    int maxUsage;
+};
+
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileCacheStatistics
+{
+public:
+    // Bucket i counts the decodes that took less than 2^(i+1) microseconds,
+    // and at least 2^i for i > 0. The last bucket also counts the slower ones.
+    enum { DecodeTimeBuckets = 16 };
+
+    QGeoTileCacheStatistics();
+
+    QVariantMap toVariantMap() const;
+    void addDecodeTime(qint64 usecs);
+
+    QGeoTileCacheLayerStatistics texture;
+    QGeoTileCacheLayerStatistics memory;
+    QGeoTileCacheLayerStatistics disk;
+
+    QVector<quint64> decodeTimes;
+    quint64 decodes;
+    qint64 totalDecodeTime; // in microseconds
+
+    // Filled in by the engine, the cache does not know about the fetcher
+    int queuedTiles;
+    int inFlightTiles;
+};
+
 class Q_LOCATION_PRIVATE_EXPORT QAbstractGeoTileCache : public QObject
 {
     Q_OBJECT
@@ -123,6 +168,15 @@ public:
     virtual CostStrategy costStrategyTexture() const = 0;
 
     virtual QSharedPointer<QGeoTileTexture> get(const QGeoTileSpec &spec) = 0;
+    virtual QSharedPointer<QGeoTileTexture> getAsync(const QGeoTileSpec &spec, bool *scheduled);
+    virtual QSharedPointer<QGeoTileTexture> cachedTexture(const QGeoTileSpec &spec);
+
+    virtual void pinTiles(const QSet<QGeoTileSpec> &tiles);
+    virtual void unpinTiles(const QSet<QGeoTileSpec> &tiles);
+    virtual bool isTileStored(const QGeoTileSpec &spec) const;
+
+    virtual QGeoTileCacheStatistics statistics() const;
+    virtual void resetStatistics();
 
     virtual void insert(const QGeoTileSpec &spec,
                 const QByteArray &bytes,
@@ -134,6 +188,10 @@ public:
     static QString baseCacheDirectory();
     static QString baseLocationCacheDirectory();
 
+Q_SIGNALS:
+    void tilesDecoded(const QList<QSharedPointer<QGeoTileTexture> > &textures,
+                      const QList<QGeoTileSpec> &failed);
+
 protected:
     QAbstractGeoTileCache(QObject *parent = 0);
     virtual void printStats() = 0;
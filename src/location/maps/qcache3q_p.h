@@ -144,6 +144,14 @@ private:
     QHash<Key, Node *> lookup_;
 
 public:
+    struct SerializedNode
+    {
+        Key key;
+        QSharedPointer<T> value;    // null for the ghosts in queue 4
+        int cost;
+        quint64 pop;
+    };
+
     explicit QCache3Q(int maxCost = 0, int minRecent = -1, int maxOldPopular = -1);
     inline ~QCache3Q() { clear(); delete q1_; delete q2_; delete q3_; delete q1_evicted_; }
 
@@ -164,17 +172,26 @@ public:
     QList<Key> keys() const;
     void printStats();
 
-    // Copy data directly into a queue. Designed for single use after construction
-    void deserializeQueue(int queueNumber, const QList<Key> &keys,
-                          const QList<QSharedPointer<T> > &values, const QList<int> &costs);
-    // Copy data from specific queue into list
-    void serializeQueue(int queueNumber, QList<QSharedPointer<T> > &buffer);
+    inline quint64 hitCount() const { return hitCount_; }
+    inline quint64 missCount() const { return missCount_; }
+    inline quint64 insertCount() const { return insertCount_; }
+    inline quint64 evictionCount() const { return evictionCount_; }
+    void resetStats();
+
+    // Copy data directly into a queue, preserving the order of buffer (front first).
+    // Designed for use on an empty cache, once per queue, followed by rebalance().
+    void deserializeQueue(int queueNumber, const QList<SerializedNode> &buffer);
+    // Copy data from specific queue into list, front first
+    void serializeQueue(int queueNumber, QList<SerializedNode> &buffer) const;
+
+    // Evict until the cache fits into maxCost again
+    void rebalance();
 
 private:
     int maxCost_, minRecent_, maxOldPopular_;
-    int hitCount_, missCount_, promote_;
+    quint64 hitCount_, missCount_, insertCount_, evictionCount_;
+    int promote_;
 
-    void rebalance();
     void unlink(Node *n);
     void link_front(Node *n, Queue *q);
 
@@ -188,7 +205,7 @@ template <class Key, class T, class EvPolicy>
 void QCache3Q<Key,T,EvPolicy>::printStats()
 {
     qDebug("\n=== cache %p ===", this);
-    qDebug("hits: %d (%.2f%%)\tmisses: %d\tfill: %.2f%%", hitCount_,
+    qDebug("hits: %llu (%.2f%%)\tmisses: %llu\tfill: %.2f%%", hitCount_,
            100.0 * float(hitCount_) / (float(hitCount_ + missCount_)),
            missCount_,
            100.0 * float(totalCost()) / float(maxCost()));
@@ -196,13 +213,23 @@ void QCache3Q<Key,T,EvPolicy>::printStats()
     qDebug("q1:  cost=%d, size=%d, pop=%llu", q1_->cost, q1_->size, q1_->pop);
     qDebug("q2:  cost=%d, size=%d, pop=%llu", q2_->cost, q2_->size, q2_->pop);
     qDebug("q3:  cost=%d, size=%d, pop=%llu", q3_->cost, q3_->size, q3_->pop);
+    qDebug("inserts: %llu\tevictions: %llu", insertCount_, evictionCount_);
+}
+
+template <class Key, class T, class EvPolicy>
+void QCache3Q<Key,T,EvPolicy>::resetStats()
+{
+    hitCount_ = 0;
+    missCount_ = 0;
+    insertCount_ = 0;
+    evictionCount_ = 0;
 }
 
 template <class Key, class T, class EvPolicy>
 QCache3Q<Key,T,EvPolicy>::QCache3Q(int maxCost, int minRecent, int maxOldPopular)
     : q1_(new Queue), q2_(new Queue), q3_(new Queue), q1_evicted_(new Queue),
       maxCost_(maxCost), minRecent_(minRecent), maxOldPopular_(maxOldPopular),
-      hitCount_(0), missCount_(0), promote_(0)
+      hitCount_(0), missCount_(0), insertCount_(0), evictionCount_(0), promote_(0)
 {
     if (minRecent_ < 0)
         minRecent_ = maxCost_ / 3;
@@ -211,7 +238,7 @@ QCache3Q<Key,T,EvPolicy>::QCache3Q(int maxCost, int minRecent, int maxOldPopular
 }
 
 template <class Key, class T, class EvPolicy>
-void QCache3Q<Key,T,EvPolicy>::serializeQueue(int queueNumber, QList<QSharedPointer<T> > &buffer)
+void QCache3Q<Key,T,EvPolicy>::serializeQueue(int queueNumber, QList<SerializedNode> &buffer) const
 {
     Q_ASSERT(queueNumber >= 1 && queueNumber <= 4);
     Queue *queue = queueNumber == 1 ? q1_ :
@@ -219,29 +246,32 @@ void QCache3Q<Key,T,EvPolicy>::serializeQueue(int queueNumber, QList<QSharedPoin
                    queueNumber == 3 ? q3_ :
                                       q1_evicted_;
     for (Node *node = queue->f; node; node = node->n)
-        buffer.append(node->v);
+        buffer.append({ node->k, node->v, node->cost, node->pop });
 }
 
 template <class Key, class T, class EvPolicy>
-void QCache3Q<Key,T,EvPolicy>::deserializeQueue(int queueNumber, const QList<Key> &keys,
-                       const QList<QSharedPointer<T> > &values, const QList<int> &costs)
+void QCache3Q<Key,T,EvPolicy>::deserializeQueue(int queueNumber, const QList<SerializedNode> &buffer)
 {
     Q_ASSERT(queueNumber >= 1 && queueNumber <= 4);
-    int bufferSize = keys.size();
-    if (bufferSize == 0)
-        return;
-    clear();
     Queue *queue = queueNumber == 1 ? q1_ :
                    queueNumber == 2 ? q2_ :
                    queueNumber == 3 ? q3_ :
                                       q1_evicted_;
-    for (int i = 0; i<bufferSize; ++i) {
+    const bool ghosts = queue == q1_evicted_;
+    // link_front reverses the order, so walk the buffer back to front
+    for (int i = buffer.size() - 1; i >= 0; --i) {
+        const SerializedNode &item = buffer.at(i);
+        if (lookup_.contains(item.key) || (!ghosts && item.value.isNull()))
+            continue;
         Node *node = new Node;
-        node->v = values[i];
-        node->k = keys[i];
-        node->cost = costs[i];
+        node->k = item.key;
+        node->pop = item.pop;
+        if (!ghosts) {
+            node->v = item.value;
+            node->cost = item.cost;
+        }
         link_front(node, queue);
-        lookup_[keys[i]] = node;
+        lookup_[item.key] = node;
     }
 }
 
@@ -265,6 +295,7 @@ bool QCache3Q<Key,T,EvPolicy>::insert(const Key &key, QSharedPointer<T> object,
     if (cost > maxCost_) {
         return false;
     }
+    ++insertCount_;
 
     if (lookup_.contains(key)) {
         Node *n = lookup_[key];
@@ -384,12 +415,14 @@ void QCache3Q<Key,T,EvPolicy>::rebalance()
         if (q3_->cost > maxOldPopular_) {
             Node *n = q3_->l;
             unlink(n);
+            ++evictionCount_;
             EvPolicy::aboutToBeEvicted(n->k, n->v);
             lookup_.remove(n->k);
             delete n;
         } else if (q1_->cost > minRecent_) {
             Node *n = q1_->l;
             unlink(n);
+            ++evictionCount_;
             EvPolicy::aboutToBeEvicted(n->k, n->v);
             n->v.clear();
             n->cost = 0;
@@ -400,6 +433,7 @@ void QCache3Q<Key,T,EvPolicy>::rebalance()
             if (q2_->size && n->pop > (q2_->pop / q2_->size)) {
                 link_front(n, q3_);
             } else {
+                ++evictionCount_;
                 EvPolicy::aboutToBeEvicted(n->k, n->v);
                 n->v.clear();
                 n->cost = 0;
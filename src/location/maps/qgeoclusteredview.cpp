@@ -0,0 +1,213 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "qgeoclusteredview_p.h"
+#include "qgeomap_p.h"
+#include "qgeocameracapabilities_p.h"
+
+#include <QtQml/QQmlContext>
+#include <QtQml/QQmlComponent>
+#include <QtQml/qqml.h>
+#include <private/qqmlchangeset_p.h>
+
+#include <map>
+
+QT_BEGIN_NAMESPACE
+
+QGeoClusteredView::~QGeoClusteredView()
+{
+}
+
+bool QGeoClusteredView::isClusterLeaf(int row) const
+{
+    return m_clusterLeaves.value(row);
+}
+
+int QGeoClusteredView::clusterRowCount() const
+{
+    return m_clusterLeaves.size();
+}
+
+/*
+    Forgets the leaves, which the view has already disposed of, and starts over with count
+    rows, none of them instantiated.
+*/
+void QGeoClusteredView::resetClusterRows(int count)
+{
+    m_clusterLeaves.fill(false, count);
+    m_leafRows.clear();
+    m_clusterIndexDirty = true;
+}
+
+/*
+    Keeps one entry per row. The leaves removed from the model are released first.
+*/
+void QGeoClusteredView::updateClusterRows(const QQmlChangeSet &changeSet)
+{
+    const QVector<QQmlChangeSet::Change> &removes = changeSet.removes();
+    std::map<int, int> mapRemoves;
+    for (int i = 0; i < removes.size(); i++)
+        mapRemoves.insert(std::pair<int, int>(removes.at(i).start(), i));
+
+    for (auto rit = mapRemoves.rbegin(); rit != mapRemoves.rend(); ++rit) {
+        const QQmlChangeSet::Change &c = removes.at(rit->second);
+        for (int idx = c.end() - 1; idx >= c.start(); --idx) {
+            if (idx >= m_clusterLeaves.size())
+                continue;
+            releaseLeaf(idx);
+            clusterRowRemoved(idx);
+            m_clusterLeaves.remove(idx);
+        }
+    }
+
+    for (const QQmlChangeSet::Change &c: changeSet.inserts()) {
+        for (int idx = c.start(); idx < c.end(); idx++) {
+            clusterRowInserted(idx);
+            m_clusterLeaves.insert(idx, false);
+        }
+    }
+
+    // The rows of the leaves moved
+    m_leafRows.clear();
+    for (int row = 0; row < m_clusterLeaves.size(); ++row) {
+        if (m_clusterLeaves.at(row))
+            m_leafRows.append(row);
+    }
+
+    // Data changes may move rows as well
+    m_clusterIndexDirty = true;
+}
+
+void QGeoClusteredView::invalidateClusterIndex()
+{
+    m_clusterIndexDirty = true;
+}
+
+/*
+    Releases all the leaves, keeping the rows.
+*/
+void QGeoClusteredView::releaseClusterLeaves()
+{
+    for (int row : qAsConst(m_leafRows))
+        releaseLeaf(row);
+    m_leafRows.clear();
+}
+
+/*
+    Instantiates the rows that stand alone in the viewport of map, releases the others, and
+    places the cluster delegates on the clusters in the viewport. Only the leaves of the
+    previous and of the new layout are visited.
+*/
+void QGeoClusteredView::layoutClusters(const QGeoMap &map, qreal radius)
+{
+    if (m_clusterIndexDirty) {
+        const int count = m_clusterLeaves.size();
+        QVector<QGeoCoordinate> coordinates(count);
+        for (int i = 0; i < count; ++i)
+            coordinates[i] = clusterRowCoordinate(i);
+        m_clusterIndex.build(coordinates, radius, map.cameraCapabilities().tileSize());
+        m_clusterIndexDirty = false;
+    }
+
+    const int level = m_clusterIndex.visibleClusters(map, &m_visibleIds);
+
+    m_nextLeafRows.resize(0);
+    int clusters = 0;
+    bool placing = true;
+    for (int id : qAsConst(m_visibleIds)) {
+        const QGeoClusterIndex::Cluster &cluster = m_clusterIndex.cluster(level, id);
+        if (cluster.count == 1) {
+            m_nextLeafRows.append(cluster.row);
+            continue;
+        }
+        if (placing && placeCluster(clusters, m_clusterIndex.coordinate(level, id), cluster.count))
+            ++clusters;
+        else
+            placing = false; // the cluster delegate failed
+    }
+    removeClusters(clusters);
+
+    if (m_wantedLeaves.size() != m_clusterLeaves.size())
+        m_wantedLeaves.fill(false, m_clusterLeaves.size());
+    for (int row : qAsConst(m_nextLeafRows))
+        m_wantedLeaves[row] = true;
+    for (int row : qAsConst(m_leafRows)) {
+        if (!m_wantedLeaves.at(row))
+            releaseLeaf(row);
+    }
+    for (int row : qAsConst(m_nextLeafRows)) {
+        m_wantedLeaves[row] = false;
+        if (!m_clusterLeaves.at(row)) {
+            m_clusterLeaves[row] = true;
+            instantiateClusterLeaf(row);
+        }
+    }
+    m_leafRows.swap(m_nextLeafRows);
+}
+
+/*
+    Creates the context of a cluster delegate instance, owned by owner until the instance
+    takes it over.
+*/
+QQmlContext *QGeoClusteredView::createClusterContext(QQmlComponent *delegate, QObject *owner,
+                                                     const QGeoCoordinate &coordinate, int count)
+{
+    QQmlContext *parentContext = delegate->creationContext();
+    if (!parentContext)
+        parentContext = qmlContext(owner);
+
+    QQmlContext *context = new QQmlContext(parentContext, owner);
+    setClusterContext(context, coordinate, count);
+    return context;
+}
+
+void QGeoClusteredView::setClusterContext(QQmlContext *context, const QGeoCoordinate &coordinate, int count)
+{
+    context->setContextProperty(QStringLiteral("clusterCoordinate"), QVariant::fromValue(coordinate));
+    context->setContextProperty(QStringLiteral("clusterCount"), count);
+}
+
+void QGeoClusteredView::releaseLeaf(int row)
+{
+    if (!m_clusterLeaves.at(row))
+        return;
+    m_clusterLeaves[row] = false;
+    releaseClusterLeaf(row);
+}
+
+QT_END_NAMESPACE
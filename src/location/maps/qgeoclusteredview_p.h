@@ -0,0 +1,112 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QGEOCLUSTEREDVIEW_P_H
+#define QGEOCLUSTEREDVIEW_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeoclusterindex_p.h>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoMap;
+class QObject;
+class QQmlChangeSet;
+class QQmlComponent;
+class QQmlContext;
+
+/*
+    The clustering shared by MapItemView and MapObjectView. It keeps track of the rows
+    instantiated as leaves, regroups the rows on model and camera changes, and tells the
+    view which leaves to instantiate or release and where to place its cluster delegates.
+    The view only instantiates the delegates.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoClusteredView
+{
+public:
+    virtual ~QGeoClusteredView();
+
+protected:
+    bool isClusterLeaf(int row) const;
+    int clusterRowCount() const;
+    void resetClusterRows(int count = 0);
+    void updateClusterRows(const QQmlChangeSet &changeSet);
+    void invalidateClusterIndex();
+    void releaseClusterLeaves();
+    void layoutClusters(const QGeoMap &map, qreal radius);
+
+    static QQmlContext *createClusterContext(QQmlComponent *delegate, QObject *owner,
+                                             const QGeoCoordinate &coordinate, int count);
+    static void setClusterContext(QQmlContext *context, const QGeoCoordinate &coordinate, int count);
+
+    // Implemented by the view
+    virtual QGeoCoordinate clusterRowCoordinate(int row) const = 0;
+    virtual void clusterRowInserted(int row) = 0;
+    virtual void clusterRowRemoved(int row) = 0;
+    virtual void instantiateClusterLeaf(int row) = 0;
+    virtual void releaseClusterLeaf(int row) = 0;
+    virtual bool placeCluster(int index, const QGeoCoordinate &coordinate, int count) = 0;
+    virtual void removeClusters(int first) = 0;
+
+private:
+    void releaseLeaf(int row);
+
+    QGeoClusterIndex m_clusterIndex;
+    bool m_clusterIndexDirty = true;
+    QVector<bool> m_clusterLeaves;  // rows instantiated, or being incubated, as leaves
+    QVector<int> m_leafRows;        // the rows in m_clusterLeaves, as of the last layout
+    QVector<int> m_nextLeafRows;    // reused by layoutClusters
+    QVector<bool> m_wantedLeaves;   // all false between two layouts
+    QVector<int> m_visibleIds;      // reused by layoutClusters
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOCLUSTEREDVIEW_P_H
@@ -0,0 +1,328 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "qgeoclusterindex_p.h"
+#include "qgeomap_p.h"
+#include "qgeoprojection_p.h"
+#include "qgeocameradata_p.h"
+
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtCore/QRectF>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+inline quint64 cellKey(qint64 cx, qint64 cy)
+{
+    return (quint64(quint32(cx)) << 32) | quint32(cy);
+}
+
+inline qint64 cellCoordinate(double v, double cellSize)
+{
+    return qint64(std::floor(v / cellSize));
+}
+
+inline quint64 cellOf(const QDoubleVector2D &p, double cellSize)
+{
+    return cellKey(cellCoordinate(p.x(), cellSize), cellCoordinate(p.y(), cellSize));
+}
+
+}
+
+QGeoClusterIndex::QGeoClusterIndex()
+{
+}
+
+/*
+    Builds the levels 0 to maximumLevel, plus the level of the leaves, for points clustered
+    within radius pixels of each other on a map made of tiles of tileSize pixels.
+    Invalid coordinates are left out.
+*/
+void QGeoClusterIndex::build(const QVector<QGeoCoordinate> &points, double radius,
+                             int tileSize, int maximumLevel)
+{
+    clear();
+    if (radius <= 0 || tileSize <= 0 || maximumLevel < 0)
+        return;
+
+    levels_.resize(maximumLevel + 2);
+    Level &leafLevel = levels_.last();
+    leafLevel.cellSize = radius / (tileSize * std::exp2(maximumLevel + 1));
+    leafLevel.clusters.reserve(points.size());
+    for (int i = 0; i < points.size(); ++i) {
+        if (!points.at(i).isValid())
+            continue;
+        Cluster leaf;
+        leaf.position = QWebMercator::coordToMercator(points.at(i));
+        leaf.count = 1;
+        leaf.row = i;
+        leafLevel.clusters.append(leaf);
+    }
+    sortLevel(leafLevel);
+
+    QVector<QPair<quint64, int> > cells;
+    QVector<bool> taken;
+    for (int z = maximumLevel; z >= 0; --z) {
+        const Level &below = levels_.at(z + 1);
+        Level &level = levels_[z];
+        level.cellSize = radius / (tileSize * std::exp2(z));
+        const double radiusSquared = level.cellSize * level.cellSize;
+
+        // The clusters below, on a grid of the radius of this level
+        cells.resize(below.clusters.size());
+        for (int i = 0; i < below.clusters.size(); ++i)
+            cells[i] = qMakePair(cellOf(below.clusters.at(i).position, level.cellSize), i);
+        std::sort(cells.begin(), cells.end());
+        taken.fill(false, below.clusters.size());
+
+        for (int i = 0; i < below.clusters.size(); ++i) {
+            if (taken.at(i))
+                continue;
+            taken[i] = true;
+            const Cluster &seed = below.clusters.at(i);
+            Cluster cluster;
+            cluster.firstChild = level.children.size();
+            cluster.count = seed.count;
+            level.children.append(i);
+            QDoubleVector2D weighted = seed.position * seed.count;
+
+            const qint64 cx = cellCoordinate(seed.position.x(), level.cellSize);
+            const qint64 cy = cellCoordinate(seed.position.y(), level.cellSize);
+            for (qint64 x = cx - 1; x <= cx + 1; ++x) {
+                for (qint64 y = cy - 1; y <= cy + 1; ++y) {
+                    if (x < 0 || y < 0)
+                        continue;
+                    const quint64 key = cellKey(x, y);
+                    auto it = std::lower_bound(cells.cbegin(), cells.cend(), qMakePair(key, 0));
+                    for (; it != cells.cend() && it->first == key; ++it) {
+                        const int j = it->second;
+                        if (taken.at(j))
+                            continue;
+                        const Cluster &neighbour = below.clusters.at(j);
+                        if ((neighbour.position - seed.position).lengthSquared() > radiusSquared)
+                            continue;
+                        taken[j] = true;
+                        level.children.append(j);
+                        weighted += neighbour.position * neighbour.count;
+                        cluster.count += neighbour.count;
+                    }
+                }
+            }
+
+            cluster.childCount = level.children.size() - cluster.firstChild;
+            cluster.position = weighted / cluster.count;
+            cluster.row = (cluster.count == 1) ? seed.row : -1;
+            level.clusters.append(cluster);
+        }
+        sortLevel(level);
+    }
+}
+
+void QGeoClusterIndex::clear()
+{
+    levels_.clear();
+}
+
+bool QGeoClusterIndex::isEmpty() const
+{
+    return levels_.isEmpty() || levels_.last().clusters.isEmpty();
+}
+
+/*
+    Returns the number of levels, including the level of the leaves.
+*/
+int QGeoClusterIndex::levelCount() const
+{
+    return levels_.size();
+}
+
+/*
+    Returns the level to show at zoomLevel: its clusters are at least the radius apart,
+    on screen.
+*/
+int QGeoClusterIndex::levelForZoom(double zoomLevel) const
+{
+    if (levels_.isEmpty())
+        return -1;
+    return qBound(0, int(std::floor(zoomLevel)), levels_.size() - 1);
+}
+
+const QGeoClusterIndex::Cluster &QGeoClusterIndex::cluster(int level, int id) const
+{
+    return levels_.at(level).clusters.at(id);
+}
+
+QGeoCoordinate QGeoClusterIndex::coordinate(int level, int id) const
+{
+    return QWebMercator::mercatorToCoord(cluster(level, id).position);
+}
+
+/*
+    Returns the rows of the points in the cluster id of level.
+*/
+QVector<int> QGeoClusterIndex::leaves(int level, int id) const
+{
+    QVector<int> rows;
+    rows.reserve(cluster(level, id).count);
+    collectLeaves(level, id, &rows);
+    return rows;
+}
+
+void QGeoClusterIndex::collectLeaves(int level, int id, QVector<int> *rows) const
+{
+    const Cluster &c = cluster(level, id);
+    if (c.row >= 0) {
+        rows->append(c.row);
+        return;
+    }
+    const Level &l = levels_.at(level);
+    for (int i = c.firstChild; i < c.firstChild + c.childCount; ++i)
+        collectLeaves(level + 1, l.children.at(i), rows);
+}
+
+/*
+    Returns the clusters of level in rect, in normalized mercator. The rect may extend
+    past the antimeridian, on either side.
+*/
+QVector<int> QGeoClusterIndex::clustersIn(int level, const QRectF &rect) const
+{
+    QVector<int> ids;
+    if (level < 0 || level >= levels_.size() || rect.isEmpty())
+        return ids;
+    const Level &l = levels_.at(level);
+
+    QVector<QRectF> pieces;
+    if (rect.width() >= 1.0) {
+        pieces << QRectF(0.0, rect.top(), 1.0, rect.height());
+    } else {
+        const QRectF r = rect.translated(-std::floor(rect.left()), 0.0);
+        pieces << r.intersected(QRectF(0.0, r.top(), 1.0, r.height()));
+        if (r.right() > 1.0)
+            pieces << QRectF(0.0, r.top(), r.right() - 1.0, r.height());
+    }
+
+    for (const QRectF &piece : qAsConst(pieces)) {
+        const qint64 x0 = qMax<qint64>(0, cellCoordinate(piece.left(), l.cellSize));
+        const qint64 x1 = cellCoordinate(piece.right(), l.cellSize);
+        const qint64 y0 = qMax<qint64>(0, cellCoordinate(piece.top(), l.cellSize));
+        const qint64 y1 = cellCoordinate(piece.bottom(), l.cellSize);
+        auto inPiece = [&piece](const Cluster &c) {
+            return c.position.x() >= piece.left() && c.position.x() <= piece.right()
+                    && c.position.y() >= piece.top() && c.position.y() <= piece.bottom();
+        };
+
+        // Fewer clusters than cells: scanning them all is cheaper
+        if ((x1 - x0 + 1) * (y1 - y0 + 1) > l.clusters.size()) {
+            for (int i = 0; i < l.clusters.size(); ++i) {
+                if (inPiece(l.clusters.at(i)))
+                    ids.append(i);
+            }
+            continue;
+        }
+        for (qint64 x = x0; x <= x1; ++x) {
+            auto it = std::lower_bound(l.cells.cbegin(), l.cells.cend(), cellKey(x, y0));
+            const quint64 last = cellKey(x, y1);
+            for (; it != l.cells.cend() && *it <= last; ++it) {
+                const int i = int(it - l.cells.cbegin());
+                if (inPiece(l.clusters.at(i)))
+                    ids.append(i);
+            }
+        }
+    }
+    return ids;
+}
+
+/*
+    Fills ids with the clusters in the viewport of map, and returns their level.
+    Without a Web Mercator projection, all the clusters of the level are returned.
+*/
+int QGeoClusterIndex::visibleClusters(const QGeoMap &map, QVector<int> *ids) const
+{
+    ids->clear();
+    const int level = levelForZoom(map.cameraData().zoomLevel());
+    if (isEmpty())
+        return level;
+
+    if (map.geoProjection().projectionType() != QGeoProjection::ProjectionWebMercator) {
+        ids->resize(levels_.at(level).clusters.size());
+        std::iota(ids->begin(), ids->end(), 0);
+        return level;
+    }
+
+    const QGeoProjectionWebMercator &p = static_cast<const QGeoProjectionWebMercator &>(map.geoProjection());
+    const QList<QDoubleVector2D> region = p.visibleGeometryExpanded();
+    if (region.isEmpty())
+        return level;
+    double minX = region.first().x(), maxX = minX;
+    double minY = region.first().y(), maxY = minY;
+    for (const QDoubleVector2D &v : region) {
+        minX = qMin(minX, v.x());
+        maxX = qMax(maxX, v.x());
+        minY = qMin(minY, v.y());
+        maxY = qMax(maxY, v.y());
+    }
+    *ids = clustersIn(level, QRectF(QPointF(minX, minY), QPointF(maxX, maxY)));
+    return level;
+}
+
+/*
+    Orders the clusters of level by grid cell, so that each cell is a contiguous range.
+*/
+void QGeoClusterIndex::sortLevel(Level &level) const
+{
+    const int count = level.clusters.size();
+    QVector<QPair<quint64, int> > order(count);
+    for (int i = 0; i < count; ++i)
+        order[i] = qMakePair(cellOf(level.clusters.at(i).position, level.cellSize), i);
+    std::sort(order.begin(), order.end());
+
+    QVector<Cluster> clusters(count);
+    level.cells.resize(count);
+    for (int i = 0; i < count; ++i) {
+        clusters[i] = level.clusters.at(order.at(i).second);
+        level.cells[i] = order.at(i).first;
+    }
+    level.clusters = clusters;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,112 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QGEOCLUSTERINDEX_P_H
+#define QGEOCLUSTERINDEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoMap;
+
+/*
+    Groups points into clusters for each integer zoom level, from the leaves, one per point,
+    up to the whole world at zoom level 0. The clusters of a level are made greedily of the
+    clusters of the level below that are closer than a radius, in pixels at that level, to
+    the first of them. They are kept sorted by grid cell, so that the clusters of a viewport
+    are found without visiting the others.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoClusterIndex
+{
+public:
+    struct Cluster {
+        QDoubleVector2D position; // in normalized mercator, weighted by the leaves
+        int count = 0;            // number of leaves
+        int row = -1;             // of the leaf, if count == 1
+        int firstChild = 0;       // in the children of the level
+        int childCount = 0;
+    };
+
+    QGeoClusterIndex();
+
+    void build(const QVector<QGeoCoordinate> &points, double radius,
+               int tileSize = 256, int maximumLevel = 20);
+    void clear();
+    bool isEmpty() const;
+
+    int levelCount() const;
+    int levelForZoom(double zoomLevel) const;
+    const Cluster &cluster(int level, int id) const;
+    QGeoCoordinate coordinate(int level, int id) const;
+    QVector<int> leaves(int level, int id) const;
+
+    QVector<int> clustersIn(int level, const QRectF &rect) const;
+    int visibleClusters(const QGeoMap &map, QVector<int> *ids) const;
+
+private:
+    struct Level {
+        double cellSize = 1.0;
+        QVector<Cluster> clusters;
+        QVector<quint64> cells; // sorted, one per cluster
+        QVector<int> children;  // ids in the level below
+    };
+
+    void sortLevel(Level &level) const;
+    void collectLeaves(int level, int id, QVector<int> *rows) const;
+
+    QVector<Level> levels_;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOCLUSTERINDEX_P_H
@@ -40,9 +40,13 @@
 #include "qgeomappingmanager_p.h"
 
 #include <QDir>
+#include <QSaveFile>
+#include <QDataStream>
 #include <QStandardPaths>
 #include <QMetaType>
 #include <QPixmap>
+#include <QThread>
+#include <QElapsedTimer>
 #include <QDebug>
 
 Q_DECLARE_METATYPE(QList<QGeoTileSpec>)
@@ -50,6 +54,11 @@ Q_DECLARE_METATYPE(QSet<QGeoTileSpec>)
 
 QT_BEGIN_NAMESPACE
 
+static const quint32 queueManifestMagic = 0x51475451; // "QGTQ"
+static const quint32 queueManifestVersion = 1;
+static const quint32 pinManifestMagic = 0x5147504e; // "QGPN"
+static const quint32 pinManifestVersion = 1;
+
 class QGeoCachedTileMemory
 {
 public:
@@ -63,6 +72,7 @@ public:
     QGeoFileTileCache *cache;
     QByteArray bytes;
     QString format;
+    QImage image;   // decoded, in the tile arena, when bytes is empty
 };
 
 void QCache3QTileEvictionPolicy::aboutToBeRemoved(const QGeoTileSpec &key, QSharedPointer<QGeoCachedTileDisk> obj)
@@ -88,8 +98,11 @@ QGeoCachedTileDisk::~QGeoCachedTileDisk()
 QGeoFileTileCache::QGeoFileTileCache(const QString &directory, QObject *parent)
     : QAbstractGeoTileCache(parent), directory_(directory), minTextureUsage_(0), extraTextureUsage_(0)
     ,costStrategyDisk_(ByteSize), costStrategyMemory_(ByteSize), costStrategyTexture_(ByteSize)
-    ,isDiskCostSet_(false), isMemoryCostSet_(false), isTextureCostSet_(false)
+    ,isDiskCostSet_(false), isMemoryCostSet_(false), isTextureCostSet_(false), diskStorage_(FileStorage)
+    ,asynchronousDecoding_(false), decodedMemoryCache_(false), bytesRead_(0), bytesWritten_(0)
 {
+    // leave one core to the GUI thread
+    decodePool_.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
 
 }
 
@@ -122,6 +135,15 @@ void QGeoFileTileCache::init()
     if (!directoryCreated)
         qWarning() << "Failed to create cache directory " << directory_;
 
+    if (diskStorage_ == PackStorage) {
+        packStore_.reset(new QGeoTilePackStore(directory_));
+        if (!packStore_->open()) {
+            qWarning() << "Falling back to one file per tile in" << directory_;
+            packStore_.reset();
+            diskStorage_ = FileStorage;
+        }
+    }
+
     // default values
     if (!isDiskCostSet_) { // If setMaxDiskUsage has not been called yet
         if (costStrategyDisk_ == ByteSize)
@@ -144,93 +166,267 @@ void QGeoFileTileCache::init()
             setExtraTextureUsage(30); // byte size of texture is >> compressed image, hence unitary cost should be lower
     }
 
+    loadPins();
     loadTiles();
 }
 
 void QGeoFileTileCache::loadTiles()
 {
-    QStringList formats;
-    formats << QLatin1String("*.*");
-
     QDir dir(directory_);
-    QStringList files = dir.entryList(formats, QDir::Files);
-#if 0 // workaround for QTBUG-60581
-    // Method:
-    // 1. read each queue file then, if each file exists, deserialize the data into the appropriate
-    // cache queue.
-    for (int i = 1; i<=4; i++) {
-        QString filename = dir.filePath(QString::fromLatin1("queue") + QString::number(i));
-        QFile file(filename);
-        if (!file.open(QIODevice::ReadOnly))
-            continue;
-        QList<QSharedPointer<QGeoCachedTileDisk> > queue;
-        QList<QGeoTileSpec> specs;
-        QList<int> costs;
-        while (!file.atEnd()) {
-            QByteArray line = file.readLine().trimmed();
-            QString filename = QString::fromLatin1(line.constData(), line.length());
-            if (dir.exists(filename)){
-                files.removeOne(filename);
-                QGeoTileSpec spec = filenameToTileSpec(filename);
-                if (spec.zoom() == -1)
-                    continue;
-                QSharedPointer<QGeoCachedTileDisk> tileDisk(new QGeoCachedTileDisk);
-                tileDisk->filename = dir.filePath(filename);
-                tileDisk->cache = this;
-                tileDisk->spec = spec;
-                QFileInfo fi(tileDisk->filename);
-                specs.append(spec);
-                queue.append(tileDisk);
-                if (costStrategyDisk_ == ByteSize)
-                    costs.append(fi.size());
-                else
-                    costs.append(1);
+    const QStringList files = diskTileNames();
 
-            }
-        }
+    // 1. restore the cache queues from the manifest written at shutdown. The manifest carries
+    // the costs, so the tiles listed in it do not need to be stat'ed.
+    const QSet<QString> restored = loadQueues(QSet<QString>(files.cbegin(), files.cend()));
 
-        diskCache_.deserializeQueue(i, specs, queue, costs);
-        file.close();
-    }
-#endif
     // 2. remaining tiles that aren't registered in a queue get pushed into cache here
-    // this is a backup, in case the queue manifest files get deleted or out of sync due to
+    // this is a backup, in case the queue manifest file gets deleted or out of sync due to
     // the application not closing down properly
     for (int i = 0; i < files.size(); ++i) {
+        if (restored.contains(files.at(i)))
+            continue;
         QGeoTileSpec spec = filenameToTileSpec(files.at(i));
         if (spec.zoom() == -1)
             continue;
         QString filename = dir.filePath(files.at(i));
         addToDiskCache(spec, filename);
     }
+
+    // the manifest may come from a session with a larger disk cache
+    diskCache_.rebalance();
 }
 
-QGeoFileTileCache::~QGeoFileTileCache()
+QString QGeoFileTileCache::queueManifestName()
 {
-#if 0 // workaround for QTBUG-60581
-    // write disk cache queues to disk
+    return QStringLiteral("queues");
+}
+
+/*
+    Restores the disk cache queues from the manifest written by saveQueues(), keeping only the
+    entries whose tiles are in \a files. Returns the names of the restored tiles.
+*/
+QSet<QString> QGeoFileTileCache::loadQueues(const QSet<QString> &files)
+{
+    QSet<QString> restored;
     QDir dir(directory_);
-    for (int i = 1; i<=4; i++) {
-        QString filename = dir.filePath(QString::fromLatin1("queue") + QString::number(i));
-        QFile file(filename);
-        if (!file.open(QIODevice::WriteOnly)){
-            qWarning() << "Unable to write tile cache file " << filename;
-            continue;
-        }
-        QList<QSharedPointer<QGeoCachedTileDisk> > queue;
-        diskCache_.serializeQueue(i, queue);
-        foreach (const QSharedPointer<QGeoCachedTileDisk> &tile, queue) {
-            if (tile.isNull())
+    QFile file(dir.filePath(queueManifestName()));
+    if (!file.open(QIODevice::ReadOnly))
+        return restored;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 costStrategy = -1;
+    stream >> magic >> version >> costStrategy;
+    // costs written with a different strategy are meaningless
+    if (stream.status() != QDataStream::Ok || magic != queueManifestMagic
+            || version != queueManifestVersion || costStrategy != costStrategyDisk_) {
+        return restored;
+    }
+
+    QList<QCache3QDiskNode> queues[4];
+    for (int i = 0; i < 4 && stream.status() == QDataStream::Ok; ++i) {
+        quint32 count = 0;
+        stream >> count;
+        for (quint32 j = 0; j < count && stream.status() == QDataStream::Ok; ++j) {
+            QString plugin;
+            QString name;
+            qint32 mapId, zoom, x, y, tileVersion, cost;
+            quint64 pop;
+            stream >> plugin >> mapId >> zoom >> x >> y >> tileVersion >> cost >> pop >> name;
+
+            const QGeoTileSpec spec(plugin, mapId, zoom, x, y, tileVersion);
+            QSharedPointer<QGeoCachedTileDisk> td;
+            if (pinned_.contains(spec)) // pinned since, stored separately
                 continue;
+            if (i < 3) { // queue 4 only holds the ghosts of evicted tiles
+                if (!files.contains(name) || restored.contains(name)
+                        || !(filenameToTileSpec(name) == spec)) {
+                    continue;
+                }
+                td.reset(new QGeoCachedTileDisk);
+                td->spec = spec;
+                td->filename = dir.filePath(name);
+                td->cache = this;
+                restored.insert(name);
+            }
+            queues[i].append({ spec, td, cost, pop });
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qWarning() << "Tile cache queue manifest" << file.fileName() << "is corrupted. Ignoring it.";
+        // the tiles are still on disk, they must not be evicted
+        for (int i = 0; i < 3; ++i) {
+            for (const QCache3QDiskNode &node : qAsConst(queues[i]))
+                node.value->cache = nullptr;
+        }
+        return QSet<QString>();
+    }
 
+    for (int i = 0; i < 4; ++i)
+        diskCache_.deserializeQueue(i + 1, queues[i]);
+    return restored;
+}
+
+/*
+    Writes the disk cache queues, with the costs and popularity of their tiles, to a manifest
+    in the cache directory. The manifest is written to a temporary file that is renamed over
+    the previous one only once complete.
+*/
+void QGeoFileTileCache::saveQueues() const
+{
+    if (directory_.isEmpty())
+        return;
+
+    QDir dir(directory_);
+    QSaveFile file(dir.filePath(queueManifestName()));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Unable to write tile cache file " << file.fileName();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << queueManifestMagic << queueManifestVersion << qint32(costStrategyDisk_);
+    for (int i = 1; i <= 4; ++i) {
+        QList<QCache3QDiskNode> queue;
+        diskCache_.serializeQueue(i, queue);
+        stream << quint32(queue.size());
+        for (const QCache3QDiskNode &node : qAsConst(queue)) {
             // we just want the filename here, not the full path
-            int index = tile->filename.lastIndexOf(QLatin1Char('/'));
-            QByteArray filename = tile->filename.mid(index + 1).toLatin1() + '\n';
-            file.write(filename);
+            const QString name = node.value ? QFileInfo(node.value->filename).fileName() : QString();
+            stream << node.key.plugin() << qint32(node.key.mapId()) << qint32(node.key.zoom())
+                   << qint32(node.key.x()) << qint32(node.key.y()) << qint32(node.key.version())
+                   << qint32(node.cost) << node.pop << name;
         }
-        file.close();
     }
-#endif
+
+    if (stream.status() != QDataStream::Ok || !file.commit())
+        qWarning() << "Unable to write tile cache file " << file.fileName();
+}
+
+QString QGeoFileTileCache::pinManifestName()
+{
+    return QStringLiteral("pinned");
+}
+
+/*
+    Reads the list of pinned tiles written by savePins().
+*/
+void QGeoFileTileCache::loadPins()
+{
+    QFile file(QDir(directory_).filePath(pinManifestName()));
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 count = 0;
+    stream >> magic >> version >> count;
+    if (stream.status() != QDataStream::Ok || magic != pinManifestMagic || version != pinManifestVersion) {
+        qWarning() << "Pinned tiles file" << file.fileName() << "is corrupted. Ignoring it.";
+        return;
+    }
+
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString plugin;
+        qint32 mapId, zoom, x, y, tileVersion;
+        stream >> plugin >> mapId >> zoom >> x >> y >> tileVersion;
+        if (stream.status() == QDataStream::Ok)
+            pinned_.insert(QGeoTileSpec(plugin, mapId, zoom, x, y, tileVersion));
+    }
+}
+
+/*
+    Writes the list of pinned tiles, stored or not, to the cache directory.
+*/
+void QGeoFileTileCache::savePins() const
+{
+    if (directory_.isEmpty())
+        return;
+
+    QDir dir(directory_);
+    if (pinned_.isEmpty()) {
+        dir.remove(pinManifestName());
+        return;
+    }
+
+    QSaveFile file(dir.filePath(pinManifestName()));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Unable to write tile cache file " << file.fileName();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << pinManifestMagic << pinManifestVersion << quint32(pinned_.size());
+    for (const QGeoTileSpec &spec : pinned_) {
+        stream << spec.plugin() << qint32(spec.mapId()) << qint32(spec.zoom())
+               << qint32(spec.x()) << qint32(spec.y()) << qint32(spec.version());
+    }
+
+    if (stream.status() != QDataStream::Ok || !file.commit())
+        qWarning() << "Unable to write tile cache file " << file.fileName();
+}
+
+void QGeoFileTileCache::pinTiles(const QSet<QGeoTileSpec> &tiles)
+{
+    bool changed = false;
+    for (const QGeoTileSpec &spec : tiles) {
+        if (pinned_.contains(spec))
+            continue;
+        pinned_.insert(spec);
+        changed = true;
+
+        // Take it out of the disk cache, leaving the data in place
+        QSharedPointer<QGeoCachedTileDisk> td = diskCache_.object(spec);
+        if (td) {
+            const QString filename = td->filename;
+            diskCache_.remove(spec);
+            addToDiskCache(spec, filename);
+        }
+    }
+    if (changed)
+        savePins();
+}
+
+void QGeoFileTileCache::unpinTiles(const QSet<QGeoTileSpec> &tiles)
+{
+    bool changed = false;
+    for (const QGeoTileSpec &spec : tiles) {
+        if (!pinned_.remove(spec))
+            continue;
+        changed = true;
+
+        QSharedPointer<QGeoCachedTileDisk> td = pinnedDisk_.take(spec);
+        if (td)
+            addToDiskCache(spec, td->filename);
+    }
+    if (changed) {
+        diskCache_.rebalance();
+        savePins();
+    }
+}
+
+bool QGeoFileTileCache::isTileStored(const QGeoTileSpec &spec) const
+{
+    return !diskTile(spec).isNull();
+}
+
+QGeoFileTileCache::~QGeoFileTileCache()
+{
+    // decoding jobs read from the disk storage
+    decodePool_.clear();
+    decodePool_.waitForDone();
+
+    // write disk cache queues to disk
+    saveQueues();
 }
 
 void QGeoFileTileCache::printStats()
@@ -240,6 +436,38 @@ void QGeoFileTileCache::printStats()
     diskCache_.printStats();
 }
 
+template <class Cache>
+static void fillLayerStatistics(QGeoTileCacheLayerStatistics *layer, const Cache &cache)
+{
+    layer->hits = cache.hitCount();
+    layer->misses = cache.missCount();
+    layer->inserts = cache.insertCount();
+    layer->evictions = cache.evictionCount();
+    layer->usage = cache.totalCost();
+    layer->maxUsage = cache.maxCost();
+}
+
+QGeoTileCacheStatistics QGeoFileTileCache::statistics() const
+{
+    QGeoTileCacheStatistics stats = decodeStatistics_;
+    fillLayerStatistics(&stats.texture, textureCache_);
+    fillLayerStatistics(&stats.memory, memoryCache_);
+    fillLayerStatistics(&stats.disk, diskCache_);
+    stats.disk.bytesRead = bytesRead_.loadRelaxed();
+    stats.disk.bytesWritten = bytesWritten_.loadRelaxed();
+    return stats;
+}
+
+void QGeoFileTileCache::resetStatistics()
+{
+    textureCache_.resetStats();
+    memoryCache_.resetStats();
+    diskCache_.resetStats();
+    bytesRead_.storeRelaxed(0);
+    bytesWritten_.storeRelaxed(0);
+    decodeStatistics_ = QGeoTileCacheStatistics();
+}
+
 void QGeoFileTileCache::setMaxDiskUsage(int diskUsage)
 {
     diskCache_.setMaxCost(diskUsage);
@@ -306,6 +534,12 @@ void QGeoFileTileCache::clearAll()
     textureCache_.clear();
     memoryCache_.clear();
     diskCache_.clear();
+    pinned_.clear();
+    pinnedDisk_.clear();
+    savePins();
+    tileArena_.trim();
+    if (packStore_)
+        packStore_->clear();
     QDir dir(directory_);
     dir.setNameFilters(QStringList() << QLatin1String("*-*-*-*.*"));
     dir.setFilter(QDir::Files);
@@ -325,20 +559,32 @@ void QGeoFileTileCache::clearMapId(const int mapId)
     for (const QGeoTileSpec &k : textureCache_.keys())
         if (k.mapId() == mapId)
             textureCache_.remove(k);
+    tileArena_.trim();
+    // the files are removed below
+    for (auto it = pinned_.begin(); it != pinned_.end(); ) {
+        if (it->mapId() == mapId) {
+            pinnedDisk_.remove(*it);
+            it = pinned_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    savePins();
 
     // TODO: It seems the cache leaves residues, like some tiles do not get picked up.
     // After the above calls, files that shouldnt be left behind are still on disk.
     // Do an additional pass and make sure what has to be deleted gets deleted.
     QDir dir(directory_);
-    QStringList formats;
-    formats << QLatin1String("*.*");
-    QStringList files = dir.entryList(formats, QDir::Files);
+    QStringList files = diskTileNames();
     qWarning() << "Old tile data detected. Cache eviction left out "<< files.size() << "tiles";
     for (const QString &tileFileName : files) {
         QGeoTileSpec spec = filenameToTileSpec(tileFileName);
         if (spec.mapId() != mapId)
             continue;
-        QFile::remove(dir.filePath(tileFileName));
+        if (packStore_)
+            packStore_->remove(tileFileName);
+        else
+            QFile::remove(dir.filePath(tileFileName));
     }
 }
 
@@ -372,6 +618,23 @@ QAbstractGeoTileCache::CostStrategy QGeoFileTileCache::costStrategyTexture() con
     return costStrategyTexture_;
 }
 
+/*
+    Selects how tiles are stored on disk. Has to be called before init().
+*/
+void QGeoFileTileCache::setDiskStorage(QGeoFileTileCache::DiskStorage storage)
+{
+    if (packStore_) {
+        qWarning() << "QGeoFileTileCache::setDiskStorage has to be called before init()";
+        return;
+    }
+    diskStorage_ = storage;
+}
+
+QGeoFileTileCache::DiskStorage QGeoFileTileCache::diskStorage() const
+{
+    return diskStorage_;
+}
+
 QSharedPointer<QGeoTileTexture> QGeoFileTileCache::get(const QGeoTileSpec &spec)
 {
     QSharedPointer<QGeoTileTexture> tt = getFromMemory(spec);
@@ -380,6 +643,149 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::get(const QGeoTileSpec &spec)
     return getFromDisk(spec);
 }
 
+/*
+    Like get(), but tiles that are not in the texture cache are read and decoded in
+    a thread pool when asynchronous decoding is enabled. The results are delivered
+    in batches through tilesDecoded().
+*/
+QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getAsync(const QGeoTileSpec &spec, bool *scheduled)
+{
+    *scheduled = false;
+    if (!asynchronousDecoding_)
+        return get(spec);
+
+    QSharedPointer<QGeoTileTexture> tt = textureCache_.object(spec);
+    if (tt)
+        return tt;
+
+    // Nothing to decode
+    QSharedPointer<QGeoCachedTileMemory> tm = memoryCache_.object(spec);
+    if (tm && !tm->image.isNull())
+        return addToTextureCache(spec, tm->image);
+
+    *scheduled = scheduleDecode(spec);
+    return QSharedPointer<QGeoTileTexture>();
+}
+
+QSharedPointer<QGeoTileTexture> QGeoFileTileCache::cachedTexture(const QGeoTileSpec &spec)
+{
+    return textureCache_.object(spec);
+}
+
+void QGeoFileTileCache::setAsynchronousDecoding(bool enabled)
+{
+    asynchronousDecoding_ = enabled;
+}
+
+bool QGeoFileTileCache::asynchronousDecoding() const
+{
+    return asynchronousDecoding_;
+}
+
+/*
+    When enabled, the memory cache keeps tiles decoded, in a slab arena, instead of
+    encoded. A tile that drops out of the texture cache but is still in the memory
+    cache is then put back without decoding it again or allocating new pixels.
+    With the ByteSize cost strategy, the memory cache size has to account for the
+    decoded size of the tiles.
+*/
+void QGeoFileTileCache::setDecodedMemoryCache(bool enabled)
+{
+    decodedMemoryCache_ = enabled;
+}
+
+bool QGeoFileTileCache::decodedMemoryCache() const
+{
+    return decodedMemoryCache_;
+}
+
+bool QGeoFileTileCache::scheduleDecode(const QGeoTileSpec &spec)
+{
+    if (pendingDecodes_.contains(spec))
+        return true;
+
+    // The caches are not thread-safe: look the tile up here, and only hand
+    // the bytes or the file name over to the worker.
+    QByteArray bytes;
+    QString filename;
+    QString format;
+    QSharedPointer<QGeoCachedTileMemory> tm = memoryCache_.object(spec);
+    if (tm) {
+        bytes = tm->bytes;
+        format = tm->format;
+    } else {
+        QSharedPointer<QGeoCachedTileDisk> td = diskTile(spec);
+        if (!td)
+            return false;
+        filename = td->filename;
+        format = QFileInfo(filename).suffix();
+    }
+
+    pendingDecodes_.insert(spec);
+    decodePool_.start(QRunnable::create([this, spec, bytes, filename, format]() {
+        const bool fromDisk = bytes.isEmpty();
+        const QByteArray data = fromDisk ? readDiskTile(filename) : bytes;
+
+        QElapsedTimer timer;
+        timer.start();
+        QImage image;
+        // Converting it here, instead of in each QSGTexture::bind()
+        if (image.loadFromData(data)
+                && image.format() != QImage::Format_RGB32
+                && image.format() != QImage::Format_ARGB32_Premultiplied) {
+            image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        }
+        const qint64 decodeTime = timer.nsecsElapsed() / 1000;
+
+        QMetaObject::invokeMethod(this, [this, spec, data, format, image, fromDisk, decodeTime]() {
+            decodeFinished(spec, data, format, image, fromDisk, decodeTime);
+        }, Qt::QueuedConnection);
+    }));
+    return true;
+}
+
+void QGeoFileTileCache::decodeFinished(const QGeoTileSpec &spec, const QByteArray &bytes,
+                                       const QString &format, const QImage &image, bool fromDisk,
+                                       qint64 decodeTime)
+{
+    pendingDecodes_.remove(spec);
+    if (!image.isNull())
+        decodeStatistics_.addDecodeTime(decodeTime);
+
+    // Deliver everything decoded until the next event loop iteration at once
+    if (decodedTiles_.isEmpty() && failedDecodes_.isEmpty())
+        QMetaObject::invokeMethod(this, &QGeoFileTileCache::flushDecodedTiles, Qt::QueuedConnection);
+
+    if (isTileBogus(bytes)) {
+        QSharedPointer<QGeoTileTexture> tt(new QGeoTileTexture);
+        tt->spec = spec;
+        decodedTiles_.append(tt);
+        return;
+    }
+
+    // This is a truly invalid image. The fetcher should try again.
+    if (image.isNull()) {
+        handleError(spec, QLatin1String("Problem with tile image"));
+        failedDecodes_.append(spec);
+        return;
+    }
+
+    if (fromDisk || decodedMemoryCache_)
+        decodedTiles_.append(addDecodedTile(spec, bytes, format, image));
+    else
+        decodedTiles_.append(addToTextureCache(spec, image));
+}
+
+void QGeoFileTileCache::flushDecodedTiles()
+{
+    const QList<QSharedPointer<QGeoTileTexture> > decoded = decodedTiles_;
+    const QList<QGeoTileSpec> failed = failedDecodes_;
+    decodedTiles_.clear();
+    failedDecodes_.clear();
+    if (!decoded.isEmpty() || !failed.isEmpty())
+        emit tilesDecoded(decoded, failed);
+}
+
 void QGeoFileTileCache::insert(const QGeoTileSpec &spec,
                            const QByteArray &bytes,
                            const QString &format,
@@ -469,13 +875,24 @@ QGeoTileSpec QGeoFileTileCache::filenameToTileSpecDefault(const QString &filenam
 
 void QGeoFileTileCache::evictFromDiskCache(QGeoCachedTileDisk *td)
 {
-    QFile::remove(td->filename);
+    if (td->cache && td->cache->packStore_)
+        td->cache->packStore_->remove(QFileInfo(td->filename).fileName());
+    else
+        QFile::remove(td->filename);
 }
 
 void QGeoFileTileCache::evictFromMemoryCache(QGeoCachedTileMemory * /* tm  */)
 {
 }
 
+QSharedPointer<QGeoCachedTileDisk> QGeoFileTileCache::diskTile(const QGeoTileSpec &spec) const
+{
+    QSharedPointer<QGeoCachedTileDisk> td = pinnedDisk_.value(spec);
+    if (td)
+        return td;
+    return diskCache_.object(spec);
+}
+
 QSharedPointer<QGeoCachedTileDisk> QGeoFileTileCache::addToDiskCache(const QGeoTileSpec &spec, const QString &filename)
 {
     QSharedPointer<QGeoCachedTileDisk> td(new QGeoCachedTileDisk);
@@ -483,11 +900,16 @@ QSharedPointer<QGeoCachedTileDisk> QGeoFileTileCache::addToDiskCache(const QGeoT
     td->filename = filename;
     td->cache = this;
 
-    int cost = 1;
-    if (costStrategyDisk_ == ByteSize) {
-        QFileInfo fi(filename);
-        cost = fi.size();
+    if (pinned_.contains(spec)) {
+        // never deletes the data when released
+        td->cache = nullptr;
+        pinnedDisk_.insert(spec, td);
+        return td;
     }
+
+    int cost = 1;
+    if (costStrategyDisk_ == ByteSize)
+        cost = diskTileSize(filename);
     diskCache_.insert(spec, td, cost);
     return td;
 }
@@ -499,17 +921,20 @@ bool QGeoFileTileCache::addToDiskCache(const QGeoTileSpec &spec, const QString &
     td->filename = filename;
     td->cache = this;
 
+    if (pinned_.contains(spec)) {
+        td->cache = nullptr;
+        if (!writeDiskTile(filename, bytes))
+            return false;
+        pinnedDisk_.insert(spec, td);
+        return true;
+    }
+
     int cost = 1;
     if (costStrategyDisk_ == ByteSize)
         cost = bytes.size();
 
-    if (diskCache_.insert(spec, td, cost)) {
-        QFile file(filename);
-        file.open(QIODevice::WriteOnly);
-        file.write(bytes);
-        file.close();
-        return true;
-    }
+    if (diskCache_.insert(spec, td, cost))
+        return writeDiskTile(filename, bytes);
     return false;
 }
 
@@ -530,6 +955,41 @@ void QGeoFileTileCache::addToMemoryCache(const QGeoTileSpec &spec, const QByteAr
     memoryCache_.insert(spec, tm, cost);
 }
 
+/*
+    Replaces the memory cache entry for \a spec with the decoded \a image, copied into
+    the tile arena. Returns the copy, which can go to the texture cache as well.
+*/
+QImage QGeoFileTileCache::addToMemoryCache(const QGeoTileSpec &spec, const QImage &image)
+{
+    QSharedPointer<QGeoCachedTileMemory> tm(new QGeoCachedTileMemory);
+    tm->spec = spec;
+    tm->cache = this;
+    tm->image = tileArena_.store(image);
+    if (tm->image.isNull())
+        return QImage();
+
+    int cost = 1;
+    if (costStrategyMemory_ == ByteSize)
+        cost = int(tm->image.sizeInBytes());
+    memoryCache_.insert(spec, tm, cost);
+    return tm->image;
+}
+
+// Caches a tile that was just decoded, in the memory cache and in the texture cache
+QSharedPointer<QGeoTileTexture> QGeoFileTileCache::addDecodedTile(const QGeoTileSpec &spec,
+                                                                  const QByteArray &bytes,
+                                                                  const QString &format,
+                                                                  const QImage &image)
+{
+    if (!decodedMemoryCache_) {
+        addToMemoryCache(spec, bytes, format);
+        return addToTextureCache(spec, image);
+    }
+
+    const QImage stored = addToMemoryCache(spec, image);
+    return addToTextureCache(spec, stored.isNull() ? image : stored);
+}
+
 QSharedPointer<QGeoTileTexture> QGeoFileTileCache::addToTextureCache(const QGeoTileSpec &spec, const QImage &image)
 {
     QSharedPointer<QGeoTileTexture> tt(new QGeoTileTexture);
@@ -552,12 +1012,20 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromMemory(const QGeoTileS
 
     QSharedPointer<QGeoCachedTileMemory> tm = memoryCache_.object(spec);
     if (tm) {
+        if (!tm->image.isNull())
+            return addToTextureCache(spec, tm->image);
+
+        QElapsedTimer timer;
+        timer.start();
         QImage image;
         if (!image.loadFromData(tm->bytes)) {
             handleError(spec, QLatin1String("Problem with tile image"));
             return QSharedPointer<QGeoTileTexture>(0);
         }
-        QSharedPointer<QGeoTileTexture> tt = addToTextureCache(spec, image);
+        decodeStatistics_.addDecodeTime(timer.nsecsElapsed() / 1000);
+        QSharedPointer<QGeoTileTexture> tt = decodedMemoryCache_
+                ? addDecodedTile(spec, tm->bytes, tm->format, image)
+                : addToTextureCache(spec, image);
         if (tt)
             return tt;
     }
@@ -566,13 +1034,10 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromMemory(const QGeoTileS
 
 QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromDisk(const QGeoTileSpec &spec)
 {
-    QSharedPointer<QGeoCachedTileDisk> td = diskCache_.object(spec);
+    QSharedPointer<QGeoCachedTileDisk> td = diskTile(spec);
     if (td) {
         const QString format = QFileInfo(td->filename).suffix();
-        QFile file(td->filename);
-        file.open(QIODevice::ReadOnly);
-        QByteArray bytes = file.readAll();
-        file.close();
+        QByteArray bytes = readDiskTile(td->filename);
 
         QImage image;
         // Some tiles from the servers could be valid images but the tile fetcher
@@ -586,6 +1051,8 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromDisk(const QGeoTileSpe
         }
 
         // This is a truly invalid image. The fetcher should try again.
+        QElapsedTimer timer;
+        timer.start();
         if (!image.loadFromData(bytes)) {
             handleError(spec, QLatin1String("Problem with tile image"));
             return QSharedPointer<QGeoTileTexture>(0);
@@ -594,9 +1061,9 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromDisk(const QGeoTileSpe
         // Converting it here, instead of in each QSGTexture::bind()
         if (image.format() != QImage::Format_RGB32 && image.format() != QImage::Format_ARGB32_Premultiplied)
             image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        decodeStatistics_.addDecodeTime(timer.nsecsElapsed() / 1000);
 
-        addToMemoryCache(spec, bytes, format);
-        QSharedPointer<QGeoTileTexture> tt = addToTextureCache(td->spec, image);
+        QSharedPointer<QGeoTileTexture> tt = addDecodedTile(td->spec, bytes, format, image);
         if (tt)
             return tt;
     }
@@ -626,4 +1093,64 @@ QString QGeoFileTileCache::directory() const
     return directory_;
 }
 
+/*
+    Returns the names, relative to directory(), of all the tiles stored on disk.
+*/
+QStringList QGeoFileTileCache::diskTileNames() const
+{
+    if (packStore_)
+        return packStore_->names();
+
+    QStringList formats;
+    formats << QLatin1String("*.*");
+    QDir dir(directory_);
+    return dir.entryList(formats, QDir::Files);
+}
+
+int QGeoFileTileCache::diskTileSize(const QString &filename) const
+{
+    if (packStore_)
+        return packStore_->size(QFileInfo(filename).fileName());
+    return QFileInfo(QDir(directory_), filename).size();
+}
+
+QDateTime QGeoFileTileCache::diskTileLastModified(const QString &filename) const
+{
+    if (packStore_)
+        return packStore_->lastModified(QFileInfo(filename).fileName());
+    return QFileInfo(QDir(directory_), filename).lastModified();
+}
+
+// Also called from the decoding threads
+QByteArray QGeoFileTileCache::readDiskTile(const QString &filename) const
+{
+    QByteArray bytes;
+    if (packStore_) {
+        bytes = packStore_->read(QFileInfo(filename).fileName());
+    } else {
+        QFile file(QDir(directory_).filePath(filename));
+        if (!file.open(QIODevice::ReadOnly))
+            return QByteArray();
+        bytes = file.readAll();
+    }
+    bytesRead_.fetchAndAddRelaxed(bytes.size());
+    return bytes;
+}
+
+bool QGeoFileTileCache::writeDiskTile(const QString &filename, const QByteArray &bytes)
+{
+    if (packStore_) {
+        if (!packStore_->write(QFileInfo(filename).fileName(), bytes))
+            return false;
+    } else {
+        QFile file(QDir(directory_).filePath(filename));
+        if (!file.open(QIODevice::WriteOnly))
+            return false;
+        file.write(bytes);
+        file.close();
+    }
+    bytesWritten_.fetchAndAddRelaxed(bytes.size());
+    return true;
+}
+
 QT_END_NAMESPACE
@@ -55,10 +55,14 @@
 #include <QSet>
 #include <QMutex>
 #include <QTimer>
+#include <QThreadPool>
+#include <QAtomicInteger>
 
 #include "qgeotilespec_p.h"
 #include "qgeotiledmappingmanagerengine_p.h"
 #include "qabstractgeotilecache_p.h"
+#include "qgeotilepackstore_p.h"
+#include "qgeotileslabarena_p.h"
 
 #include <QImage>
 
@@ -95,10 +99,17 @@ protected:
     void aboutToBeEvicted(const QGeoTileSpec &key, QSharedPointer<QGeoCachedTileDisk> obj);
 };
 
+typedef QCache3Q<QGeoTileSpec, QGeoCachedTileDisk, QCache3QTileEvictionPolicy>::SerializedNode QCache3QDiskNode;
+
 class Q_LOCATION_PRIVATE_EXPORT QGeoFileTileCache : public QAbstractGeoTileCache
 {
     Q_OBJECT
 public:
+    enum DiskStorage {
+        FileStorage,    // one file per tile
+        PackStorage     // all tiles in a single pack file, see QGeoTilePackStore
+    };
+
     QGeoFileTileCache(const QString &directory = QString(), QObject *parent = 0);
     ~QGeoFileTileCache();
 
@@ -123,9 +134,23 @@ public:
     CostStrategy costStrategyMemory() const override;
     void setCostStrategyTexture(CostStrategy costStrategy) override;
     CostStrategy costStrategyTexture() const override;
-
+    void setDiskStorage(DiskStorage storage);
+    DiskStorage diskStorage() const;
 
     QSharedPointer<QGeoTileTexture> get(const QGeoTileSpec &spec) override;
+    QSharedPointer<QGeoTileTexture> getAsync(const QGeoTileSpec &spec, bool *scheduled) override;
+    QSharedPointer<QGeoTileTexture> cachedTexture(const QGeoTileSpec &spec) override;
+    void setAsynchronousDecoding(bool enabled);
+    bool asynchronousDecoding() const;
+    void setDecodedMemoryCache(bool enabled);
+    bool decodedMemoryCache() const;
+
+    void pinTiles(const QSet<QGeoTileSpec> &tiles) override;
+    void unpinTiles(const QSet<QGeoTileSpec> &tiles) override;
+    bool isTileStored(const QGeoTileSpec &spec) const override;
+
+    QGeoTileCacheStatistics statistics() const override;
+    void resetStatistics() override;
 
     // can be called without a specific tileCache pointer
     static void evictFromDiskCache(QGeoCachedTileDisk *td);
@@ -143,15 +168,35 @@ protected:
     void init() override;
     void printStats() override;
     void loadTiles();
+    QSet<QString> loadQueues(const QSet<QString> &files);
+    void saveQueues() const;
+    static QString queueManifestName();
+    void loadPins();
+    void savePins() const;
+    static QString pinManifestName();
 
     QString directory() const;
 
+    QStringList diskTileNames() const;
+    int diskTileSize(const QString &filename) const;
+    QDateTime diskTileLastModified(const QString &filename) const;
+    QByteArray readDiskTile(const QString &filename) const;
+    bool writeDiskTile(const QString &filename, const QByteArray &bytes);
+
+    QSharedPointer<QGeoCachedTileDisk> diskTile(const QGeoTileSpec &spec) const;
     QSharedPointer<QGeoCachedTileDisk> addToDiskCache(const QGeoTileSpec &spec, const QString &filename);
     bool addToDiskCache(const QGeoTileSpec &spec, const QString &filename, const QByteArray &bytes);
     void addToMemoryCache(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format);
+    QImage addToMemoryCache(const QGeoTileSpec &spec, const QImage &image);
+    QSharedPointer<QGeoTileTexture> addDecodedTile(const QGeoTileSpec &spec, const QByteArray &bytes,
+                                                   const QString &format, const QImage &image);
     QSharedPointer<QGeoTileTexture> addToTextureCache(const QGeoTileSpec &spec, const QImage &image);
     QSharedPointer<QGeoTileTexture> getFromMemory(const QGeoTileSpec &spec);
     QSharedPointer<QGeoTileTexture> getFromDisk(const QGeoTileSpec &spec);
+    bool scheduleDecode(const QGeoTileSpec &spec);
+    void decodeFinished(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format,
+                        const QImage &image, bool fromDisk, qint64 decodeTime);
+    void flushDecodedTiles();
 
     virtual bool isTileBogus(const QByteArray &bytes) const;
     virtual QString tileSpecToFilename(const QGeoTileSpec &spec, const QString &format, const QString &directory) const;
@@ -171,6 +216,27 @@ protected:
     bool isDiskCostSet_;
     bool isMemoryCostSet_;
     bool isTextureCostSet_;
+    DiskStorage diskStorage_;
+    QScopedPointer<QGeoTilePackStore> packStore_;
+
+    // Pinned tiles are kept out of diskCache_, so that they are never evicted
+    QSet<QGeoTileSpec> pinned_;
+    QHash<QGeoTileSpec, QSharedPointer<QGeoCachedTileDisk> > pinnedDisk_;
+
+    bool asynchronousDecoding_;
+    QThreadPool decodePool_;
+    QSet<QGeoTileSpec> pendingDecodes_;
+    QList<QSharedPointer<QGeoTileTexture> > decodedTiles_;
+    QList<QGeoTileSpec> failedDecodes_;
+
+    // Decoded tiles in the memory cache share their pixels with the texture cache
+    bool decodedMemoryCache_;
+    QGeoTileSlabArena tileArena_;
+
+    // The disk tiles are also read by the decoding threads
+    mutable QAtomicInteger<qint64> bytesRead_;
+    QAtomicInteger<qint64> bytesWritten_;
+    QGeoTileCacheStatistics decodeStatistics_;
 };
 
 QT_END_NAMESPACE
@@ -152,6 +152,23 @@ bool QGeoMappingManager::isInitialized() const
     return d_ptr->engine->isInitialized();
 }
 
+/*!
+    Returns the runtime statistics of the engine, such as the hit and miss
+    counts of each tile cache layer. The keys depend on the engine.
+*/
+QVariantMap QGeoMappingManager::statistics() const
+{
+    return d_ptr->engine->statistics();
+}
+
+/*!
+    Resets the counters reported by statistics().
+*/
+void QGeoMappingManager::resetStatistics()
+{
+    d_ptr->engine->resetStatistics();
+}
+
 /*!
     Sets the locale to be used by the this manager to \a locale.
 
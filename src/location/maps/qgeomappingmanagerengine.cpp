@@ -179,6 +179,22 @@ bool QGeoMappingManagerEngine::isInitialized() const
     return d->initialized;
 }
 
+/*!
+    Returns engine specific runtime statistics, such as tile cache usage.
+    The default implementation returns an empty map.
+*/
+QVariantMap QGeoMappingManagerEngine::statistics() const
+{
+    return QVariantMap();
+}
+
+/*!
+    Resets the counters reported by statistics().
+*/
+void QGeoMappingManagerEngine::resetStatistics()
+{
+}
+
 /*!
     Sets the locale to be used by the this manager to \a locale.
 
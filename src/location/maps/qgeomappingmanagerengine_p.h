@@ -97,6 +97,9 @@ public:
 
     bool isInitialized() const;
 
+    virtual QVariantMap statistics() const;
+    virtual void resetStatistics();
+
 Q_SIGNALS:
     void initialized();
     void supportedMapTypesChanged();
@@ -0,0 +1,416 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeoofflineregionmanager_p.h"
+#include "qgeotiledmappingmanagerengine_p.h"
+#include "qabstractgeotilecache_p.h"
+#include "qgeocameratiles_p.h"
+#include "qgeocameratiles_p_p.h"
+#include "qgeocameracapabilities_p.h"
+
+#include <QtPositioning/QGeoShape>
+#include <QtPositioning/QGeoRectangle>
+#include <QtPositioning/QGeoCircle>
+#include <QtPositioning/QGeoPath>
+#include <QtPositioning/QGeoPolygon>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioning/private/qlocationutils_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+
+#include <QDebug>
+
+#include <algorithm>
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+typedef QVector<QDoubleVector2D> MercatorPolygon;
+
+static QDoubleVector2D toMercator(const QGeoCoordinate &coordinate)
+{
+    const double maxLatitude = QLocationUtils::mercatorMaxLatitude();
+    QGeoCoordinate c = coordinate;
+    c.setLatitude(qBound(-maxLatitude, c.latitude(), maxLatitude));
+    return QWebMercator::coordToMercator(c);
+}
+
+// Converts a ring to mercator, keeping consecutive points less than half a world apart,
+// so that rings crossing the dateline extend past x = 1 (or below x = 0).
+static MercatorPolygon toMercatorRing(const QList<QGeoCoordinate> &ring)
+{
+    MercatorPolygon result;
+    result.reserve(ring.size());
+    for (const QGeoCoordinate &c : ring) {
+        QDoubleVector2D p = toMercator(c);
+        if (!result.isEmpty()) {
+            const double previousX = result.last().x();
+            while (p.x() - previousX > 0.5)
+                p.setX(p.x() - 1.0);
+            while (p.x() - previousX < -0.5)
+                p.setX(p.x() + 1.0);
+        }
+        result.append(p);
+    }
+    return result;
+}
+
+// The area as polygons in mercator coordinates
+static QList<MercatorPolygon> areaPolygons(const QGeoShape &area)
+{
+    QList<MercatorPolygon> polygons;
+
+    switch (area.type()) {
+    case QGeoShape::PolygonType: {
+        const QGeoPolygon polygon(area);
+        // holes are not worth excluding
+        polygons.append(toMercatorRing(polygon.path()));
+        break;
+    }
+    case QGeoShape::CircleType: {
+        const QGeoCircle circle(area);
+        QList<QGeoCoordinate> ring;
+        const int segments = 64;
+        for (int i = 0; i < segments; ++i)
+            ring.append(circle.center().atDistanceAndAzimuth(circle.radius(), 360.0 * i / segments));
+        polygons.append(toMercatorRing(ring));
+        break;
+    }
+    case QGeoShape::PathType: {
+        // One quad per segment, grown by half the width of the path on both sides
+        const QGeoPath path(area);
+        const QList<QGeoCoordinate> &coordinates = path.path();
+        const double buffer = qMax(path.width() / 2.0, 1.0);
+        for (int i = 1; i < coordinates.size(); ++i) {
+            const MercatorPolygon segment = toMercatorRing({ coordinates.at(i - 1), coordinates.at(i) });
+            const QDoubleVector2D p1 = segment.at(0);
+            const QDoubleVector2D p2 = segment.at(1);
+
+            // meters to mercator units at the latitude of the segment
+            const double latitude = (coordinates.at(i - 1).latitude() + coordinates.at(i).latitude()) / 2.0;
+            const double cosLatitude = qMax(std::cos(qDegreesToRadians(latitude)), 1e-6);
+            const double offset = buffer / (QLocationUtils::earthMeanCircumference() * cosLatitude);
+
+            QDoubleVector2D direction = p2 - p1;
+            const double length = direction.length();
+            direction = length > 0.0 ? direction / length : QDoubleVector2D(1.0, 0.0);
+            const QDoubleVector2D normal(-direction.y() * offset, direction.x() * offset);
+            const QDoubleVector2D along = direction * offset;
+
+            polygons.append({ p1 - along + normal, p2 + along + normal,
+                              p2 + along - normal, p1 - along - normal });
+        }
+        break;
+    }
+    default: {
+        const QGeoRectangle rectangle = area.boundingGeoRectangle();
+        const QDoubleVector2D topLeft = toMercator(rectangle.topLeft());
+        QDoubleVector2D bottomRight = toMercator(rectangle.bottomRight());
+        if (bottomRight.x() < topLeft.x()) // crosses the dateline
+            bottomRight.setX(bottomRight.x() + 1.0);
+        if (qFuzzyCompare(rectangle.width(), 360.0))
+            bottomRight.setX(topLeft.x() + 1.0);
+        polygons.append({ topLeft, QDoubleVector2D(bottomRight.x(), topLeft.y()),
+                          bottomRight, QDoubleVector2D(topLeft.x(), bottomRight.y()) });
+        break;
+    }
+    }
+
+    return polygons;
+}
+
+/*
+    Returns the tiles covering \a area at each zoom level from \a minimumZoomLevel to
+    \a maximumZoomLevel. The tiles are found with QGeoCameraTiles, the same way as the
+    tiles covering the camera frustum.
+*/
+QSet<QGeoTileSpec> QGeoOfflineRegionManager::tilesForArea(const QGeoShape &area,
+                                                          int minimumZoomLevel, int maximumZoomLevel,
+                                                          const QString &pluginString,
+                                                          const QGeoMapType &mapType, int mapVersion)
+{
+    QSet<QGeoTileSpec> tiles;
+    if (!area.isValid())
+        return tiles;
+
+    const QList<MercatorPolygon> polygons = areaPolygons(area);
+
+    QGeoCameraTiles cameraTiles;
+    cameraTiles.setPluginString(pluginString);
+    cameraTiles.setMapType(mapType);
+    cameraTiles.setMapVersion(mapVersion);
+    QGeoCameraTilesPrivate *d = QGeoCameraTilesPrivate::get(&cameraTiles);
+
+    for (int z = qMax(0, minimumZoomLevel); z <= maximumZoomLevel && z < 31; ++z) {
+        d->m_intZoomLevel = z;
+        d->m_sideLength = 1 << z;
+        const double side = d->m_sideLength;
+
+        for (const MercatorPolygon &polygon : polygons) {
+            if (polygon.size() < 3)
+                continue;
+
+            double minX = polygon.first().x();
+            double maxX = minX;
+            for (const QDoubleVector2D &p : polygon) {
+                minX = qMin(minX, p.x());
+                maxX = qMax(maxX, p.x());
+            }
+            const double shift = std::floor(minX);
+
+            PolygonVector footprint;
+            footprint.reserve(polygon.size());
+            for (const QDoubleVector2D &p : polygon) {
+                const double x = qMin(p.x() - shift, minX - shift + 1.0);
+                footprint.append(QDoubleVector3D(x * side, qBound(0.0, p.y(), 1.0) * side, 0.0));
+            }
+
+            if (maxX - shift <= 1.0) {
+                tiles += d->tilesFromPolygon(footprint);
+                continue;
+            }
+
+            // Crosses the dateline: the part past it wraps around to x = 0
+            const QPair<PolygonVector, PolygonVector> parts = d->splitPolygonAtAxisValue(footprint, 0, side);
+            tiles += d->tilesFromPolygon(parts.first);
+            PolygonVector wrapped = parts.second;
+            for (QDoubleVector3D &p : wrapped)
+                p.setX(p.x() - side);
+            tiles += d->tilesFromPolygon(wrapped);
+        }
+    }
+
+    return tiles;
+}
+
+QGeoOfflineRegionManager::QGeoOfflineRegionManager(QGeoTiledMappingManagerEngine *engine, QObject *parent)
+    : QObject(parent), m_engine(engine), m_maxConcurrentRequests(8),
+      m_totalTiles(0), m_completedTiles(0), m_failedTiles(0)
+{
+    if (engine) {
+        connect(engine, &QGeoTiledMappingManagerEngine::tileFetched,
+                this, &QGeoOfflineRegionManager::tileFetched);
+        connect(engine, &QGeoTiledMappingManagerEngine::tileError,
+                this, &QGeoOfflineRegionManager::tileError);
+    }
+}
+
+QGeoOfflineRegionManager::~QGeoOfflineRegionManager()
+{
+    cancel();
+}
+
+QSet<QGeoTileSpec> QGeoOfflineRegionManager::engineTiles(const QGeoShape &area,
+                                                         int minimumZoomLevel, int maximumZoomLevel,
+                                                         const QGeoMapType &mapType) const
+{
+    // Tiles outside of the zoom range of the map type are never fetched
+    const QGeoCameraCapabilities capabilities = m_engine->cameraCapabilities(mapType.mapId());
+    if (capabilities.isValid()) {
+        minimumZoomLevel = qMax(minimumZoomLevel, static_cast<int>(std::ceil(capabilities.minimumZoomLevel())));
+        maximumZoomLevel = qMin(maximumZoomLevel, static_cast<int>(std::floor(capabilities.maximumZoomLevel())));
+    }
+
+    const QString pluginString = m_engine->managerName() + QLatin1Char('_')
+            + QString::number(m_engine->managerVersion());
+    return tilesForArea(area, minimumZoomLevel, maximumZoomLevel, pluginString, mapType,
+                        m_engine->tileVersion());
+}
+
+/*
+    Pins the tiles covering \a area from \a minimumZoomLevel to \a maximumZoomLevel in the
+    tile cache, and fetches the ones that are not stored yet. progress() is emitted as the
+    tiles arrive, and finished() once no tile is left to fetch.
+*/
+void QGeoOfflineRegionManager::download(const QGeoShape &area,
+                                        int minimumZoomLevel, int maximumZoomLevel,
+                                        const QGeoMapType &mapType)
+{
+    if (m_engine.isNull() || !m_engine->tileCache())
+        return;
+
+    QAbstractGeoTileCache *cache = m_engine->tileCache();
+    const QSet<QGeoTileSpec> tiles = engineTiles(area, minimumZoomLevel, maximumZoomLevel, mapType);
+    cache->pinTiles(tiles);
+
+    QList<QGeoTileSpec> missing;
+    for (const QGeoTileSpec &tile : tiles) {
+        if (m_wanted.contains(tile))
+            continue;
+        ++m_totalTiles;
+        if (cache->isTileStored(tile))
+            ++m_completedTiles;
+        else
+            missing.append(tile);
+    }
+
+    // Lower zoom levels first, they are few and already give an overview
+    std::sort(missing.begin(), missing.end(), [](const QGeoTileSpec &a, const QGeoTileSpec &b) {
+        if (a.zoom() != b.zoom())
+            return a.zoom() < b.zoom();
+        if (a.y() != b.y())
+            return a.y() < b.y();
+        return a.x() < b.x();
+    });
+    m_pending += missing;
+    m_wanted += QSet<QGeoTileSpec>(missing.cbegin(), missing.cend());
+
+    emit progress(m_completedTiles + m_failedTiles, m_totalTiles);
+    requestMoreTiles();
+    if (m_wanted.isEmpty()) // already stored, or nothing to download
+        emit finished();
+}
+
+/*
+    Releases the tiles covering \a area, so that they are evicted from the cache
+    like any other tile.
+*/
+void QGeoOfflineRegionManager::remove(const QGeoShape &area,
+                                      int minimumZoomLevel, int maximumZoomLevel,
+                                      const QGeoMapType &mapType)
+{
+    if (m_engine.isNull() || !m_engine->tileCache())
+        return;
+
+    m_engine->tileCache()->unpinTiles(engineTiles(area, minimumZoomLevel, maximumZoomLevel, mapType));
+}
+
+/*
+    Stops downloading. The tiles fetched so far stay pinned.
+*/
+void QGeoOfflineRegionManager::cancel()
+{
+    if (!m_engine.isNull() && !m_requested.isEmpty())
+        m_engine->updateRegionTileRequests(QSet<QGeoTileSpec>(), m_requested);
+
+    m_pending.clear();
+    m_requested.clear();
+    m_wanted.clear();
+    m_retries.clear();
+    m_totalTiles = 0;
+    m_completedTiles = 0;
+    m_failedTiles = 0;
+}
+
+void QGeoOfflineRegionManager::setMaxConcurrentRequests(int maxRequests)
+{
+    m_maxConcurrentRequests = qMax(1, maxRequests);
+    requestMoreTiles();
+}
+
+int QGeoOfflineRegionManager::maxConcurrentRequests() const
+{
+    return m_maxConcurrentRequests;
+}
+
+bool QGeoOfflineRegionManager::isActive() const
+{
+    return !m_wanted.isEmpty();
+}
+
+int QGeoOfflineRegionManager::totalTiles() const
+{
+    return m_totalTiles;
+}
+
+int QGeoOfflineRegionManager::completedTiles() const
+{
+    return m_completedTiles;
+}
+
+int QGeoOfflineRegionManager::failedTiles() const
+{
+    return m_failedTiles;
+}
+
+void QGeoOfflineRegionManager::requestMoreTiles()
+{
+    if (m_engine.isNull())
+        return;
+
+    QSet<QGeoTileSpec> tiles;
+    while (m_requested.size() < m_maxConcurrentRequests && !m_pending.isEmpty()) {
+        const QGeoTileSpec tile = m_pending.takeFirst();
+        m_requested.insert(tile);
+        tiles.insert(tile);
+    }
+
+    if (!tiles.isEmpty())
+        m_engine->updateRegionTileRequests(tiles, QSet<QGeoTileSpec>());
+}
+
+void QGeoOfflineRegionManager::tileFetched(const QGeoTileSpec &spec)
+{
+    if (!m_requested.remove(spec))
+        return;
+
+    m_wanted.remove(spec);
+    m_retries.remove(spec);
+    ++m_completedTiles;
+    emit progress(m_completedTiles + m_failedTiles, m_totalTiles);
+
+    requestMoreTiles();
+    if (m_wanted.isEmpty())
+        emit finished();
+}
+
+void QGeoOfflineRegionManager::tileError(const QGeoTileSpec &spec, const QString &errorString)
+{
+    if (!m_requested.remove(spec))
+        return;
+
+    // Try again once the other tiles are done
+    const int retries = m_retries.value(spec, 0);
+    if (retries < 2) {
+        m_retries.insert(spec, retries + 1);
+        m_pending.append(spec);
+    } else {
+        qWarning("QGeoOfflineRegionManager: Failed to fetch tile (%d,%d,%d): '%s'",
+                 spec.x(), spec.y(), spec.zoom(), qPrintable(errorString));
+        m_wanted.remove(spec);
+        m_retries.remove(spec);
+        ++m_failedTiles;
+        emit progress(m_completedTiles + m_failedTiles, m_totalTiles);
+    }
+
+    requestMoreTiles();
+    if (m_wanted.isEmpty())
+        emit finished();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,128 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QGEOOFFLINEREGIONMANAGER_P_H
+#define QGEOOFFLINEREGIONMANAGER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+
+#include <QObject>
+#include <QPointer>
+#include <QList>
+#include <QSet>
+#include <QHash>
+
+#include "qgeotilespec_p.h"
+#include "qgeomaptype_p.h"
+
+QT_BEGIN_NAMESPACE
+
+class QGeoShape;
+class QGeoTiledMappingManagerEngine;
+
+/*
+    Downloads the tiles covering an area, for a range of zoom levels, so that the area can be
+    shown without network access. The tiles are fetched through the engine's QGeoTileFetcher,
+    a few at a time, and pinned in the engine's tile cache so that they are never evicted.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoOfflineRegionManager : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QGeoOfflineRegionManager(QGeoTiledMappingManagerEngine *engine, QObject *parent = nullptr);
+    ~QGeoOfflineRegionManager();
+
+    static QSet<QGeoTileSpec> tilesForArea(const QGeoShape &area,
+                                           int minimumZoomLevel, int maximumZoomLevel,
+                                           const QString &pluginString, const QGeoMapType &mapType,
+                                           int mapVersion);
+
+    void download(const QGeoShape &area, int minimumZoomLevel, int maximumZoomLevel,
+                  const QGeoMapType &mapType);
+    void remove(const QGeoShape &area, int minimumZoomLevel, int maximumZoomLevel,
+                const QGeoMapType &mapType);
+    void cancel();
+
+    void setMaxConcurrentRequests(int maxRequests);
+    int maxConcurrentRequests() const;
+
+    bool isActive() const;
+    int totalTiles() const;
+    int completedTiles() const;
+    int failedTiles() const;
+
+Q_SIGNALS:
+    void progress(int completedTiles, int totalTiles);
+    void finished();
+
+private Q_SLOTS:
+    void tileFetched(const QGeoTileSpec &spec);
+    void tileError(const QGeoTileSpec &spec, const QString &errorString);
+
+private:
+    QSet<QGeoTileSpec> engineTiles(const QGeoShape &area, int minimumZoomLevel, int maximumZoomLevel,
+                                   const QGeoMapType &mapType) const;
+    void requestMoreTiles();
+
+    QPointer<QGeoTiledMappingManagerEngine> m_engine;
+    QList<QGeoTileSpec> m_pending;      // not requested yet
+    QSet<QGeoTileSpec> m_requested;     // being fetched
+    QSet<QGeoTileSpec> m_wanted;        // m_pending and m_requested
+    QHash<QGeoTileSpec, int> m_retries;
+    int m_maxConcurrentRequests;
+    int m_totalTiles;
+    int m_completedTiles;
+    int m_failedTiles;
+
+    Q_DISABLE_COPY(QGeoOfflineRegionManager)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOOFFLINEREGIONMANAGER_P_H
@@ -49,6 +49,10 @@
 
 QT_BEGIN_NAMESPACE
 #define PREFETCH_FRUSTUM_SCALE 2.0
+// How far ahead in time, in ms, the camera is extrapolated by PrefetchPredictive
+#define PREDICTIVE_PREFETCH_LOOKAHEAD 1000
+// Camera changes, in ms, used to estimate the camera velocity
+#define CAMERA_SAMPLE_WINDOW 500
 
 static const double invLog2 = 1.0 / std::log(2.0);
 
@@ -112,6 +116,22 @@ void QGeoTiledMap::updateTile(const QGeoTileSpec &spec)
     d->updateTile(spec);
 }
 
+void QGeoTiledMap::updateTileTextures(const QList<QSharedPointer<QGeoTileTexture> > &textures)
+{
+    Q_D(QGeoTiledMap);
+    d->updateTileTextures(textures);
+}
+
+/*
+    Returns how urgently \a spec is needed by this map, lower values being more urgent.
+    Used to order network requests.
+*/
+double QGeoTiledMap::tileRequestPriority(const QGeoTileSpec &spec) const
+{
+    Q_D(const QGeoTiledMap);
+    return d->tileRequestPriority(spec);
+}
+
 void QGeoTiledMap::setPrefetchStyle(QGeoTiledMap::PrefetchStyle style)
 {
     Q_D(QGeoTiledMap);
@@ -197,6 +217,7 @@ QGeoTiledMapPrivate::QGeoTiledMapPrivate(QGeoTiledMappingManagerEngine *engine)
       m_minZoomLevel(static_cast<int>(std::ceil(m_cameraCapabilities.minimumZoomLevel()))),
       m_prefetchStyle(QGeoTiledMap::PrefetchTwoNeighbourLayers)
 {
+    m_cameraClock.start();
     int tileSize = m_cameraCapabilities.tileSize();
     QString pluginString(engine->managerName() + QLatin1Char('_') + QString::number(engine->managerVersion()));
     m_visibleTiles->setTileSize(tileSize);
@@ -266,14 +287,38 @@ void QGeoTiledMapPrivate::prefetchTiles()
         }
             break;
 
+        case QGeoTiledMap::PrefetchPredictive:
+            tiles += predictedTiles();
+            break;
+
         default:
             break;
         }
 
-        m_tileRequests->requestTiles(tiles - m_mapScene->texturedTiles());
+        const QSet<QGeoTileSpec> textured = m_mapScene->texturedTiles();
+        m_tileRequests->requestTiles(m_visibleTiles->createTiles() - textured, tiles - textured);
     }
 }
 
+double QGeoTiledMapPrivate::tileRequestPriority(const QGeoTileSpec &spec) const
+{
+    // Tiles of the zoom level being shown come before the other layers,
+    // then tiles closer to the center of the viewport come first.
+    static const double zoomLevelPenalty = 64.0;
+
+    const QGeoCameraData camera = m_visibleTiles->cameraData();
+    const QDoubleVector2D center = QWebMercator::coordToMercator(camera.center());
+    const double side = 1 << spec.zoom();
+
+    // Distance in tiles of the requested zoom level, wrapping around the dateline
+    double dx = qAbs((spec.x() + 0.5) / side - center.x());
+    dx = qMin(dx, 1.0 - dx) * side;
+    const double dy = ((spec.y() + 0.5) / side - center.y()) * side;
+
+    const int zoomDistance = qAbs(spec.zoom() - static_cast<int>(std::floor(camera.zoomLevel())));
+    return zoomDistance * zoomLevelPenalty + std::sqrt(dx * dx + dy * dy);
+}
+
 QGeoMapType QGeoTiledMapPrivate::activeMapType()
 {
     return m_visibleTiles->activeMapType();
@@ -327,6 +372,7 @@ void QGeoTiledMapPrivate::changeCameraData(const QGeoCameraData &cameraData)
 
     m_visibleTiles->setCameraData(cam);
     m_mapScene->setCameraData(cam);
+    recordCameraSample(cam);
 
     updateScene();
     q->sgNodeChanged();
@@ -343,17 +389,108 @@ void QGeoTiledMapPrivate::updateScene()
     if (newTilesIntroduced && m_copyrightVisible)
         q->evaluateCopyrights(tiles);
 
+    // While the camera moves, also request the tiles it is heading to
+    QSet<QGeoTileSpec> predicted;
+    if (m_prefetchStyle == QGeoTiledMap::PrefetchPredictive)
+        predicted = predictedTiles();
+
     // don't request tiles that are already built and textured
+    const QSet<QGeoTileSpec> textured = m_mapScene->texturedTiles();
     QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > cachedTiles =
-            m_tileRequests->requestTiles(m_visibleTiles->createTiles() - m_mapScene->texturedTiles());
+            m_tileRequests->requestTiles(m_visibleTiles->createTiles() - textured, predicted - textured);
 
-    for (auto it = cachedTiles.cbegin(); it != cachedTiles.cend(); ++it)
-        m_mapScene->addTile(it.key(), it.value());
+    for (auto it = cachedTiles.cbegin(); it != cachedTiles.cend(); ++it) {
+        if (tiles.contains(it.key()))
+            m_mapScene->addTile(it.key(), it.value());
+    }
 
     if (!cachedTiles.isEmpty())
         emit q->sgNodeChanged();
 }
 
+void QGeoTiledMapPrivate::recordCameraSample(const QGeoCameraData &cameraData)
+{
+    const qint64 now = m_cameraClock.elapsed();
+    int expired = 0;
+    while (expired < m_cameraSamples.size() && now - m_cameraSamples.at(expired).time > CAMERA_SAMPLE_WINDOW)
+        ++expired;
+    m_cameraSamples.remove(0, expired);
+
+    CameraSample sample;
+    sample.time = now;
+    sample.center = QWebMercator::coordToMercator(cameraData.center());
+    sample.zoomLevel = cameraData.zoomLevel();
+    sample.bearing = cameraData.bearing();
+    m_cameraSamples.append(sample);
+}
+
+/*
+    Extrapolates the camera \a msecs in the future from its recent changes.
+    Returns false if the camera is not moving.
+*/
+bool QGeoTiledMapPrivate::predictCamera(int msecs, QGeoCameraData *cameraData) const
+{
+    if (m_cameraSamples.size() < 2)
+        return false;
+
+    const CameraSample &first = m_cameraSamples.first();
+    const CameraSample &last = m_cameraSamples.last();
+    const qint64 now = m_cameraClock.elapsed();
+    const double dt = last.time - first.time;
+    // The camera stopped, or too few samples to tell its velocity
+    if (now - last.time > CAMERA_SAMPLE_WINDOW / 2 || dt < 16)
+        return false;
+
+    const double factor = msecs / dt;
+
+    // Wrap around the dateline
+    double dx = last.center.x() - first.center.x();
+    if (dx > 0.5)
+        dx -= 1.0;
+    else if (dx < -0.5)
+        dx += 1.0;
+    const double dy = last.center.y() - first.center.y();
+
+    double dBearing = last.bearing - first.bearing;
+    if (dBearing > 180.0)
+        dBearing -= 360.0;
+    else if (dBearing < -180.0)
+        dBearing += 360.0;
+
+    const QDoubleVector2D move(dx * factor, dy * factor);
+    const double zoomMove = (last.zoomLevel - first.zoomLevel) * factor;
+    const double bearingMove = dBearing * factor;
+
+    // Not worth prefetching for less than a quarter of a tile
+    const double tilesMoved = move.length() * std::pow(2.0, last.zoomLevel);
+    if (tilesMoved < 0.25 && qAbs(zoomMove) < 0.25 && qAbs(bearingMove) < 5.0)
+        return false;
+
+    double x = last.center.x() + move.x();
+    x -= std::floor(x);
+    const double y = qBound(0.0, last.center.y() + move.y(), 1.0);
+    double bearing = std::fmod(last.bearing + bearingMove, 360.0);
+    if (bearing < 0.0)
+        bearing += 360.0;
+
+    *cameraData = m_visibleTiles->cameraData();
+    cameraData->setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(x, y)));
+    cameraData->setZoomLevel(qBound<double>(m_minZoomLevel, last.zoomLevel + zoomMove, m_maxZoomLevel));
+    cameraData->setBearing(bearing);
+    return true;
+}
+
+QSet<QGeoTileSpec> QGeoTiledMapPrivate::predictedTiles()
+{
+    QGeoCameraData camera;
+    if (!predictCamera(PREDICTIVE_PREFETCH_LOOKAHEAD, &camera))
+        return QSet<QGeoTileSpec>();
+
+    m_prefetchTiles->setCameraData(camera);
+    m_prefetchTiles->setViewExpansion(1.0);
+    return m_prefetchTiles->createTiles();
+}
+
 void QGeoTiledMapPrivate::setVisibleArea(const QRectF &visibleArea)
 {
     Q_Q(QGeoTiledMap);
@@ -437,7 +574,8 @@ void QGeoTiledMapPrivate::updateTile(const QGeoTileSpec &spec)
      Q_Q(QGeoTiledMap);
     // Only promote the texture up to GPU if it is visible
     if (m_visibleTiles->createTiles().contains(spec)){
-        QSharedPointer<QGeoTileTexture> tex = m_tileRequests->tileTexture(spec);
+        // may be decoded in the background, and then come back through updateTileTextures
+        QSharedPointer<QGeoTileTexture> tex = m_tileRequests->requestTileTexture(spec);
         if (!tex.isNull() && !tex->image.isNull()) {
             m_mapScene->addTile(spec, tex);
             emit q->sgNodeChanged();
@@ -445,6 +583,21 @@ void QGeoTiledMapPrivate::updateTile(const QGeoTileSpec &spec)
     }
 }
 
+void QGeoTiledMapPrivate::updateTileTextures(const QList<QSharedPointer<QGeoTileTexture> > &textures)
+{
+    Q_Q(QGeoTiledMap);
+    const QSet<QGeoTileSpec> &visibleTiles = m_visibleTiles->createTiles();
+    bool changed = false;
+    for (const QSharedPointer<QGeoTileTexture> &tex : textures) {
+        if (!tex->image.isNull() && visibleTiles.contains(tex->spec)) {
+            m_mapScene->addTile(tex->spec, tex);
+            changed = true;
+        }
+    }
+    if (changed)
+        emit q->sgNodeChanged();
+}
+
 QSGNode *QGeoTiledMapPrivate::updateSceneGraph(QSGNode *oldNode, QQuickWindow *window)
 {
     return m_mapScene->updateSceneGraph(oldNode, window);
@@ -49,6 +49,7 @@
 
 #include <QObject>
 #include <QString>
+#include <QSharedPointer>
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/private/qgeomap_p.h>
 #include <QtLocation/private/qgeocameradata_p.h>
@@ -75,13 +76,15 @@ class Q_LOCATION_PRIVATE_EXPORT QGeoTiledMap : public QGeoMap
     Q_OBJECT
     Q_DECLARE_PRIVATE(QGeoTiledMap)
 public:
-    enum PrefetchStyle { NoPrefetching, PrefetchNeighbourLayer, PrefetchTwoNeighbourLayers };
+    enum PrefetchStyle { NoPrefetching, PrefetchNeighbourLayer, PrefetchTwoNeighbourLayers, PrefetchPredictive };
     QGeoTiledMap(QGeoTiledMappingManagerEngine *engine, QObject *parent);
     virtual ~QGeoTiledMap();
 
     QAbstractGeoTileCache *tileCache();
     QGeoTileRequestManager *requestManager();
     void updateTile(const QGeoTileSpec &spec);
+    void updateTileTextures(const QList<QSharedPointer<QGeoTileTexture> > &textures);
+    double tileRequestPriority(const QGeoTileSpec &spec) const;
     void setPrefetchStyle(PrefetchStyle style);
 
     void prefetchData() override;
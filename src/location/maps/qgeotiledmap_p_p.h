@@ -54,6 +54,9 @@
 #include <QtPositioning/private/qdoublevector3d_p.h>
 #include <QtPositioning/private/qdoublevector2d_p.h>
 #include <QtCore/QPointer>
+#include <QtCore/QVector>
+#include <QtCore/QSet>
+#include <QtCore/QElapsedTimer>
 
 QT_BEGIN_NAMESPACE
 
@@ -78,7 +81,9 @@ public:
     QSGNode *updateSceneGraph(QSGNode *node, QQuickWindow *window);
 
     void updateTile(const QGeoTileSpec &spec);
+    void updateTileTextures(const QList<QSharedPointer<QGeoTileTexture> > &textures);
     void prefetchTiles();
+    double tileRequestPriority(const QGeoTileSpec &spec) const;
     QGeoMapType activeMapType();
     void onCameraCapabilitiesChanged(const QGeoCameraCapabilities &oldCameraCapabilities);
 
@@ -90,6 +95,9 @@ protected:
     void clearScene();
 
     void updateScene();
+    void recordCameraSample(const QGeoCameraData &cameraData);
+    bool predictCamera(int msecs, QGeoCameraData *cameraData) const;
+    QSet<QGeoTileSpec> predictedTiles();
 
     void setVisibleArea(const QRectF &visibleArea) override;
     QRectF visibleArea() const override;
@@ -108,6 +116,16 @@ protected:
     int m_maxZoomLevel;
     int m_minZoomLevel;
     QGeoTiledMap::PrefetchStyle m_prefetchStyle;
+
+    struct CameraSample
+    {
+        qint64 time;
+        QDoubleVector2D center; // mercator
+        double zoomLevel;
+        double bearing;
+    };
+    QVector<CameraSample> m_cameraSamples; // recent camera changes, used to predict the camera
+    QElapsedTimer m_cameraClock;
     Q_DISABLE_COPY(QGeoTiledMapPrivate)
 };
 
@@ -117,18 +117,34 @@ void QGeoTiledMappingManagerEngine::releaseMap(QGeoTiledMap *map)
         QSet<QGeoTiledMap *> maps = hi.value();
         if (maps.contains(map)) {
             maps.remove(map);
-            if (maps.isEmpty())
+            if (maps.isEmpty()) {
                 newTileHash.remove(hi.key());
-            else
+                d_ptr->prefetchRequests_.remove(hi.key());
+            } else
                 newTileHash.insert(hi.key(), maps);
         }
     }
     d_ptr->tileHash_ = newTileHash;
+
+    for (auto it = d_ptr->decodeHash_.begin(); it != d_ptr->decodeHash_.end(); ) {
+        it->remove(map);
+        if (it->isEmpty())
+            it = d_ptr->decodeHash_.erase(it);
+        else
+            ++it;
+    }
 }
 
+/*
+    Updates the tiles requested by \a map. Tiles in \a prefetchTiles are only
+    wanted speculatively: they are fetched after the tiles that \a map shows, and
+    only while the network is not busy with those. Tiles in \a tilesAdded that are
+    already requested are moved to the request class given by \a prefetchTiles.
+*/
 void QGeoTiledMappingManagerEngine::updateTileRequests(QGeoTiledMap *map,
                                             const QSet<QGeoTileSpec> &tilesAdded,
-                                            const QSet<QGeoTileSpec> &tilesRemoved)
+                                            const QSet<QGeoTileSpec> &tilesRemoved,
+                                            const QSet<QGeoTileSpec> &prefetchTiles)
 {
     Q_D(QGeoTiledMappingManagerEngine);
 
@@ -162,18 +178,36 @@ void QGeoTiledMappingManagerEngine::updateTileRequests(QGeoTiledMap *map,
         QSet<QGeoTiledMap *> mapSet = d->tileHash_.value(*rem);
         mapSet.remove(map);
         if (mapSet.isEmpty()) {
-            cancelTiles.insert(*rem);
+            // still wanted for an offline region
+            if (!d->regionTiles_.contains(*rem))
+                cancelTiles.insert(*rem);
             d->tileHash_.remove(*rem);
+            d->prefetchRequests_.remove(*rem);
         } else {
             d->tileHash_.insert(*rem, mapSet);
         }
     }
 
+    // A tile is fetched as a prefetch tile only if no map shows it
+    QSet<QGeoTileSpec> fetcherPrefetchTiles;
+
     add = tilesAdded.constBegin();
     for (; add != addEnd; ++add) {
         QSet<QGeoTiledMap *> mapSet = d->tileHash_.value(*add);
+        const bool prefetch = prefetchTiles.contains(*add);
         if (mapSet.isEmpty()) {
             reqTiles.insert(*add);
+            if (prefetch) {
+                d->prefetchRequests_.insert(*add);
+                fetcherPrefetchTiles.insert(*add);
+            }
+        } else if (!prefetch && d->prefetchRequests_.remove(*add)) {
+            reqTiles.insert(*add);
+        } else if (prefetch && mapSet.size() == 1 && mapSet.contains(map)
+                   && !d->prefetchRequests_.contains(*add)) {
+            d->prefetchRequests_.insert(*add);
+            reqTiles.insert(*add);
+            fetcherPrefetchTiles.insert(*add);
         }
         mapSet.insert(map);
         d->tileHash_.insert(*add, mapSet);
@@ -181,10 +215,56 @@ void QGeoTiledMappingManagerEngine::updateTileRequests(QGeoTiledMap *map,
 
     cancelTiles -= reqTiles;
 
-    QMetaObject::invokeMethod(d->fetcher_, "updateTileRequests",
-                              Qt::QueuedConnection,
-                              Q_ARG(QSet<QGeoTileSpec>, reqTiles),
-                              Q_ARG(QSet<QGeoTileSpec>, cancelTiles));
+    // Let the fetcher send the most urgent requests first
+    QHash<QGeoTileSpec, double> priorities;
+    priorities.reserve(reqTiles.size());
+    for (const QGeoTileSpec &tile : qAsConst(reqTiles))
+        priorities.insert(tile, map->tileRequestPriority(tile));
+
+    QGeoTileFetcher *fetcher = d->fetcher_;
+    QMetaObject::invokeMethod(fetcher, [fetcher, reqTiles, cancelTiles, priorities, fetcherPrefetchTiles]() {
+        fetcher->updateTileRequests(reqTiles, cancelTiles, priorities, fetcherPrefetchTiles);
+    }, Qt::QueuedConnection);
+}
+
+/*
+    Requests \a tilesAdded for an offline region, and stops fetching \a tilesRemoved unless
+    a map shows them. The tiles are stored in the disk cache, and tileFetched() or
+    tileError() are emitted for each of them.
+
+    Region tiles are fetched with the priority of prefetch tiles, so that they do not
+    delay the tiles of the maps.
+*/
+void QGeoTiledMappingManagerEngine::updateRegionTileRequests(const QSet<QGeoTileSpec> &tilesAdded,
+                                                             const QSet<QGeoTileSpec> &tilesRemoved)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+
+    QSet<QGeoTileSpec> reqTiles;
+    QSet<QGeoTileSpec> cancelTiles;
+
+    for (const QGeoTileSpec &tile : tilesRemoved) {
+        if (d->regionTiles_.remove(tile) && !d->tileHash_.contains(tile))
+            cancelTiles.insert(tile);
+    }
+
+    for (const QGeoTileSpec &tile : tilesAdded) {
+        if (d->regionTiles_.contains(tile))
+            continue;
+        d->regionTiles_.insert(tile);
+        // maps are already fetching it
+        if (!d->tileHash_.contains(tile))
+            reqTiles.insert(tile);
+    }
+    cancelTiles -= reqTiles;
+
+    if (reqTiles.isEmpty() && cancelTiles.isEmpty())
+        return;
+
+    QGeoTileFetcher *fetcher = d->fetcher_;
+    QMetaObject::invokeMethod(fetcher, [fetcher, reqTiles, cancelTiles]() {
+        fetcher->updateTileRequests(reqTiles, cancelTiles, QHash<QGeoTileSpec, double>(), reqTiles);
+    }, Qt::QueuedConnection);
 }
 
 void QGeoTiledMappingManagerEngine::engineTileFinished(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format)
@@ -207,13 +287,21 @@ void QGeoTiledMappingManagerEngine::engineTileFinished(const QGeoTileSpec &spec,
     }
 
     d->tileHash_.remove(spec);
-    tileCache()->insert(spec, bytes, format, d->cacheHint_);
+    d->prefetchRequests_.remove(spec);
+
+    // Offline regions must end up on disk
+    QAbstractGeoTileCache::CacheAreas areas = d->cacheHint_;
+    if (d->regionTiles_.remove(spec))
+        areas |= QAbstractGeoTileCache::DiskCache;
+    tileCache()->insert(spec, bytes, format, areas);
 
     map = maps.constBegin();
     mapEnd = maps.constEnd();
     for (; map != mapEnd; ++map) {
         (*map)->requestManager()->tileFetched(spec);
     }
+
+    emit tileFetched(spec);
 }
 
 void QGeoTiledMappingManagerEngine::engineTileError(const QGeoTileSpec &spec, const QString &errorString)
@@ -234,6 +322,8 @@ void QGeoTiledMappingManagerEngine::engineTileError(const QGeoTileSpec &spec, co
             d->mapHash_.insert(*map, tileSet);
     }
     d->tileHash_.remove(spec);
+    d->prefetchRequests_.remove(spec);
+    d->regionTiles_.remove(spec);
 
     for (map = maps.constBegin(); map != mapEnd; ++map) {
         (*map)->requestManager()->tileError(spec, errorString);
@@ -242,6 +332,36 @@ void QGeoTiledMappingManagerEngine::engineTileError(const QGeoTileSpec &spec, co
     emit tileError(spec, errorString);
 }
 
+void QGeoTiledMappingManagerEngine::engineTilesDecoded(const QList<QSharedPointer<QGeoTileTexture> > &textures,
+                                                       const QList<QGeoTileSpec> &failed)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+
+    // regroup the batch per map, so that each map updates its scene once
+    QHash<QGeoTiledMap *, QList<QSharedPointer<QGeoTileTexture> > > mapTextures;
+    QHash<QGeoTiledMap *, QList<QGeoTileSpec> > mapFailures;
+
+    for (const QSharedPointer<QGeoTileTexture> &texture : textures) {
+        const QSet<QGeoTiledMap *> maps = d->decodeHash_.take(texture->spec);
+        for (QGeoTiledMap *map : maps)
+            mapTextures[map].append(texture);
+    }
+    for (const QGeoTileSpec &spec : failed) {
+        const QSet<QGeoTiledMap *> maps = d->decodeHash_.take(spec);
+        for (QGeoTiledMap *map : maps)
+            mapFailures[map].append(spec);
+    }
+
+    QSet<QGeoTiledMap *> maps;
+    for (auto it = mapTextures.cbegin(); it != mapTextures.cend(); ++it)
+        maps.insert(it.key());
+    for (auto it = mapFailures.cbegin(); it != mapFailures.cend(); ++it)
+        maps.insert(it.key());
+
+    for (QGeoTiledMap *map : qAsConst(maps))
+        map->requestManager()->tilesDecoded(mapTextures.value(map), mapFailures.value(map));
+}
+
 void QGeoTiledMappingManagerEngine::setTileSize(const QSize &tileSize)
 {
     Q_D(QGeoTiledMappingManagerEngine);
@@ -275,6 +395,31 @@ QAbstractGeoTileCache::CacheAreas QGeoTiledMappingManagerEngine::cacheHint() con
     return d->cacheHint_;
 }
 
+QGeoTileCacheStatistics QGeoTiledMappingManagerEngine::tileCacheStatistics() const
+{
+    Q_D(const QGeoTiledMappingManagerEngine);
+    QGeoTileCacheStatistics stats;
+    if (d->tileCache_)
+        stats = d->tileCache_->statistics();
+    if (d->fetcher_) {
+        stats.queuedTiles = d->fetcher_->queuedTileCount();
+        stats.inFlightTiles = d->fetcher_->inFlightTileCount();
+    }
+    return stats;
+}
+
+QVariantMap QGeoTiledMappingManagerEngine::statistics() const
+{
+    return tileCacheStatistics().toVariantMap();
+}
+
+void QGeoTiledMappingManagerEngine::resetStatistics()
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+    if (d->tileCache_)
+        d->tileCache_->resetStatistics();
+}
+
 void QGeoTiledMappingManagerEngine::setCacheHint(QAbstractGeoTileCache::CacheAreas cacheHint)
 {
     Q_D(QGeoTiledMappingManagerEngine);
@@ -291,6 +436,8 @@ void QGeoTiledMappingManagerEngine::setTileCache(QAbstractGeoTileCache *cache)
     cache->setParent(this);
     d->tileCache_ = cache;
     d->tileCache_->init();
+    connect(d->tileCache_, &QAbstractGeoTileCache::tilesDecoded,
+            this, &QGeoTiledMappingManagerEngine::engineTilesDecoded);
 }
 
 QAbstractGeoTileCache *QGeoTiledMappingManagerEngine::tileCache()
@@ -302,6 +449,8 @@ QAbstractGeoTileCache *QGeoTiledMappingManagerEngine::tileCache()
             cacheDirectory = QAbstractGeoTileCache::baseLocationCacheDirectory() + managerName();
         d->tileCache_ = new QGeoFileTileCache(cacheDirectory);
         d->tileCache_->init();
+        connect(d->tileCache_, &QAbstractGeoTileCache::tilesDecoded,
+                this, &QGeoTiledMappingManagerEngine::engineTilesDecoded);
     }
     return d->tileCache_;
 }
@@ -311,6 +460,31 @@ QSharedPointer<QGeoTileTexture> QGeoTiledMappingManagerEngine::getTileTexture(co
     return d_ptr->tileCache_->get(spec);
 }
 
+/*
+    Returns the texture for \a spec if it is available without blocking. If the tile cache is
+    loading and decoding it in the background, \a pending is set to true and the texture is
+    delivered to \a map through QGeoTileRequestManager::tilesDecoded().
+*/
+QSharedPointer<QGeoTileTexture> QGeoTiledMappingManagerEngine::requestTileTexture(QGeoTiledMap *map,
+                                                                                  const QGeoTileSpec &spec,
+                                                                                  bool *pending)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+    QSharedPointer<QGeoTileTexture> texture = d->tileCache_->getAsync(spec, pending);
+    if (*pending)
+        d->decodeHash_[spec].insert(map);
+    return texture;
+}
+
+/*
+    Returns the texture for \a spec if the tile cache holds it decoded already, null otherwise.
+*/
+QSharedPointer<QGeoTileTexture> QGeoTiledMappingManagerEngine::cachedTileTexture(const QGeoTileSpec &spec)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+    return d->tileCache_->cachedTexture(spec);
+}
+
 /*******************************************************************************
 *******************************************************************************/
 
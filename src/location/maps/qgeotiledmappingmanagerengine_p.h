@@ -84,18 +84,30 @@ public:
 
     virtual void updateTileRequests(QGeoTiledMap *map,
                             const QSet<QGeoTileSpec> &tilesAdded,
-                            const QSet<QGeoTileSpec> &tilesRemoved);
+                            const QSet<QGeoTileSpec> &tilesRemoved,
+                            const QSet<QGeoTileSpec> &prefetchTiles = QSet<QGeoTileSpec>());
+    void updateRegionTileRequests(const QSet<QGeoTileSpec> &tilesAdded,
+                                  const QSet<QGeoTileSpec> &tilesRemoved);
 
     QAbstractGeoTileCache *tileCache();
     virtual QSharedPointer<QGeoTileTexture> getTileTexture(const QGeoTileSpec &spec);
+    QSharedPointer<QGeoTileTexture> requestTileTexture(QGeoTiledMap *map, const QGeoTileSpec &spec, bool *pending);
+    QSharedPointer<QGeoTileTexture> cachedTileTexture(const QGeoTileSpec &spec);
 
     QAbstractGeoTileCache::CacheAreas cacheHint() const;
 
+    QGeoTileCacheStatistics tileCacheStatistics() const;
+    QVariantMap statistics() const override;
+    void resetStatistics() override;
+
 protected Q_SLOTS:
     virtual void engineTileFinished(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format);
     virtual void engineTileError(const QGeoTileSpec &spec, const QString &errorString);
+    virtual void engineTilesDecoded(const QList<QSharedPointer<QGeoTileTexture> > &textures,
+                                    const QList<QGeoTileSpec> &failed);
 
 Q_SIGNALS:
+    void tileFetched(const QGeoTileSpec &spec);
     void tileError(const QGeoTileSpec &spec, const QString &errorString);
     void tileVersionChanged();
 
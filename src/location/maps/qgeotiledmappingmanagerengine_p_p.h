@@ -71,6 +71,9 @@ public:
     int m_tileVersion;
     QHash<QGeoTiledMap *, QSet<QGeoTileSpec> > mapHash_;
     QHash<QGeoTileSpec, QSet<QGeoTiledMap *> > tileHash_;
+    QHash<QGeoTileSpec, QSet<QGeoTiledMap *> > decodeHash_;
+    QSet<QGeoTileSpec> prefetchRequests_;
+    QSet<QGeoTileSpec> regionTiles_; // requested to fill offline regions, see QGeoOfflineRegionManager
     QAbstractGeoTileCache::CacheAreas cacheHint_;
     QAbstractGeoTileCache *tileCache_;
     QGeoTileFetcher *fetcher_;
@@ -71,6 +71,23 @@ QGeoTileFetcher::~QGeoTileFetcher()
 
 void QGeoTileFetcher::updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded,
                                                   const QSet<QGeoTileSpec> &tilesRemoved)
+{
+    updateTileRequests(tilesAdded, tilesRemoved, QHash<QGeoTileSpec, double>(), QSet<QGeoTileSpec>());
+}
+
+/*
+    Queues \a tilesAdded and cancels \a tilesRemoved. Queued tiles are fetched in
+    ascending order of their value in \a priorities; tiles without a priority come
+    first, in the order they were added. Queueing a tile again updates its priority.
+
+    Tiles in \a prefetchTiles are only fetched once no other tile is waiting, and
+    only use part of the requests allowed per host. A visible tile that finds its
+    host saturated takes the place of a running prefetch request.
+*/
+void QGeoTileFetcher::updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded,
+                                         const QSet<QGeoTileSpec> &tilesRemoved,
+                                         const QHash<QGeoTileSpec, double> &priorities,
+                                         const QSet<QGeoTileSpec> &prefetchTiles)
 {
     Q_D(QGeoTileFetcher);
 
@@ -78,12 +95,56 @@ void QGeoTileFetcher::updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded,
 
     cancelTileRequests(tilesRemoved);
 
-    std::copy(tilesAdded.cbegin(), tilesAdded.cend(), std::back_inserter(d->queue_));
+    for (const QGeoTileSpec &tile : tilesAdded) {
+        const double priority = priorities.value(tile, 0.0);
+        const bool prefetch = prefetchTiles.contains(tile);
+        if (!d->invmap_.contains(tile))
+            d->enqueue(tile, priority, prefetch);
+        else if (!prefetch)
+            d->prefetchInFlight_.remove(tile);
+        else
+            d->prefetchInFlight_.insert(tile, priority);
+    }
 
-    if (d->enabled_ && initialized() && !d->queue_.isEmpty() && !d->timer_.isActive())
+    if (d->enabled_ && initialized() && d->hasQueuedTiles() && !d->timer_.isActive())
         d->timer_.start(0, this);
 }
 
+/*
+    Sets the maximum number of requests that can be in flight at the same time for each
+    host returned by tileHost(). Further tiles stay queued, so that they can still be
+    reordered or cancelled cheaply, until a running request finishes.
+*/
+void QGeoTileFetcher::setMaxRequestsPerHost(int maxRequests)
+{
+    Q_D(QGeoTileFetcher);
+
+    QMutexLocker ml(&d->queueMutex_);
+    d->maxRequestsPerHost_ = qMax(1, maxRequests);
+    if (d->enabled_ && d->hasQueuedTiles() && !d->timer_.isActive())
+        d->timer_.start(0, this);
+}
+
+int QGeoTileFetcher::maxRequestsPerHost() const
+{
+    Q_D(const QGeoTileFetcher);
+    return d->maxRequestsPerHost_;
+}
+
+int QGeoTileFetcher::queuedTileCount() const
+{
+    Q_D(const QGeoTileFetcher);
+    QMutexLocker ml(&d->queueMutex_);
+    return d->queued_.size();
+}
+
+int QGeoTileFetcher::inFlightTileCount() const
+{
+    Q_D(const QGeoTileFetcher);
+    QMutexLocker ml(&d->queueMutex_);
+    return d->invmap_.size();
+}
+
 void QGeoTileFetcher::cancelTileRequests(const QSet<QGeoTileSpec> &tiles)
 {
     Q_D(QGeoTileFetcher);
@@ -96,52 +157,80 @@ void QGeoTileFetcher::cancelTileRequests(const QSet<QGeoTileSpec> &tiles)
         QGeoTiledMapReply *reply = d->invmap_.value(*tile, 0);
         if (reply) {
             d->invmap_.remove(*tile);
+            d->releaseHost(*tile);
             reply->abort();
             if (reply->isFinished())
                 reply->deleteLater();
         }
-        d->queue_.removeAll(*tile);
+        d->cancel(*tile);
     }
 }
 
-void QGeoTileFetcher::requestNextTile()
+/*
+    Sends as many queued requests as the per-host limit allows, most urgent first.
+    A whole batch of tiles is dispatched in a single pass.
+*/
+void QGeoTileFetcher::requestNextTiles()
 {
     Q_D(QGeoTileFetcher);
 
     QMutexLocker ml(&d->queueMutex_);
 
-    if (!d->enabled_)
-        return;
-
-    if (d->queue_.isEmpty())
-        return;
-
-    QGeoTileSpec ts = d->queue_.takeFirst();
-    if (d->queue_.isEmpty())
-        d->timer_.stop();
-
-    // Check against min/max zoom to prevent sending requests for not existing objects
-    const QGeoCameraCapabilities & cameraCaps = d->engine_->cameraCapabilities(ts.mapId());
-    // the ZL in QGeoTileSpec is relative to the native tile size of the provider.
-    // It gets denormalized in QGeoTiledMap.
-    if (ts.zoom() < cameraCaps.minimumZoomLevel() || ts.zoom() > cameraCaps.maximumZoomLevel() || !fetchingEnabled())
-        return;
+    // Restarted by updateTileRequests() or when a running request finishes
+    d->timer_.stop();
 
-    QGeoTiledMapReply *reply = getTileImage(ts);
-    if (!reply)
+    if (!d->enabled_)
         return;
 
-    if (reply->isFinished()) {
-        handleReply(reply, ts);
-    } else {
-        connect(reply,
-                SIGNAL(finished()),
-                this,
-                SLOT(finished()),
-                Qt::QueuedConnection);
-
-        d->invmap_.insert(ts, reply);
+    // Tiles whose host is saturated. Give up scanning after a while, the queue is
+    // likely made of such tiles only.
+    QVector<QGeoTileFetcherPrivate::QueuedTile> deferred;
+    int consecutiveDeferred = 0;
+
+    QGeoTileFetcherPrivate::QueuedTile next;
+    while (consecutiveDeferred < 64 && d->dequeue(&next)) {
+        const QGeoTileSpec &ts = next.spec;
+
+        // Check against min/max zoom to prevent sending requests for not existing objects
+        const QGeoCameraCapabilities & cameraCaps = d->engine_->cameraCapabilities(ts.mapId());
+        // the ZL in QGeoTileSpec is relative to the native tile size of the provider.
+        // It gets denormalized in QGeoTiledMap.
+        if (ts.zoom() < cameraCaps.minimumZoomLevel() || ts.zoom() > cameraCaps.maximumZoomLevel() || !fetchingEnabled())
+            continue;
+
+        const QString host = tileHost(ts);
+        const int limit = next.prefetch ? d->maxPrefetchRequestsPerHost() : d->maxRequestsPerHost_;
+        if (d->inFlight_.value(host, 0) >= limit
+                && (next.prefetch || !d->preemptPrefetchRequest(host))) {
+            deferred.append(next);
+            ++consecutiveDeferred;
+            continue;
+        }
+        consecutiveDeferred = 0;
+
+        QGeoTiledMapReply *reply = getTileImage(ts);
+        if (!reply)
+            continue;
+
+        if (reply->isFinished()) {
+            handleReply(reply, ts);
+        } else {
+            connect(reply,
+                    SIGNAL(finished()),
+                    this,
+                    SLOT(finished()),
+                    Qt::QueuedConnection);
+
+            d->invmap_.insert(ts, reply);
+            d->replyHosts_.insert(ts, host);
+            ++d->inFlight_[host];
+            if (next.prefetch)
+                d->prefetchInFlight_.insert(ts, next.priority);
+        }
     }
+
+    for (const QGeoTileFetcherPrivate::QueuedTile &tile : qAsConst(deferred))
+        d->requeue(tile);
 }
 
 void QGeoTileFetcher::finished()
@@ -156,12 +245,18 @@ void QGeoTileFetcher::finished()
 
     QGeoTileSpec spec = reply->tileSpec();
 
-    if (!d->invmap_.contains(spec)) {
+    // Cancelled, possibly requested again since then
+    if (d->invmap_.value(spec, 0) != reply) {
         reply->deleteLater();
         return;
     }
 
     d->invmap_.remove(spec);
+    d->releaseHost(spec);
+
+    // A slot is free again
+    if (d->enabled_ && d->hasQueuedTiles() && !d->timer_.isActive())
+        d->timer_.start(0, this);
 
     handleReply(reply, spec);
 }
@@ -175,13 +270,13 @@ void QGeoTileFetcher::timerEvent(QTimerEvent *event)
     }
 
     QMutexLocker ml(&d->queueMutex_);
-    if (d->queue_.isEmpty() || !initialized()) {
+    if (!d->hasQueuedTiles() || !initialized()) {
         d->timer_.stop();
         return;
     }
     ml.unlock();
 
-    requestNextTile();
+    requestNextTiles();
 }
 
 bool QGeoTileFetcher::initialized() const
@@ -194,6 +289,16 @@ bool QGeoTileFetcher::fetchingEnabled() const
     return true;
 }
 
+/*
+    Returns the host serving \a spec. The number of concurrent requests is limited
+    per host. The default implementation puts all tiles on the same host.
+*/
+QString QGeoTileFetcher::tileHost(const QGeoTileSpec &spec) const
+{
+    Q_UNUSED(spec);
+    return QString();
+}
+
 void QGeoTileFetcher::handleReply(QGeoTiledMapReply *reply, const QGeoTileSpec &spec)
 {
     Q_D(QGeoTileFetcher);
@@ -216,7 +321,7 @@ void QGeoTileFetcher::handleReply(QGeoTiledMapReply *reply, const QGeoTileSpec &
 *******************************************************************************/
 
 QGeoTileFetcherPrivate::QGeoTileFetcherPrivate()
-:   QObjectPrivate(), enabled_(false), engine_(0)
+:   QObjectPrivate(), enabled_(false), sequence_(0), maxRequestsPerHost_(6), engine_(0)
 {
 }
 
@@ -224,4 +329,106 @@ QGeoTileFetcherPrivate::~QGeoTileFetcherPrivate()
 {
 }
 
+static inline bool queuedAfter(const QGeoTileFetcherPrivate::QueuedTile &a,
+                               const QGeoTileFetcherPrivate::QueuedTile &b)
+{
+    if (a.prefetch != b.prefetch)
+        return a.prefetch;
+    if (a.priority != b.priority)
+        return a.priority > b.priority;
+    return a.sequence > b.sequence;
+}
+
+bool QGeoTileFetcherPrivate::hasQueuedTiles() const
+{
+    return !queued_.isEmpty();
+}
+
+void QGeoTileFetcherPrivate::enqueue(const QGeoTileSpec &spec, double priority, bool prefetch)
+{
+    // Supersedes any previous entry for the same tile
+    requeue(QueuedTile{ prefetch, priority, ++sequence_, spec });
+}
+
+void QGeoTileFetcherPrivate::requeue(const QueuedTile &tile)
+{
+    queued_.insert(tile.spec, tile.sequence);
+    queue_.append(tile);
+    std::push_heap(queue_.begin(), queue_.end(), queuedAfter);
+
+    if (queue_.size() > 2 * queued_.size() + 64)
+        compactQueue();
+}
+
+bool QGeoTileFetcherPrivate::dequeue(QueuedTile *tile)
+{
+    while (!queue_.isEmpty()) {
+        std::pop_heap(queue_.begin(), queue_.end(), queuedAfter);
+        const QueuedTile top = queue_.takeLast();
+        const auto it = queued_.find(top.spec);
+        if (it != queued_.end() && it.value() == top.sequence) {
+            queued_.erase(it);
+            *tile = top;
+            return true;
+        }
+    }
+    return false;
+}
+
+void QGeoTileFetcherPrivate::cancel(const QGeoTileSpec &spec)
+{
+    // The heap entry goes stale and is dropped later
+    queued_.remove(spec);
+    if (queued_.isEmpty())
+        queue_.clear();
+}
+
+void QGeoTileFetcherPrivate::compactQueue()
+{
+    QVector<QueuedTile> live;
+    live.reserve(queued_.size());
+    for (const QueuedTile &tile : qAsConst(queue_)) {
+        if (queued_.value(tile.spec, 0) == tile.sequence)
+            live.append(tile);
+    }
+    queue_.swap(live);
+    std::make_heap(queue_.begin(), queue_.end(), queuedAfter);
+}
+
+void QGeoTileFetcherPrivate::releaseHost(const QGeoTileSpec &spec)
+{
+    prefetchInFlight_.remove(spec);
+    const auto it = inFlight_.find(replyHosts_.take(spec));
+    if (it != inFlight_.end() && --it.value() <= 0)
+        inFlight_.erase(it);
+}
+
+// Keep part of the window free, so that tiles coming into view do not wait behind prefetching
+int QGeoTileFetcherPrivate::maxPrefetchRequestsPerHost() const
+{
+    return qMax(1, maxRequestsPerHost_ / 2);
+}
+
+// Aborts a running prefetch request to \a host, and queues its tile again.
+bool QGeoTileFetcherPrivate::preemptPrefetchRequest(const QString &host)
+{
+    for (auto it = prefetchInFlight_.cbegin(); it != prefetchInFlight_.cend(); ++it) {
+        if (replyHosts_.value(it.key()) != host)
+            continue;
+
+        const QGeoTileSpec spec = it.key();
+        const double priority = it.value();
+        QGeoTiledMapReply *reply = invmap_.take(spec);
+        releaseHost(spec);
+        if (reply) {
+            reply->abort();
+            if (reply->isFinished())
+                reply->deleteLater();
+        }
+        enqueue(spec, priority, true);
+        return true;
+    }
+    return false;
+}
+
 QT_END_NAMESPACE
@@ -49,6 +49,7 @@
 //
 
 #include <QObject>
+#include <QHash>
 #include <QtLocation/private/qlocationglobal_p.h>
 #include "qgeomaptype_p.h"
 #include "qgeotiledmappingmanagerengine_p.h"
@@ -71,12 +72,22 @@ public:
     QGeoTileFetcher(QGeoMappingManagerEngine *parent);
     virtual ~QGeoTileFetcher();
 
+    void updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded, const QSet<QGeoTileSpec> &tilesRemoved,
+                            const QHash<QGeoTileSpec, double> &priorities,
+                            const QSet<QGeoTileSpec> &prefetchTiles);
+
+    void setMaxRequestsPerHost(int maxRequests);
+    int maxRequestsPerHost() const;
+
+    int queuedTileCount() const;
+    int inFlightTileCount() const;
+
 public Q_SLOTS:
     void updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded, const QSet<QGeoTileSpec> &tilesRemoved);
 
 private Q_SLOTS:
     void cancelTileRequests(const QSet<QGeoTileSpec> &tiles);
-    void requestNextTile();
+    void requestNextTiles();
     void finished();
 
 Q_SIGNALS:
@@ -90,6 +101,7 @@ protected:
     QAbstractGeoTileCache::CacheAreas cacheHint() const;
     virtual bool initialized() const;
     virtual bool fetchingEnabled() const;
+    virtual QString tileHost(const QGeoTileSpec &spec) const;
 
 private:
 
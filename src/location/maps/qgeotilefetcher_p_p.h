@@ -59,11 +59,12 @@
 #include <QMutex>
 #include <QMutexLocker>
 #include <QHash>
+#include <QVector>
 #include "qgeomaptype_p.h"
+#include "qgeotilespec_p.h"
 
 QT_BEGIN_NAMESPACE
 
-class QGeoTileSpec;
 class QGeoTiledMapReply;
 class QGeoMappingManagerEngine;
 
@@ -74,10 +75,36 @@ public:
     QGeoTileFetcherPrivate();
     virtual ~QGeoTileFetcherPrivate();
 
+    struct QueuedTile
+    {
+        bool prefetch;
+        double priority;
+        quint64 sequence;
+        QGeoTileSpec spec;
+    };
+
+    bool hasQueuedTiles() const;
+    void enqueue(const QGeoTileSpec &spec, double priority, bool prefetch);
+    void requeue(const QueuedTile &tile);
+    bool dequeue(QueuedTile *tile);
+    void cancel(const QGeoTileSpec &spec);
+    void compactQueue();
+    void releaseHost(const QGeoTileSpec &spec);
+    int maxPrefetchRequestsPerHost() const;
+    bool preemptPrefetchRequest(const QString &host);
+
     bool enabled_;
     QBasicTimer timer_;
-    QMutex queueMutex_;
-    QList<QGeoTileSpec> queue_;
+    mutable QMutex queueMutex_;
+    // Binary heap ordered by (prefetch, priority, sequence). Cancelled or re-prioritized
+    // tiles leave stale entries behind, which are skipped when popped.
+    QVector<QueuedTile> queue_;
+    QHash<QGeoTileSpec, quint64> queued_; // live entries: spec -> sequence
+    quint64 sequence_;
+    int maxRequestsPerHost_;
+    QHash<QString, int> inFlight_;
+    QHash<QGeoTileSpec, QString> replyHosts_;
+    QHash<QGeoTileSpec, double> prefetchInFlight_; // running prefetch requests -> priority
     QHash<QGeoTileSpec, QGeoTiledMapReply *> invmap_;
     QGeoMappingManagerEngine *engine_;
 
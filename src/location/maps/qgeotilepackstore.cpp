@@ -0,0 +1,498 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "qgeotilepackstore_p.h"
+
+#include <QDir>
+#include <QSaveFile>
+#include <QVector>
+#include <QPair>
+#include <QRandomGenerator>
+#include <QtEndian>
+#include <QDebug>
+
+#include <algorithm>
+#include <mutex>
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+const char indexMagic[4] = { 'Q', 'G', 'T', 'I' };
+const char packMagic[4] = { 'Q', 'G', 'T', 'P' };
+const quint32 indexVersion = 1;
+
+// magic + version + generation
+const qint64 indexHeaderSize = 12;
+// magic + generation
+const qint64 packHeaderSize = 8;
+// type + name length
+const qint64 recordHeaderSize = 3;
+// offset + length + timestamp
+const qint64 putPayloadSize = 20;
+// don't bother compacting packs that waste less than this
+const qint64 minimumGarbageSize = 4 * 1024 * 1024;
+
+template <typename T>
+inline void appendLittleEndian(QByteArray &buffer, T value)
+{
+    const int pos = buffer.size();
+    buffer.resize(pos + int(sizeof(T)));
+    qToLittleEndian<T>(value, buffer.data() + pos);
+}
+
+QByteArray packHeader(quint32 generation)
+{
+    QByteArray header(packMagic, sizeof(packMagic));
+    appendLittleEndian<quint32>(header, generation);
+    return header;
+}
+
+QByteArray indexHeader(quint32 generation)
+{
+    QByteArray header(indexMagic, sizeof(indexMagic));
+    appendLittleEndian<quint32>(header, indexVersion);
+    appendLittleEndian<quint32>(header, generation);
+    return header;
+}
+
+QByteArray indexRecord(QGeoTilePackStore::RecordType type, const QByteArray &name, const QGeoTilePackStore::Entry &entry)
+{
+    QByteArray record;
+    record.reserve(int(recordHeaderSize + name.size() + putPayloadSize));
+    appendLittleEndian<quint8>(record, type);
+    appendLittleEndian<quint16>(record, quint16(name.size()));
+    record.append(name);
+    if (type == QGeoTilePackStore::PutRecord) {
+        appendLittleEndian<qint64>(record, entry.offset);
+        appendLittleEndian<qint32>(record, entry.length);
+        appendLittleEndian<qint64>(record, entry.timestamp);
+    }
+    return record;
+}
+
+} // namespace
+
+QGeoTilePackStore::QGeoTilePackStore(const QString &directory)
+    : directory_(directory), packMap_(nullptr), packMapSize_(0), packSize_(0), liveSize_(0)
+{
+}
+
+QGeoTilePackStore::~QGeoTilePackStore()
+{
+    close();
+}
+
+QString QGeoTilePackStore::packFileName()
+{
+    return QStringLiteral("tiles.pack");
+}
+
+QString QGeoTilePackStore::indexFileName()
+{
+    return QStringLiteral("tiles.idx");
+}
+
+QString QGeoTilePackStore::directory() const
+{
+    return directory_;
+}
+
+bool QGeoTilePackStore::isOpen() const
+{
+    const std::lock_guard<QRecursiveMutex> locker(mutex_);
+    return pack_.isOpen() && index_.isOpen();
+}
+
+bool QGeoTilePackStore::open()
+{
+    const std::lock_guard<QRecursiveMutex> locker(mutex_);
+    if (isOpen())
+        return true;
+
+    if (!QDir::root().mkpath(directory_) || !openFiles()) {
+        qWarning() << "Unable to open tile pack in" << directory_;
+        close();
+        return false;
+    }
+
+    if (!loadIndex()) {
+        qWarning() << "Tile pack in" << directory_ << "is corrupted or out of sync. Discarding it.";
+        clear();
+    }
+
+    if (garbageSize() > liveSize_ && garbageSize() > minimumGarbageSize)
+        compact();
+
+    mapPack();
+    return isOpen();
+}
+
+void QGeoTilePackStore::close()
+{
+    const std::lock_guard<QRecursiveMutex> locker(mutex_);
+    unmapPack();
+    pack_.close();
+    index_.close();
+    entries_.clear();
+    packSize_ = 0;
+    liveSize_ = 0;
+}
+
+bool QGeoTilePackStore::openFiles()
+{
+    const QDir dir(directory_);
+    pack_.setFileName(dir.filePath(packFileName()));
+    index_.setFileName(dir.filePath(indexFileName()));
+    return pack_.open(QIODevice::ReadWrite) && index_.open(QIODevice::ReadWrite);
+}
+
+bool QGeoTilePackStore::loadIndex()
+{
+    entries_.clear();
+    liveSize_ = 0;
+    packSize_ = pack_.size();
+    const qint64 indexSize = index_.size();
+
+    if (indexSize == 0 && packSize_ == 0) {
+        clear();
+        return true;
+    }
+    if (indexSize < indexHeaderSize || packSize_ < packHeaderSize)
+        return false;
+
+    pack_.seek(0);
+    const QByteArray packHead = pack_.read(packHeaderSize);
+    if (packHead.size() != packHeaderSize || !packHead.startsWith(QByteArray(packMagic, sizeof(packMagic))))
+        return false;
+    const quint32 generation = qFromLittleEndian<quint32>(packHead.constData() + 4);
+
+    QByteArray buffer;
+    const uchar *data = index_.map(0, indexSize);
+    const bool mapped = data != nullptr;
+    if (!mapped) {
+        index_.seek(0);
+        buffer = index_.readAll();
+        if (buffer.size() != indexSize)
+            return false;
+        data = reinterpret_cast<const uchar *>(buffer.constData());
+    }
+
+    const bool headerValid = memcmp(data, indexMagic, sizeof(indexMagic)) == 0
+            && qFromLittleEndian<quint32>(data + 4) == indexVersion
+            && qFromLittleEndian<quint32>(data + 8) == generation;
+
+    qint64 pos = indexHeaderSize;
+    while (headerValid && indexSize - pos >= recordHeaderSize) {
+        const quint8 type = data[pos];
+        const quint16 nameLength = qFromLittleEndian<quint16>(data + pos + 1);
+        if (type != PutRecord && type != RemoveRecord)
+            break;
+        const qint64 recordSize = recordHeaderSize + nameLength + (type == PutRecord ? putPayloadSize : 0);
+        if (indexSize - pos < recordSize)
+            break; // truncated trailing record
+
+        const uchar *field = data + pos + recordHeaderSize;
+        const QString name = QString::fromUtf8(reinterpret_cast<const char *>(field), nameLength);
+        if (type == PutRecord) {
+            field += nameLength;
+            Entry entry;
+            entry.offset = qFromLittleEndian<qint64>(field);
+            entry.length = qFromLittleEndian<qint32>(field + 8);
+            entry.timestamp = qFromLittleEndian<qint64>(field + 12);
+            // Entries pointing outside the pack were written by a crashed session
+            if (entry.offset >= packHeaderSize && entry.length >= 0 && entry.offset + entry.length <= packSize_)
+                entries_.insert(name, entry);
+            else
+                entries_.remove(name);
+        } else {
+            entries_.remove(name);
+        }
+        pos += recordSize;
+    }
+
+    if (mapped)
+        index_.unmap(const_cast<uchar *>(data));
+
+    if (!headerValid) {
+        entries_.clear();
+        return false;
+    }
+
+    if (pos < indexSize)
+        index_.resize(pos);
+
+    for (const Entry &entry : qAsConst(entries_))
+        liveSize_ += entry.length;
+    return true;
+}
+
+void QGeoTilePackStore::mapPack()
+{
+    unmapPack();
+    if (!pack_.isOpen() || packSize_ <= packHeaderSize)
+        return;
+    pack_.flush();
+    packMap_ = pack_.map(0, packSize_);
+    packMapSize_ = packMap_ ? packSize_ : 0;
+}
+
+void QGeoTilePackStore::unmapPack()
+{
+    if (packMap_)
+        pack_.unmap(packMap_);
+    packMap_ = nullptr;
+    packMapSize_ = 0;
+}
+
+bool QGeoTilePackStore::appendIndexRecord(RecordType type, const QByteArray &name, const Entry &entry)
+{
+    const QByteArray record = indexRecord(type, name, entry);
+    if (!index_.seek(index_.size()) || index_.write(record) != record.size()) {
+        qWarning() << "Unable to write tile pack index" << index_.fileName();
+        return false;
+    }
+    index_.flush();
+    return true;
+}
+
+bool QGeoTilePackStore::contains(const QString &name) const
+{
+    const std::lock_guard<QRecursiveMutex> locker(mutex_);
+    return entries_.contains(name);
+}
+
+QStringList QGeoTilePackStore::names() const
+{
+    const std::lock_guard<QRecursiveMutex> locker(mutex_);
+    return entries_.keys();
+}
+
+int QGeoTilePackStore::size(const QString &name) const
+{
+    const std::lock_guard<QRecursiveMutex> locker(mutex_);
+    return entries_.value(name).length;
+}
+
+QDateTime QGeoTilePackStore::lastModified(const QString &name) const
+{
+    const std::lock_guard<QRecursiveMutex> locker(mutex_);
+    const auto it = entries_.constFind(name);
+    if (it == entries_.constEnd())
+        return QDateTime();
+    return QDateTime::fromMSecsSinceEpoch(it->timestamp);
+}
+
+QByteArray QGeoTilePackStore::read(const QString &name)
+{
+    const std::lock_guard<QRecursiveMutex> locker(mutex_);
+    const auto it = entries_.constFind(name);
+    if (it == entries_.constEnd())
+        return QByteArray();
+
+    const Entry &entry = it.value();
+    if (entry.offset + entry.length <= packMapSize_)
+        return QByteArray(reinterpret_cast<const char *>(packMap_ + entry.offset), entry.length);
+
+    // Appended after the pack was mapped
+    if (!pack_.seek(entry.offset))
+        return QByteArray();
+    return pack_.read(entry.length);
+}
+
+bool QGeoTilePackStore::write(const QString &name, const QByteArray &bytes)
+{
+    const std::lock_guard<QRecursiveMutex> locker(mutex_);
+    if (!isOpen() || name.isEmpty())
+        return false;
+
+    Entry entry;
+    entry.offset = packSize_;
+    entry.length = bytes.size();
+    entry.timestamp = QDateTime::currentMSecsSinceEpoch();
+
+    if (!pack_.seek(packSize_) || pack_.write(bytes) != bytes.size()) {
+        qWarning() << "Unable to write tile pack" << pack_.fileName();
+        return false;
+    }
+    // The tile bytes must hit the pack before the index references them
+    pack_.flush();
+    packSize_ += bytes.size();
+
+    if (!appendIndexRecord(PutRecord, name.toUtf8(), entry))
+        return false;
+
+    const auto it = entries_.constFind(name);
+    if (it != entries_.constEnd())
+        liveSize_ -= it->length;
+    entries_.insert(name, entry);
+    liveSize_ += entry.length;
+    return true;
+}
+
+void QGeoTilePackStore::remove(const QString &name)
+{
+    const std::lock_guard<QRecursiveMutex> locker(mutex_);
+    const auto it = entries_.find(name);
+    if (it == entries_.end())
+        return;
+
+    appendIndexRecord(RemoveRecord, name.toUtf8(), Entry());
+    liveSize_ -= it->length;
+    entries_.erase(it);
+}
+
+void QGeoTilePackStore::clear()
+{
+    const std::lock_guard<QRecursiveMutex> locker(mutex_);
+    if (!isOpen())
+        return;
+
+    unmapPack();
+    const quint32 generation = QRandomGenerator::global()->generate();
+
+    pack_.resize(0);
+    pack_.seek(0);
+    pack_.write(packHeader(generation));
+    pack_.flush();
+
+    index_.resize(0);
+    index_.seek(0);
+    index_.write(indexHeader(generation));
+    index_.flush();
+
+    entries_.clear();
+    packSize_ = packHeaderSize;
+    liveSize_ = 0;
+}
+
+qint64 QGeoTilePackStore::packSize() const
+{
+    const std::lock_guard<QRecursiveMutex> locker(mutex_);
+    return packSize_;
+}
+
+qint64 QGeoTilePackStore::garbageSize() const
+{
+    const std::lock_guard<QRecursiveMutex> locker(mutex_);
+    if (!isOpen())
+        return 0;
+    return packSize_ - packHeaderSize - liveSize_;
+}
+
+bool QGeoTilePackStore::compact()
+{
+    const std::lock_guard<QRecursiveMutex> locker(mutex_);
+    if (!isOpen())
+        return false;
+    if (garbageSize() == 0)
+        return true;
+
+    const QDir dir(directory_);
+    QSaveFile pack(dir.filePath(packFileName()));
+    QSaveFile index(dir.filePath(indexFileName()));
+    if (!pack.open(QIODevice::WriteOnly) || !index.open(QIODevice::WriteOnly)) {
+        qWarning() << "Unable to compact tile pack in" << directory_;
+        return false;
+    }
+
+    const quint32 generation = QRandomGenerator::global()->generate();
+    pack.write(packHeader(generation));
+    index.write(indexHeader(generation));
+
+    // Keep the original pack order, so that tiles written together stay together
+    QVector<QPair<qint64, QString> > order;
+    order.reserve(entries_.size());
+    for (auto it = entries_.cbegin(); it != entries_.cend(); ++it)
+        order.append(qMakePair(it->offset, it.key()));
+    std::sort(order.begin(), order.end());
+
+    QHash<QString, Entry> compacted;
+    compacted.reserve(entries_.size());
+    qint64 offset = packHeaderSize;
+    for (const auto &item : qAsConst(order)) {
+        const Entry &old = entries_[item.second];
+        const QByteArray bytes = read(item.second);
+        if (bytes.size() != old.length)
+            continue;
+
+        Entry entry;
+        entry.offset = offset;
+        entry.length = old.length;
+        entry.timestamp = old.timestamp;
+        pack.write(bytes);
+        index.write(indexRecord(PutRecord, item.second.toUtf8(), entry));
+        compacted.insert(item.second, entry);
+        offset += entry.length;
+    }
+
+    // The old files must be closed before being replaced. The pack is committed
+    // first: a crash before the index commit leaves mismatching generations,
+    // which open() detects.
+    unmapPack();
+    pack_.close();
+    index_.close();
+    const bool packCommitted = pack.commit();
+    const bool indexCommitted = packCommitted && index.commit();
+    if (!packCommitted)
+        index.cancelWriting();
+
+    if (!openFiles()) {
+        qWarning() << "Unable to reopen tile pack in" << directory_;
+        close();
+        return false;
+    }
+
+    if (!indexCommitted) {
+        qWarning() << "Unable to compact tile pack in" << directory_;
+        if (packCommitted) // generations now mismatch
+            clear();
+        else
+            mapPack();
+        return false;
+    }
+
+    entries_ = compacted;
+    packSize_ = offset;
+    liveSize_ = offset - packHeaderSize;
+    mapPack();
+    return true;
+}
+
+QT_END_NAMESPACE
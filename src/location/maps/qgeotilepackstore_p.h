@@ -0,0 +1,151 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QGEOTILEPACKSTORE_P_H
+#define QGEOTILEPACKSTORE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QFile>
+#include <QMutex>
+
+QT_BEGIN_NAMESPACE
+
+/*
+ * QGeoTilePackStore
+ *
+ * Disk backend for QGeoFileTileCache that keeps all the tiles of a cache
+ * directory in a single append-only pack file ("tiles.pack"), together with
+ * an append-only index journal ("tiles.idx") mapping the tile file name, as
+ * produced by QGeoFileTileCache::tileSpecToFilename, to the offset and length
+ * of the tile bytes inside the pack.
+ *
+ * Opening the store maps the index and replays it, so startup costs
+ * O(index size) instead of one directory entry plus one stat per tile.
+ * Reads are served from a read-only mapping of the pack when the tile lies
+ * in the mapped region, or with a single positioned read otherwise.
+ * Removals only append a tombstone to the index; the dead space is reclaimed
+ * by compact(), which open() runs when more than half of the pack is garbage.
+ *
+ * All public functions are thread-safe, so that tiles can be read from
+ * decoding threads.
+ *
+ * A truncated trailing index record (e.g. after a crash while writing) is
+ * ignored and cut off, and entries pointing past the end of the pack are
+ * dropped, so the store always reopens in a consistent state.
+ */
+class Q_LOCATION_PRIVATE_EXPORT QGeoTilePackStore
+{
+public:
+    enum RecordType : quint8 {
+        PutRecord = 1,
+        RemoveRecord = 2
+    };
+
+    struct Entry
+    {
+        qint64 offset = 0;
+        qint64 timestamp = 0;
+        int length = 0;
+    };
+
+    explicit QGeoTilePackStore(const QString &directory);
+    ~QGeoTilePackStore();
+
+    bool open();
+    void close();
+    bool isOpen() const;
+
+    QString directory() const;
+
+    bool contains(const QString &name) const;
+    QStringList names() const;
+    int size(const QString &name) const;
+    QDateTime lastModified(const QString &name) const;
+
+    QByteArray read(const QString &name);
+    bool write(const QString &name, const QByteArray &bytes);
+    void remove(const QString &name);
+    void clear();
+
+    qint64 packSize() const;
+    qint64 garbageSize() const;
+    bool compact();
+
+    static QString packFileName();
+    static QString indexFileName();
+
+private:
+    bool openFiles();
+    bool loadIndex();
+    void mapPack();
+    void unmapPack();
+    bool appendIndexRecord(RecordType type, const QByteArray &name, const Entry &entry);
+
+    QString directory_;
+    QFile pack_;
+    QFile index_;
+    uchar *packMap_;
+    qint64 packMapSize_;
+    qint64 packSize_;
+    qint64 liveSize_;
+    QHash<QString, Entry> entries_;
+    mutable QRecursiveMutex mutex_;
+
+    Q_DISABLE_COPY(QGeoTilePackStore)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILEPACKSTORE_P_H
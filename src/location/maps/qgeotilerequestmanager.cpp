@@ -53,14 +53,20 @@ public:
     QGeoTiledMap *m_map;
     QPointer<QGeoTiledMappingManagerEngine> m_engine;
 
-    QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > requestTiles(const QSet<QGeoTileSpec> &tiles);
+    QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > requestTiles(const QSet<QGeoTileSpec> &visibleTiles,
+                                                                       const QSet<QGeoTileSpec> &prefetchTiles);
     void tileError(const QGeoTileSpec &tile, const QString &errorString);
 
     QHash<QGeoTileSpec, int> m_retries;
     QHash<QGeoTileSpec, QSharedPointer<RetryFuture> > m_futures;
     QSet<QGeoTileSpec> m_requested;
+    QSet<QGeoTileSpec> m_prefetching; // requested tiles that are not visible
+    QSet<QGeoTileSpec> m_decoding;
 
     void tileFetched(const QGeoTileSpec &spec);
+    QSharedPointer<QGeoTileTexture> requestTileTexture(const QGeoTileSpec &spec);
+    void tilesDecoded(const QList<QSharedPointer<QGeoTileTexture> > &textures,
+                      const QList<QGeoTileSpec> &failed);
 };
 
 QGeoTileRequestManager::QGeoTileRequestManager(QGeoTiledMap *map, QGeoTiledMappingManagerEngine *engine)
@@ -76,7 +82,18 @@ QGeoTileRequestManager::~QGeoTileRequestManager()
 
 QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManager::requestTiles(const QSet<QGeoTileSpec> &tiles)
 {
-    return d_ptr->requestTiles(tiles);
+    return d_ptr->requestTiles(tiles, QSet<QGeoTileSpec>());
+}
+
+/*
+    Like requestTiles(), but also requests \a prefetchTiles, which are not shown yet.
+    These are fetched with a lower priority than \a visibleTiles, and only while
+    the network is not busy with visible tiles.
+*/
+QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManager::requestTiles(const QSet<QGeoTileSpec> &visibleTiles,
+                                                                                           const QSet<QGeoTileSpec> &prefetchTiles)
+{
+    return d_ptr->requestTiles(visibleTiles, prefetchTiles);
 }
 
 void QGeoTileRequestManager::tileFetched(const QGeoTileSpec &spec)
@@ -92,6 +109,22 @@ QSharedPointer<QGeoTileTexture> QGeoTileRequestManager::tileTexture(const QGeoTi
         return QSharedPointer<QGeoTileTexture>();
 }
 
+/*
+    Like tileTexture(), but lets the tile cache load and decode the tile in the background.
+    In that case a null texture is returned, and the texture is later passed to
+    QGeoTiledMap::updateTileTextures().
+*/
+QSharedPointer<QGeoTileTexture> QGeoTileRequestManager::requestTileTexture(const QGeoTileSpec &spec)
+{
+    return d_ptr->requestTileTexture(spec);
+}
+
+void QGeoTileRequestManager::tilesDecoded(const QList<QSharedPointer<QGeoTileTexture> > &textures,
+                                          const QList<QGeoTileSpec> &failed)
+{
+    d_ptr->tilesDecoded(textures, failed);
+}
+
 void QGeoTileRequestManager::tileError(const QGeoTileSpec &tile, const QString &errorString)
 {
     d_ptr->tileError(tile, errorString);
@@ -107,10 +140,15 @@ QGeoTileRequestManagerPrivate::~QGeoTileRequestManagerPrivate()
 {
 }
 
-QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPrivate::requestTiles(const QSet<QGeoTileSpec> &tiles)
+QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPrivate::requestTiles(const QSet<QGeoTileSpec> &visibleTiles,
+                                                                                                  const QSet<QGeoTileSpec> &prefetchTiles)
 {
+    const QSet<QGeoTileSpec> prefetchOnly = prefetchTiles - visibleTiles;
+    const QSet<QGeoTileSpec> tiles = visibleTiles + prefetchOnly;
     QSet<QGeoTileSpec> cancelTiles = m_requested - tiles;
-    QSet<QGeoTileSpec> requestTiles = tiles - m_requested;
+    // tiles being decoded by the cache are neither requested again nor cancelled
+    m_decoding.intersect(tiles);
+    QSet<QGeoTileSpec> requestTiles = tiles - m_requested - m_decoding;
     QSet<QGeoTileSpec> cached;
 //    int tileSize = tiles.size();
 //    int newTiles = requestTiles.size();
@@ -125,11 +163,16 @@ QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPriva
         iter end = requestTiles.constEnd();
         for (; i != end; ++i) {
             QGeoTileSpec tile = *i;
-            QSharedPointer<QGeoTileTexture> tex = m_engine->getTileTexture(tile);
+            bool pending = false;
+            QSharedPointer<QGeoTileTexture> tex = m_engine->requestTileTexture(m_map, tile, &pending);
             if (tex) {
                 if (!tex->image.isNull())
                     cachedTex.insert(tile, tex);
                 cached.insert(tile);
+            } else if (pending) {
+                // The cache is decoding it in the background, it will be delivered shortly
+                m_decoding.insert(tile);
+                cached.insert(tile);
             } else {
                 // Try to use textures from lower zoom levels, but still request the proper tile
                 QGeoTileSpec spec = tile;
@@ -139,7 +182,8 @@ QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPriva
                     spec.setZoom(z);
                     spec.setX(tile.x() / denominator);
                     spec.setY(tile.y() / denominator);
-                    QSharedPointer<QGeoTileTexture> t = m_engine->getTileTexture(spec);
+                    // Only parents already decoded are used, nothing is read or decoded for them
+                    QSharedPointer<QGeoTileTexture> t = m_engine->cachedTileTexture(spec);
                     if (t && !t->image.isNull()) {
                         cachedTex.insert(tile, t);
                         break;
@@ -152,14 +196,23 @@ QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPriva
     requestTiles -= cached;
 
     m_requested -= cancelTiles;
+
+    // Tiles already requested whose class changed, e.g. prefetched tiles coming into view
+    QSet<QGeoTileSpec> prefetching = m_requested & prefetchOnly;
+    QSet<QGeoTileSpec> reclassified = (prefetching - m_prefetching) + (m_prefetching - prefetching - cancelTiles);
+    reclassified -= requestTiles;
+
     m_requested += requestTiles;
+    prefetching += requestTiles & prefetchOnly;
+    m_prefetching = prefetching;
 
 //    qDebug() << "required # tiles: " << tileSize << ", new tiles: " << newTiles << ", total server requests: " << requested_.size();
 
-    if (!requestTiles.isEmpty() || !cancelTiles.isEmpty()) {
+    if (!requestTiles.isEmpty() || !cancelTiles.isEmpty() || !reclassified.isEmpty()) {
         if (!m_engine.isNull()) {
 //            qDebug() << "new server requests: " << requestTiles.size() << ", server cancels: " << cancelTiles.size();
-            m_engine->updateTileRequests(m_map, requestTiles, cancelTiles);
+            requestTiles += reclassified;
+            m_engine->updateTileRequests(m_map, requestTiles, cancelTiles, requestTiles & m_prefetching);
 
             // Remove any cancelled tiles from the error retry hash to avoid
             // re-using the numbers for a totally different request cycle.
@@ -179,16 +232,50 @@ void QGeoTileRequestManagerPrivate::tileFetched(const QGeoTileSpec &spec)
 {
     m_map->updateTile(spec);
     m_requested.remove(spec);
+    m_prefetching.remove(spec);
     m_retries.remove(spec);
     m_futures.remove(spec);
 }
 
+QSharedPointer<QGeoTileTexture> QGeoTileRequestManagerPrivate::requestTileTexture(const QGeoTileSpec &spec)
+{
+    if (m_engine.isNull())
+        return QSharedPointer<QGeoTileTexture>();
+
+    bool pending = false;
+    QSharedPointer<QGeoTileTexture> tex = m_engine->requestTileTexture(m_map, spec, &pending);
+    if (pending)
+        m_decoding.insert(spec);
+    return tex;
+}
+
+void QGeoTileRequestManagerPrivate::tilesDecoded(const QList<QSharedPointer<QGeoTileTexture> > &textures,
+                                                 const QList<QGeoTileSpec> &failed)
+{
+    QList<QSharedPointer<QGeoTileTexture> > wanted;
+    for (const QSharedPointer<QGeoTileTexture> &texture : textures) {
+        if (m_decoding.remove(texture->spec))
+            wanted.append(texture);
+    }
+    if (!wanted.isEmpty())
+        m_map->updateTileTextures(wanted);
+
+    // Broken cached data: go through the regular retry logic, which refetches the tile
+    for (const QGeoTileSpec &spec : failed) {
+        if (m_decoding.remove(spec)) {
+            m_requested.insert(spec);
+            tileError(spec, QLatin1String("Problem with tile image"));
+        }
+    }
+}
+
 // Represents a tile that needs to be retried after a certain period of time
 class RetryFuture : public QObject
 {
     Q_OBJECT
 public:
-    RetryFuture(const QGeoTileSpec &tile, QGeoTiledMap *map, QGeoTiledMappingManagerEngine* engine, QObject *parent = 0);
+    RetryFuture(const QGeoTileSpec &tile, QGeoTiledMap *map, QGeoTiledMappingManagerEngine* engine,
+                bool prefetch, QObject *parent = 0);
 
 public Q_SLOTS:
     void retry();
@@ -197,19 +284,24 @@ private:
     QGeoTileSpec m_tile;
     QGeoTiledMap *m_map;
     QPointer<QGeoTiledMappingManagerEngine> m_engine;
+    bool m_prefetch;
 };
 
-RetryFuture::RetryFuture(const QGeoTileSpec &tile, QGeoTiledMap *map, QGeoTiledMappingManagerEngine* engine, QObject *parent)
-    : QObject(parent), m_tile(tile), m_map(map), m_engine(engine)
+RetryFuture::RetryFuture(const QGeoTileSpec &tile, QGeoTiledMap *map, QGeoTiledMappingManagerEngine* engine,
+                         bool prefetch, QObject *parent)
+    : QObject(parent), m_tile(tile), m_map(map), m_engine(engine), m_prefetch(prefetch)
 {}
 
 void RetryFuture::retry()
 {
     QSet<QGeoTileSpec> requestTiles;
     QSet<QGeoTileSpec> cancelTiles;
+    QSet<QGeoTileSpec> prefetchTiles;
     requestTiles.insert(m_tile);
+    if (m_prefetch)
+        prefetchTiles.insert(m_tile);
     if (!m_engine.isNull())
-        m_engine->updateTileRequests(m_map, requestTiles, cancelTiles);
+        m_engine->updateTileRequests(m_map, requestTiles, cancelTiles, prefetchTiles);
 }
 
 void QGeoTileRequestManagerPrivate::tileError(const QGeoTileSpec &tile, const QString &errorString)
@@ -223,6 +315,7 @@ void QGeoTileRequestManagerPrivate::tileError(const QGeoTileSpec &tile, const QS
                      "Last error message was: '%s'",
                      tile.x(), tile.y(), tile.zoom(), qPrintable(errorString));
             m_requested.remove(tile);
+            m_prefetching.remove(tile);
             m_retries.remove(tile);
             m_futures.remove(tile);
 
@@ -230,7 +323,7 @@ void QGeoTileRequestManagerPrivate::tileError(const QGeoTileSpec &tile, const QS
             // Exponential time backoff when retrying
             int delay = (1 << count) * 500;
 
-            QSharedPointer<RetryFuture> future(new RetryFuture(tile,m_map,m_engine));
+            QSharedPointer<RetryFuture> future(new RetryFuture(tile, m_map, m_engine, m_prefetching.contains(tile)));
             m_futures.insert(tile, future);
 
             QTimer::singleShot(delay, future.data(), SLOT(retry()));
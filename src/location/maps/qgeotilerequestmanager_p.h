@@ -66,10 +66,15 @@ public:
     ~QGeoTileRequestManager();
 
     QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > requestTiles(const QSet<QGeoTileSpec> &tiles);
+    QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > requestTiles(const QSet<QGeoTileSpec> &visibleTiles,
+                                                                       const QSet<QGeoTileSpec> &prefetchTiles);
 
     void tileError(const QGeoTileSpec &tile, const QString &errorString);
     void tileFetched(const QGeoTileSpec &spec);
     QSharedPointer<QGeoTileTexture> tileTexture(const QGeoTileSpec &spec);
+    QSharedPointer<QGeoTileTexture> requestTileTexture(const QGeoTileSpec &spec);
+    void tilesDecoded(const QList<QSharedPointer<QGeoTileTexture> > &textures,
+                      const QList<QGeoTileSpec> &failed);
 
 private:
     QScopedPointer<QGeoTileRequestManagerPrivate> d_ptr;
@@ -0,0 +1,255 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeotileslabarena_p.h"
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+
+#include <cstring>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+// Keeps the rows of every slab aligned for SIMD uploads
+static const int slabAlignment = 64;
+
+namespace {
+
+struct Block;
+
+struct Slab
+{
+    QGeoTileSlabArena::Data *arena;
+    Block *block;
+    uchar *data;
+    Slab *nextFree;
+    bool inUse;
+};
+
+struct Block
+{
+    uchar *memory;
+    Slab *slabs;
+    int slabSize;
+    int used;
+};
+
+}
+
+struct QGeoTileSlabArena::Data
+{
+    Data(int slabsPerBlock)
+        : ref(1), slabsPerBlock(slabsPerBlock), reservedBytes(0), usedBytes(0)
+    {
+    }
+
+    ~Data()
+    {
+        for (Block *block : qAsConst(blocks))
+            freeBlock(block);
+    }
+
+    void freeBlock(Block *block)
+    {
+        qFreeAligned(block->memory);
+        delete[] block->slabs;
+        delete block;
+    }
+
+    Slab *takeSlab(int slabSize);
+    void rebuildFreeLists();
+
+    // The arena itself, plus one for each slab in use
+    QAtomicInt ref;
+    QMutex mutex;
+    const int slabsPerBlock;
+    QHash<int, Slab *> freeSlabs;   // by slab size
+    QList<Block *> blocks;
+    qint64 reservedBytes;
+    qint64 usedBytes;
+};
+
+Slab *QGeoTileSlabArena::Data::takeSlab(int slabSize)
+{
+    Slab *slab = freeSlabs.value(slabSize);
+    if (!slab) {
+        uchar *memory = static_cast<uchar *>(qMallocAligned(size_t(slabSize) * slabsPerBlock, slabAlignment));
+        if (!memory)
+            return nullptr;
+
+        Block *block = new Block;
+        block->memory = memory;
+        block->slabs = new Slab[slabsPerBlock];
+        block->slabSize = slabSize;
+        block->used = 0;
+        for (int i = 0; i < slabsPerBlock; ++i) {
+            Slab &s = block->slabs[i];
+            s.arena = this;
+            s.block = block;
+            s.data = memory + size_t(slabSize) * i;
+            s.nextFree = i + 1 < slabsPerBlock ? &block->slabs[i + 1] : nullptr;
+            s.inUse = false;
+        }
+        blocks.append(block);
+        reservedBytes += qint64(slabSize) * slabsPerBlock;
+        slab = block->slabs;
+    }
+
+    freeSlabs.insert(slabSize, slab->nextFree);
+    slab->nextFree = nullptr;
+    slab->inUse = true;
+    ++slab->block->used;
+    usedBytes += slabSize;
+    return slab;
+}
+
+void QGeoTileSlabArena::Data::rebuildFreeLists()
+{
+    freeSlabs.clear();
+    for (Block *block : qAsConst(blocks)) {
+        for (int i = slabsPerBlock - 1; i >= 0; --i) {
+            Slab &slab = block->slabs[i];
+            if (slab.inUse)
+                continue;
+            slab.nextFree = freeSlabs.value(block->slabSize);
+            freeSlabs.insert(block->slabSize, &slab);
+        }
+    }
+}
+
+// QImageCleanupFunction, called when the last copy of a stored image goes away
+static void releaseSlab(void *info)
+{
+    Slab *slab = static_cast<Slab *>(info);
+    QGeoTileSlabArena::Data *d = slab->arena;
+    {
+        QMutexLocker locker(&d->mutex);
+        const int slabSize = slab->block->slabSize;
+        slab->inUse = false;
+        slab->nextFree = d->freeSlabs.value(slabSize);
+        d->freeSlabs.insert(slabSize, slab);
+        --slab->block->used;
+        d->usedBytes -= slabSize;
+    }
+    if (!d->ref.deref())
+        delete d;
+}
+
+QGeoTileSlabArena::QGeoTileSlabArena(int slabsPerBlock)
+    : d(new Data(qMax(1, slabsPerBlock)))
+{
+}
+
+QGeoTileSlabArena::~QGeoTileSlabArena()
+{
+    // Images still in use keep the slabs alive
+    if (!d->ref.deref())
+        delete d;
+}
+
+/*
+    Returns a copy of \a image whose pixels live in a slab of the arena. The image is
+    converted to a format that can be uploaded to a texture as is, if needed.
+*/
+QImage QGeoTileSlabArena::store(const QImage &image)
+{
+    if (image.isNull())
+        return QImage();
+
+    QImage source = image;
+    if (source.format() != QImage::Format_RGB32 && source.format() != QImage::Format_ARGB32_Premultiplied)
+        source = source.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    const qint64 size = source.sizeInBytes();
+    const qint64 slabSize = (size + slabAlignment - 1) & ~qint64(slabAlignment - 1);
+    if (slabSize > std::numeric_limits<int>::max() / d->slabsPerBlock)
+        return source;
+
+    Slab *slab;
+    {
+        QMutexLocker locker(&d->mutex);
+        slab = d->takeSlab(int(slabSize));
+    }
+    if (!slab)
+        return source;
+    d->ref.ref();
+
+    std::memcpy(slab->data, source.constBits(), size_t(size));
+    return QImage(slab->data, source.width(), source.height(), source.bytesPerLine(),
+                  source.format(), releaseSlab, slab);
+}
+
+/*
+    Frees the blocks none of whose slabs are in use.
+*/
+void QGeoTileSlabArena::trim()
+{
+    QMutexLocker locker(&d->mutex);
+
+    bool freed = false;
+    for (int i = d->blocks.size() - 1; i >= 0; --i) {
+        Block *block = d->blocks.at(i);
+        if (block->used)
+            continue;
+        d->reservedBytes -= qint64(block->slabSize) * d->slabsPerBlock;
+        d->freeBlock(block);
+        d->blocks.removeAt(i);
+        freed = true;
+    }
+
+    if (freed)
+        d->rebuildFreeLists();
+}
+
+qint64 QGeoTileSlabArena::reservedBytes() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->reservedBytes;
+}
+
+qint64 QGeoTileSlabArena::usedBytes() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->usedBytes;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,88 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOTILESLABARENA_P_H
+#define QGEOTILESLABARENA_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+
+#include <QImage>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Keeps decoded tile images in fixed-size slabs, allocated a block at a time for each
+    image size. An image stored here shares its pixels with every copy of it, and gives
+    its slab back to the arena once the last copy is gone, from whichever thread.
+    The slabs are reused for the next tiles of the same size instead of being freed.
+*/
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileSlabArena
+{
+public:
+    explicit QGeoTileSlabArena(int slabsPerBlock = 16);
+    ~QGeoTileSlabArena();
+
+    QImage store(const QImage &image);
+    void trim();
+
+    qint64 reservedBytes() const;
+    qint64 usedBytes() const;
+
+    struct Data;
+
+private:
+    Data *d;
+
+    Q_DISABLE_COPY(QGeoTileSlabArena)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILESLABARENA_P_H
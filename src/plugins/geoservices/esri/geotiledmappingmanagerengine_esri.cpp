@@ -140,6 +140,21 @@ GeoTiledMappingManagerEngineEsri::GeoTiledMappingManagerEngineEsri(const QVarian
     }
     QGeoFileTileCache *tileCache = new QGeoFileTileCache(cacheDirectory);
 
+    /*
+     * Disk storage setup -- defaults to one file per tile (old behavior)
+     */
+    if (parameters.contains(QStringLiteral("esri.mapping.cache.disk.storage"))) {
+        QString diskStorage = parameters.value(QStringLiteral("esri.mapping.cache.disk.storage")).toString().toLower();
+        if (diskStorage == QLatin1String("packfile"))
+            tileCache->setDiskStorage(QGeoFileTileCache::PackStorage);
+        else
+            tileCache->setDiskStorage(QGeoFileTileCache::FileStorage);
+    }
+    if (parameters.contains(QStringLiteral("esri.mapping.cache.async_decoding")))
+        tileCache->setAsynchronousDecoding(parameters.value(QStringLiteral("esri.mapping.cache.async_decoding")).toBool());
+    if (parameters.contains(QStringLiteral("esri.mapping.cache.memory.decoded")))
+        tileCache->setDecodedMemoryCache(parameters.value(QStringLiteral("esri.mapping.cache.memory.decoded")).toBool());
+
     /*
      * Disk cache setup -- defaults to ByteSize (old behavior)
      */
@@ -206,6 +221,8 @@ GeoTiledMappingManagerEngineEsri::GeoTiledMappingManagerEngineEsri(const QVarian
             m_prefetchStyle = QGeoTiledMap::PrefetchNeighbourLayer;
         else if (prefetchingMode == QStringLiteral("NoPrefetching"))
             m_prefetchStyle = QGeoTiledMap::NoPrefetching;
+        else if (prefetchingMode == QStringLiteral("Predictive"))
+            m_prefetchStyle = QGeoTiledMap::PrefetchPredictive;
     }
 
     setTileCache(tileCache);
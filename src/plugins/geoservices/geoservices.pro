@@ -7,6 +7,7 @@ qtConfig(geoservices_mapbox): SUBDIRS += mapbox
 qtConfig(geoservices_esri): SUBDIRS += esri
 qtConfig(geoservices_itemsoverlay): SUBDIRS += itemsoverlay
 qtConfig(geoservices_osm): SUBDIRS += osm
+qtConfig(geoservices_mbtiles): SUBDIRS += mbtiles
 
 qtConfig(geoservices_mapboxgl) {
     !exists(../../3rdparty/mapbox-gl-native/mapbox-gl-native.pro) {
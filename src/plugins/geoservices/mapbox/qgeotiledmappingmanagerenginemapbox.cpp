@@ -165,6 +165,21 @@ QGeoTiledMappingManagerEngineMapbox::QGeoTiledMappingManagerEngineMapbox(const Q
 
     QGeoFileTileCache *tileCache = new QGeoFileTileCacheMapbox(mapTypes, scaleFactor, m_cacheDirectory);
 
+    /*
+     * Disk storage setup -- defaults to one file per tile (old behavior)
+     */
+    if (parameters.contains(QStringLiteral("mapbox.mapping.cache.disk.storage"))) {
+        QString diskStorage = parameters.value(QStringLiteral("mapbox.mapping.cache.disk.storage")).toString().toLower();
+        if (diskStorage == QLatin1String("packfile"))
+            tileCache->setDiskStorage(QGeoFileTileCache::PackStorage);
+        else
+            tileCache->setDiskStorage(QGeoFileTileCache::FileStorage);
+    }
+    if (parameters.contains(QStringLiteral("mapbox.mapping.cache.async_decoding")))
+        tileCache->setAsynchronousDecoding(parameters.value(QStringLiteral("mapbox.mapping.cache.async_decoding")).toBool());
+    if (parameters.contains(QStringLiteral("mapbox.mapping.cache.memory.decoded")))
+        tileCache->setDecodedMemoryCache(parameters.value(QStringLiteral("mapbox.mapping.cache.memory.decoded")).toBool());
+
     /*
      * Disk cache setup -- defaults to Unitary since:
      *
@@ -238,6 +253,8 @@ QGeoTiledMappingManagerEngineMapbox::QGeoTiledMappingManagerEngineMapbox(const Q
             m_prefetchStyle = QGeoTiledMap::PrefetchNeighbourLayer;
         else if (prefetchingMode == QStringLiteral("NoPrefetching"))
             m_prefetchStyle = QGeoTiledMap::NoPrefetching;
+        else if (prefetchingMode == QStringLiteral("Predictive"))
+            m_prefetchStyle = QGeoTiledMap::PrefetchPredictive;
     }
 
     setTileCache(tileCache);
@@ -0,0 +1,29 @@
+TARGET = qtgeoservices_mbtiles
+
+QT += location-private positioning-private
+
+QT_FOR_CONFIG += location-private
+qtConfig(location-labs-plugin): DEFINES += LOCATIONLABS
+
+HEADERS += \
+    qgeoserviceproviderpluginmbtiles.h \
+    qgeotiledmappingmanagerenginembtiles.h \
+    qgeotilefetchermbtiles.h \
+    qgeomapreplymbtiles.h \
+    qgeotiledmapmbtiles.h \
+    qmbtilesarchive.h
+
+SOURCES += \
+    qgeoserviceproviderpluginmbtiles.cpp \
+    qgeotiledmappingmanagerenginembtiles.cpp \
+    qgeotilefetchermbtiles.cpp \
+    qgeomapreplymbtiles.cpp \
+    qgeotiledmapmbtiles.cpp \
+    qmbtilesarchive.cpp
+
+OTHER_FILES += \
+    mbtiles_plugin.json
+
+PLUGIN_TYPE = geoservices
+PLUGIN_CLASS_NAME = QGeoServiceProviderFactoryMBTiles
+load(qt_plugin)
@@ -0,0 +1,192 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeotiledmappingmanagerenginembtiles.h"
+#include "qgeotiledmapmbtiles.h"
+#include "qgeotilefetchermbtiles.h"
+#include "qmbtilesarchive.h"
+
+#include <QtLocation/private/qgeocameracapabilities_p.h>
+#include <QtLocation/private/qgeomaptype_p.h>
+#include <QtLocation/private/qgeofiletilecache_p.h>
+
+#include <QFileInfo>
+
+QT_BEGIN_NAMESPACE
+
+static const QString kParamArchive(QStringLiteral("mbtiles.archive"));
+static const QString kParamCacheDirectory(QStringLiteral("mbtiles.mapping.cache.directory"));
+static const QString kParamMemoryCacheSize(QStringLiteral("mbtiles.mapping.cache.memory.size"));
+static const QString kParamDecodedMemoryCache(QStringLiteral("mbtiles.mapping.cache.memory.decoded"));
+static const QString kParamTextureCacheSize(QStringLiteral("mbtiles.mapping.cache.texture.size"));
+static const QString kParamPrefetchingStyle(QStringLiteral("mbtiles.mapping.prefetching_style"));
+
+QGeoTiledMappingManagerEngineMBTiles::QGeoTiledMappingManagerEngineMBTiles(const QVariantMap &parameters,
+                                                                           QGeoServiceProvider::Error *error,
+                                                                           QString *errorString)
+:   QGeoTiledMappingManagerEngine()
+{
+    const QStringList fileNames = parameters.value(kParamArchive).toStringList();
+    if (fileNames.isEmpty()) {
+        *error = QGeoServiceProvider::MissingRequiredParameterError;
+        *errorString = QStringLiteral("The mbtiles.archive parameter is required");
+        return;
+    }
+
+    // One map type per archive, all tiles are indexed up front
+    QGeoCameraCapabilities cameraCaps;
+    cameraCaps.setSupportsBearing(true);
+    cameraCaps.setSupportsTilting(true);
+    cameraCaps.setMinimumTilt(0);
+    cameraCaps.setMaximumTilt(80);
+    cameraCaps.setMinimumFieldOfView(20.0);
+    cameraCaps.setMaximumFieldOfView(120.0);
+    cameraCaps.setOverzoomEnabled(true);
+
+    QList<QGeoMapType> mapTypes;
+    int minimumZoomLevel = -1;
+    int maximumZoomLevel = -1;
+    for (const QString &fileName : fileNames) {
+        QMBTilesArchive *archive = new QMBTilesArchive(fileName);
+        m_archives.append(archive);
+        if (!archive->open()) {
+            *error = QGeoServiceProvider::NotSupportedError;
+            *errorString = fileName + QStringLiteral(": ") + archive->errorString();
+            return;
+        }
+        if (archive->tileCount() == 0) {
+            *error = QGeoServiceProvider::NotSupportedError;
+            *errorString = fileName + QStringLiteral(": The archive contains no tiles");
+            return;
+        }
+
+        QGeoCameraCapabilities archiveCaps = cameraCaps;
+        archiveCaps.setMinimumZoomLevel(archive->minimumZoomLevel());
+        archiveCaps.setMaximumZoomLevel(archive->maximumZoomLevel());
+
+        if (minimumZoomLevel < 0 || archive->minimumZoomLevel() < minimumZoomLevel)
+            minimumZoomLevel = archive->minimumZoomLevel();
+        maximumZoomLevel = qMax(maximumZoomLevel, archive->maximumZoomLevel());
+
+        QString name = archive->metadata(QStringLiteral("name"));
+        if (name.isEmpty())
+            name = QFileInfo(fileName).completeBaseName();
+
+        mapTypes << QGeoMapType(QGeoMapType::CustomMap,
+                                name,
+                                archive->metadata(QStringLiteral("description")),
+                                false,
+                                false,
+                                m_archives.size(),
+                                QByteArrayLiteral("mbtiles"),
+                                archiveCaps);
+    }
+
+    cameraCaps.setMinimumZoomLevel(minimumZoomLevel);
+    cameraCaps.setMaximumZoomLevel(maximumZoomLevel);
+    setCameraCapabilities(cameraCaps);
+    setSupportedMapTypes(mapTypes);
+    setTileSize(QSize(256, 256));
+
+    setTileFetcher(new QGeoTileFetcherMBTiles(this));
+
+    /* TILE CACHE */
+    // The archive already is the disk cache, only keep tiles in memory
+    QString cacheDirectory;
+    if (parameters.contains(kParamCacheDirectory))
+        cacheDirectory = parameters.value(kParamCacheDirectory).toString();
+    else
+        cacheDirectory = QAbstractGeoTileCache::baseLocationCacheDirectory() + QLatin1String("mbtiles");
+    QGeoFileTileCache *tileCache = new QGeoFileTileCache(cacheDirectory);
+
+    if (parameters.contains(kParamMemoryCacheSize)) {
+        bool ok = false;
+        int cacheSize = parameters.value(kParamMemoryCacheSize).toString().toInt(&ok);
+        if (ok)
+            tileCache->setMaxMemoryUsage(cacheSize);
+    }
+    if (parameters.contains(kParamDecodedMemoryCache))
+        tileCache->setDecodedMemoryCache(parameters.value(kParamDecodedMemoryCache).toBool());
+    if (parameters.contains(kParamTextureCacheSize)) {
+        bool ok = false;
+        int cacheSize = parameters.value(kParamTextureCacheSize).toString().toInt(&ok);
+        if (ok)
+            tileCache->setExtraTextureUsage(cacheSize);
+    }
+
+    setTileCache(tileCache);
+    setCacheHint(QAbstractGeoTileCache::MemoryCache);
+
+    /* PREFETCHING */
+    if (parameters.contains(kParamPrefetchingStyle)) {
+        const QString prefetchingMode = parameters.value(kParamPrefetchingStyle).toString();
+        if (prefetchingMode == QStringLiteral("TwoNeighbourLayers"))
+            m_prefetchStyle = QGeoTiledMap::PrefetchTwoNeighbourLayers;
+        else if (prefetchingMode == QStringLiteral("OneNeighbourLayer"))
+            m_prefetchStyle = QGeoTiledMap::PrefetchNeighbourLayer;
+        else if (prefetchingMode == QStringLiteral("NoPrefetching"))
+            m_prefetchStyle = QGeoTiledMap::NoPrefetching;
+        else if (prefetchingMode == QStringLiteral("Predictive"))
+            m_prefetchStyle = QGeoTiledMap::PrefetchPredictive;
+    }
+
+    *error = QGeoServiceProvider::NoError;
+    errorString->clear();
+}
+
+QGeoTiledMappingManagerEngineMBTiles::~QGeoTiledMappingManagerEngineMBTiles()
+{
+    qDeleteAll(m_archives);
+}
+
+QGeoMap *QGeoTiledMappingManagerEngineMBTiles::createMap()
+{
+    QGeoTiledMap *map = new QGeoTiledMapMBTiles(this);
+    map->setPrefetchStyle(m_prefetchStyle);
+    return map;
+}
+
+const QMBTilesArchive *QGeoTiledMappingManagerEngineMBTiles::archive(int mapId) const
+{
+    if (mapId < 1 || mapId > m_archives.size())
+        return nullptr;
+    return m_archives.at(mapId - 1);
+}
+
+QT_END_NAMESPACE
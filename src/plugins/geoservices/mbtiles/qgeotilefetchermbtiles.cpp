@@ -0,0 +1,68 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeotilefetchermbtiles.h"
+#include "qgeotiledmappingmanagerenginembtiles.h"
+#include "qgeomapreplymbtiles.h"
+#include "qmbtilesarchive.h"
+
+#include <QtLocation/private/qgeotilespec_p.h>
+
+QT_BEGIN_NAMESPACE
+
+QGeoTileFetcherMBTiles::QGeoTileFetcherMBTiles(QGeoTiledMappingManagerEngineMBTiles *parent)
+    : QGeoTileFetcher(parent), m_engine(parent)
+{
+}
+
+/*
+    Reads the tile straight out of the archive. The reply is already finished, so
+    QGeoTileFetcher handles it right away instead of waiting for a network round trip.
+*/
+QGeoTiledMapReply *QGeoTileFetcherMBTiles::getTileImage(const QGeoTileSpec &spec)
+{
+    const QMBTilesArchive *archive = m_engine->archive(spec.mapId());
+    if (!archive)
+        return new QGeoMapReplyMBTiles(spec, QByteArray(), QString(), this);
+
+    return new QGeoMapReplyMBTiles(spec, archive->tile(spec.zoom(), spec.x(), spec.y()),
+                                   archive->format(), this);
+}
+
+QT_END_NAMESPACE
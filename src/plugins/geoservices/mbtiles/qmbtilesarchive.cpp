@@ -0,0 +1,684 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qmbtilesarchive.h"
+
+#include <QtCore/QtEndian>
+
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+// See https://www.sqlite.org/fileformat.html for the layout parsed below
+static const int kHeaderSize = 100;
+static const uchar kInteriorTablePage = 0x05;
+static const uchar kLeafTablePage = 0x0d;
+static const int kMaximumTreeDepth = 32;
+static const int kMaximumZoomLevel = 29;
+
+static inline quint16 get16(const uchar *p)
+{
+    return qFromBigEndian<quint16>(p);
+}
+
+static inline quint32 get32(const uchar *p)
+{
+    return qFromBigEndian<quint32>(p);
+}
+
+// Returns the number of bytes used by the varint at p, or 0 if it runs past end
+static int readVarint(const uchar *p, const uchar *end, quint64 *value)
+{
+    quint64 v = 0;
+    for (int i = 0; i < 9; ++i) {
+        if (p + i >= end)
+            return 0;
+        if (i == 8) {
+            *value = (v << 8) | p[i];
+            return 9;
+        }
+        v = (v << 7) | (p[i] & 0x7f);
+        if (!(p[i] & 0x80)) {
+            *value = v;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+static quint32 serialTypeSize(quint64 type)
+{
+    static const quint32 sizes[] = { 0, 1, 2, 3, 4, 6, 8, 8, 0, 0, 0, 0 };
+    if (type < 12)
+        return sizes[type];
+    return quint32((type - 12) / 2); // blobs are even, text is odd
+}
+
+// How much of a payload of the given size is stored in the b-tree leaf cell itself
+static quint32 localPayloadSize(quint32 usableSize, quint32 size)
+{
+    const quint32 maxLocal = usableSize - 35;
+    if (size <= maxLocal)
+        return size;
+    const quint32 minLocal = (usableSize - 12) * 32 / 255 - 23;
+    const quint32 local = minLocal + (size - minLocal) % (usableSize - 4);
+    return local <= maxLocal ? local : minLocal;
+}
+
+QMBTilesArchive::QMBTilesArchive(const QString &fileName)
+    : m_file(fileName), m_data(nullptr), m_size(0), m_pageSize(0), m_usableSize(0),
+      m_pageCount(0), m_textEncoding(1), m_minimumZoomLevel(-1), m_maximumZoomLevel(-1)
+{
+}
+
+QMBTilesArchive::~QMBTilesArchive()
+{
+    close();
+}
+
+bool QMBTilesArchive::open()
+{
+    close();
+    m_errorString.clear();
+
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        setError(m_file.errorString());
+        return false;
+    }
+
+    m_size = m_file.size();
+    m_data = m_size > 0 ? m_file.map(0, m_size) : nullptr;
+    if (!m_data) {
+        setError(QStringLiteral("Unable to map the archive: ") + m_file.errorString());
+        close();
+        return false;
+    }
+
+    if (!readHeader() || !readSchema() || !readTiles()) {
+        close();
+        return false;
+    }
+    readMetadata();
+
+    return true;
+}
+
+void QMBTilesArchive::close()
+{
+    if (m_data)
+        m_file.unmap(const_cast<uchar *>(m_data));
+    m_data = nullptr;
+    m_size = 0;
+    m_file.close();
+
+    m_tables.clear();
+    m_metadata.clear();
+    m_tiles.clear();
+    m_minimumZoomLevel = -1;
+    m_maximumZoomLevel = -1;
+}
+
+bool QMBTilesArchive::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+QString QMBTilesArchive::fileName() const
+{
+    return m_file.fileName();
+}
+
+QString QMBTilesArchive::errorString() const
+{
+    return m_errorString;
+}
+
+QString QMBTilesArchive::metadata(const QString &name) const
+{
+    return m_metadata.value(name);
+}
+
+QString QMBTilesArchive::format() const
+{
+    const QString format = m_metadata.value(QStringLiteral("format")).toLower();
+    return format.isEmpty() ? QStringLiteral("png") : format;
+}
+
+int QMBTilesArchive::minimumZoomLevel() const
+{
+    return m_minimumZoomLevel;
+}
+
+int QMBTilesArchive::maximumZoomLevel() const
+{
+    return m_maximumZoomLevel;
+}
+
+int QMBTilesArchive::tileCount() const
+{
+    return m_tiles.size();
+}
+
+bool QMBTilesArchive::contains(int zoom, int x, int y) const
+{
+    return m_tiles.contains(tileKey(zoom, x, y));
+}
+
+QByteArray QMBTilesArchive::tile(int zoom, int x, int y) const
+{
+    const auto it = m_tiles.constFind(tileKey(zoom, x, y));
+    if (it == m_tiles.constEnd())
+        return QByteArray();
+
+    QByteArray data(int(it->size), Qt::Uninitialized);
+    if (!readPayload(it->payload, it->offset, it->size, data.data()))
+        return QByteArray();
+    return data;
+}
+
+bool QMBTilesArchive::readHeader()
+{
+    if (m_size < kHeaderSize || std::memcmp(m_data, "SQLite format 3", 16) != 0) {
+        setError(QStringLiteral("Not an MBTiles archive"));
+        return false;
+    }
+
+    m_pageSize = get16(m_data + 16);
+    if (m_pageSize == 1)
+        m_pageSize = 65536;
+    if (m_pageSize < 512 || (m_pageSize & (m_pageSize - 1))) {
+        setError(QStringLiteral("Invalid page size"));
+        return false;
+    }
+
+    m_usableSize = m_pageSize - m_data[20];
+    m_pageCount = quint32(m_size / m_pageSize);
+    if (m_usableSize < 480 || m_pageCount == 0) {
+        setError(QStringLiteral("Invalid page size"));
+        return false;
+    }
+
+    m_textEncoding = int(get32(m_data + 56));
+    if (m_textEncoding < 1 || m_textEncoding > 3)
+        m_textEncoding = 1;
+
+    return true;
+}
+
+bool QMBTilesArchive::readSchema()
+{
+    // sqlite_master(type, name, tbl_name, rootpage, sql) is rooted at page 1
+    QVector<Column> columns;
+    const bool ok = scanTable(1, [&](qint64, const Payload &payload) {
+        if (!readRecord(payload, &columns) || columns.size() < 5)
+            return true;
+
+        Table table;
+        table.type = textValue(payload, columns.at(0));
+        qint64 rootPage = 0;
+        integerValue(payload, columns.at(3), &rootPage);
+        table.rootPage = quint32(rootPage);
+        table.sql = textValue(payload, columns.at(4));
+
+        if (table.type == QLatin1String("table") || table.type == QLatin1String("view"))
+            m_tables.insert(textValue(payload, columns.at(1)).toLower(), table);
+        return true;
+    });
+
+    if (!ok)
+        setError(QStringLiteral("Corrupt database schema"));
+    return ok;
+}
+
+bool QMBTilesArchive::readMetadata()
+{
+    const Table table = m_tables.value(QStringLiteral("metadata"));
+    if (table.type != QLatin1String("table"))
+        return false;
+
+    const QStringList names = columnNames(table.sql);
+    const int nameColumn = names.indexOf(QStringLiteral("name"));
+    const int valueColumn = names.indexOf(QStringLiteral("value"));
+    if (nameColumn < 0 || valueColumn < 0)
+        return false;
+
+    QVector<Column> columns;
+    return scanTable(table.rootPage, [&](qint64, const Payload &payload) {
+        if (readRecord(payload, &columns) && columns.size() > qMax(nameColumn, valueColumn)) {
+            m_metadata.insert(textValue(payload, columns.at(nameColumn)),
+                              textValue(payload, columns.at(valueColumn)));
+        }
+        return true;
+    });
+}
+
+bool QMBTilesArchive::readTiles()
+{
+    const Table tiles = m_tables.value(QStringLiteral("tiles"));
+    bool ok = false;
+    if (tiles.type == QLatin1String("table")) {
+        ok = readTilesTable(tiles);
+    } else {
+        const Table map = m_tables.value(QStringLiteral("map"));
+        const Table images = m_tables.value(QStringLiteral("images"));
+        if (map.type != QLatin1String("table") || images.type != QLatin1String("table")) {
+            setError(QStringLiteral("The archive has no tiles table"));
+            return false;
+        }
+        ok = readDeduplicatedTiles(map, images);
+    }
+
+    if (!ok && m_errorString.isEmpty())
+        setError(QStringLiteral("Corrupt tiles table"));
+    return ok;
+}
+
+bool QMBTilesArchive::readTilesTable(const Table &table)
+{
+    const QStringList names = columnNames(table.sql);
+    const int zoomColumn = names.indexOf(QStringLiteral("zoom_level"));
+    const int xColumn = names.indexOf(QStringLiteral("tile_column"));
+    const int yColumn = names.indexOf(QStringLiteral("tile_row"));
+    const int dataColumn = names.indexOf(QStringLiteral("tile_data"));
+    if (zoomColumn < 0 || xColumn < 0 || yColumn < 0 || dataColumn < 0) {
+        setError(QStringLiteral("The tiles table lacks the MBTiles columns"));
+        return false;
+    }
+    const int columnCount = qMax(qMax(zoomColumn, xColumn), qMax(yColumn, dataColumn)) + 1;
+
+    QVector<Column> columns;
+    return scanTable(table.rootPage, [&](qint64, const Payload &payload) {
+        qint64 zoom, x, y;
+        if (!readRecord(payload, &columns) || columns.size() < columnCount
+                || !integerValue(payload, columns.at(zoomColumn), &zoom)
+                || !integerValue(payload, columns.at(xColumn), &x)
+                || !integerValue(payload, columns.at(yColumn), &y)
+                || columns.at(dataColumn).serialType < 12) {
+            return true; // not a tile
+        }
+
+        const Column &data = columns.at(dataColumn);
+        insertTile(zoom, x, y, { payload, data.offset, data.size });
+        return true;
+    });
+}
+
+bool QMBTilesArchive::readDeduplicatedTiles(const Table &map, const Table &images)
+{
+    const QStringList mapNames = columnNames(map.sql);
+    const int zoomColumn = mapNames.indexOf(QStringLiteral("zoom_level"));
+    const int xColumn = mapNames.indexOf(QStringLiteral("tile_column"));
+    const int yColumn = mapNames.indexOf(QStringLiteral("tile_row"));
+    const int mapIdColumn = mapNames.indexOf(QStringLiteral("tile_id"));
+
+    const QStringList imageNames = columnNames(images.sql);
+    const int dataColumn = imageNames.indexOf(QStringLiteral("tile_data"));
+    const int imageIdColumn = imageNames.indexOf(QStringLiteral("tile_id"));
+
+    if (zoomColumn < 0 || xColumn < 0 || yColumn < 0 || mapIdColumn < 0
+            || dataColumn < 0 || imageIdColumn < 0) {
+        setError(QStringLiteral("The map and images tables lack the MBTiles columns"));
+        return false;
+    }
+
+    // tile_id is usually text, but some producers use integers. An INTEGER PRIMARY KEY
+    // column is an alias of the rowid, and is stored as NULL in the record.
+    auto idValue = [this](qint64 rowId, const Payload &payload, const Column &column) {
+        qint64 id;
+        if (column.serialType == 0)
+            return QByteArray::number(rowId);
+        if (integerValue(payload, column, &id))
+            return QByteArray::number(id);
+        return bytesValue(payload, column);
+    };
+
+    QHash<QByteArray, TileLocation> imageLocations;
+    QVector<Column> columns;
+    bool ok = scanTable(images.rootPage, [&](qint64 rowId, const Payload &payload) {
+        if (!readRecord(payload, &columns) || columns.size() <= qMax(dataColumn, imageIdColumn)
+                || columns.at(dataColumn).serialType < 12) {
+            return true;
+        }
+        const Column &data = columns.at(dataColumn);
+        imageLocations.insert(idValue(rowId, payload, columns.at(imageIdColumn)),
+                              { payload, data.offset, data.size });
+        return true;
+    });
+    if (!ok)
+        return false;
+
+    const int columnCount = qMax(qMax(zoomColumn, xColumn), qMax(yColumn, mapIdColumn)) + 1;
+    return scanTable(map.rootPage, [&](qint64 rowId, const Payload &payload) {
+        qint64 zoom, x, y;
+        if (!readRecord(payload, &columns) || columns.size() < columnCount
+                || !integerValue(payload, columns.at(zoomColumn), &zoom)
+                || !integerValue(payload, columns.at(xColumn), &x)
+                || !integerValue(payload, columns.at(yColumn), &y)) {
+            return true;
+        }
+
+        const auto image = imageLocations.constFind(idValue(rowId, payload, columns.at(mapIdColumn)));
+        if (image != imageLocations.constEnd())
+            insertTile(zoom, x, y, *image);
+        return true;
+    });
+}
+
+void QMBTilesArchive::insertTile(qint64 zoom, qint64 column, qint64 row, const TileLocation &location)
+{
+    if (zoom < 0 || zoom > kMaximumZoomLevel)
+        return;
+    const qint64 side = qint64(1) << zoom;
+    if (column < 0 || column >= side || row < 0 || row >= side)
+        return;
+
+    // MBTiles rows count from the south
+    const int y = int(side - 1 - row);
+    m_tiles.insert(tileKey(int(zoom), int(column), y), location);
+
+    if (m_minimumZoomLevel < 0 || zoom < m_minimumZoomLevel)
+        m_minimumZoomLevel = int(zoom);
+    if (zoom > m_maximumZoomLevel)
+        m_maximumZoomLevel = int(zoom);
+}
+
+const uchar *QMBTilesArchive::page(quint32 number) const
+{
+    if (number == 0 || number > m_pageCount)
+        return nullptr;
+    return m_data + qint64(number - 1) * m_pageSize;
+}
+
+bool QMBTilesArchive::scanTable(quint32 rootPage, const RowVisitor &visitor) const
+{
+    return scanPage(rootPage, 0, visitor);
+}
+
+bool QMBTilesArchive::scanPage(quint32 number, int depth, const RowVisitor &visitor) const
+{
+    // Deeper trees are either corrupt or contain a cycle
+    if (depth > kMaximumTreeDepth)
+        return false;
+
+    const uchar *p = page(number);
+    if (!p)
+        return false;
+
+    const uchar *header = number == 1 ? p + kHeaderSize : p;
+    const uchar *end = p + m_usableSize;
+    const uchar type = header[0];
+    if (type != kInteriorTablePage && type != kLeafTablePage)
+        return false;
+
+    const int headerSize = type == kInteriorTablePage ? 12 : 8;
+    const int cellCount = get16(header + 3);
+    const uchar *cellPointers = header + headerSize;
+    if (cellPointers + 2 * cellCount > end)
+        return false;
+
+    for (int i = 0; i < cellCount; ++i) {
+        const uchar *cell = p + get16(cellPointers + 2 * i);
+        if (cell < cellPointers + 2 * cellCount || cell >= end)
+            return false;
+
+        if (type == kInteriorTablePage) {
+            if (cell + 4 > end || !scanPage(get32(cell), depth + 1, visitor))
+                return false;
+            continue;
+        }
+
+        quint64 size;
+        quint64 rowId;
+        int n = readVarint(cell, end, &size);
+        if (!n)
+            return false;
+        cell += n;
+        n = readVarint(cell, end, &rowId);
+        if (!n || size > 0x7fffffff)
+            return false;
+        cell += n;
+
+        Payload payload;
+        payload.localOffset = cell - m_data;
+        payload.size = quint32(size);
+        payload.localSize = localPayloadSize(m_usableSize, payload.size);
+        payload.overflowPage = 0;
+        if (cell + payload.localSize > end)
+            return false;
+        if (payload.localSize < payload.size) {
+            if (cell + payload.localSize + 4 > end)
+                return false;
+            payload.overflowPage = get32(cell + payload.localSize);
+        }
+
+        if (!visitor(qint64(rowId), payload))
+            return false;
+    }
+
+    if (type == kInteriorTablePage)
+        return scanPage(get32(header + 8), depth + 1, visitor);
+    return true;
+}
+
+bool QMBTilesArchive::readPayload(const Payload &payload, quint32 offset, quint32 size, char *out) const
+{
+    if (quint64(offset) + size > payload.size)
+        return false;
+
+    if (offset < payload.localSize) {
+        const quint32 n = qMin(size, payload.localSize - offset);
+        std::memcpy(out, m_data + payload.localOffset + offset, n);
+        out += n;
+        offset += n;
+        size -= n;
+    }
+
+    // Each overflow page starts with the number of the next one
+    const quint32 chunkSize = m_usableSize - 4;
+    quint32 number = payload.overflowPage;
+    quint32 chunkOffset = payload.localSize;
+    quint32 visited = 0;
+    while (size > 0) {
+        const uchar *p = page(number);
+        if (!p || ++visited > m_pageCount)
+            return false;
+
+        if (offset < chunkOffset + chunkSize) {
+            const quint32 from = offset - chunkOffset;
+            const quint32 n = qMin(size, chunkSize - from);
+            std::memcpy(out, p + 4 + from, n);
+            out += n;
+            offset += n;
+            size -= n;
+        }
+
+        number = get32(p);
+        chunkOffset += chunkSize;
+    }
+
+    return true;
+}
+
+bool QMBTilesArchive::readRecord(const Payload &payload, QVector<Column> *columns) const
+{
+    columns->clear();
+
+    uchar prefix[9];
+    const quint32 prefixSize = qMin<quint32>(sizeof(prefix), payload.size);
+    if (!readPayload(payload, 0, prefixSize, reinterpret_cast<char *>(prefix)))
+        return false;
+
+    quint64 headerSize;
+    const int n = readVarint(prefix, prefix + prefixSize, &headerSize);
+    if (!n || headerSize < quint64(n) || headerSize > payload.size || headerSize > 65536)
+        return false;
+
+    QByteArray header(int(headerSize), Qt::Uninitialized);
+    if (!readPayload(payload, 0, quint32(headerSize), header.data()))
+        return false;
+
+    const uchar *p = reinterpret_cast<const uchar *>(header.constData()) + n;
+    const uchar *end = reinterpret_cast<const uchar *>(header.constData()) + headerSize;
+    quint64 offset = headerSize;
+    while (p < end) {
+        Column column;
+        const int typeSize = readVarint(p, end, &column.serialType);
+        if (!typeSize || column.serialType == 10 || column.serialType == 11)
+            return false;
+        p += typeSize;
+
+        column.offset = quint32(offset);
+        column.size = serialTypeSize(column.serialType);
+        offset += column.size;
+        if (offset > payload.size)
+            return false;
+        columns->append(column);
+    }
+
+    return true;
+}
+
+bool QMBTilesArchive::integerValue(const Payload &payload, const Column &column, qint64 *value) const
+{
+    if (column.serialType == 8 || column.serialType == 9) {
+        *value = column.serialType - 8;
+        return true;
+    }
+    if (column.serialType < 1 || column.serialType > 6)
+        return false;
+
+    uchar bytes[8];
+    if (!readPayload(payload, column.offset, column.size, reinterpret_cast<char *>(bytes)))
+        return false;
+
+    // Big endian two's complement
+    quint64 v = (bytes[0] & 0x80) ? ~quint64(0) : 0;
+    for (quint32 i = 0; i < column.size; ++i)
+        v = (v << 8) | bytes[i];
+    *value = qint64(v);
+    return true;
+}
+
+QByteArray QMBTilesArchive::bytesValue(const Payload &payload, const Column &column) const
+{
+    if (column.serialType < 12)
+        return QByteArray();
+
+    QByteArray bytes(int(column.size), Qt::Uninitialized);
+    if (!readPayload(payload, column.offset, column.size, bytes.data()))
+        return QByteArray();
+    return bytes;
+}
+
+QString QMBTilesArchive::textValue(const Payload &payload, const Column &column) const
+{
+    const QByteArray bytes = bytesValue(payload, column);
+    if (m_textEncoding == 1)
+        return QString::fromUtf8(bytes);
+
+    // UTF-16, little endian for 2 and big endian for 3
+    QString text;
+    text.reserve(bytes.size() / 2);
+    for (int i = 0; i + 1 < bytes.size(); i += 2) {
+        const ushort a = uchar(bytes.at(i));
+        const ushort b = uchar(bytes.at(i + 1));
+        text.append(QChar(m_textEncoding == 2 ? ushort(a | (b << 8)) : ushort((a << 8) | b)));
+    }
+    return text;
+}
+
+void QMBTilesArchive::setError(const QString &errorString)
+{
+    m_errorString = errorString;
+}
+
+quint64 QMBTilesArchive::tileKey(int zoom, int x, int y)
+{
+    return (quint64(zoom) << 58) | (quint64(x) << 29) | quint64(y);
+}
+
+// The column names of a CREATE TABLE statement, lower case
+QStringList QMBTilesArchive::columnNames(const QString &sql)
+{
+    QStringList names;
+    const int open = sql.indexOf(QLatin1Char('('));
+    if (open < 0)
+        return names;
+
+    int depth = 0;
+    int start = open + 1;
+    for (int i = start; i < sql.size(); ++i) {
+        const QChar c = sql.at(i);
+        if (c == QLatin1Char('(')) {
+            ++depth;
+            continue;
+        }
+        if (c == QLatin1Char(')') && depth > 0) {
+            --depth;
+            continue;
+        }
+        if (c != QLatin1Char(',') && c != QLatin1Char(')'))
+            continue;
+
+        const QString definition = sql.mid(start, i - start).trimmed();
+        start = i + 1;
+
+        int nameEnd = 0;
+        while (nameEnd < definition.size() && !definition.at(nameEnd).isSpace())
+            ++nameEnd;
+        QString name = definition.left(nameEnd);
+        for (const char quote : { '"', '`', '[', ']', '\'' })
+            name.remove(QLatin1Char(quote));
+
+        // Table constraints are not columns
+        const QString keyword = name.toUpper();
+        if (keyword != QLatin1String("CONSTRAINT") && keyword != QLatin1String("PRIMARY")
+                && keyword != QLatin1String("UNIQUE") && keyword != QLatin1String("CHECK")
+                && keyword != QLatin1String("FOREIGN")) {
+            names.append(name.toLower());
+        }
+
+        if (c == QLatin1Char(')'))
+            break;
+    }
+
+    return names;
+}
+
+QT_END_NAMESPACE
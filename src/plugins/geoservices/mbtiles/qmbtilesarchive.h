@@ -0,0 +1,158 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QMBTILESARCHIVE_H
+#define QMBTILESARCHIVE_H
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtCore/QByteArray>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Read-only access to an MBTiles archive, without SQLite.
+
+    The archive is memory mapped and its table b-trees are walked directly, following the
+    SQLite file format. All tiles are indexed when the archive is opened, so that looking
+    up a tile afterwards is a hash lookup followed by a copy out of the mapping.
+
+    Both the plain "tiles" table layout and the deduplicated layout, where "tiles" is a
+    view joining the "map" and "images" tables, are supported. Archives with pending
+    changes in a write-ahead log are read without them.
+*/
+class QMBTilesArchive
+{
+public:
+    explicit QMBTilesArchive(const QString &fileName);
+    ~QMBTilesArchive();
+
+    bool open();
+    void close();
+    bool isOpen() const;
+
+    QString fileName() const;
+    QString errorString() const;
+
+    QString metadata(const QString &name) const;
+    QString format() const;
+    int minimumZoomLevel() const;
+    int maximumZoomLevel() const;
+    int tileCount() const;
+
+    // x and y follow the XYZ scheme used by QGeoTileSpec, not the TMS scheme of the archive
+    bool contains(int zoom, int x, int y) const;
+    QByteArray tile(int zoom, int x, int y) const;
+
+private:
+    // A record stored in a table b-tree leaf cell, possibly spilling into overflow pages
+    struct Payload {
+        qint64 localOffset;
+        quint32 localSize;
+        quint32 size;
+        quint32 overflowPage;
+    };
+
+    struct Column {
+        quint64 serialType;
+        quint32 offset;
+        quint32 size;
+    };
+
+    struct TileLocation {
+        Payload payload;
+        quint32 offset;
+        quint32 size;
+    };
+
+    struct Table {
+        QString type;
+        quint32 rootPage;
+        QString sql;
+    };
+
+    typedef std::function<bool(qint64 rowId, const Payload &payload)> RowVisitor;
+
+    bool readHeader();
+    bool readSchema();
+    bool readMetadata();
+    bool readTiles();
+    bool readTilesTable(const Table &table);
+    bool readDeduplicatedTiles(const Table &map, const Table &images);
+
+    const uchar *page(quint32 number) const;
+    bool scanTable(quint32 rootPage, const RowVisitor &visitor) const;
+    bool scanPage(quint32 number, int depth, const RowVisitor &visitor) const;
+    bool readPayload(const Payload &payload, quint32 offset, quint32 size, char *out) const;
+    bool readRecord(const Payload &payload, QVector<Column> *columns) const;
+    bool integerValue(const Payload &payload, const Column &column, qint64 *value) const;
+    QByteArray bytesValue(const Payload &payload, const Column &column) const;
+    QString textValue(const Payload &payload, const Column &column) const;
+    void insertTile(qint64 zoom, qint64 column, qint64 row, const TileLocation &location);
+    void setError(const QString &errorString);
+
+    static quint64 tileKey(int zoom, int x, int y);
+    static QStringList columnNames(const QString &sql);
+
+    QFile m_file;
+    const uchar *m_data;
+    qint64 m_size;
+    quint32 m_pageSize;
+    quint32 m_usableSize;
+    quint32 m_pageCount;
+    int m_textEncoding;
+    QString m_errorString;
+
+    QHash<QString, Table> m_tables;
+    QHash<QString, QString> m_metadata;
+    QHash<quint64, TileLocation> m_tiles;
+    int m_minimumZoomLevel;
+    int m_maximumZoomLevel;
+
+    Q_DISABLE_COPY(QMBTilesArchive)
+};
+
+QT_END_NAMESPACE
+
+#endif // QMBTILESARCHIVE_H
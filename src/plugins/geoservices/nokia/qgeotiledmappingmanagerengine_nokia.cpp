@@ -131,6 +131,21 @@ QGeoTiledMappingManagerEngineNokia::QGeoTiledMappingManagerEngineNokia(
 
     QGeoFileTileCache *tileCache = new QGeoFileTileCacheNokia(ppi, m_cacheDirectory);
 
+    /*
+     * Disk storage setup -- defaults to one file per tile (old behavior)
+     */
+    if (parameters.contains(QStringLiteral("here.mapping.cache.disk.storage"))) {
+        QString diskStorage = parameters.value(QStringLiteral("here.mapping.cache.disk.storage")).toString().toLower();
+        if (diskStorage == QLatin1String("packfile"))
+            tileCache->setDiskStorage(QGeoFileTileCache::PackStorage);
+        else
+            tileCache->setDiskStorage(QGeoFileTileCache::FileStorage);
+    }
+    if (parameters.contains(QStringLiteral("here.mapping.cache.async_decoding")))
+        tileCache->setAsynchronousDecoding(parameters.value(QStringLiteral("here.mapping.cache.async_decoding")).toBool());
+    if (parameters.contains(QStringLiteral("here.mapping.cache.memory.decoded")))
+        tileCache->setDecodedMemoryCache(parameters.value(QStringLiteral("here.mapping.cache.memory.decoded")).toBool());
+
     /*
      * Disk cache setup -- defaults to ByteSize (old behavior)
      */
@@ -197,6 +212,8 @@ QGeoTiledMappingManagerEngineNokia::QGeoTiledMappingManagerEngineNokia(
             m_prefetchStyle = QGeoTiledMap::PrefetchNeighbourLayer;
         else if (prefetchingMode == QStringLiteral("NoPrefetching"))
             m_prefetchStyle = QGeoTiledMap::NoPrefetching;
+        else if (prefetchingMode == QStringLiteral("Predictive"))
+            m_prefetchStyle = QGeoTiledMap::PrefetchPredictive;
     }
 
     setTileCache(tileCache);
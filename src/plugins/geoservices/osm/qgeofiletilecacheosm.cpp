@@ -79,6 +79,16 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCacheOsm::get(const QGeoTileSpec &sp
     return getFromDisk(spec);
 }
 
+QSharedPointer<QGeoTileTexture> QGeoFileTileCacheOsm::getAsync(const QGeoTileSpec &spec, bool *scheduled)
+{
+    // The offline storage has to take precedence over the disk cache, and is only read synchronously
+    if (m_offlineData) {
+        *scheduled = false;
+        return get(spec);
+    }
+    return QGeoFileTileCache::getAsync(spec, scheduled);
+}
+
 void QGeoFileTileCacheOsm::onProviderResolutionFinished(const QGeoTileProviderOsm *provider)
 {
     clearObsoleteTiles(provider);
@@ -122,24 +132,20 @@ void QGeoFileTileCacheOsm::init()
     // Create a mapId to maxTimestamp LUT..
     m_maxMapIdTimestamps.resize(max+1); // initializes to invalid QDateTime
 
-    // .. by finding the newest file in each tileset (tileset = mapId).
-    QDir dir(directory_);
-    QStringList formats;
-    formats << QLatin1String("*.*");
-    QStringList files = dir.entryList(formats, QDir::Files);
+    // Base class ::init(), opens the disk storage
+    QGeoFileTileCache::init();
 
+    // .. by finding the newest file in each tileset (tileset = mapId).
+    const QStringList files = diskTileNames();
     for (const QString &tileFileName : files) {
         QGeoTileSpec spec = filenameToTileSpec(tileFileName);
         if (spec.zoom() == -1)
             continue;
-        QFileInfo fi(dir.filePath(tileFileName));
-        if (fi.lastModified() > m_maxMapIdTimestamps[spec.mapId()])
-            m_maxMapIdTimestamps[spec.mapId()] = fi.lastModified();
+        const QDateTime lastModified = diskTileLastModified(tileFileName);
+        if (lastModified > m_maxMapIdTimestamps[spec.mapId()])
+            m_maxMapIdTimestamps[spec.mapId()] = lastModified;
     }
 
-    // Base class ::init()
-    QGeoFileTileCache::init();
-
     for (QGeoTileProviderOsm * p: m_providers)
         clearObsoleteTiles(p);
 }
@@ -170,8 +176,7 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCacheOsm::getFromOfflineStorage(cons
         return QSharedPointer<QGeoTileTexture>(0);
     }
 
-    addToMemoryCache(spec, bytes, QString());
-    return addToTextureCache(spec, image);
+    return addDecodedTile(spec, bytes, QString(), image);
 }
 
 void QGeoFileTileCacheOsm::dropTiles(int mapId)
@@ -195,11 +200,8 @@ void QGeoFileTileCacheOsm::dropTiles(int mapId)
 
 void QGeoFileTileCacheOsm::loadTiles(int mapId)
 {
-    QStringList formats;
-    formats << QLatin1String("*.*");
-
     QDir dir(directory_);
-    QStringList files = dir.entryList(formats, QDir::Files);
+    QStringList files = diskTileNames();
 
     for (int i = 0; i < files.size(); ++i) {
         QGeoTileSpec spec = filenameToTileSpec(files.at(i));
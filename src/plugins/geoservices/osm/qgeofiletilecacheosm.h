@@ -56,6 +56,7 @@ public:
     ~QGeoFileTileCacheOsm();
 
     QSharedPointer<QGeoTileTexture> get(const QGeoTileSpec &spec) override;
+    QSharedPointer<QGeoTileTexture> getAsync(const QGeoTileSpec &spec, bool *scheduled) override;
 
 Q_SIGNALS:
     void mapDataUpdated(int mapId);
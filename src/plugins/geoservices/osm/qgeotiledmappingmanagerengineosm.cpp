@@ -252,6 +252,21 @@ QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVarian
         m_offlineDirectory = parameters.value(QStringLiteral("osm.mapping.offline.directory")).toString();
     QGeoFileTileCacheOsm *tileCache = new QGeoFileTileCacheOsm(m_providers, m_offlineDirectory, m_cacheDirectory);
 
+    /*
+     * Disk storage setup -- defaults to one file per tile (old behavior)
+     */
+    if (parameters.contains(QStringLiteral("osm.mapping.cache.disk.storage"))) {
+        QString diskStorage = parameters.value(QStringLiteral("osm.mapping.cache.disk.storage")).toString().toLower();
+        if (diskStorage == QLatin1String("packfile"))
+            tileCache->setDiskStorage(QGeoFileTileCache::PackStorage);
+        else
+            tileCache->setDiskStorage(QGeoFileTileCache::FileStorage);
+    }
+    if (parameters.contains(QStringLiteral("osm.mapping.cache.async_decoding")))
+        tileCache->setAsynchronousDecoding(parameters.value(QStringLiteral("osm.mapping.cache.async_decoding")).toBool());
+    if (parameters.contains(QStringLiteral("osm.mapping.cache.memory.decoded")))
+        tileCache->setDecodedMemoryCache(parameters.value(QStringLiteral("osm.mapping.cache.memory.decoded")).toBool());
+
     /*
      * Disk cache setup -- defaults to ByteSize (old behavior)
      */
@@ -319,6 +334,12 @@ QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVarian
         const QByteArray ua = parameters.value(QStringLiteral("osm.useragent")).toString().toLatin1();
         tileFetcher->setUserAgent(ua);
     }
+    if (parameters.contains(QStringLiteral("osm.mapping.max_requests_per_host"))) {
+        bool ok = false;
+        const int maxRequests = parameters.value(QStringLiteral("osm.mapping.max_requests_per_host")).toString().toInt(&ok);
+        if (ok && maxRequests > 0)
+            tileFetcher->setMaxRequestsPerHost(maxRequests);
+    }
     setTileFetcher(tileFetcher);
 
     /* PREFETCHING */
@@ -330,6 +351,8 @@ QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVarian
             m_prefetchStyle = QGeoTiledMap::PrefetchNeighbourLayer;
         else if (prefetchingMode == QStringLiteral("NoPrefetching"))
             m_prefetchStyle = QGeoTiledMap::NoPrefetching;
+        else if (prefetchingMode == QStringLiteral("Predictive"))
+            m_prefetchStyle = QGeoTiledMap::PrefetchPredictive;
     }
 
     *error = QGeoServiceProvider::NoError;
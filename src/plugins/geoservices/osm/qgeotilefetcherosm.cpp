@@ -136,7 +136,7 @@ void QGeoTileFetcherOsm::restartTimer()
 {
     Q_D(QGeoTileFetcherOsm);
 
-    if (!d->queue_.isEmpty())
+    if (d->hasQueuedTiles())
         d->timer_.start(0, this);
 }
 
@@ -163,6 +163,16 @@ QGeoTiledMapReply *QGeoTileFetcherOsm::getTileImage(const QGeoTileSpec &spec)
     return new QGeoMapReplyOsm(reply, spec, m_providers[id]->format());
 }
 
+QString QGeoTileFetcherOsm::tileHost(const QGeoTileSpec &spec) const
+{
+    int id = spec.mapId();
+    if (id < 1 || id > m_providers.size())
+        return QString();
+    id -= 1;
+
+    return m_providers[id]->tileAddress(spec.x(), spec.y(), spec.zoom()).host();
+}
+
 void QGeoTileFetcherOsm::readyUpdated()
 {
     updateTileRequests(QSet<QGeoTileSpec>(), QSet<QGeoTileSpec>());
@@ -4,10 +4,12 @@ QT = core positioning
 
 SOURCES += \
     qgeoareamonitor_polling.cpp \
+    qgeoareamonitorindex.cpp \
     positionpollfactory.cpp
 
 HEADERS += \
     qgeoareamonitor_polling.h \
+    qgeoareamonitorindex.h \
     positionpollfactory.h
 
 OTHER_FILES += \
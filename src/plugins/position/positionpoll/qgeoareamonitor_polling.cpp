@@ -38,6 +38,7 @@
 ****************************************************************************/
 
 #include "qgeoareamonitor_polling.h"
+#include "qgeoareamonitorindex.h"
 #include <QtPositioning/qgeocoordinate.h>
 #include <QtPositioning/qgeorectangle.h>
 #include <QtPositioning/qgeocircle.h>
@@ -89,6 +90,7 @@ public:
         const std::lock_guard<QRecursiveMutex> locker(mutex);
 
         activeMonitorAreas.insert(monitor.identifier(), monitor);
+        areaIndex.insert(monitor);
         singleShotTrigger.remove(monitor.identifier());
 
         checkStartStop();
@@ -100,6 +102,7 @@ public:
         const std::lock_guard<QRecursiveMutex> locker(mutex);
 
         activeMonitorAreas.insert(monitor.identifier(), monitor);
+        areaIndex.insert(monitor);
         singleShotTrigger.insert(monitor.identifier(), signalId);
 
         checkStartStop();
@@ -111,6 +114,7 @@ public:
         const std::lock_guard<QRecursiveMutex> locker(mutex);
 
         QGeoAreaMonitorInfo mon = activeMonitorAreas.take(monitor.identifier());
+        areaIndex.remove(monitor.identifier());
 
         checkStartStop();
         setupNextExpiryTimeout();
@@ -240,6 +244,7 @@ private:
                 //this is the finishing singleshot event
                 singleShotTrigger.remove(monitorIdent);
                 activeMonitorAreas.remove(monitorIdent);
+                areaIndex.remove(monitorIdent);
                 setupNextExpiryTimeout();
             } else {
                 insideArea.insert(monitorIdent);
@@ -258,6 +263,7 @@ private:
                 //this is the finishing singleShot event
                 singleShotTrigger.remove(monitorIdent);
                 activeMonitorAreas.remove(monitorIdent);
+                areaIndex.remove(monitorIdent);
                 setupNextExpiryTimeout();
             } else {
                 insideArea.remove(monitorIdent);
@@ -282,6 +288,7 @@ private Q_SLOTS:
          * This allows us to continue to remove the existing monitors as they expire.
          **/
         const QGeoAreaMonitorInfo info = activeMonitorAreas.take(activeExpiry.second);
+        areaIndex.remove(activeExpiry.second);
         setupNextExpiryTimeout();
         emit timeout(info);
 
@@ -289,16 +296,27 @@ private Q_SLOTS:
 
     void positionUpdated(const QGeoPositionInfo &info)
     {
-        foreach (const QGeoAreaMonitorInfo &monInfo, activeMonitors()) {
-            const QString identifier = monInfo.identifier();
-            if (monInfo.area().contains(info.coordinate())) {
-                if (processInsideArea(identifier))
-                    emit areaEventDetected(monInfo, info, true);
-            } else {
-                if (processOutsideArea(identifier))
-                    emit areaEventDetected(monInfo, info, false);
+        // The events are emitted once the lock is released, as the clients may call back
+        QList<QPair<QGeoAreaMonitorInfo, bool> > events;
+        {
+            const std::lock_guard<QRecursiveMutex> locker(mutex);
+
+            // Only the monitors near the position, or whose area it may have left, are tested
+            const QGeoCoordinate coordinate = info.coordinate();
+            foreach (const QGeoAreaMonitorInfo &monInfo, areaIndex.candidates(coordinate, insideArea)) {
+                const QString identifier = monInfo.identifier();
+                if (areaIndex.contains(identifier, coordinate)) {
+                    if (processInsideArea(identifier))
+                        events.append(qMakePair(monInfo, true));
+                } else {
+                    if (processOutsideArea(identifier))
+                        events.append(qMakePair(monInfo, false));
+                }
             }
         }
+
+        for (const auto &event : qAsConst(events))
+            emit areaEventDetected(event.first, info, event.second);
     }
 
 private:
@@ -308,6 +326,7 @@ private:
     QSet<QString> insideArea;
 
     MonitorTable activeMonitorAreas;
+    QGeoAreaMonitorIndex areaIndex;
 
     QGeoPositionInfoSource* source = nullptr;
     QList<QGeoAreaMonitorPolling*> registeredClients;
@@ -0,0 +1,228 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeoareamonitorindex.h"
+
+#include <QtPositioning/qgeocircle.h>
+
+#include <QtCore/qmath.h>
+
+#include <algorithm>
+
+static const double CellDegrees = 0.1;
+static const int Rows = 1800;      // 180 / CellDegrees
+static const int Columns = 3600;   // 360 / CellDegrees
+// Areas covering more cells are tested on every update
+static const int MaxCellsPerArea = 1024;
+// Same as QGeoCoordinate::distanceTo()
+static const double EarthMeanRadius = 6371007.2;
+
+quint64 QGeoAreaMonitorIndex::cellKey(int row, int column)
+{
+    return (quint64(row) << 32) | quint32(column);
+}
+
+int QGeoAreaMonitorIndex::rowOf(double latitude)
+{
+    return qBound(0, int((latitude + 90.0) / CellDegrees), Rows - 1);
+}
+
+int QGeoAreaMonitorIndex::columnOf(double longitude)
+{
+    return qBound(0, int((longitude + 180.0) / CellDegrees), Columns - 1);
+}
+
+void QGeoAreaMonitorIndex::insert(const QGeoAreaMonitorInfo &monitor)
+{
+    remove(monitor.identifier());
+
+    Entry &entry = m_entries[monitor.identifier()];
+    entry.monitor = monitor;
+    entry.bounds = monitor.area().boundingGeoRectangle();
+    entry.order = m_nextOrder++;
+
+    if (!entry.bounds.isValid() || entry.bounds.isEmpty()) {
+        m_large.insert(monitor.identifier());
+        return;
+    }
+
+    const int firstRow = rowOf(entry.bounds.bottomLeft().latitude());
+    const int lastRow = rowOf(entry.bounds.topRight().latitude());
+    const int firstColumn = columnOf(entry.bounds.topLeft().longitude());
+    int lastColumn = columnOf(entry.bounds.bottomRight().longitude());
+    // Crossing the antimeridian, wrap the columns around
+    if (lastColumn < firstColumn)
+        lastColumn += Columns;
+
+    if (qint64(lastRow - firstRow + 1) * (lastColumn - firstColumn + 1) > MaxCellsPerArea) {
+        m_large.insert(monitor.identifier());
+        return;
+    }
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const quint64 key = cellKey(row, column % Columns);
+            entry.cells.append(key);
+            m_cells[key].append(monitor.identifier());
+        }
+    }
+}
+
+void QGeoAreaMonitorIndex::remove(const QString &identifier)
+{
+    const auto it = m_entries.find(identifier);
+    if (it == m_entries.end())
+        return;
+
+    for (quint64 key : qAsConst(it->cells)) {
+        const auto cell = m_cells.find(key);
+        cell->removeOne(identifier);
+        if (cell->isEmpty())
+            m_cells.erase(cell);
+    }
+    m_large.remove(identifier);
+    m_entries.erase(it);
+}
+
+bool QGeoAreaMonitorIndex::isSettled(const Entry &entry) const
+{
+    return entry.generation == m_generation && m_odometer < entry.odometerLimit;
+}
+
+QList<QGeoAreaMonitorInfo> QGeoAreaMonitorIndex::candidates(const QGeoCoordinate &position,
+                                                            const QSet<QString> &inside)
+{
+    // The distance travelled bounds how far the position has moved from any earlier one.
+    // Without it, every remembered distance is dropped.
+    if (position.isValid() && m_lastPosition.isValid())
+        m_odometer += m_lastPosition.distanceTo(position);
+    else
+        ++m_generation;
+    m_lastPosition = position;
+
+    QList<const Entry *> entries;
+    auto add = [&](const QString &identifier, bool checkBounds) {
+        const auto it = m_entries.constFind(identifier);
+        if (it == m_entries.constEnd() || isSettled(*it))
+            return;
+        if (checkBounds && !it->bounds.contains(position))
+            return;
+        entries.append(&*it);
+    };
+
+    if (position.isValid()) {
+        const auto cell = m_cells.constFind(cellKey(rowOf(position.latitude()),
+                                                    columnOf(position.longitude())));
+        if (cell != m_cells.constEnd()) {
+            for (const QString &identifier : *cell) {
+                if (!inside.contains(identifier))
+                    add(identifier, true);
+            }
+        }
+        for (const QString &identifier : m_large) {
+            if (!inside.contains(identifier))
+                add(identifier, false);
+        }
+    }
+    // Those can only be left
+    for (const QString &identifier : inside)
+        add(identifier, false);
+
+    std::sort(entries.begin(), entries.end(), [](const Entry *a, const Entry *b) {
+        return a->order < b->order;
+    });
+
+    QList<QGeoAreaMonitorInfo> result;
+    result.reserve(entries.size());
+    for (const Entry *entry : qAsConst(entries))
+        result.append(entry->monitor);
+    return result;
+}
+
+bool QGeoAreaMonitorIndex::contains(const QString &identifier, const QGeoCoordinate &position)
+{
+    const auto it = m_entries.find(identifier);
+    if (it == m_entries.end())
+        return false;
+
+    const bool inside = it->monitor.area().contains(position);
+    if (position.isValid()) {
+        it->odometerLimit = m_odometer + safeDistance(it->monitor.area(), position, inside);
+        it->generation = m_generation;
+    }
+    return inside;
+}
+
+/*
+    A lower bound of the distance from position to the boundary of area, in meters,
+    slightly shortened to absorb rounding. Zero when it is not known.
+*/
+double QGeoAreaMonitorIndex::safeDistance(const QGeoShape &area, const QGeoCoordinate &position,
+                                          bool inside)
+{
+    double distance = 0.0;
+    switch (area.type()) {
+    case QGeoShape::CircleType: {
+        const QGeoCircle circle(area);
+        distance = qAbs(circle.center().distanceTo(position) - circle.radius());
+        break;
+    }
+    case QGeoShape::RectangleType: {
+        if (!inside)
+            break;
+        // Along the meridian to the top and bottom edges, and at most the distance to
+        // the great circles of the left and right edges
+        const QGeoRectangle rectangle(area);
+        const double latitude = qDegreesToRadians(position.latitude());
+        distance = qDegreesToRadians(qMin(rectangle.topLeft().latitude() - position.latitude(),
+                                          position.latitude() - rectangle.bottomLeft().latitude()));
+        if (rectangle.width() < 360.0) {
+            for (double edge : { rectangle.topLeft().longitude(), rectangle.bottomRight().longitude() }) {
+                const double deltaLongitude = qDegreesToRadians(position.longitude() - edge);
+                distance = qMin(distance, qAsin(qMin(1.0, qAbs(qSin(deltaLongitude)) * qCos(latitude))));
+            }
+        }
+        distance *= EarthMeanRadius;
+        break;
+    }
+    default:
+        break;
+    }
+    return qMax(0.0, distance * 0.999 - 0.01);
+}
@@ -0,0 +1,95 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOAREAMONITORINDEX_H
+#define QGEOAREAMONITORINDEX_H
+
+#include <QtPositioning/qgeoareamonitorinfo.h>
+#include <QtPositioning/qgeocoordinate.h>
+#include <QtPositioning/qgeorectangle.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qset.h>
+
+/*
+    Keeps the monitors in a grid over the bounding boxes of their areas, so that only
+    the monitors near a position are tested, and remembers for each monitor how far the
+    position can travel before it could cross the boundary of the area.
+*/
+class QGeoAreaMonitorIndex
+{
+public:
+    void insert(const QGeoAreaMonitorInfo &monitor);
+    void remove(const QString &identifier);
+
+    // The monitors whose area may contain position, or that contained it until now
+    QList<QGeoAreaMonitorInfo> candidates(const QGeoCoordinate &position,
+                                          const QSet<QString> &inside);
+    bool contains(const QString &identifier, const QGeoCoordinate &position);
+
+private:
+    struct Entry
+    {
+        QGeoAreaMonitorInfo monitor;
+        QGeoRectangle bounds;
+        QList<quint64> cells;
+        quint64 order = 0;
+        // The monitor is not tested again until the odometer reaches this
+        double odometerLimit = 0.0;
+        int generation = -1;
+    };
+
+    static double safeDistance(const QGeoShape &area, const QGeoCoordinate &position, bool inside);
+    static quint64 cellKey(int row, int column);
+    static int rowOf(double latitude);
+    static int columnOf(double longitude);
+    bool isSettled(const Entry &entry) const;
+
+    QHash<QString, Entry> m_entries;
+    QHash<quint64, QList<QString>> m_cells;
+    QSet<QString> m_large;
+    quint64 m_nextOrder = 0;
+
+    QGeoCoordinate m_lastPosition;
+    double m_odometer = 0.0;
+    int m_generation = 0;
+};
+
+#endif // QGEOAREAMONITORINDEX_H
@@ -97,4 +97,88 @@ Paths QClipperUtils::qListToPaths(const QList<QList<QDoubleVector2D> > &lists)
     return res;
 }
 
+QClipperPathIndex::QClipperPathIndex(const Path &path)
+    : m_path(path)
+{
+    const int count = int(path.size());
+    if (count < 3)
+        return;
+
+    m_minY = m_maxY = path[0].Y;
+    for (const IntPoint &p : path) {
+        m_minY = qMin(m_minY, p.Y);
+        m_maxY = qMax(m_maxY, p.Y);
+    }
+
+    // About two edges per band, so that most bands hold a few edges
+    const int bands = qBound(1, count / 2, 4096);
+    m_bandHeight = (m_maxY - m_minY) / bands + 1;
+
+    auto bandOf = [this](cInt y) { return int((y - m_minY) / m_bandHeight); };
+    m_bandStarts.fill(0, bands + 1);
+    for (int i = 0; i < count; ++i) {
+        const cInt y1 = path[i].Y;
+        const cInt y2 = path[(i + 1) % count].Y;
+        for (int b = bandOf(qMin(y1, y2)), last = bandOf(qMax(y1, y2)); b <= last; ++b)
+            ++m_bandStarts[b + 1];
+    }
+    for (int b = 0; b < bands; ++b)
+        m_bandStarts[b + 1] += m_bandStarts[b];
+
+    // Edges keep the order of the path in each band
+    m_bandEdges.resize(m_bandStarts.last());
+    QList<int> next(m_bandStarts.begin(), m_bandStarts.end() - 1);
+    for (int i = 0; i < count; ++i) {
+        const cInt y1 = path[i].Y;
+        const cInt y2 = path[(i + 1) % count].Y;
+        for (int b = bandOf(qMin(y1, y2)), last = bandOf(qMax(y1, y2)); b <= last; ++b)
+            m_bandEdges[next[b]++] = i;
+    }
+}
+
+/*
+    The same tests as PointInPolygon() in clipper.cpp, on the edges of the band only:
+    an edge not spanning pt.Y can neither cross the ray nor hold pt.
+*/
+int QClipperPathIndex::pointInPolygon(const IntPoint &pt) const
+{
+    if (m_bandStarts.isEmpty() || pt.Y < m_minY || pt.Y > m_maxY)
+        return 0;
+
+    const int count = int(m_path.size());
+    const int band = int((pt.Y - m_minY) / m_bandHeight);
+    int result = 0;
+    for (int e = m_bandStarts.at(band), end = m_bandStarts.at(band + 1); e < end; ++e) {
+        const int i = m_bandEdges.at(e);
+        const IntPoint &ip = m_path[i];
+        const IntPoint &ipNext = m_path[i + 1 == count ? 0 : i + 1];
+        if (ipNext.Y == pt.Y) {
+            if ((ipNext.X == pt.X) || (ip.Y == pt.Y && ((ipNext.X > pt.X) == (ip.X < pt.X))))
+                return -1;
+        }
+        if ((ip.Y < pt.Y) != (ipNext.Y < pt.Y)) {
+            if (ip.X >= pt.X) {
+                if (ipNext.X > pt.X) {
+                    result = 1 - result;
+                } else {
+                    const double d = double(ip.X - pt.X) * (ipNext.Y - pt.Y)
+                                   - double(ipNext.X - pt.X) * (ip.Y - pt.Y);
+                    if (!d)
+                        return -1;
+                    if ((d > 0) == (ipNext.Y > ip.Y))
+                        result = 1 - result;
+                }
+            } else if (ipNext.X > pt.X) {
+                const double d = double(ip.X - pt.X) * (ipNext.Y - pt.Y)
+                               - double(ipNext.X - pt.X) * (ip.Y - pt.Y);
+                if (!d)
+                    return -1;
+                if ((d > 0) == (ipNext.Y > ip.Y))
+                    result = 1 - result;
+            }
+        }
+    }
+    return result;
+}
+
 QT_END_NAMESPACE
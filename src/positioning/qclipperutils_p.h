@@ -81,6 +81,28 @@ public:
     static Paths qListToPaths(const QList<QList<QDoubleVector2D> > &lists);
 };
 
+/*
+    Buckets the edges of a closed path into horizontal bands, so that a point is only
+    tested against the edges spanning its Y. pointInPolygon() returns the same as
+    c2t::clip2tri::pointInPolygon() on the path.
+*/
+class Q_POSITIONING_PRIVATE_EXPORT QClipperPathIndex
+{
+public:
+    QClipperPathIndex() {}
+    explicit QClipperPathIndex(const Path &path);
+
+    int pointInPolygon(const IntPoint &pt) const;
+
+private:
+    Path m_path;
+    cInt m_minY = 0;
+    cInt m_maxY = -1;
+    cInt m_bandHeight = 1;
+    QList<int> m_bandStarts;    // m_bandEdges[m_bandStarts[b], m_bandStarts[b + 1]) span band b
+    QList<int> m_bandEdges;     // the index of the first vertex of each edge
+};
+
 QT_END_NAMESPACE
 
 #endif // QCLIPPERUTILS_P_H
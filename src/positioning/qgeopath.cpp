@@ -48,8 +48,16 @@
 
 #include "qdoublevector2d_p.h"
 #include "qdoublevector3d_p.h"
+
+#include <QtCore/QVarLengthArray>
+
+#include <algorithm>
+#include <cmath>
+
 QT_BEGIN_NAMESPACE
 
+static const double qgeopath_EARTH_MEAN_RADIUS = 6371007.2; // meters, as QGeoCoordinate::distanceTo()
+
 /*!
     \class QGeoPath
     \inmodule QtPositioning
@@ -359,6 +367,66 @@ bool QGeoPath::containsCoordinate(const QGeoCoordinate &coordinate) const
     return d->containsCoordinate(coordinate);
 }
 
+/*!
+    Returns the index of the first coordinate of the path segment nearest to \a coordinate,
+    or -1 if the path is empty or \a coordinate is invalid.
+    A path made of a single coordinate has a single segment of zero length, at index 0.
+
+    Segments are compared by the distance between \a coordinate and their closest point,
+    ties being resolved in favor of the lowest index.
+
+    \since 6.0
+    \sa nearestCoordinate(), distanceTo(), projectedOffset()
+*/
+int QGeoPath::nearestSegment(const QGeoCoordinate &coordinate) const
+{
+    Q_D(const QGeoPath);
+    return d->segmentIndex().nearest(coordinate).segment;
+}
+
+/*!
+    Returns the point of the path nearest to \a coordinate, or an invalid
+    coordinate if the path is empty or \a coordinate is invalid.
+
+    \since 6.0
+    \sa nearestSegment()
+*/
+QGeoCoordinate QGeoPath::nearestCoordinate(const QGeoCoordinate &coordinate) const
+{
+    Q_D(const QGeoPath);
+    return d->segmentIndex().nearest(coordinate).coordinate;
+}
+
+/*!
+    Returns the distance in meters from \a coordinate to the nearest point of the path,
+    or NaN if the path is empty or \a coordinate is invalid.
+    The width of the path is not taken into account.
+
+    \since 6.0
+    \sa nearestCoordinate()
+*/
+double QGeoPath::distanceTo(const QGeoCoordinate &coordinate) const
+{
+    Q_D(const QGeoPath);
+    return d->segmentIndex().nearest(coordinate).distance;
+}
+
+/*!
+    Returns the distance in meters along the path, from its first coordinate to the point
+    of the path nearest to \a coordinate, or NaN if the path is empty or \a coordinate is invalid.
+
+    Like \l length(), the distance covered by each segment is the shortest distance between
+    its two coordinates.
+
+    \since 6.0
+    \sa nearestCoordinate(), length()
+*/
+double QGeoPath::projectedOffset(const QGeoCoordinate &coordinate) const
+{
+    Q_D(const QGeoPath);
+    return d->segmentIndex().nearest(coordinate).offset;
+}
+
 /*!
     Removes the last occurrence of \a coordinate from the path.
 */
@@ -400,6 +468,240 @@ QString QGeoPath::toString() const
  *
 *******************************************************************************/
 
+static const int qgeopath_SEGMENTS_PER_LEAF = 4;
+
+QGeoPathSegmentIndex::QGeoPathSegmentIndex(const QList<QGeoCoordinate> &path)
+:   m_path(path)
+{
+    const int size = m_path.size();
+    if (!size)
+        return;
+
+    // Longitudes are unwrapped along the path, like computeBBox() does, so that each
+    // segment is the straight mercator line crossing the dateline when shorter that way.
+    m_mercator.reserve(size);
+    m_latitudes.reserve(size);
+    m_offsets.reserve(size);
+    double longitude = m_path.at(0).longitude();
+    for (int i = 0; i < size; ++i) {
+        const QGeoCoordinate &c = m_path.at(i);
+        if (i > 0) {
+            double deltaLongi = c.longitude() - m_path.at(i - 1).longitude();
+            if (deltaLongi > 180.0)
+                deltaLongi -= 360.0;
+            else if (deltaLongi < -180.0)
+                deltaLongi += 360.0;
+            longitude += deltaLongi;
+        }
+        QDoubleVector2D mercator = QWebMercator::coordToMercator(c);
+        mercator.setX(longitude / 360.0 + 0.5);
+        m_mercator << mercator;
+        // coordToMercator() clamps near the poles, the candidates found on the segments do too
+        m_latitudes << QWebMercator::mercatorToCoord(QDoubleVector2D(0.5, mercator.y())).latitude();
+        m_offsets << (i > 0 ? m_offsets.last() + m_path.at(i - 1).distanceTo(c) : 0.0);
+    }
+
+    // A single coordinate makes a single zero length segment
+    const int segments = qMax(size - 1, 1);
+    m_segments.reserve(segments);
+    for (int i = 0; i < segments; ++i)
+        m_segments << i;
+    m_nodes.reserve(2 * (segments / qgeopath_SEGMENTS_PER_LEAF) + 1);
+    build(0, segments);
+}
+
+int QGeoPathSegmentIndex::build(int first, int count)
+{
+    const int index = m_nodes.size();
+    m_nodes.append(Node());
+
+    Node node;
+    node.minLatitude = node.minLongitude = qInf();
+    node.maxLatitude = node.maxLongitude = -qInf();
+    double minX = qInf(), maxX = -qInf(), minY = qInf(), maxY = -qInf();
+    for (int i = first; i < first + count; ++i) {
+        const int a = m_segments.at(i);
+        const int b = qMin(a + 1, m_path.size() - 1);
+        for (int v : {a, b}) {
+            const double longitude = (m_mercator.at(v).x() - 0.5) * 360.0;
+            node.minLatitude = qMin(node.minLatitude, m_latitudes.at(v));
+            node.maxLatitude = qMax(node.maxLatitude, m_latitudes.at(v));
+            node.minLongitude = qMin(node.minLongitude, longitude);
+            node.maxLongitude = qMax(node.maxLongitude, longitude);
+        }
+        const QDoubleVector2D center = (m_mercator.at(a) + m_mercator.at(b)) * 0.5;
+        minX = qMin(minX, center.x());
+        maxX = qMax(maxX, center.x());
+        minY = qMin(minY, center.y());
+        maxY = qMax(maxY, center.y());
+    }
+    // Path coordinates are returned as they are, not as reached through m_mercator: pad the
+    // bounds to cover both, the projection round trip being off by far less than this.
+    const double padding = 1e-9;
+    node.minLatitude -= padding;
+    node.maxLatitude += padding;
+    node.minLongitude -= padding;
+    node.maxLongitude += padding;
+
+    if (count <= qgeopath_SEGMENTS_PER_LEAF) {
+        node.first = first;
+        node.count = count;
+        node.right = -1;
+    } else {
+        // Median split of the segment centers along the longest mercator axis
+        const bool alongX = (maxX - minX) >= (maxY - minY);
+        auto center = [this, alongX](int segment) {
+            const int b = qMin(segment + 1, m_path.size() - 1);
+            return alongX ? m_mercator.at(segment).x() + m_mercator.at(b).x()
+                          : m_mercator.at(segment).y() + m_mercator.at(b).y();
+        };
+        const int half = count / 2;
+        std::nth_element(m_segments.begin() + first, m_segments.begin() + first + half,
+                         m_segments.begin() + first + count,
+                         [&center](int l, int r) { return center(l) < center(r); });
+        node.first = first;
+        node.count = 0;
+        build(first, half);
+        node.right = build(first + half, count - half);
+    }
+    m_nodes[index] = node;
+    return index;
+}
+
+// Lower bound of the haversine term of QGeoCoordinate::distanceTo() between a coordinate and
+// any point within node: each of its terms is bounded separately, the cosine of the latitude
+// of the farther point by the latitude of node farthest from the equator.
+static double haversineLowerBound(double latitude, double longitude, double cosLatitude,
+                                  double minLatitude, double maxLatitude,
+                                  double minLongitude, double maxLongitude)
+{
+    double deltaLatitude = 0.0;
+    if (latitude < minLatitude)
+        deltaLatitude = minLatitude - latitude;
+    else if (latitude > maxLatitude)
+        deltaLatitude = latitude - maxLatitude;
+
+    double deltaLongitude = 0.0;
+    const double span = maxLongitude - minLongitude;
+    if (span < 360.0) {
+        double delta = std::fmod(longitude - minLongitude, 360.0);
+        if (delta < 0.0)
+            delta += 360.0;
+        if (delta > span)
+            deltaLongitude = qMin(delta - span, 360.0 - delta);
+    }
+
+    const double maxAbsLatitude = qMax(qAbs(minLatitude), qAbs(maxLatitude));
+    const double haversineLat = std::sin(qDegreesToRadians(deltaLatitude) / 2.0);
+    const double haversineLon = std::sin(qDegreesToRadians(deltaLongitude) / 2.0);
+    return haversineLat * haversineLat
+            + cosLatitude * std::cos(qDegreesToRadians(maxAbsLatitude)) * haversineLon * haversineLon;
+}
+
+QGeoPathSegmentIndex::Match QGeoPathSegmentIndex::segmentMatch(int segment,
+                                                                const QGeoCoordinate &coordinate,
+                                                                const QDoubleVector2D &mercator) const
+{
+    const int next = qMin(segment + 1, m_path.size() - 1);
+    const QDoubleVector2D a = m_mercator.at(segment);
+    const QDoubleVector2D b = m_mercator.at(next);
+
+    // Pick the copy of coordinate, around the globe, closest to the segment
+    QDoubleVector2D p = mercator;
+    p.setX(p.x() + std::round((a.x() + b.x()) * 0.5 - p.x()));
+
+    Match match;
+    match.segment = segment;
+    match.coordinate = ((p - a).length() < (p - b).length()) ? m_path.at(segment) : m_path.at(next);
+    if (segment != next) {
+        const double u = ((p.x() - a.x()) * (b.x() - a.x()) + (p.y() - a.y()) * (b.y() - a.y())) / (b - a).lengthSquared();
+        const QDoubleVector2D intersection(a.x() + u * (b.x() - a.x()), a.y() + u * (b.y() - a.y()));
+        if (u > 0 && u < 1 && (p - intersection).length() < qMin((p - a).length(), (p - b).length())) // And it falls in the segment
+            match.coordinate = QWebMercator::mercatorToCoord(intersection);
+    }
+    match.distance = coordinate.distanceTo(match.coordinate);
+    match.offset = m_offsets.at(segment) + m_path.at(segment).distanceTo(match.coordinate);
+    return match;
+}
+
+QGeoPathSegmentIndex::Match QGeoPathSegmentIndex::search(const QGeoCoordinate &coordinate,
+                                                         double maxDistance, bool firstMatch) const
+{
+    Match best;
+    if (m_nodes.isEmpty() || !coordinate.isValid())
+        return best;
+
+    const double latitude = coordinate.latitude();
+    const double longitude = coordinate.longitude();
+    const double cosLatitude = std::cos(qDegreesToRadians(latitude));
+    const QDoubleVector2D mercator = QWebMercator::coordToMercator(coordinate);
+
+    // Distances are compared through their haversine term, with some slack for rounding
+    auto haversine = [](double meters) {
+        const double s = std::sin(qMin(meters / qgeopath_EARTH_MEAN_RADIUS, M_PI) / 2.0);
+        return s * s;
+    };
+    double bound = qIsFinite(maxDistance) ? haversine(maxDistance) : 1.0;
+    auto prune = [&](const Node &node) {
+        return haversineLowerBound(latitude, longitude, cosLatitude,
+                                   node.minLatitude, node.maxLatitude,
+                                   node.minLongitude, node.maxLongitude) * (1.0 - 1e-9) > bound;
+    };
+
+    QVarLengthArray<int, 64> stack;
+    stack.append(0);
+    while (!stack.isEmpty()) {
+        const int index = stack.takeLast();
+        const Node &node = m_nodes.at(index);
+        if (prune(node))
+            continue;
+
+        if (node.count) {
+            for (int i = node.first; i < node.first + node.count; ++i) {
+                const Match match = segmentMatch(m_segments.at(i), coordinate, mercator);
+                if (match.distance > maxDistance)
+                    continue;
+                if (firstMatch)
+                    return match;
+                if (best.segment < 0 || match.distance < best.distance
+                        || (match.distance == best.distance && match.segment < best.segment)) {
+                    best = match;
+                    bound = haversine(best.distance);
+                }
+            }
+            continue;
+        }
+
+        // Visit the nearer child first, it is pushed last
+        const int left = index + 1;
+        const int right = node.right;
+        const Node &l = m_nodes.at(left);
+        const Node &r = m_nodes.at(right);
+        const double toLeft = haversineLowerBound(latitude, longitude, cosLatitude, l.minLatitude,
+                                                  l.maxLatitude, l.minLongitude, l.maxLongitude);
+        const double toRight = haversineLowerBound(latitude, longitude, cosLatitude, r.minLatitude,
+                                                   r.maxLatitude, r.minLongitude, r.maxLongitude);
+        if (toLeft <= toRight) {
+            stack.append(right);
+            stack.append(left);
+        } else {
+            stack.append(left);
+            stack.append(right);
+        }
+    }
+    return best;
+}
+
+QGeoPathSegmentIndex::Match QGeoPathSegmentIndex::nearest(const QGeoCoordinate &coordinate) const
+{
+    return search(coordinate, qInf(), false);
+}
+
+bool QGeoPathSegmentIndex::withinDistance(const QGeoCoordinate &coordinate, double distance) const
+{
+    return search(coordinate, distance, true).segment >= 0;
+}
+
 QGeoPathPrivate::QGeoPathPrivate()
 :   QGeoShapePrivate(QGeoShape::PathType)
 {
@@ -463,20 +765,10 @@ const QList<QGeoCoordinate> &QGeoPathPrivate::path() const
 
 bool QGeoPathPrivate::lineContains(const QGeoCoordinate &coordinate) const
 {
-    // Unoptimized approach:
-    // - consider each segment of the path
-    // - project it into mercator space (rhumb lines are straight in mercator space)
-    // - find closest point to coordinate
-    // - unproject the closest point
-    // - calculate coordinate to closest point distance with distanceTo()
-    // - if not within lineRadius, advance
-    //
-    // To keep wrapping into the equation:
-    //   If the mercator x value of a coordinate of the line, or the coordinate parameter, is less
-    // than mercator(m_bbox).x, add that to the conversion.
-
-    if (m_bboxDirty)
-        const_cast<QGeoPathPrivate &>(*this).computeBoundingBox();
+    // The segments are projected into mercator space (rhumb lines are straight in mercator space),
+    // where the closest point of each segment to coordinate is found, unprojected, and compared
+    // to lineRadius with distanceTo(). segmentIndex() only visits the segments that might be
+    // close enough.
 
     double lineRadius = qMax(width() * 0.5, 0.2); // minimum radius: 20cm
 
@@ -485,50 +777,7 @@ bool QGeoPathPrivate::lineContains(const QGeoCoordinate &coordinate) const
     else if (m_path.size() == 1)
         return (m_path[0].distanceTo(coordinate) <= lineRadius);
 
-    QDoubleVector2D p = QWebMercator::coordToMercator(coordinate);
-    if (p.x() < m_leftBoundWrapped)
-        p.setX(p.x() + m_leftBoundWrapped);  // unwrap X
-
-    QDoubleVector2D a;
-    QDoubleVector2D b;
-    if (m_path.size()) {
-        a = QWebMercator::coordToMercator(m_path[0]);
-        if (a.x() < m_leftBoundWrapped)
-            a.setX(a.x() + m_leftBoundWrapped);  // unwrap X
-    }
-    for (int i = 1; i < m_path.size(); i++) {
-        b = QWebMercator::coordToMercator(m_path[i]);
-        if (b.x() < m_leftBoundWrapped)
-            b.setX(b.x() + m_leftBoundWrapped);  // unwrap X
-        if (b == a)
-            continue;
-
-        double u = ((p.x() - a.x()) * (b.x() - a.x()) + (p.y() - a.y()) * (b.y() - a.y()) ) / (b - a).lengthSquared();
-        QDoubleVector2D intersection(a.x() + u * (b.x() - a.x()) , a.y() + u * (b.y() - a.y()) );
-
-        QDoubleVector2D candidate = ( (p-a).length() < (p-b).length() ) ? a : b;
-
-        if (u > 0 && u < 1
-            && (p-intersection).length() < (p-candidate).length()  ) // And it falls in the segment
-                candidate = intersection;
-
-
-        if (candidate.x() > 1.0)
-            candidate.setX(candidate.x() - m_leftBoundWrapped); // wrap X
-
-        QGeoCoordinate closest = QWebMercator::mercatorToCoord(candidate);
-
-        double distanceMeters = coordinate.distanceTo(closest);
-        if (distanceMeters <= lineRadius)
-            return true;
-
-        // swap
-        a = b;
-    }
-
-    // Last check if the coordinate is on the left of leftBoundMercator, but close enough to
-    // m_path[0]
-    return (m_path[0].distanceTo(coordinate) <= lineRadius);
+    return segmentIndex().withinDistance(coordinate, lineRadius);
 }
 
 bool QGeoPathPrivate::contains(const QGeoCoordinate &coordinate) const
@@ -586,6 +835,7 @@ bool QGeoPathPrivate::containsCoordinate(const QGeoCoordinate &coordinate) const
 
 void QGeoPathPrivate::translate(double degreesLatitude, double degreesLongitude)
 {
+    m_segmentIndex.reset();
     // Need min/maxLati, so update bbox
     QVector<double> m_deltaXs;
     double m_minX, m_maxX, m_minLati, m_maxLati;
@@ -667,6 +917,14 @@ void QGeoPathPrivate::removeCoordinate(int index)
 void QGeoPathPrivate::markDirty()
 {
     m_bboxDirty = true;
+    m_segmentIndex.reset();
+}
+
+const QGeoPathSegmentIndex &QGeoPathPrivate::segmentIndex() const
+{
+    if (!m_segmentIndex)
+        const_cast<QGeoPathPrivate &>(*this).m_segmentIndex.reset(new QGeoPathSegmentIndex(m_path));
+    return *m_segmentIndex;
 }
 
 void QGeoPathPrivate::computeBoundingBox()
@@ -702,11 +960,13 @@ QGeoShapePrivate *QGeoPathPrivateEager::clone() const
 
 void QGeoPathPrivateEager::markDirty()
 {
+    m_segmentIndex.reset();
     computeBoundingBox();
 }
 
 void QGeoPathPrivateEager::translate(double degreesLatitude, double degreesLongitude)
 {
+    m_segmentIndex.reset();
     if (degreesLatitude > 0.0)
         degreesLatitude = qMin(degreesLatitude, 90.0 - m_maxLati);
     else
@@ -727,6 +987,7 @@ void QGeoPathPrivateEager::addCoordinate(const QGeoCoordinate &coordinate)
         return;
     m_path.append(coordinate);
     //m_clipperDirty = true; // clipper not used in polylines
+    m_segmentIndex.reset();
     updateBoundingBox();
 }
 
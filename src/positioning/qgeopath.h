@@ -88,6 +88,10 @@ public:
     Q_INVOKABLE void replaceCoordinate(int index, const QGeoCoordinate &coordinate);
     Q_INVOKABLE QGeoCoordinate coordinateAt(int index) const;
     Q_INVOKABLE bool containsCoordinate(const QGeoCoordinate &coordinate) const;
+    Q_INVOKABLE int nearestSegment(const QGeoCoordinate &coordinate) const;
+    Q_INVOKABLE QGeoCoordinate nearestCoordinate(const QGeoCoordinate &coordinate) const;
+    Q_INVOKABLE double distanceTo(const QGeoCoordinate &coordinate) const;
+    Q_INVOKABLE double projectedOffset(const QGeoCoordinate &coordinate) const;
     Q_INVOKABLE void removeCoordinate(const QGeoCoordinate &coordinate);
     Q_INVOKABLE void removeCoordinate(int index);
 
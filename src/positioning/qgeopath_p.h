@@ -56,7 +56,9 @@
 #include "qgeocoordinate.h"
 #include "qlocationutils_p.h"
 #include <QtPositioning/qgeopath.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
 #include <QtCore/QVector>
+#include <QtCore/QSharedPointer>
 
 QT_BEGIN_NAMESPACE
 
@@ -176,6 +178,49 @@ inline static void updateBBox( const QList<QGeoCoordinate> &m_path,
                            QGeoCoordinate(m_minLati, currentMaxLongi));
 }
 
+// Bounding volume hierarchy over the segments of a path, built once per path change.
+// Segments are rhumb lines, hence straight in mercator space; node bounds are kept in
+// degrees so that a lower bound on QGeoCoordinate::distanceTo() can prune whole subtrees.
+class Q_POSITIONING_PRIVATE_EXPORT QGeoPathSegmentIndex
+{
+public:
+    struct Match
+    {
+        int segment = -1;           // index of the first coordinate of the nearest segment
+        QGeoCoordinate coordinate;  // nearest point on that segment
+        double distance = qQNaN();  // meters from the query to coordinate
+        double offset = qQNaN();    // meters along the path from its first coordinate
+    };
+
+    explicit QGeoPathSegmentIndex(const QList<QGeoCoordinate> &path);
+
+    Match nearest(const QGeoCoordinate &coordinate) const;
+    bool withinDistance(const QGeoCoordinate &coordinate, double distance) const;
+
+private:
+    struct Node
+    {
+        double minLatitude;
+        double maxLatitude;
+        double minLongitude;        // unwrapped, may exceed [-180, 180]
+        double maxLongitude;
+        int first;                  // leaves: range in m_segments
+        int count;                  // 0 for inner nodes
+        int right;                  // inner nodes: right child, the left one follows the node
+    };
+
+    int build(int first, int count);
+    Match search(const QGeoCoordinate &coordinate, double maxDistance, bool firstMatch) const;
+    Match segmentMatch(int segment, const QGeoCoordinate &coordinate, const QDoubleVector2D &mercator) const;
+
+    QList<QGeoCoordinate> m_path;
+    QList<QDoubleVector2D> m_mercator;  // x unwrapped along the path
+    QList<double> m_latitudes;          // latitudes as reached through m_mercator
+    QList<double> m_offsets;            // path length up to each coordinate
+    QList<int> m_segments;
+    QList<Node> m_nodes;
+};
+
 // Lazy by default. Eager, within the module, used only in MapItems/MapObjectsQSG
 class Q_POSITIONING_PRIVATE_EXPORT QGeoPathPrivate : public QGeoShapePrivate
 {
@@ -215,6 +260,7 @@ public:
     virtual void removeCoordinate(int index);
     virtual void computeBoundingBox();
     virtual void markDirty();
+    const QGeoPathSegmentIndex &segmentIndex() const;
 
 // data members
     QList<QGeoCoordinate> m_path;
@@ -222,6 +268,7 @@ public:
     QGeoRectangle m_bbox; // cached
     double m_leftBoundWrapped; // cached
     bool m_bboxDirty = false;
+    QSharedPointer<const QGeoPathSegmentIndex> m_segmentIndex; // cached, shared between copies
 };
 
 class Q_POSITIONING_PRIVATE_EXPORT QGeoPathPrivateEager : public QGeoPathPrivate
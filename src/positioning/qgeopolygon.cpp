@@ -581,7 +581,7 @@ void QGeoPolygonPrivate::addHole(const QList<QGeoCoordinate> &holePath)
             return;
 
     m_holesList << holePath;
-    // ToDo: mark clipper dirty when hole caching gets added
+    m_clipperDirty = true;
 }
 
 const QList<QGeoCoordinate> QGeoPolygonPrivate::holePath(int index) const
@@ -595,7 +595,7 @@ void QGeoPolygonPrivate::removeHole(int index)
         return;
 
     m_holesList.removeAt(index);
-    // ToDo: mark clipper dirty when hole caching gets added
+    m_clipperDirty = true;
 }
 
 int QGeoPolygonPrivate::holesCount() const
@@ -603,27 +603,46 @@ int QGeoPolygonPrivate::holesCount() const
     return m_holesList.size();
 }
 
-bool QGeoPolygonPrivate::polygonContains(const QGeoCoordinate &coordinate) const
+// The left bound of the bounding box of ring, as QGeoPathPrivate::computeBoundingBox() sets it
+static double ringLeftBoundWrapped(const QList<QGeoCoordinate> &ring)
 {
-    if (m_clipperDirty)
-        const_cast<QGeoPolygonPrivate *>(this)->updateClipperPath(); // this one updates bbox too if needed
+    QVector<double> deltaXs;
+    double minX, maxX, minLati, maxLati;
+    QGeoRectangle bbox;
+    computeBBox(ring, deltaXs, minX, maxX, minLati, maxLati, bbox);
+    return QWebMercator::coordToMercator(bbox.topLeft()).x();
+}
 
+static IntPoint toWrappedIntPoint(const QGeoCoordinate &coordinate, double leftBoundWrapped)
+{
     QDoubleVector2D coord = QWebMercator::coordToMercator(coordinate);
-
-    if (coord.x() < m_leftBoundWrapped)
+    if (coord.x() < leftBoundWrapped)
         coord.setX(coord.x() + 1.0);
+    return QClipperUtils::toIntPoint(coord);
+}
 
+static QtClipperLib::Path toWrappedClipperPath(const QList<QGeoCoordinate> &ring, double leftBoundWrapped)
+{
+    QtClipperLib::Path path;
+    path.reserve(ring.size());
+    for (const QGeoCoordinate &c : ring)
+        path.push_back(toWrappedIntPoint(c, leftBoundWrapped));
+    return path;
+}
 
-    IntPoint intCoord = QClipperUtils::toIntPoint(coord);
-    if (!c2t::clip2tri::pointInPolygon(intCoord, m_clipperPath))
+bool QGeoPolygonPrivate::polygonContains(const QGeoCoordinate &coordinate) const
+{
+    if (m_clipperDirty)
+        const_cast<QGeoPolygonPrivate *>(this)->updateClipperPath(); // this one updates bbox too if needed
+
+    if (!c2t::clip2tri::pointInPolygon(toWrappedIntPoint(coordinate, m_leftBoundWrapped), m_clipperPath))
         return false;
 
-    // else iterates the holes List checking whether the point is contained inside the holes
-    for (const QList<QGeoCoordinate> &holePath : qAsConst(m_holesList)) {
-        // ToDo: cache these
-        QGeoPolygon holePolygon;
-        holePolygon.setPath(holePath);
-        if (holePolygon.contains(coordinate))
+    // else iterates the holes List checking whether the point is contained inside the holes.
+    // Each hole is wrapped around its own bounding box, as a QGeoPolygon of its own would be.
+    for (int i = 0; i < m_holesClipperPaths.size(); ++i) {
+        const IntPoint holeCoord = toWrappedIntPoint(coordinate, m_holesLeftBoundWrapped.at(i));
+        if (c2t::clip2tri::pointInPolygon(holeCoord, m_holesClipperPaths.at(i)))
             return false;
     }
     return true;
@@ -640,14 +659,15 @@ void QGeoPolygonPrivate::updateClipperPath()
         computeBoundingBox();
     m_clipperDirty = false;
 
-    QList<QDoubleVector2D> preservedPath;
-    for (const QGeoCoordinate &c : m_path) {
-        QDoubleVector2D crd = QWebMercator::coordToMercator(c);
-        if (crd.x() < m_leftBoundWrapped)
-            crd.setX(crd.x() + 1.0);
-        preservedPath << crd;
+    m_clipperPath = toWrappedClipperPath(m_path, m_leftBoundWrapped);
+
+    m_holesClipperPaths.clear();
+    m_holesLeftBoundWrapped.clear();
+    for (const QList<QGeoCoordinate> &holePath : qAsConst(m_holesList)) {
+        const double leftBoundWrapped = ringLeftBoundWrapped(holePath);
+        m_holesLeftBoundWrapped << leftBoundWrapped;
+        m_holesClipperPaths << toWrappedClipperPath(holePath, leftBoundWrapped);
     }
-    m_clipperPath = QClipperUtils::qListToPath(preservedPath);
 }
 
 QGeoPolygonPrivateEager::QGeoPolygonPrivateEager() : QGeoPolygonPrivate()
@@ -738,4 +758,83 @@ QGeoPolygonEager::~QGeoPolygonEager()
 
 }
 
+QGeoPolygonPrivatePrepared::QGeoPolygonPrivatePrepared() : QGeoPolygonPrivate()
+{
+}
+
+QGeoPolygonPrivatePrepared::QGeoPolygonPrivatePrepared(const QList<QGeoCoordinate> &path) : QGeoPolygonPrivate(path)
+{
+}
+
+QGeoPolygonPrivatePrepared::~QGeoPolygonPrivatePrepared()
+{
+
+}
+
+QGeoShapePrivate *QGeoPolygonPrivatePrepared::clone() const
+{
+    return new QGeoPolygonPrivatePrepared(*this);
+}
+
+bool QGeoPolygonPrivatePrepared::contains(const QGeoCoordinate &coordinate) const
+{
+    if (m_clipperDirty)
+        const_cast<QGeoPolygonPrivatePrepared *>(this)->updateClipperPath();
+
+    if (!m_clipperIndex.pointInPolygon(toWrappedIntPoint(coordinate, m_leftBoundWrapped)))
+        return false;
+
+    for (int i = 0; i < m_holesClipperIndexes.size(); ++i) {
+        const IntPoint holeCoord = toWrappedIntPoint(coordinate, m_holesLeftBoundWrapped.at(i));
+        if (m_holesClipperIndexes.at(i).pointInPolygon(holeCoord))
+            return false;
+    }
+    return true;
+}
+
+void QGeoPolygonPrivatePrepared::updateClipperPath()
+{
+    QGeoPolygonPrivate::updateClipperPath();
+
+    m_clipperIndex = QClipperPathIndex(m_clipperPath);
+    m_holesClipperIndexes.clear();
+    for (const QtClipperLib::Path &holePath : qAsConst(m_holesClipperPaths))
+        m_holesClipperIndexes << QClipperPathIndex(holePath);
+}
+
+QGeoPolygonPrepared::QGeoPolygonPrepared() : QGeoPolygon()
+{
+    initPolygonConversions();
+    d_ptr = new QGeoPolygonPrivatePrepared;
+}
+
+QGeoPolygonPrepared::QGeoPolygonPrepared(const QList<QGeoCoordinate> &path) : QGeoPolygon()
+{
+    initPolygonConversions();
+    d_ptr = new QGeoPolygonPrivatePrepared(path);
+}
+
+QGeoPolygonPrepared::QGeoPolygonPrepared(const QGeoPolygon &other) : QGeoPolygon()
+{
+    initPolygonConversions();
+    d_ptr = new QGeoPolygonPrivatePrepared;
+    setPath(other.path());
+    for (int i = 0; i < other.holesCount(); i++)
+        addHole(other.holePath(i));
+}
+
+QGeoPolygonPrepared::QGeoPolygonPrepared(const QGeoShape &other) : QGeoPolygon()
+{
+    initPolygonConversions();
+    if (other.type() == QGeoShape::PolygonType)
+        *this = QGeoPolygonPrepared(QGeoPolygon(other));
+    else
+        d_ptr = new QGeoPolygonPrivatePrepared;
+}
+
+QGeoPolygonPrepared::~QGeoPolygonPrepared()
+{
+
+}
+
 QT_END_NAMESPACE
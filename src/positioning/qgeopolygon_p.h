@@ -87,6 +87,8 @@ public:
     bool m_clipperDirty = true;
     QList<QList<QGeoCoordinate>> m_holesList;
     QtClipperLib::Path m_clipperPath;
+    QList<QtClipperLib::Path> m_holesClipperPaths;
+    QList<double> m_holesLeftBoundWrapped;
 };
 
 class Q_POSITIONING_PRIVATE_EXPORT QGeoPolygonPrivateEager : public QGeoPolygonPrivate
@@ -131,6 +133,40 @@ public:
     ~QGeoPolygonEager();
 };
 
+// A polygon that indexes the edges of its rings to answer contains() in sublinear time.
+// Worth it when many points are tested against the same polygon.
+class Q_POSITIONING_PRIVATE_EXPORT QGeoPolygonPrivatePrepared : public QGeoPolygonPrivate
+{
+public:
+    QGeoPolygonPrivatePrepared();
+    QGeoPolygonPrivatePrepared(const QList<QGeoCoordinate> &path);
+    ~QGeoPolygonPrivatePrepared();
+
+// QGeoShape API
+    virtual QGeoShapePrivate *clone() const override;
+    virtual bool contains(const QGeoCoordinate &coordinate) const override;
+
+// QGeoPolygonPrivate API
+    virtual void updateClipperPath() override;
+
+// data members
+    QClipperPathIndex m_clipperIndex;
+    QList<QClipperPathIndex> m_holesClipperIndexes;
+};
+
+// This is a mean of creating a QGeoPolygonPrivatePrepared and injecting it into QGeoPolygons via operator=
+class Q_POSITIONING_PRIVATE_EXPORT QGeoPolygonPrepared : public QGeoPolygon
+{
+    Q_GADGET
+public:
+
+    QGeoPolygonPrepared();
+    QGeoPolygonPrepared(const QList<QGeoCoordinate> &path);
+    QGeoPolygonPrepared(const QGeoPolygon &other);
+    QGeoPolygonPrepared(const QGeoShape &other);
+    ~QGeoPolygonPrepared();
+};
+
 QT_END_NAMESPACE
 
 #endif // QGEOPOLYGON_P_H
@@ -51,178 +51,323 @@
 
 QT_BEGIN_NAMESPACE
 
+namespace {
+
+/*
+    A field of an NMEA sentence. It points into the sentence, which is never copied.
+*/
+struct NmeaField
+{
+    const char *data = nullptr;
+    int size = 0;
+
+    bool isEmpty() const { return size == 0; }
+    char first() const { return data[0]; }
+};
+
+/*
+    Records where each comma separated field of a sentence starts, in a fixed array.
+    Fields past MaxFields are dropped, and the missing ones read as empty.
+*/
+class NmeaTokenizer
+{
+public:
+    enum { MaxFields = 40 };
+
+    NmeaTokenizer(const char *data, int size)
+    {
+        int start = 0;
+        for (int i = 0; i <= size && count_ < MaxFields; ++i) {
+            if (i == size || data[i] == ',') {
+                fields_[count_].data = data + start;
+                fields_[count_].size = i - start;
+                ++count_;
+                start = i + 1;
+            }
+        }
+    }
+
+    int count() const { return count_; }
+    NmeaField operator[](int i) const { return i < count_ ? fields_[i] : NmeaField(); }
+
+private:
+    NmeaField fields_[MaxFields];
+    int count_ = 0;
+};
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline int hexDigitValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+bool nmeaToInt(NmeaField field, int *value)
+{
+    const char *p = field.data;
+    const char *end = p + field.size;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+    if (p == end || end - p > 9)
+        return false;
+
+    int result = 0;
+    for (; p < end; ++p) {
+        if (!isDigit(*p))
+            return false;
+        result = result * 10 + (*p - '0');
+    }
+    *value = negative ? -result : result;
+    return true;
+}
+
+/*
+    Parses [sign]digits[.digits], which is all NMEA uses. With at most 15 significant
+    digits, the mantissa and the power of ten are exact doubles, so that their quotient
+    is correctly rounded, as strtod() would. Anything else goes through QByteArray.
+*/
+bool nmeaToDouble(NmeaField field, double *value)
+{
+    static const double powersOf10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char *p = field.data;
+    const char *end = p + field.size;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+
+    quint64 mantissa = 0;
+    int significantDigits = 0;
+    int digits = 0;
+    int fractionDigits = 0;
+    bool hasDot = false;
+    for (; p < end; ++p) {
+        if (isDigit(*p)) {
+            ++digits;
+            if (mantissa || *p != '0')
+                ++significantDigits;
+            mantissa = mantissa * 10 + quint64(*p - '0');
+            if (hasDot)
+                ++fractionDigits;
+            if (significantDigits > 15 || fractionDigits > 22)
+                break;
+        } else if (*p == '.' && !hasDot) {
+            hasDot = true;
+        } else {
+            break;
+        }
+    }
+    if (p != end) {
+        bool ok = false;
+        const double result = QByteArray::fromRawData(field.data, field.size).toDouble(&ok);
+        if (ok)
+            *value = result;
+        return ok;
+    }
+    if (!digits)
+        return false;
+
+    const double result = double(mantissa) / powersOf10[fractionDigits];
+    *value = negative ? -result : result;
+    return true;
+}
+
+bool nmeaToTime(const char *data, int size, QTime *time)
+{
+    // hhmmss, optionally followed by a fraction of a second
+    if (size < 6 || (size > 6 && data[6] != '.'))
+        return false;
+    for (int i = 0; i < 6; ++i) {
+        if (!isDigit(data[i]))
+            return false;
+    }
+    QTime tempTime((data[0] - '0') * 10 + data[1] - '0',
+                   (data[2] - '0') * 10 + data[3] - '0',
+                   (data[4] - '0') * 10 + data[5] - '0');
+    if (!tempTime.isValid())
+        return false;
+
+    const int fractionSize = qMin(3, size - 7);
+    if (fractionSize > 0) {
+        int msecs = 0;
+        bool hasMsecs = true;
+        for (int i = 7; i < 7 + fractionSize; ++i) {
+            hasMsecs = hasMsecs && isDigit(data[i]);
+            msecs = msecs * 10 + data[i] - '0';
+        }
+        if (hasMsecs)
+            tempTime = tempTime.addMSecs(msecs * (fractionSize == 3 ? 1 : fractionSize == 2 ? 10 : 100));
+    }
+
+    *time = tempTime;
+    return true;
+}
+
+// ddmmyy, in this century
+QDate nmeaToDate(NmeaField field)
+{
+    if (field.size != 6)
+        return QDate();
+    for (int i = 0; i < 6; ++i) {
+        if (!isDigit(field.data[i]))
+            return QDate();
+    }
+    const QDate date(2000 + (field.data[4] - '0') * 10 + field.data[5] - '0',
+                     (field.data[2] - '0') * 10 + field.data[3] - '0',
+                     (field.data[0] - '0') * 10 + field.data[1] - '0');
+    return date.isValid() ? date : QDate();
+}
+
 // converts e.g. 15306.0235 from NMEA sentence to 153.100392
-static double qlocationutils_nmeaDegreesToDecimal(double nmeaDegrees)
+double nmeaDegreesToDecimal(double nmeaDegrees)
 {
     double deg;
     double min = 100.0 * modf(nmeaDegrees / 100.0, &deg);
     return deg + (min / 60.0);
 }
 
-static void qlocationutils_readGga(const char *data, int size, QGeoPositionInfo *info, double uere,
-                                   bool *hasFix)
+bool nmeaToLatLong(NmeaField latString, char latDirection, NmeaField lngString, char lngDirection,
+                   double *lat, double *lng)
 {
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
-    QGeoCoordinate coord;
+    if ((latDirection != 'N' && latDirection != 'S')
+            || (lngDirection != 'E' && lngDirection != 'W')) {
+        return false;
+    }
 
-    if (hasFix && parts.count() > 6 && parts[6].count() > 0)
-        *hasFix = parts[6].toInt() > 0;
+    double tempLat;
+    double tempLng;
+    if (nmeaToDouble(latString, &tempLat) && nmeaToDouble(lngString, &tempLng)) {
+        tempLat = nmeaDegreesToDecimal(tempLat);
+        if (latDirection == 'S')
+            tempLat *= -1;
+        tempLng = nmeaDegreesToDecimal(tempLng);
+        if (lngDirection == 'W')
+            tempLng *= -1;
 
-    if (parts.count() > 1 && parts[1].count() > 0) {
-        QTime time;
-        if (QLocationUtils::getNmeaTime(parts[1], &time))
-            info->setTimestamp(QDateTime(QDate(), time, Qt::UTC));
+        if (QLocationUtils::isValidLat(tempLat) && QLocationUtils::isValidLong(tempLng)) {
+            *lat = tempLat;
+            *lng = tempLng;
+            return true;
+        }
     }
+    return false;
+}
 
-    if (parts.count() > 5 && parts[3].count() == 1 && parts[5].count() == 1) {
+// Reads the lat/long at field, followed by its direction and the longitude fields
+void readNmeaCoordinate(const NmeaTokenizer &parts, int field, QGeoCoordinate *coord)
+{
+    if (parts.count() > field + 3 && parts[field + 1].size == 1 && parts[field + 3].size == 1) {
         double lat;
         double lng;
-        if (QLocationUtils::getNmeaLatLong(parts[2], parts[3][0], parts[4], parts[5][0], &lat, &lng)) {
-            coord.setLatitude(lat);
-            coord.setLongitude(lng);
+        if (nmeaToLatLong(parts[field], parts[field + 1].first(),
+                          parts[field + 2], parts[field + 3].first(), &lat, &lng)) {
+            coord->setLatitude(lat);
+            coord->setLongitude(lng);
         }
     }
+}
 
-    if (parts.count() > 8 && !parts[8].isEmpty()) {
-        bool hasHdop = false;
-        double hdop = parts[8].toDouble(&hasHdop);
-        if (hasHdop)
-            info->setAttribute(QGeoPositionInfo::HorizontalAccuracy, 2 * hdop * uere);
-    }
+void readGga(const NmeaTokenizer &parts, QGeoPositionInfo *info, double uere, bool *hasFix)
+{
+    QGeoCoordinate coord;
+    int fixQuality;
+    if (hasFix && nmeaToInt(parts[6], &fixQuality))
+        *hasFix = fixQuality > 0;
 
-    if (parts.count() > 9 && parts[9].count() > 0) {
-        bool hasAlt = false;
-        double alt = parts[9].toDouble(&hasAlt);
-        if (hasAlt)
-            coord.setAltitude(alt);
-    }
+    QTime time;
+    if (nmeaToTime(parts[1].data, parts[1].size, &time))
+        info->setTimestamp(QDateTime(QDate(), time, Qt::UTC));
+
+    readNmeaCoordinate(parts, 2, &coord);
+
+    double value;
+    if (nmeaToDouble(parts[8], &value))
+        info->setAttribute(QGeoPositionInfo::HorizontalAccuracy, 2 * value * uere);
+
+    if (nmeaToDouble(parts[9], &value))
+        coord.setAltitude(value);
 
     if (coord.type() != QGeoCoordinate::InvalidCoordinate)
         info->setCoordinate(coord);
 }
 
-static void qlocationutils_readGsa(const char *data, int size, QGeoPositionInfo *info, double uere,
-                                   bool *hasFix)
+void readGsa(const NmeaTokenizer &parts, QGeoPositionInfo *info, double uere, bool *hasFix)
 {
-    QList<QByteArray> parts = QByteArray::fromRawData(data, size).split(',');
-
-    if (hasFix && parts.count() > 2 && !parts[2].isEmpty())
-        *hasFix = parts[2].toInt() > 0;
-
-    if (parts.count() > 16 && !parts[16].isEmpty()) {
-        bool hasHdop = false;
-        double hdop = parts[16].toDouble(&hasHdop);
-        if (hasHdop)
-            info->setAttribute(QGeoPositionInfo::HorizontalAccuracy, 2 * hdop * uere);
-    }
-
-    if (parts.count() > 17 && !parts[17].isEmpty()) {
-        bool hasVdop = false;
-        double vdop = parts[17].toDouble(&hasVdop);
-        if (hasVdop)
-            info->setAttribute(QGeoPositionInfo::VerticalAccuracy, 2 * vdop * uere);
-    }
+    int fixMode;
+    if (hasFix && nmeaToInt(parts[2], &fixMode))
+        *hasFix = fixMode > 0;
+
+    double value;
+    if (nmeaToDouble(parts[16], &value))
+        info->setAttribute(QGeoPositionInfo::HorizontalAccuracy, 2 * value * uere);
+    if (nmeaToDouble(parts[17], &value))
+        info->setAttribute(QGeoPositionInfo::VerticalAccuracy, 2 * value * uere);
 }
 
-static void qlocationutils_readGsa(const char *data,
-                                              int size,
-                                              QList<int> &pnrsInUse)
+void readGsa(const NmeaTokenizer &parts, QList<int> &pnrsInUse)
 {
-    QList<QByteArray> parts = QByteArray::fromRawData(data, size).split(',');
     pnrsInUse.clear();
     if (parts.count() <= 2)
         return;
-    bool ok;
-    for (int i = 3; i <= qMin(14, parts.size()); ++i) {
-        const QByteArray &pnrString = parts.at(i);
-        if (pnrString.isEmpty())
-            continue;
-        int pnr = pnrString.toInt(&ok);
-        if (ok)
+    for (int i = 3; i <= 14; ++i) {
+        int pnr;
+        if (nmeaToInt(parts[i], &pnr))
             pnrsInUse.append(pnr);
     }
 }
 
-static void qlocationutils_readGll(const char *data, int size, QGeoPositionInfo *info, bool *hasFix)
+void readGll(const NmeaTokenizer &parts, QGeoPositionInfo *info, bool *hasFix)
 {
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
     QGeoCoordinate coord;
 
-    if (hasFix && parts.count() > 6 && parts[6].count() > 0)
-        *hasFix = (parts[6][0] == 'A');
+    if (hasFix && !parts[6].isEmpty())
+        *hasFix = (parts[6].first() == 'A');
 
-    if (parts.count() > 5 && parts[5].count() > 0) {
-        QTime time;
-        if (QLocationUtils::getNmeaTime(parts[5], &time))
-            info->setTimestamp(QDateTime(QDate(), time, Qt::UTC));
-    }
+    QTime time;
+    if (nmeaToTime(parts[5].data, parts[5].size, &time))
+        info->setTimestamp(QDateTime(QDate(), time, Qt::UTC));
 
-    if (parts.count() > 4 && parts[2].count() == 1 && parts[4].count() == 1) {
-        double lat;
-        double lng;
-        if (QLocationUtils::getNmeaLatLong(parts[1], parts[2][0], parts[3], parts[4][0], &lat, &lng)) {
-            coord.setLatitude(lat);
-            coord.setLongitude(lng);
-        }
-    }
+    readNmeaCoordinate(parts, 1, &coord);
 
     if (coord.type() != QGeoCoordinate::InvalidCoordinate)
         info->setCoordinate(coord);
 }
 
-static void qlocationutils_readRmc(const char *data, int size, QGeoPositionInfo *info, bool *hasFix)
+void readRmc(const NmeaTokenizer &parts, QGeoPositionInfo *info, bool *hasFix)
 {
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
     QGeoCoordinate coord;
-    QDate date;
     QTime time;
 
-    if (hasFix && parts.count() > 2 && parts[2].count() > 0)
-        *hasFix = (parts[2][0] == 'A');
-
-    if (parts.count() > 9 && parts[9].count() == 6) {
-        date = QDate::fromString(QString::fromLatin1(parts[9]), QStringLiteral("ddMMyy"));
-        if (date.isValid())
-            date = date.addYears(100);     // otherwise starts from 1900
-        else
-            date = QDate();
-    }
-
-    if (parts.count() > 1 && parts[1].count() > 0)
-        QLocationUtils::getNmeaTime(parts[1], &time);
-
-    if (parts.count() > 6 && parts[4].count() == 1 && parts[6].count() == 1) {
-        double lat;
-        double lng;
-        if (QLocationUtils::getNmeaLatLong(parts[3], parts[4][0], parts[5], parts[6][0], &lat, &lng)) {
-            coord.setLatitude(lat);
-            coord.setLongitude(lng);
-        }
-    }
-
-    bool parsed = false;
-    double value = 0.0;
-    if (parts.count() > 7 && parts[7].count() > 0) {
-        value = parts[7].toDouble(&parsed);
-        if (parsed)
-            info->setAttribute(QGeoPositionInfo::GroundSpeed, qreal(value * 1.852 / 3.6));    // knots -> m/s
-    }
-    if (parts.count() > 8 && parts[8].count() > 0) {
-        value = parts[8].toDouble(&parsed);
-        if (parsed)
-            info->setAttribute(QGeoPositionInfo::Direction, qreal(value));
-    }
-    if (parts.count() > 11 && parts[11].count() == 1
-            && (parts[11][0] == 'E' || parts[11][0] == 'W')) {
-        value = parts[10].toDouble(&parsed);
-        if (parsed) {
-            if (parts[11][0] == 'W')
-                value *= -1;
-            info->setAttribute(QGeoPositionInfo::MagneticVariation, qreal(value));
-        }
+    if (hasFix && !parts[2].isEmpty())
+        *hasFix = (parts[2].first() == 'A');
+
+    const QDate date = nmeaToDate(parts[9]);
+    nmeaToTime(parts[1].data, parts[1].size, &time);
+    readNmeaCoordinate(parts, 3, &coord);
+
+    double value;
+    if (nmeaToDouble(parts[7], &value))
+        info->setAttribute(QGeoPositionInfo::GroundSpeed, qreal(value * 1.852 / 3.6));    // knots -> m/s
+    if (nmeaToDouble(parts[8], &value))
+        info->setAttribute(QGeoPositionInfo::Direction, qreal(value));
+    if (parts[11].size == 1 && (parts[11].first() == 'E' || parts[11].first() == 'W')
+            && nmeaToDouble(parts[10], &value)) {
+        if (parts[11].first() == 'W')
+            value *= -1;
+        info->setAttribute(QGeoPositionInfo::MagneticVariation, qreal(value));
     }
 
     if (coord.type() != QGeoCoordinate::InvalidCoordinate)
@@ -231,51 +376,49 @@ static void qlocationutils_readRmc(const char *data, int size, QGeoPositionInfo
     info->setTimestamp(QDateTime(date, time, Qt::UTC));
 }
 
-static void qlocationutils_readVtg(const char *data, int size, QGeoPositionInfo *info, bool *hasFix)
+void readVtg(const NmeaTokenizer &parts, QGeoPositionInfo *info, bool *hasFix)
 {
     if (hasFix)
         *hasFix = false;
 
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
-
-    bool parsed = false;
-    double value = 0.0;
-    if (parts.count() > 1 && parts[1].count() > 0) {
-        value = parts[1].toDouble(&parsed);
-        if (parsed)
-            info->setAttribute(QGeoPositionInfo::Direction, qreal(value));
-    }
-    if (parts.count() > 7 && parts[7].count() > 0) {
-        value = parts[7].toDouble(&parsed);
-        if (parsed)
-            info->setAttribute(QGeoPositionInfo::GroundSpeed, qreal(value / 3.6));    // km/h -> m/s
-    }
+    double value;
+    if (nmeaToDouble(parts[1], &value))
+        info->setAttribute(QGeoPositionInfo::Direction, qreal(value));
+    if (nmeaToDouble(parts[7], &value))
+        info->setAttribute(QGeoPositionInfo::GroundSpeed, qreal(value / 3.6));    // km/h -> m/s
 }
 
-static void qlocationutils_readZda(const char *data, int size, QGeoPositionInfo *info, bool *hasFix)
+void readZda(const NmeaTokenizer &parts, QGeoPositionInfo *info, bool *hasFix)
 {
     if (hasFix)
         *hasFix = false;
 
-    QByteArray sentence(data, size);
-    QList<QByteArray> parts = sentence.split(',');
     QDate date;
     QTime time;
+    nmeaToTime(parts[1].data, parts[1].size, &time);
+
+    int day;
+    int month;
+    int year;
+    if (parts[4].size == 4     // must be full 4-digit year
+            && nmeaToInt(parts[2], &day) && nmeaToInt(parts[3], &month) && nmeaToInt(parts[4], &year)
+            && day > 0 && month > 0 && year > 0) {
+        date.setDate(year, month, day);
+    }
 
-    if (parts.count() > 1 && parts[1].count() > 0)
-        QLocationUtils::getNmeaTime(parts[1], &time);
+    info->setTimestamp(QDateTime(date, time, Qt::UTC));
+}
 
-    if (parts.count() > 4 && parts[2].count() > 0 && parts[3].count() > 0
-            && parts[4].count() == 4) {     // must be full 4-digit year
-        int day = parts[2].toUInt();
-        int month = parts[3].toUInt();
-        int year = parts[4].toUInt();
-        if (day > 0 && month > 0 && year > 0)
-            date.setDate(year, month, day);
+// The size of the sentence without its checksum
+int nmeaPayloadSize(const char *data, int size)
+{
+    for (int i = 0; i < size; ++i) {
+        if (data[i] == '*')
+            return i;
     }
+    return size;
+}
 
-    info->setTimestamp(QDateTime(date, time, Qt::UTC));
 }
 
 QLocationUtils::NmeaSentence QLocationUtils::getNmeaSentenceType(const char *data, int size)
@@ -320,32 +463,27 @@ bool QLocationUtils::getPosInfoFromNmea(const char *data, int size, QGeoPosition
     if (nmeaType == NmeaSentenceInvalid)
         return false;
 
-    // Adjust size so that * and following characters are not parsed by the following functions.
-    for (int i = 0; i < size; ++i) {
-        if (data[i] == '*') {
-            size = i;
-            break;
-        }
-    }
+    // The * and following characters are not parsed by the following functions.
+    const NmeaTokenizer parts(data, nmeaPayloadSize(data, size));
 
     switch (nmeaType) {
     case NmeaSentenceGGA:
-        qlocationutils_readGga(data, size, info, uere, hasFix);
+        readGga(parts, info, uere, hasFix);
         return true;
     case NmeaSentenceGSA:
-        qlocationutils_readGsa(data, size, info, uere, hasFix);
+        readGsa(parts, info, uere, hasFix);
         return true;
     case NmeaSentenceGLL:
-        qlocationutils_readGll(data, size, info, hasFix);
+        readGll(parts, info, hasFix);
         return true;
     case NmeaSentenceRMC:
-        qlocationutils_readRmc(data, size, info, hasFix);
+        readRmc(parts, info, hasFix);
         return true;
     case NmeaSentenceVTG:
-        qlocationutils_readVtg(data, size, info, hasFix);
+        readVtg(parts, info, hasFix);
         return true;
     case NmeaSentenceZDA:
-        qlocationutils_readZda(data, size, info, hasFix);
+        readZda(parts, info, hasFix);
         return true;
     default:
         return false;
@@ -361,27 +499,26 @@ QLocationUtils::GSVParseStatus QLocationUtils::getSatInfoFromNmea(const char *da
     if (nmeaType != NmeaSentenceGSV)
         return GSVNotParsed;
 
-    QList<QByteArray> parts = QByteArray::fromRawData(data, size).split(',');
+    const NmeaTokenizer parts(data, nmeaPayloadSize(data, size));
 
     if (parts.count() <= 3) {
         infos.clear();
         return GSVFullyParsed; // Malformed sentence.
     }
-    bool ok;
-    const int totalSentences = parts.at(1).toInt(&ok);
-    if (!ok) {
+    int totalSentences;
+    if (!nmeaToInt(parts[1], &totalSentences)) {
         infos.clear();
         return GSVFullyParsed; // Malformed sentence.
     }
 
-    const int sentence = parts.at(2).toInt(&ok);
-    if (!ok) {
+    int sentence;
+    if (!nmeaToInt(parts[2], &sentence)) {
         infos.clear();
         return GSVFullyParsed; // Malformed sentence.
     }
 
-    const int totalSats = parts.at(3).toInt(&ok);
-    if (!ok) {
+    int totalSats;
+    if (!nmeaToInt(parts[3], &totalSats)) {
         infos.clear();
         return GSVFullyParsed; // Malformed sentence.
     }
@@ -394,14 +531,11 @@ QLocationUtils::GSVParseStatus QLocationUtils::getSatInfoFromNmea(const char *da
     int field = 4;
     for (int i = 0; i < numSatInSentence; ++i) {
         QGeoSatelliteInfo info;
-        const int prn = parts.at(field++).toInt(&ok);
-        info.setSatelliteIdentifier((ok) ? prn : 0);
-        const int elevation = parts.at(field++).toInt(&ok);
-        info.setAttribute(QGeoSatelliteInfo::Elevation, (ok) ? elevation : 0);
-        const int azimuth = parts.at(field++).toInt(&ok);
-        info.setAttribute(QGeoSatelliteInfo::Azimuth, (ok) ? azimuth : 0);
-        const int snr = parts.at(field++).toInt(&ok);
-        info.setSignalStrength((ok) ? snr : -1);
+        int value;
+        info.setSatelliteIdentifier(nmeaToInt(parts[field++], &value) ? value : 0);
+        info.setAttribute(QGeoSatelliteInfo::Elevation, nmeaToInt(parts[field++], &value) ? value : 0);
+        info.setAttribute(QGeoSatelliteInfo::Azimuth, nmeaToInt(parts[field++], &value) ? value : 0);
+        info.setSignalStrength(nmeaToInt(parts[field++], &value) ? value : -1);
         infos.append(info);
     }
 
@@ -420,14 +554,8 @@ bool QLocationUtils::getSatInUseFromNmea(const char *data, int size, QList<int>
     if (nmeaType != NmeaSentenceGSA)
         return false;
 
-    // Adjust size so that * and following characters are not parsed by the following functions.
-    for (int i = 0; i < size; ++i) {
-        if (data[i] == '*') {
-            size = i;
-            break;
-        }
-    }
-    qlocationutils_readGsa(data, size, pnrsInUse);
+    // The * and following characters are not parsed by the following functions.
+    readGsa(NmeaTokenizer(data, nmeaPayloadSize(data, size)), pnrsInUse);
     return true;
 }
 
@@ -449,69 +577,26 @@ bool QLocationUtils::hasValidNmeaChecksum(const char *data, int size)
     int result = 0;
     for (int i = 1; i < asteriskIndex; ++i)
         result ^= data[i];
-    /*
-        char calc[CSUM_LEN + 1];
-        ::snprintf(calc, CSUM_LEN + 1, "%02x", result);
-        return ::strncmp(calc, &data[asteriskIndex+1], 2) == 0;
-        */
-
-    QByteArray checkSumBytes(&data[asteriskIndex + 1], 2);
-    bool ok = false;
-    int checksum = checkSumBytes.toInt(&ok,16);
-    return ok && checksum == result;
+
+    const int high = hexDigitValue(data[asteriskIndex + 1]);
+    const int low = hexDigitValue(data[asteriskIndex + 2]);
+    return high >= 0 && low >= 0 && (high << 4 | low) == result;
 }
 
 bool QLocationUtils::getNmeaTime(const QByteArray &bytes, QTime *time)
 {
-    int dotIndex = bytes.indexOf('.');
-    QTime tempTime;
-
-    if (dotIndex < 0) {
-        tempTime = QTime::fromString(QString::fromLatin1(bytes.constData()),
-                                     QStringLiteral("hhmmss"));
-    } else {
-        tempTime = QTime::fromString(QString::fromLatin1(bytes.mid(0, dotIndex)),
-                                     QStringLiteral("hhmmss"));
-        bool hasMsecs = false;
-        int midLen = qMin(3, bytes.size() - dotIndex - 1);
-        int msecs = bytes.mid(dotIndex + 1, midLen).toUInt(&hasMsecs);
-        if (hasMsecs)
-            tempTime = tempTime.addMSecs(msecs*(midLen == 3 ? 1 : midLen == 2 ? 10 : 100));
-    }
-
-    if (tempTime.isValid()) {
-        *time = tempTime;
-        return true;
-    }
-    return false;
+    return nmeaToTime(bytes.constData(), bytes.size(), time);
 }
 
 bool QLocationUtils::getNmeaLatLong(const QByteArray &latString, char latDirection, const QByteArray &lngString, char lngDirection, double *lat, double *lng)
 {
-    if ((latDirection != 'N' && latDirection != 'S')
-            || (lngDirection != 'E' && lngDirection != 'W')) {
-        return false;
-    }
-
-    bool hasLat = false;
-    bool hasLong = false;
-    double tempLat = latString.toDouble(&hasLat);
-    double tempLng = lngString.toDouble(&hasLong);
-    if (hasLat && hasLong) {
-        tempLat = qlocationutils_nmeaDegreesToDecimal(tempLat);
-        if (latDirection == 'S')
-            tempLat *= -1;
-        tempLng = qlocationutils_nmeaDegreesToDecimal(tempLng);
-        if (lngDirection == 'W')
-            tempLng *= -1;
-
-        if (isValidLat(tempLat) && isValidLong(tempLng)) {
-            *lat = tempLat;
-            *lng = tempLng;
-            return true;
-        }
-    }
-    return false;
+    NmeaField latField;
+    latField.data = latString.constData();
+    latField.size = latString.size();
+    NmeaField lngField;
+    lngField.data = lngString.constData();
+    lngField.size = lngString.size();
+    return nmeaToLatLong(latField, latDirection, lngField, lngDirection, lat, lng);
 }
 
 QT_END_NAMESPACE
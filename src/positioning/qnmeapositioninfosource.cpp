@@ -43,12 +43,14 @@
 #include "qlocationutils_p.h"
 
 #include <QIODevice>
+#include <QFile>
 #include <QBasicTimer>
 #include <QTimerEvent>
 #include <QTimer>
 #include <array>
 #include <QDebug>
 #include <QtCore/QtNumeric>
+#include <string.h>
 
 
 QT_BEGIN_NAMESPACE
@@ -134,7 +136,8 @@ static bool propagateAttributes(QGeoPositionInfo &dst, const QGeoPositionInfo &s
 
 // returns false if src does not contain any additional or different data than dst,
 // true otherwise.
-static bool mergePositions(QGeoPositionInfo &dst, const QGeoPositionInfo &src, QByteArray nmeaSentence)
+static bool mergePositions(QGeoPositionInfo &dst, const QGeoPositionInfo &src,
+                           const char *nmeaSentence, int size)
 {
     bool updated = false;
 
@@ -144,9 +147,10 @@ static bool mergePositions(QGeoPositionInfo &dst, const QGeoPositionInfo &src, Q
 
 #if USE_NMEA_PIMPL
     QGeoPositionInfoPrivateNmea *dstPimpl = static_cast<QGeoPositionInfoPrivateNmea *>(QGeoPositionInfoPrivate::get(dst));
-    dstPimpl->nmeaSentences.append(nmeaSentence);
+    dstPimpl->nmeaSentences.append(QByteArray(nmeaSentence, size));
 #else
     Q_UNUSED(nmeaSentence);
+    Q_UNUSED(size);
 #endif
     return updated;
 }
@@ -162,8 +166,108 @@ static qint64 msecsTo(const QDateTime &from, const QDateTime &to)
     return from.msecsTo(to);
 }
 
+void QNmeaUpdateCompleter::complete(QGeoPositionInfo *update)
+{
+    QDate date = update->timestamp().date();
+    if (date.isValid()) {
+        m_currentDate = date;
+    } else {
+        // some sentence have time but no date
+        QTime time = update->timestamp().time();
+        if (time.isValid() && m_currentDate.isValid())
+            update->setTimestamp(QDateTime(m_currentDate, time, Qt::UTC));
+    }
+
+    // Some attributes are sent in separate NMEA sentences. Save and restore the accuracy
+    // measurements.
+    if (update->hasAttribute(QGeoPositionInfo::HorizontalAccuracy))
+        m_horizontalAccuracy = update->attribute(QGeoPositionInfo::HorizontalAccuracy);
+    else if (!qIsNaN(m_horizontalAccuracy))
+        update->setAttribute(QGeoPositionInfo::HorizontalAccuracy, m_horizontalAccuracy);
+
+    if (update->hasAttribute(QGeoPositionInfo::VerticalAccuracy))
+        m_verticalAccuracy = update->attribute(QGeoPositionInfo::VerticalAccuracy);
+    else if (!qIsNaN(m_verticalAccuracy))
+        update->setAttribute(QGeoPositionInfo::VerticalAccuracy, m_verticalAccuracy);
+}
+
+QNmeaUpdateMerger::QNmeaUpdateMerger()
+    : m_update(*new QGeoPositionInfoPrivateNmea)
+{
+}
+
+bool QNmeaUpdateMerger::addPosition(QGeoPositionInfo &pos, bool hasFix, const char *data, int size)
+{
+    const QTime infoTime = m_update.timestamp().time(); // if update has been set, time must be valid.
+    const QDate infoDate = m_update.timestamp().date(); // this one might not be valid, as some sentences do not contain it
+
+    const bool oldFix = m_hasFix;
+    m_hasFix |= hasFix;
+
+    // Date may or may not be valid, as some packets do not have date.
+    // If date isn't valid, match is performed on time only.
+    // Hence, make sure that packet blocks are generated with
+    // the sentences containing the full timestamp (e.g., GPRMC) *first* !
+    if (infoTime.isValid()) {
+        if (pos.timestamp().time().isValid()) {
+            const bool newerTime = infoTime < pos.timestamp().time();
+            const bool newerDate = (infoDate.isValid() // if time is valid but one date or both are not,
+                                    && pos.timestamp().date().isValid()
+                                    && infoDate < pos.timestamp().date());
+            if (newerTime || newerDate) {
+                // Effectively read data for different update, that is also newer,
+                // so flush retained update, and copy the new pos into m_update
+                const QDate updateDate = m_update.timestamp().date();
+                const QDate lastPushedDate = m_lastPushedTS.date();
+                const bool newerTimestampSinceLastPushed = m_update.timestamp() > m_lastPushedTS;
+                const bool invalidDate = !(updateDate.isValid() && lastPushedDate.isValid());
+                const bool newerTimeSinceLastPushed = m_update.timestamp().time() > m_lastPushedTS.time();
+                if ( newerTimestampSinceLastPushed || (invalidDate && newerTimeSinceLastPushed)) {
+                    pushUpdate(&m_update, oldFix);
+                    m_lastPushedTS = m_update.timestamp();
+                }
+                // next update data
+                propagateAttributes(pos, m_update, false);
+                m_update = pos;
+                m_hasFix = hasFix;
+                return true;
+            }
+            // timestamps match -- merge into m_update
+            if (infoTime == pos.timestamp().time())
+                return mergePositions(m_update, pos, data, size);
+            // else discard out of order outdated info.
+            return false;
+        }
+        // no timestamp available in parsed update-- merge into m_update
+        return mergePositions(m_update, pos, data, size);
+    }
+
+    // there was no info with valid TS. Overwrite with whatever is parsed.
+#if USE_NMEA_PIMPL
+    static_cast<QGeoPositionInfoPrivateNmea *>(QGeoPositionInfoPrivate::get(pos))->nmeaSentences.append(QByteArray(data, size));
+#else
+    Q_UNUSED(data);
+    Q_UNUSED(size);
+#endif
+    propagateAttributes(pos, m_update);
+    m_update = pos;
+    return true;
+}
+
+void QNmeaUpdateMerger::pushPendingUpdate()
+{
+    const bool newerTime = m_update.timestamp().time() > m_lastPushedTS.time();
+    const bool newerDate = (m_update.timestamp().date().isValid()
+                            && m_lastPushedTS.date().isValid()
+                            && m_update.timestamp().date() > m_lastPushedTS.date());
+    if (newerTime || newerDate) {
+        pushUpdate(&m_update, m_hasFix);
+        m_lastPushedTS = m_update.timestamp();
+    }
+}
+
 QNmeaRealTimeReader::QNmeaRealTimeReader(QNmeaPositionInfoSourcePrivate *sourcePrivate)
-        : QNmeaReader(sourcePrivate), m_update(*new QGeoPositionInfoPrivateNmea)
+        : QNmeaReader(sourcePrivate)
 {
     // An env var controlling the number of milliseconds to use to withold
     // an update and wait for additional data to combine.
@@ -188,15 +292,11 @@ QNmeaRealTimeReader::QNmeaRealTimeReader(QNmeaPositionInfoSourcePrivate *sourceP
 void QNmeaRealTimeReader::readAvailableData()
 {
     while (m_proxy->m_device->canReadLine()) {
-        const QTime infoTime = m_update.timestamp().time(); // if update has been set, time must be valid.
-        const QDate infoDate = m_update.timestamp().date(); // this one might not be valid, as some sentences do not contain it
-
         QGeoPositionInfoPrivateNmea *pimpl = new QGeoPositionInfoPrivateNmea;
         QGeoPositionInfo pos(*pimpl);
 
         char buf[1024];
         qint64 size = m_proxy->m_device->readLine(buf, sizeof(buf));
-        const bool oldFix = m_hasFix;
         bool hasFix;
         const bool parsed = m_proxy->parsePosInfoFromNmeaData(buf, size, &pos, &hasFix);
 
@@ -205,61 +305,12 @@ void QNmeaRealTimeReader::readAvailableData()
             continue;
         }
 
-        m_hasFix |= hasFix;
         m_updateParsed = true;
-
-        // Date may or may not be valid, as some packets do not have date.
-        // If date isn't valid, match is performed on time only.
-        // Hence, make sure that packet blocks are generated with
-        // the sentences containing the full timestamp (e.g., GPRMC) *first* !
-        if (infoTime.isValid()) {
-            if (pos.timestamp().time().isValid()) {
-                const bool newerTime = infoTime < pos.timestamp().time();
-                const bool newerDate = (infoDate.isValid() // if time is valid but one date or both are not,
-                                        && pos.timestamp().date().isValid()
-                                        && infoDate < pos.timestamp().date());
-                if (newerTime || newerDate) {
-                    // Effectively read data for different update, that is also newer,
-                    // so flush retained update, and copy the new pos into m_update
-                    const QDate updateDate = m_update.timestamp().date();
-                    const QDate lastPushedDate = m_lastPushedTS.date();
-                    const bool newerTimestampSinceLastPushed = m_update.timestamp() > m_lastPushedTS;
-                    const bool invalidDate = !(updateDate.isValid() && lastPushedDate.isValid());
-                    const bool newerTimeSinceLastPushed = m_update.timestamp().time() > m_lastPushedTS.time();
-                    if ( newerTimestampSinceLastPushed || (invalidDate && newerTimeSinceLastPushed)) {
-                        m_proxy->notifyNewUpdate(&m_update, oldFix);
-                        m_lastPushedTS = m_update.timestamp();
-                    }
-                    m_timer.stop();
-                    // next update data
-                    propagateAttributes(pos, m_update, false);
-                    m_update = pos;
-                    m_hasFix = hasFix;
-                } else {
-                    if (infoTime == pos.timestamp().time())
-                        // timestamps match -- merge into m_update
-                        if (mergePositions(m_update, pos, QByteArray(buf, size))) {
-                            // Reset the timer only if new info has been received.
-                            // Else the source might be keep repeating outdated info until
-                            // new info become available.
-                            m_timer.stop();
-                        }
-                    // else discard out of order outdated info.
-                }
-            } else {
-                // no timestamp available in parsed update-- merge into m_update
-                if (mergePositions(m_update, pos, QByteArray(buf, size)))
-                    m_timer.stop();
-            }
-        } else {
-            // there was no info with valid TS. Overwrite with whatever is parsed.
-#if USE_NMEA_PIMPL
-            pimpl->nmeaSentences.append(QByteArray(buf, size));
-#endif
-            propagateAttributes(pos, m_update);
-            m_update = pos;
+        // Reset the timer only if new info has been received.
+        // Else the source might be keep repeating outdated info until
+        // new info become available.
+        if (addPosition(pos, hasFix, buf, size))
             m_timer.stop();
-        }
     }
 
     if (m_updateParsed) {
@@ -272,17 +323,15 @@ void QNmeaRealTimeReader::readAvailableData()
 
 void QNmeaRealTimeReader::notifyNewUpdate()
 {
-    const bool newerTime = m_update.timestamp().time() > m_lastPushedTS.time();
-    const bool newerDate = (m_update.timestamp().date().isValid()
-                            && m_lastPushedTS.date().isValid()
-                            && m_update.timestamp().date() > m_lastPushedTS.date());
-    if (newerTime || newerDate) {
-        m_proxy->notifyNewUpdate(&m_update, m_hasFix);
-        m_lastPushedTS = m_update.timestamp();
-    }
+    pushPendingUpdate();
     m_timer.stop();
 }
 
+void QNmeaRealTimeReader::pushUpdate(QGeoPositionInfo *update, bool hasFix)
+{
+    m_proxy->notifyNewUpdate(update, hasFix);
+}
+
 
 //============================================================
 
@@ -393,12 +442,12 @@ static int processSentence(QGeoPositionInfo &info,
                     } else {
                         if (infoTime == pos.timestamp().time())
                             // timestamps match -- merge into info
-                            mergePositions(info, pos, QByteArray(buf, size));
+                            mergePositions(info, pos, buf, size);
                         // else discard out of order outdated info.
                     }
                 } else {
                     // no timestamp available -- merge into info
-                    mergePositions(info, pos, QByteArray(buf, size));
+                    mergePositions(info, pos, buf, size);
                 }
             } else {
                 // there was no info with valid TS. Overwrite with whatever is parsed.
@@ -473,6 +522,213 @@ void QNmeaSimulatedReader::processNextSentence()
 }
 
 
+//============================================================
+
+/*
+    QNmeaBatchReader replays a recorded NMEA log as fast as possible. The log is
+    processed in blocks of chunkSize() bytes per thread; each block is cut at
+    sentence boundaries and its chunks are parsed in parallel. The parsed sentences
+    are then merged in log order, exactly as QNmeaRealTimeReader merges them, and
+    the updates with a fix are emitted once per block through positionsUpdated().
+
+    Sentences are parsed with QLocationUtils, so that the parsing of a
+    QNmeaPositionInfoSource subclass is not used.
+*/
+
+class QNmeaBatchReader::Merger : public QNmeaUpdateMerger
+{
+public:
+    QList<QGeoPositionInfo> m_updates;
+
+protected:
+    void pushUpdate(QGeoPositionInfo *update, bool hasFix) override
+    {
+        m_completer.complete(update);
+        if (hasFix && update->isValid())
+            m_updates.append(*update);
+    }
+
+private:
+    QNmeaUpdateCompleter m_completer;
+};
+
+static void parseNmeaChunk(const char *data, qint64 size, double uere,
+                           QList<QPendingGeoPositionInfo> *parsed)
+{
+    const char *end = data + size;
+    while (data < end) {
+        const char *lineEnd = static_cast<const char *>(memchr(data, '\n', end - data));
+        lineEnd = lineEnd ? lineEnd + 1 : end;
+
+        QPendingGeoPositionInfo pending;
+        pending.info = QGeoPositionInfo(*new QGeoPositionInfoPrivateNmea);
+        if (QLocationUtils::getPosInfoFromNmea(data, int(lineEnd - data), &pending.info, uere,
+                                               &pending.hasFix)) {
+            parsed->append(pending);
+        }
+        data = lineEnd;
+    }
+}
+
+QNmeaBatchReader::QNmeaBatchReader(QObject *parent)
+    : QObject(parent),
+      m_userEquivalentRangeError(qQNaN()),
+      m_chunkSize(1 << 20)
+{
+}
+
+QNmeaBatchReader::~QNmeaBatchReader()
+{
+}
+
+void QNmeaBatchReader::setUserEquivalentRangeError(double uere)
+{
+    m_userEquivalentRangeError = uere;
+}
+
+double QNmeaBatchReader::userEquivalentRangeError() const
+{
+    return m_userEquivalentRangeError;
+}
+
+void QNmeaBatchReader::setChunkSize(int bytes)
+{
+    m_chunkSize = qMax(1024, bytes);
+}
+
+int QNmeaBatchReader::chunkSize() const
+{
+    return m_chunkSize;
+}
+
+bool QNmeaBatchReader::replay(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning("QNmeaBatchReader: cannot open %s", qPrintable(fileName));
+        return false;
+    }
+    return replay(&file);
+}
+
+/*
+    Replays the device to its end. Files are memory mapped, other devices are
+    read block by block.
+*/
+bool QNmeaBatchReader::replay(QIODevice *device)
+{
+    if (!device || (!device->isOpen() && !device->open(QIODevice::ReadOnly))) {
+        qWarning("QNmeaBatchReader: cannot open QIODevice data source");
+        return false;
+    }
+
+    begin();
+    const qint64 blockSize = qint64(m_chunkSize) * qMax(1, m_threadPool.maxThreadCount());
+
+    QFileDevice *file = qobject_cast<QFileDevice *>(device);
+    const qint64 mapSize = file && !file->isSequential() ? file->size() - file->pos() : 0;
+    uchar *mapped = mapSize > 0 ? file->map(file->pos(), mapSize) : nullptr;
+    if (mapped) {
+        const char *data = reinterpret_cast<const char *>(mapped);
+        for (qint64 offset = 0; offset < mapSize; ) {
+            const qint64 size = qMin(blockSize, mapSize - offset);
+            offset += replayBlock(data + offset, size, offset + size == mapSize);
+        }
+        file->unmap(mapped);
+        file->seek(file->pos() + mapSize);
+    } else {
+        // Keep the partial sentence at the end of a block for the next one
+        QByteArray buffer;
+        for (;;) {
+            const QByteArray block = device->read(blockSize);
+            buffer.append(block);
+            const bool atEnd = block.isEmpty();
+            buffer.remove(0, replayBlock(buffer.constData(), buffer.size(), atEnd));
+            if (atEnd)
+                break;
+        }
+    }
+
+    end();
+    return true;
+}
+
+void QNmeaBatchReader::replay(const QByteArray &data)
+{
+    begin();
+    const qint64 blockSize = qint64(m_chunkSize) * qMax(1, m_threadPool.maxThreadCount());
+    for (qint64 offset = 0; offset < data.size(); ) {
+        const qint64 size = qMin(blockSize, qint64(data.size()) - offset);
+        offset += replayBlock(data.constData() + offset, size, offset + size == data.size());
+    }
+    end();
+}
+
+// Returns the number of bytes consumed, which stops at the last complete sentence unless atEnd
+qint64 QNmeaBatchReader::replayBlock(const char *data, qint64 size, bool atEnd)
+{
+    qint64 usable = size;
+    if (!atEnd) {
+        while (usable > 0 && data[usable - 1] != '\n')
+            --usable;
+        if (usable == 0) // a single line longer than the block, it can't be a valid sentence
+            usable = size;
+    }
+    if (usable == 0)
+        return 0;
+
+    QList<QPair<qint64, qint64>> chunks;
+    for (qint64 start = 0; start < usable; ) {
+        qint64 end = qMin(start + m_chunkSize, usable);
+        while (end < usable && data[end - 1] != '\n')
+            ++end;
+        chunks.append(qMakePair(start, end));
+        start = end;
+    }
+
+    QList<QList<QPendingGeoPositionInfo>> parsed(chunks.size());
+    const double uere = m_userEquivalentRangeError;
+    if (chunks.size() == 1) {
+        parseNmeaChunk(data, usable, uere, &parsed[0]);
+    } else {
+        for (int i = 0; i < chunks.size(); ++i) {
+            const char *chunk = data + chunks.at(i).first;
+            const qint64 chunkSize = chunks.at(i).second - chunks.at(i).first;
+            QList<QPendingGeoPositionInfo> *result = &parsed[i];
+            m_threadPool.start(QRunnable::create([chunk, chunkSize, uere, result]() {
+                parseNmeaChunk(chunk, chunkSize, uere, result);
+            }));
+        }
+        m_threadPool.waitForDone();
+    }
+
+    for (QList<QPendingGeoPositionInfo> &chunk : parsed) {
+        for (QPendingGeoPositionInfo &pending : chunk)
+            m_merger->addPosition(pending.info, pending.hasFix, nullptr, 0);
+    }
+
+    if (!m_merger->m_updates.isEmpty()) {
+        emit positionsUpdated(m_merger->m_updates);
+        m_merger->m_updates.clear();
+    }
+    return usable;
+}
+
+void QNmeaBatchReader::begin()
+{
+    m_merger.reset(new Merger);
+}
+
+void QNmeaBatchReader::end()
+{
+    m_merger->pushPendingUpdate();
+    if (!m_merger->m_updates.isEmpty())
+        emit positionsUpdated(m_merger->m_updates);
+    m_merger.reset();
+    emit finished();
+}
+
+
 //============================================================
 
 
@@ -487,8 +743,6 @@ QNmeaPositionInfoSourcePrivate::QNmeaPositionInfoSourcePrivate(QNmeaPositionInfo
         m_nmeaReader(0),
         m_updateTimer(0),
         m_requestTimer(0),
-        m_horizontalAccuracy(qQNaN()),
-        m_verticalAccuracy(qQNaN()),
         m_noUpdateLastInterval(false),
         m_updateTimeoutSent(false),
         m_connectedReadyRead(false)
@@ -650,27 +904,7 @@ void QNmeaPositionInfoSourcePrivate::notifyNewUpdate(QGeoPositionInfo *update, b
     // include <QDebug> before uncommenting
     //qDebug() << "QNmeaPositionInfoSourcePrivate::notifyNewUpdate()" << update->timestamp() << hasFix << m_invokedStart << (m_requestTimer && m_requestTimer->isActive());
 
-    QDate date = update->timestamp().date();
-    if (date.isValid()) {
-        m_currentDate = date;
-    } else {
-        // some sentence have time but no date
-        QTime time = update->timestamp().time();
-        if (time.isValid() && m_currentDate.isValid())
-            update->setTimestamp(QDateTime(m_currentDate, time, Qt::UTC));
-    }
-
-    // Some attributes are sent in separate NMEA sentences. Save and restore the accuracy
-    // measurements.
-    if (update->hasAttribute(QGeoPositionInfo::HorizontalAccuracy))
-        m_horizontalAccuracy = update->attribute(QGeoPositionInfo::HorizontalAccuracy);
-    else if (!qIsNaN(m_horizontalAccuracy))
-        update->setAttribute(QGeoPositionInfo::HorizontalAccuracy, m_horizontalAccuracy);
-
-    if (update->hasAttribute(QGeoPositionInfo::VerticalAccuracy))
-        m_verticalAccuracy = update->attribute(QGeoPositionInfo::VerticalAccuracy);
-    else if (!qIsNaN(m_verticalAccuracy))
-        update->setAttribute(QGeoPositionInfo::VerticalAccuracy, m_verticalAccuracy);
+    m_completer.complete(update);
 
     if (hasFix && update->isValid()) {
         if (m_requestTimer && m_requestTimer->isActive()) { // User called requestUpdate()
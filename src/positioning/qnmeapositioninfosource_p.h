@@ -52,11 +52,15 @@
 
 #include "qnmeapositioninfosource.h"
 #include "qgeopositioninfo.h"
+#include "qpositioningglobal_p.h"
 
 #include <QObject>
 #include <QQueue>
 #include <QPointer>
 #include <QtCore/qtimer.h>
+#include <QtCore/qnumeric.h>
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qthreadpool.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -71,6 +75,41 @@ struct QPendingGeoPositionInfo
     bool hasFix;
 };
 
+/*
+    Fills in what an update inherits from the ones before it: the date, for sentences
+    that only carry a time, and the accuracies, which are sent in separate sentences.
+*/
+struct QNmeaUpdateCompleter
+{
+    void complete(QGeoPositionInfo *update);
+
+    QDate m_currentDate;
+    qreal m_horizontalAccuracy = qQNaN();
+    qreal m_verticalAccuracy = qQNaN();
+};
+
+/*
+    Merges parsed sentences that share a timestamp into one update, and pushes the
+    update once a sentence with a newer timestamp starts the next one.
+*/
+class QNmeaUpdateMerger
+{
+public:
+    QNmeaUpdateMerger();
+    virtual ~QNmeaUpdateMerger() {}
+
+    // Returns true if the pending update has changed
+    bool addPosition(QGeoPositionInfo &pos, bool hasFix, const char *data, int size);
+    void pushPendingUpdate();
+
+protected:
+    virtual void pushUpdate(QGeoPositionInfo *update, bool hasFix) = 0;
+
+    QGeoPositionInfo m_update;
+    QDateTime m_lastPushedTS;
+    bool m_hasFix = false;
+};
+
 
 class QNmeaPositionInfoSourcePrivate : public QObject
 {
@@ -117,11 +156,9 @@ private:
     QNmeaPositionInfoSource *m_source;
     QNmeaReader *m_nmeaReader;
     QGeoPositionInfo m_pendingUpdate;
-    QDate m_currentDate;
+    QNmeaUpdateCompleter m_completer;
     QBasicTimer *m_updateTimer; // the timer used in startUpdates()
     QTimer *m_requestTimer; // the timer used in requestUpdate()
-    qreal m_horizontalAccuracy;
-    qreal m_verticalAccuracy;
     bool m_noUpdateLastInterval;
     bool m_updateTimeoutSent;
     bool m_connectedReadyRead;
@@ -142,7 +179,7 @@ protected:
 };
 
 
-class QNmeaRealTimeReader : public QNmeaReader
+class QNmeaRealTimeReader : public QNmeaReader, public QNmeaUpdateMerger
 {
 public:
     explicit QNmeaRealTimeReader(QNmeaPositionInfoSourcePrivate *sourcePrivate);
@@ -150,12 +187,12 @@ public:
     void notifyNewUpdate();
 
     // Data members
-    QGeoPositionInfo m_update;
-    QDateTime m_lastPushedTS;
     bool m_updateParsed = false;
-    bool m_hasFix = false;
     QTimer m_timer;
     int m_pushDelay = -1;
+
+protected:
+    void pushUpdate(QGeoPositionInfo *update, bool hasFix) override;
 };
 
 
@@ -183,6 +220,41 @@ private:
     bool m_hasValidDateTime;
 };
 
+
+class Q_POSITIONING_PRIVATE_EXPORT QNmeaBatchReader : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QNmeaBatchReader(QObject *parent = nullptr);
+    ~QNmeaBatchReader();
+
+    void setUserEquivalentRangeError(double uere);
+    double userEquivalentRangeError() const;
+
+    void setChunkSize(int bytes);
+    int chunkSize() const;
+
+    bool replay(const QString &fileName);
+    bool replay(QIODevice *device);
+    void replay(const QByteArray &data);
+
+Q_SIGNALS:
+    void positionsUpdated(const QList<QGeoPositionInfo> &updates);
+    void finished();
+
+private:
+    class Merger;
+
+    qint64 replayBlock(const char *data, qint64 size, bool atEnd);
+    void begin();
+    void end();
+
+    QThreadPool m_threadPool;
+    QScopedPointer<Merger> m_merger;
+    double m_userEquivalentRangeError;
+    int m_chunkSize;
+};
+
 QT_END_NAMESPACE
 
 #endif
@@ -54,20 +54,34 @@ qtHaveModule(location) {
            qgeoroutesegment \
            qgeoroutingmanagerplugins \
            qgeotilespec \
+           qgeotilepackstore \
+           qgeotileslabarena \
+           qgeoclusterindex \
+           qgeotilecachestatistics \
+           qgeopathlevelofdetail \
            qgeoroutexmlparser \
            maptype \
            qgeocameratiles
 
+    # Builds its fixtures with SQLite
+    qtHaveModule(sql): SUBDIRS += qmbtilesarchive
+
+    QT_FOR_CONFIG += location-private
+    qtConfig(location-labs-plugin): SUBDIRS += qgeomapobjectspatialindex \
+                                               qgeomapobjectqsgsupport
+
     # These use plugins
     !android: {
         SUBDIRS += qgeoserviceprovider \
                          qgeoroutingmanager \
                          nokia_services \
                          qgeocodingmanager \
-                         qgeotiledmap
+                         qgeotiledmap \
+                         qgeoofflineregionmanager
 
         qgeoserviceprovider.depends = geotestplugin
         qgeotiledmap.depends = geotestplugin
+        qgeoofflineregionmanager.depends = geotestplugin
     }
     qtHaveModule(quick):!android {
         SUBDIRS += declarative_geoshape \
@@ -93,7 +107,9 @@ SUBDIRS += \
            qgeolocation \
            qgeopositioninfo \
            qgeosatelliteinfo \
-           qgeojson
+           qgeojson \
+           qlocationutils \
+           qnmeabatchreader
 
 !android: SUBDIRS += \
             positionplugin \
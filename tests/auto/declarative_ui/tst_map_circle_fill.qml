@@ -0,0 +1,130 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+import QtTest 1.0
+import QtPositioning 5.5
+import QtLocation 5.15
+
+Item {
+    id: page
+    x: 0; y: 0;
+    width: 240
+    height: 240
+    Plugin { id: testPlugin
+             name : "qmlgeo.test.plugin"
+             allowExperimental: true
+             parameters: [ PluginParameter { name: "finishRequestImmediately"; value: true}]
+    }
+
+    Map {
+        id: map;
+        x: 20; y: 20; width: 200; height: 200
+        center: QtPositioning.coordinate(0, 0)
+        zoomLevel: 3
+        plugin: testPlugin;
+
+        MapCircle {
+            id: circle
+            center: QtPositioning.coordinate(0, 0)
+            radius: 1000000
+            color: "red"
+            border.width: 2
+        }
+    }
+
+    TestCase {
+        name: "MapCircleFill"
+        when: windowShown && map.mapReady
+
+        function containsCoordinate(coordinate)
+        {
+            var point = map.fromCoordinate(coordinate, false)
+            var local = circle.mapFromItem(map, point.x, point.y)
+            return circle.contains(Qt.point(local.x, local.y))
+        }
+
+        // Probes inside and outside the circle, relative to its center
+        function verifyFill()
+        {
+            waitForRendering(map)
+            var c = circle.center
+            verify(containsCoordinate(c))
+            verify(containsCoordinate(c.atDistanceAndAzimuth(circle.radius * 0.8, 45)))
+            verify(containsCoordinate(c.atDistanceAndAzimuth(circle.radius * 0.8, 200)))
+            verify(!containsCoordinate(c.atDistanceAndAzimuth(circle.radius * 1.3, 0)))
+            verify(!containsCoordinate(c.atDistanceAndAzimuth(circle.radius * 1.3, 270)))
+        }
+
+        function init()
+        {
+            map.center = QtPositioning.coordinate(0, 0)
+            map.zoomLevel = 3
+            map.bearing = 0
+            map.tilt = 0
+            circle.center = QtPositioning.coordinate(0, 0)
+        }
+
+        function test_camera_changes()
+        {
+            verifyFill()
+            var width = circle.width
+            var height = circle.height
+
+            // panning keeps the fill
+            map.center = QtPositioning.coordinate(5, 8)
+            verifyFill()
+            compare(circle.width, width)
+            compare(circle.height, height)
+
+            map.bearing = 30
+            verifyFill()
+            map.zoomLevel = 4.5
+            verifyFill()
+
+            // tilted maps are clipped and tessellated
+            map.tilt = 30
+            verifyFill()
+        }
+
+        function test_dateline()
+        {
+            map.center = QtPositioning.coordinate(0, 180)
+            circle.center = QtPositioning.coordinate(20, 179)
+            verifyFill()
+            verify(containsCoordinate(QtPositioning.coordinate(20, -179)))
+        }
+
+        function test_high_latitude()
+        {
+            map.center = QtPositioning.coordinate(60, 0)
+            circle.center = QtPositioning.coordinate(65, 0)
+            verifyFill()
+        }
+    }
+}
@@ -0,0 +1,180 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+import QtTest 1.0
+import QtPositioning 5.5
+import QtLocation 5.15
+
+Item {
+    id: page
+    x: 0; y: 0;
+    width: 240
+    height: 240
+    Plugin { id: testPlugin
+             name : "qmlgeo.test.plugin"
+             allowExperimental: true
+             parameters: [ PluginParameter { name: "finishRequestImmediately"; value: true}]
+    }
+
+    Map {
+        id: map;
+        x: 20; y: 20; width: 200; height: 200
+        center: QtPositioning.coordinate(0, 0)
+        zoomLevel: 3
+        plugin: testPlugin;
+
+        SignalSpy {id: batchingChanged; target: parent; signalName: "mapItemBatchingChanged"}
+
+        MapPolyline {
+            id: polyline
+            line.width: 6
+            line.color: "red"
+            path: [
+                { latitude: 0, longitude: -10 },
+                { latitude: 0, longitude: 10 }
+            ]
+        }
+
+        MapPolygon {
+            id: polygon
+            color: "blue"
+            border.width: 2
+            border.color: "red"
+            path: [
+                { latitude: 20, longitude: -10 },
+                { latitude: 20, longitude: 10 },
+                { latitude: 10, longitude: 0 }
+            ]
+        }
+
+        MapCircle {
+            id: circle
+            color: "green"
+            center: QtPositioning.coordinate(-15, 0)
+            radius: 400000
+        }
+    }
+
+    TestCase {
+        name: "MapItemBatching"
+        when: windowShown && map.mapReady
+
+        function containsCoordinate(item, coordinate)
+        {
+            var point = map.fromCoordinate(coordinate, false)
+            var local = item.mapFromItem(map, point.x, point.y)
+            return item.contains(Qt.point(local.x, local.y))
+        }
+
+        function verifyContains()
+        {
+            waitForRendering(map)
+            verify(containsCoordinate(polyline, QtPositioning.coordinate(0, 5)))
+            verify(!containsCoordinate(polyline, QtPositioning.coordinate(5, 0)))
+            verify(containsCoordinate(polygon, QtPositioning.coordinate(17, 0)))
+            verify(!containsCoordinate(polygon, QtPositioning.coordinate(5, 0)))
+            verify(containsCoordinate(circle, QtPositioning.coordinate(-15, 0)))
+            verify(!containsCoordinate(circle, QtPositioning.coordinate(0, 0)))
+        }
+
+        function init()
+        {
+            map.center = QtPositioning.coordinate(0, 0)
+            map.zoomLevel = 3
+            map.bearing = 0
+            map.mapItemBatching = false
+            batchingChanged.clear()
+        }
+
+        function test_toggle()
+        {
+            compare(map.mapItemBatching, false)
+            map.mapItemBatching = true
+            compare(batchingChanged.count, 1)
+            map.mapItemBatching = true
+            compare(batchingChanged.count, 1)
+            verifyContains()
+            map.mapItemBatching = false
+            compare(batchingChanged.count, 2)
+            verifyContains()
+        }
+
+        function test_camera_changes()
+        {
+            map.mapItemBatching = true
+            verifyContains()
+            map.center = QtPositioning.coordinate(2, 4)
+            verifyContains()
+            map.bearing = 30
+            verifyContains()
+            map.zoomLevel = 4.5
+            verifyContains()
+        }
+
+        function test_item_changes()
+        {
+            map.mapItemBatching = true
+            verifyContains()
+
+            // style changes move the items between batches
+            polyline.line.color = "blue"
+            polygon.color = "red"
+            circle.border.width = 3
+            verifyContains()
+
+            // items that cannot be batched keep rendering on their own
+            polygon.opacity = 0.5
+            polyline.backend = MapPolyline.Transformed
+            verifyContains()
+            polygon.opacity = 1.0
+            polyline.backend = MapPolyline.Software
+
+            circle.visible = false
+            waitForRendering(map)
+            circle.visible = true
+            verifyContains()
+
+            polyline.line.color = "red"
+            polygon.color = "blue"
+            circle.border.width = 0
+        }
+
+        function test_add_remove()
+        {
+            map.mapItemBatching = true
+            waitForRendering(map)
+            map.removeMapItem(polygon)
+            waitForRendering(map)
+            compare(map.mapItems.length, 2)
+            map.addMapItem(polygon)
+            compare(map.mapItems.length, 3)
+            verifyContains()
+        }
+    }
+}
@@ -0,0 +1,162 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+import QtQuick 2.0
+import QtTest 1.0
+import QtPositioning 5.5
+import QtLocation 5.15
+
+Item {
+    id: page
+    x: 0; y: 0;
+    width: 440
+    height: 240
+    Plugin { id: testPlugin
+             name : "qmlgeo.test.plugin"
+             allowExperimental: true
+             parameters: [ PluginParameter { name: "finishRequestImmediately"; value: true}]
+    }
+
+    Component {
+        id: itemsComponent
+        Item {
+            property var items: [polyline, polygon, circle, rectangle]
+            MapPolyline {
+                id: polyline
+                line.width: 3
+                path: [ { latitude: -10, longitude: -15 }, { latitude: 5, longitude: 0 },
+                        { latitude: -5, longitude: 10 }, { latitude: 10, longitude: 20 } ]
+            }
+            MapPolygon {
+                id: polygon
+                color: "green"
+                border.width: 2
+                path: [ { latitude: 10, longitude: -20 }, { latitude: 20, longitude: -5 },
+                        { latitude: 5, longitude: -10 } ]
+            }
+            MapCircle {
+                id: circle
+                color: "red"
+                border.width: 2
+                center: QtPositioning.coordinate(-5, 5)
+                radius: 800000
+            }
+            MapRectangle {
+                id: rectangle
+                color: "blue"
+                border.width: 1
+                topLeft: QtPositioning.coordinate(0, 12)
+                bottomRight: QtPositioning.coordinate(-12, 25)
+            }
+        }
+    }
+
+    Map {
+        id: serialMap
+        x: 20; y: 20; width: 200; height: 200
+        center: QtPositioning.coordinate(0, 0)
+        zoomLevel: 3
+        plugin: testPlugin
+    }
+
+    Map {
+        id: parallelMap
+        x: 220; y: 20; width: 200; height: 200
+        center: QtPositioning.coordinate(0, 0)
+        zoomLevel: 3
+        plugin: testPlugin
+        parallelMapItemPolish: true
+    }
+
+    TestCase {
+        name: "MapItemParallelPolish"
+        when: windowShown && serialMap.mapReady && parallelMap.mapReady
+
+        property var serialItems
+        property var parallelItems
+
+        function initTestCase()
+        {
+            serialItems = itemsComponent.createObject(page).items
+            parallelItems = itemsComponent.createObject(page).items
+            for (var i = 0; i < serialItems.length; ++i) {
+                serialMap.addMapItem(serialItems[i])
+                parallelMap.addMapItem(parallelItems[i])
+            }
+        }
+
+        function setCamera(center, zoomLevel, bearing, tilt)
+        {
+            var maps = [serialMap, parallelMap]
+            for (var i = 0; i < maps.length; ++i) {
+                maps[i].center = center
+                maps[i].zoomLevel = zoomLevel
+                maps[i].bearing = bearing
+                maps[i].tilt = tilt
+            }
+        }
+
+        // Both maps have the same size and camera: so must their items
+        function compareItems()
+        {
+            waitForRendering(serialMap)
+            waitForRendering(parallelMap)
+            for (var i = 0; i < serialItems.length; ++i) {
+                var serial = serialItems[i]
+                var parallel = parallelItems[i]
+                verify(serial.width > 0)
+                fuzzyCompare(parallel.x, serial.x, 0.01)
+                fuzzyCompare(parallel.y, serial.y, 0.01)
+                fuzzyCompare(parallel.width, serial.width, 0.01)
+                fuzzyCompare(parallel.height, serial.height, 0.01)
+                var center = Qt.point(serial.width / 2, serial.height / 2)
+                compare(parallel.contains(center), serial.contains(center))
+            }
+        }
+
+        function test_camera_changes()
+        {
+            compareItems()
+            setCamera(QtPositioning.coordinate(3, 4), 3.5, 0, 0)
+            compareItems()
+            setCamera(QtPositioning.coordinate(-2, 6), 4, 25, 0)
+            compareItems()
+            setCamera(QtPositioning.coordinate(0, 0), 3, 0, 20)
+            compareItems()
+        }
+
+        function test_toggle()
+        {
+            parallelMap.parallelMapItemPolish = false
+            setCamera(QtPositioning.coordinate(1, 1), 3, 0, 0)
+            compareItems()
+            parallelMap.parallelMapItemPolish = true
+            setCamera(QtPositioning.coordinate(0, 0), 3, 0, 0)
+            compareItems()
+        }
+    }
+}
@@ -0,0 +1,136 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+import QtQuick 2.0
+import QtTest 1.0
+import QtPositioning 5.5
+import QtLocation 5.15
+
+Item {
+    id: page
+    x: 0; y: 0;
+    width: 240
+    height: 240
+    Plugin { id: testPlugin
+             name : "qmlgeo.test.plugin"
+             allowExperimental: true
+             parameters: [ PluginParameter { name: "finishRequestImmediately"; value: true}]
+    }
+
+    ListModel { id: pointsModel }
+
+    Map {
+        id: map
+        x: 20; y: 20; width: 200; height: 200
+        center: QtPositioning.coordinate(0, 0)
+        zoomLevel: 3
+        plugin: testPlugin
+
+        MapItemView {
+            id: view
+            model: pointsModel
+            incubateDelegates: false
+            add: null
+            remove: null
+            clusterRole: "coordinate"
+            delegate: MapQuickItem {
+                objectName: "leaf"
+                coordinate: model.coordinate
+                sourceItem: Rectangle { width: 4; height: 4 }
+            }
+            clusterDelegate: MapQuickItem {
+                objectName: "cluster"
+                property int count: clusterCount
+                coordinate: clusterCoordinate
+                sourceItem: Rectangle { width: 10; height: 10 }
+            }
+        }
+    }
+
+    TestCase {
+        name: "MapItemViewCluster"
+        when: windowShown && map.mapReady
+
+        function initTestCase()
+        {
+            // 0.001 degrees apart: a few pixels at zoom level 3, hundreds at 18
+            for (var i = 0; i < 50; ++i)
+                pointsModel.append({ coordinate: QtPositioning.coordinate(0, i * 0.001) })
+            pointsModel.append({ coordinate: QtPositioning.coordinate(0, 12) })
+        }
+
+        function itemsNamed(name)
+        {
+            var items = []
+            for (var i = 0; i < map.mapItems.length; ++i) {
+                if (map.mapItems[i].objectName === name)
+                    items.push(map.mapItems[i])
+            }
+            return items
+        }
+
+        function test_zoom()
+        {
+            map.center = QtPositioning.coordinate(0, 0)
+            map.zoomLevel = 3
+            var clusters = itemsNamed("cluster")
+            compare(clusters.length, 1)
+            compare(clusters[0].count, 50)
+            compare(itemsNamed("leaf").length, 1)
+
+            // Only the rows standing alone in view are instantiated
+            map.zoomLevel = 18
+            compare(itemsNamed("cluster").length, 0)
+            compare(itemsNamed("leaf").length, 1)
+
+            // The cluster items are reused
+            map.zoomLevel = 3
+            compare(itemsNamed("cluster").length, 1)
+            compare(itemsNamed("cluster")[0].count, 50)
+        }
+
+        function test_model_changes()
+        {
+            map.center = QtPositioning.coordinate(0, 0)
+            map.zoomLevel = 3
+            pointsModel.append({ coordinate: QtPositioning.coordinate(0, 0.0005) })
+            compare(itemsNamed("cluster")[0].count, 51)
+            pointsModel.remove(pointsModel.count - 1)
+            compare(itemsNamed("cluster")[0].count, 50)
+        }
+
+        function test_disable()
+        {
+            view.clusterRole = ""
+            compare(itemsNamed("cluster").length, 0)
+            compare(itemsNamed("leaf").length, pointsModel.count)
+            view.clusterRole = "coordinate"
+            map.zoomLevel = 3
+            compare(itemsNamed("cluster").length, 1)
+        }
+    }
+}
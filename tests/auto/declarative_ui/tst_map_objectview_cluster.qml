@@ -0,0 +1,157 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+import QtQuick 2.0
+import QtTest 1.0
+import QtPositioning 5.5
+import QtLocation 5.15
+import Qt.labs.location 1.0
+
+Item {
+    id: page
+    x: 0; y: 0;
+    width: 240
+    height: 240
+    Plugin { id: itemsOverlay; name: "itemsoverlay" }
+
+    ListModel { id: pointsModel }
+
+    // The delegate objects alive
+    property var leaves: []
+    property var clusters: []
+
+    function untrack(objects, object)
+    {
+        var index = objects.indexOf(object)
+        if (index >= 0)
+            objects.splice(index, 1)
+    }
+
+    Map {
+        id: map
+        x: 20; y: 20; width: 200; height: 200
+        center: QtPositioning.coordinate(0, 0)
+        zoomLevel: 3
+        plugin: itemsOverlay
+
+        MapObjectView {
+            id: view
+            model: pointsModel
+            clusterRole: "coordinate"
+            delegate: MapCircleObject {
+                center: model.coordinate
+                radius: 10
+                Component.onCompleted: page.leaves.push(this)
+                Component.onDestruction: page.untrack(page.leaves, this)
+            }
+            clusterDelegate: MapCircleObject {
+                property int count: clusterCount
+                center: clusterCoordinate
+                radius: 1000
+                Component.onCompleted: page.clusters.push(this)
+                Component.onDestruction: page.untrack(page.clusters, this)
+            }
+        }
+    }
+
+    TestCase {
+        name: "MapObjectViewCluster"
+        when: windowShown && map.mapReady
+
+        function initTestCase()
+        {
+            // 0.001 degrees apart: a few pixels at zoom level 3, hundreds at 18
+            for (var i = 0; i < 50; ++i)
+                pointsModel.append({ coordinate: QtPositioning.coordinate(0, i * 0.001) })
+            pointsModel.append({ coordinate: QtPositioning.coordinate(0, 12) })
+        }
+
+        function init()
+        {
+            map.center = QtPositioning.coordinate(0, 0)
+            map.zoomLevel = 3
+        }
+
+        function test_zoom()
+        {
+            tryCompare(page.clusters, "length", 1)
+            compare(page.clusters[0].count, 50)
+            tryCompare(page.leaves, "length", 1)
+
+            // Only the rows standing alone in view are instantiated
+            map.zoomLevel = 18
+            tryCompare(page.clusters, "length", 0)
+            tryCompare(page.leaves, "length", 1)
+
+            map.zoomLevel = 3
+            tryCompare(page.clusters, "length", 1)
+            compare(page.clusters[0].count, 50)
+            tryCompare(page.leaves, "length", 1)
+        }
+
+        function test_reuse()
+        {
+            tryCompare(page.clusters, "length", 1)
+            var cluster = page.clusters[0]
+
+            // The cluster object follows the camera, it is not created again
+            map.zoomLevel = 4
+            map.center = QtPositioning.coordinate(0, 0.01)
+            compare(page.clusters.length, 1)
+            verify(page.clusters[0] === cluster)
+            compare(cluster.count, 50)
+        }
+
+        function test_model_changes()
+        {
+            tryCompare(page.clusters, "length", 1)
+            var cluster = page.clusters[0]
+
+            pointsModel.append({ coordinate: QtPositioning.coordinate(0, 0.0005) })
+            tryCompare(cluster, "count", 51)
+            pointsModel.remove(pointsModel.count - 1)
+            tryCompare(cluster, "count", 50)
+            compare(page.clusters.length, 1)
+            tryCompare(page.leaves, "length", 1)
+        }
+
+        function test_disable()
+        {
+            tryCompare(page.clusters, "length", 1)
+
+            // Every row is instantiated
+            view.clusterRole = ""
+            tryCompare(page.clusters, "length", 0)
+            tryCompare(page.leaves, "length", pointsModel.count)
+
+            view.clusterRole = "coordinate"
+            tryCompare(page.clusters, "length", 1)
+            compare(page.clusters[0].count, 50)
+            tryCompare(page.leaves, "length", 1)
+        }
+    }
+}
@@ -0,0 +1,108 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+import QtTest 1.0
+import QtPositioning 5.12
+import QtLocation 5.15
+
+Item {
+    id: page
+    x: 0; y: 0;
+    width: 240
+    height: 240
+    Plugin { id: testPlugin
+             name : "qmlgeo.test.plugin"
+             allowExperimental: true
+             parameters: [ PluginParameter { name: "finishRequestImmediately"; value: true}]
+    }
+
+    Map {
+        id: map;
+        x: 20; y: 20; width: 200; height: 200
+        center: QtPositioning.coordinate(0, 0)
+        zoomLevel: 3
+        plugin: testPlugin;
+
+        MapPolygon {
+            id: polygon
+            color: "blue"
+            border.width: 1
+        }
+    }
+
+    TestCase {
+        name: "MapPolygonHoles"
+        when: windowShown && map.mapReady
+
+        function containsCoordinate(coordinate)
+        {
+            var point = map.fromCoordinate(coordinate, false)
+            var local = polygon.mapFromItem(map, point.x, point.y)
+            return polygon.contains(Qt.point(local.x, local.y))
+        }
+
+        function test_hole()
+        {
+            polygon.geoShape = QtPositioning.polygon(
+                        [ QtPositioning.coordinate(20, -20), QtPositioning.coordinate(20, 20),
+                          QtPositioning.coordinate(-20, 20), QtPositioning.coordinate(-20, -20) ],
+                        [ [ QtPositioning.coordinate(10, -10), QtPositioning.coordinate(10, 10),
+                            QtPositioning.coordinate(-10, 10), QtPositioning.coordinate(-10, -10) ] ])
+            waitForRendering(map)
+            verify(containsCoordinate(QtPositioning.coordinate(15, 0)))
+            verify(containsCoordinate(QtPositioning.coordinate(0, -15)))
+            verify(!containsCoordinate(QtPositioning.coordinate(0, 0)))
+            verify(!containsCoordinate(QtPositioning.coordinate(5, 5)))
+            verify(!containsCoordinate(QtPositioning.coordinate(30, 0)))
+
+            // the hole follows the camera like the outer ring
+            map.center = QtPositioning.coordinate(5, 5)
+            map.zoomLevel = 4
+            waitForRendering(map)
+            verify(containsCoordinate(QtPositioning.coordinate(15, 0)))
+            verify(!containsCoordinate(QtPositioning.coordinate(0, 0)))
+            map.center = QtPositioning.coordinate(0, 0)
+            map.zoomLevel = 3
+        }
+
+        function test_self_intersecting()
+        {
+            // a bowtie renders as two triangles meeting at the center
+            polygon.path = [ { latitude: 20, longitude: -20 },
+                             { latitude: -20, longitude: 20 },
+                             { latitude: 20, longitude: 20 },
+                             { latitude: -20, longitude: -20 } ]
+            waitForRendering(map)
+            verify(containsCoordinate(QtPositioning.coordinate(0, 15)))
+            verify(containsCoordinate(QtPositioning.coordinate(0, -15)))
+            verify(!containsCoordinate(QtPositioning.coordinate(15, 0)))
+            verify(!containsCoordinate(QtPositioning.coordinate(-15, 0)))
+        }
+    }
+}
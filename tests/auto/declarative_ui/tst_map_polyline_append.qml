@@ -0,0 +1,150 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+import QtTest 1.0
+import QtPositioning 5.5
+import QtLocation 5.15
+
+Item {
+    id: page
+    x: 0; y: 0;
+    width: 240
+    height: 240
+    Plugin { id: testPlugin
+             name : "qmlgeo.test.plugin"
+             allowExperimental: true
+             parameters: [ PluginParameter { name: "finishRequestImmediately"; value: true}]
+    }
+
+    Map {
+        id: map;
+        x: 20; y: 20; width: 200; height: 200
+        center: QtPositioning.coordinate(0, 0)
+        zoomLevel: 3
+        plugin: testPlugin;
+
+        MapPolyline {
+            id: track
+            line.width: 6
+        }
+
+        MapPolyline {
+            id: reference
+            line.width: 6
+        }
+    }
+
+    TestCase {
+        name: "MapPolylineAppend"
+        when: windowShown && map.mapReady
+
+        function containsCoordinate(item, coordinate)
+        {
+            var point = map.fromCoordinate(coordinate, false)
+            var local = item.mapFromItem(map, point.x, point.y)
+            return item.contains(Qt.point(local.x, local.y))
+        }
+
+        // Appends the coordinates one at a time, rendering in between, and compares the
+        // result with the same path set at once
+        function appendAndCompare(coordinates, probes)
+        {
+            track.path = []
+            for (var i = 0; i < coordinates.length; ++i) {
+                track.addCoordinate(coordinates[i])
+                waitForRendering(map)
+            }
+            reference.path = coordinates
+            waitForRendering(map)
+
+            compare(track.pathLength(), coordinates.length)
+            fuzzyCompare(track.x, reference.x, 4)
+            fuzzyCompare(track.y, reference.y, 4)
+            fuzzyCompare(track.width, reference.width, 4)
+            fuzzyCompare(track.height, reference.height, 4)
+            for (var j = 0; j < probes.length; ++j) {
+                compare(containsCoordinate(track, probes[j]),
+                        containsCoordinate(reference, probes[j]))
+            }
+        }
+
+        function init()
+        {
+            map.center = QtPositioning.coordinate(0, 0)
+            map.zoomLevel = 3
+            map.tilt = 0
+        }
+
+        function test_append_eastwards()
+        {
+            appendAndCompare([QtPositioning.coordinate(0, -20),
+                              QtPositioning.coordinate(0, -10),
+                              QtPositioning.coordinate(5, 0),
+                              QtPositioning.coordinate(-5, 10),
+                              QtPositioning.coordinate(0, 20)],
+                             [QtPositioning.coordinate(0, -15),
+                              QtPositioning.coordinate(5, 0),
+                              QtPositioning.coordinate(0, 20),
+                              QtPositioning.coordinate(10, 10),
+                              QtPositioning.coordinate(0, 25)])
+        }
+
+        function test_append_moving_origin()
+        {
+            // the last coordinate moves the left bound of the path
+            appendAndCompare([QtPositioning.coordinate(0, 0),
+                              QtPositioning.coordinate(5, 10),
+                              QtPositioning.coordinate(-5, -10)],
+                             [QtPositioning.coordinate(2.5, 5),
+                              QtPositioning.coordinate(-2.5, -5),
+                              QtPositioning.coordinate(5, -10)])
+        }
+
+        function test_append_across_dateline()
+        {
+            map.center = QtPositioning.coordinate(0, 180)
+            appendAndCompare([QtPositioning.coordinate(0, 160),
+                              QtPositioning.coordinate(0, 170),
+                              QtPositioning.coordinate(0, -170)],
+                             [QtPositioning.coordinate(0, 180),
+                              QtPositioning.coordinate(0, -175),
+                              QtPositioning.coordinate(5, 180)])
+        }
+
+        function test_append_tilted()
+        {
+            map.tilt = 30
+            appendAndCompare([QtPositioning.coordinate(0, -10),
+                              QtPositioning.coordinate(0, 0),
+                              QtPositioning.coordinate(0, 10)],
+                             [QtPositioning.coordinate(0, 5),
+                              QtPositioning.coordinate(5, 5)])
+        }
+    }
+}
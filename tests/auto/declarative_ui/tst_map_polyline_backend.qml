@@ -0,0 +1,143 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.0
+import QtTest 1.0
+import QtPositioning 5.5
+import QtLocation 5.15
+
+Item {
+    id: page
+    x: 0; y: 0;
+    width: 240
+    height: 240
+    Plugin { id: testPlugin
+             name : "qmlgeo.test.plugin"
+             allowExperimental: true
+             parameters: [ PluginParameter { name: "finishRequestImmediately"; value: true}]
+    }
+
+    Map {
+        id: map;
+        x: 20; y: 20; width: 200; height: 200
+        center: QtPositioning.coordinate(0, 0)
+        zoomLevel: 3
+        plugin: testPlugin;
+
+        MapPolyline {
+            id: polyline
+            line.width: 6
+            path: [
+                { latitude: 0, longitude: -10 },
+                { latitude: 0, longitude: 10 }
+            ]
+            SignalSpy {id: backendChanged; target: parent; signalName: "backendChanged"}
+        }
+    }
+
+    TestCase {
+        name: "MapPolylineBackend"
+        when: windowShown && map.mapReady
+
+        function containsCoordinate(coordinate)
+        {
+            var point = map.fromCoordinate(coordinate, false)
+            var local = polyline.mapFromItem(map, point.x, point.y)
+            return polyline.contains(Qt.point(local.x, local.y))
+        }
+
+        function verifyContains()
+        {
+            waitForRendering(map)
+            verify(containsCoordinate(QtPositioning.coordinate(0, 0)))
+            verify(containsCoordinate(QtPositioning.coordinate(0, 8)))
+            verify(!containsCoordinate(QtPositioning.coordinate(5, 0)))
+            verify(!containsCoordinate(QtPositioning.coordinate(0, 15)))
+        }
+
+        function init()
+        {
+            map.center = QtPositioning.coordinate(0, 0)
+            map.zoomLevel = 3
+            map.bearing = 0
+            polyline.backend = MapPolyline.Software
+            backendChanged.clear()
+        }
+
+        function test_backend()
+        {
+            compare(polyline.backend, MapPolyline.Software)
+            polyline.backend = MapPolyline.Transformed
+            compare(backendChanged.count, 1)
+            polyline.backend = MapPolyline.Transformed
+            compare(backendChanged.count, 1)
+            verifyContains()
+        }
+
+        function test_camera_changes()
+        {
+            polyline.backend = MapPolyline.Transformed
+            verifyContains()
+
+            // pan, rotate and zoom within the same zoom level
+            map.center = QtPositioning.coordinate(2, 4)
+            verifyContains()
+            map.bearing = 45
+            verifyContains()
+            map.zoomLevel = 3.7
+            verifyContains()
+
+            // new zoom level
+            map.zoomLevel = 4.2
+            verifyContains()
+
+            // tilted maps fall back to the software backend
+            map.tilt = 30
+            verifyContains()
+            map.tilt = 0
+        }
+
+        function test_dateline()
+        {
+            polyline.backend = MapPolyline.Transformed
+            map.center = QtPositioning.coordinate(0, 180)
+            polyline.path = [
+                { latitude: 0, longitude: 170 },
+                { latitude: 0, longitude: -170 }
+            ]
+            waitForRendering(map)
+            verify(containsCoordinate(QtPositioning.coordinate(0, 180)))
+            verify(containsCoordinate(QtPositioning.coordinate(0, -175)))
+            verify(!containsCoordinate(QtPositioning.coordinate(0, 0)))
+            polyline.path = [
+                { latitude: 0, longitude: -10 },
+                { latitude: 0, longitude: 10 }
+            ]
+        }
+    }
+}
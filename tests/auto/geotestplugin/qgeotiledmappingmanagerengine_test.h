@@ -35,6 +35,7 @@
 #include <QtLocation/private/qgeotiledmapreply_p.h>
 #include <QtLocation/private/qgeomaptype_p.h>
 #include <QtLocation/private/qgeocameracapabilities_p.h>
+#include <QtLocation/private/qgeofiletilecache_p.h>
 
 #include "qgeotiledmap_test.h"
 #include "qgeotilefetcher_test.h"
@@ -108,6 +109,8 @@ public:
         setCameraCapabilities(capabilities);
         fetcher->setTileSize(tileSize());
         setTileFetcher(fetcher);
+        if (parameters.contains(QStringLiteral("cacheDirectory")))
+            setTileCache(new QGeoFileTileCache(parameters.value(QStringLiteral("cacheDirectory")).toString()));
     }
 
     QGeoMap *createMap() override
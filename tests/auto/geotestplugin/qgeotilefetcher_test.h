@@ -43,6 +43,7 @@
 #include <QDebug>
 #include <QTimerEvent>
 #include <QVariant>
+#include <QPointer>
 
 QT_USE_NAMESPACE
 
@@ -56,10 +57,14 @@ public:
     void callSetCached(bool cached) { setFinished(cached);}
     void callSetMapImageData(const QByteArray &data) { setMapImageData(data); }
     void callSetMapImageFormat(const QString &format) { setMapImageFormat(format); }
-    void abort() { emit aborted(); }
+    void abort() { aborted_ = true; emit aborted(); }
+    bool isAborted() const { return aborted_; }
 
 Q_SIGNALS:
     void aborted();
+
+private:
+    bool aborted_ = false;
 };
 
 class QGeoTileFetcherTest: public QGeoTileFetcher
@@ -110,6 +115,15 @@ public:
         mappingReply->callSetMapImageData(bytes);
         mappingReply->callSetMapImageFormat("png");
 
+        requestedTiles_.append(spec);
+        connect(mappingReply, &TiledMapReplyTest::aborted, this, [this, spec]() {
+            abortedTiles_.append(spec);
+        });
+        if (holdRequests_) {
+            heldReplies_.append(mappingReply);
+            return mappingReply;
+        }
+
         if (finishRequestImmediately_) {
             updateRequest(mappingReply);
             return mappingReply;
@@ -132,6 +146,73 @@ public:
         tileSize_ = tileSize;
     }
 
+    // Spreads the tiles over count hosts, by column
+    void setHostCount(int count)
+    {
+        hostCount_ = count;
+    }
+
+    // Keeps the replies running until finishHeldRequests() is called
+    void setHoldRequests(bool hold)
+    {
+        holdRequests_ = hold;
+    }
+
+    // Makes the held replies finish with error instead of a tile
+    void setHeldRequestError(QGeoTiledMapReply::Error error, const QString &errorString = QString())
+    {
+        heldError_ = error;
+        heldErrorString_ = errorString;
+    }
+
+    // Finishes the first count held replies, or all of them. Returns how many finished.
+    int finishHeldRequests(int count = -1)
+    {
+        int finished = 0;
+        while (!heldReplies_.isEmpty() && (count < 0 || finished < count)) {
+            TiledMapReplyTest *reply = heldReplies_.takeFirst();
+            if (!reply || reply->isFinished() || reply->isAborted())
+                continue;
+            if (heldError_ != QGeoTiledMapReply::NoError) {
+                reply->callSetError(heldError_, heldErrorString_);
+            } else {
+                reply->callSetFinished(true);
+                emit tileFetched(reply->tileSpec());
+            }
+            ++finished;
+        }
+        return finished;
+    }
+
+    // The held replies not aborted yet
+    QList<QGeoTileSpec> heldTiles() const
+    {
+        QList<QGeoTileSpec> tiles;
+        for (const QPointer<TiledMapReplyTest> &reply : heldReplies_) {
+            if (reply && !reply->isFinished() && !reply->isAborted())
+                tiles.append(reply->tileSpec());
+        }
+        return tiles;
+    }
+
+    // All the tiles passed to getTileImage(), in order
+    QList<QGeoTileSpec> requestedTiles() const
+    {
+        return requestedTiles_;
+    }
+
+    // The tiles whose reply was aborted, in order
+    QList<QGeoTileSpec> abortedTiles() const
+    {
+        return abortedTiles_;
+    }
+
+    void clearRequestedTiles()
+    {
+        requestedTiles_.clear();
+        abortedTiles_.clear();
+    }
+
 public Q_SLOTS:
     void requestAborted()
     {
@@ -143,6 +224,13 @@ Q_SIGNALS:
     void tileFetched(const QGeoTileSpec&);
 
 protected:
+    QString tileHost(const QGeoTileSpec &spec) const override
+    {
+        if (hostCount_ <= 1)
+            return QGeoTileFetcher::tileHost(spec);
+        return QString::number(spec.x() % hostCount_);
+    }
+
     void updateRequest(TiledMapReplyTest* mappingReply)
     {
         if (errorCode_) {
@@ -174,6 +262,13 @@ private:
     QString errorString_;
     QSize tileSize_;
     QList<TiledMapReplyTest*> m_queue;
+    int hostCount_ = 1;
+    bool holdRequests_ = false;
+    QGeoTiledMapReply::Error heldError_ = QGeoTiledMapReply::NoError;
+    QString heldErrorString_;
+    QList<QPointer<TiledMapReplyTest> > heldReplies_;
+    QList<QGeoTileSpec> requestedTiles_;
+    QList<QGeoTileSpec> abortedTiles_;
 };
 
 #endif
@@ -709,6 +709,65 @@ private slots:
         delete obj2;
     }
 
+    void tst_manyMonitors()
+    {
+        QGeoAreaMonitorSource *obj = QGeoAreaMonitorSource::createSource(QStringLiteral("positionpoll"), 0);
+        QVERIFY(obj != 0);
+        QSignalSpy enteredSpy(obj, SIGNAL(areaEntered(QGeoAreaMonitorInfo,QGeoPositionInfo)));
+        QSignalSpy exitedSpy(obj, SIGNAL(areaExited(QGeoAreaMonitorInfo,QGeoPositionInfo)));
+
+        LogFilePositionSource *source = new LogFilePositionSource(this);
+        source->setUpdateInterval(UPDATE_INTERVAL);
+        obj->setPositionInfoSource(source);
+
+        // Never reached by the log
+        for (int i = 0; i < 2000; ++i) {
+            QGeoAreaMonitorInfo distant(QStringLiteral("Distant_") + QString::number(i));
+            distant.setArea(QGeoCircle(QGeoCoordinate(10.0 + (i % 40), -170.0 + (i / 40) * 6.5), 5000));
+            QVERIFY(obj->startMonitoring(distant));
+        }
+        QGeoAreaMonitorInfo antimeridian("Many_Antimeridian");
+        antimeridian.setArea(QGeoRectangle(QGeoCoordinate(1, 179.95), QGeoCoordinate(0, -179.95)));
+        QVERIFY(obj->startMonitoring(antimeridian));
+
+        // Too large for the grid
+        QGeoAreaMonitorInfo hemisphere("Many_Hemisphere");
+        hemisphere.setArea(QGeoRectangle(QGeoCoordinate(0, -180), QGeoCoordinate(-80, 180)));
+        QVERIFY(obj->startMonitoring(hemisphere));
+
+        // Crossed twice by the log
+        QGeoAreaMonitorInfo circle("Many_Circle");
+        circle.setArea(QGeoCircle(QGeoCoordinate(-27.70, 153.0918), 1500));
+        QVERIFY(obj->startMonitoring(circle));
+
+        QTRY_VERIFY_WITH_TIMEOUT(exitedSpy.count() == 2, 20000);
+        QCOMPARE(enteredSpy.count(), 3);
+
+        QList<QGeoAreaMonitorInfo> enteredMonitors;
+        enteredMonitors << hemisphere << circle << circle;
+        QList<QGeoCoordinate> enteredCoordinates;
+        enteredCoordinates << QGeoCoordinate(-27.54, 153.090718)
+                           << QGeoCoordinate(-27.69, 153.091729)
+                           << QGeoCoordinate(-27.70, 153.094168);
+        for (int i = 0; i < enteredMonitors.count(); ++i) {
+            const QList<QVariant> event = enteredSpy.takeFirst();
+            QVERIFY2(event.at(0).value<QGeoAreaMonitorInfo>() == enteredMonitors.at(i),
+                     qPrintable(QString::number(i)));
+            QCOMPARE(event.at(1).value<QGeoPositionInfo>().coordinate(), enteredCoordinates.at(i));
+        }
+
+        QList<QGeoCoordinate> exitedCoordinates;
+        exitedCoordinates << QGeoCoordinate(-27.72, 153.091940)
+                          << QGeoCoordinate(-27.68, 153.094474);
+        for (int i = 0; i < exitedCoordinates.count(); ++i) {
+            const QList<QVariant> event = exitedSpy.takeFirst();
+            QVERIFY(event.at(0).value<QGeoAreaMonitorInfo>() == circle);
+            QCOMPARE(event.at(1).value<QGeoPositionInfo>().coordinate(), exitedCoordinates.at(i));
+        }
+
+        delete obj;
+    }
+
     void debug_data()
     {
         QTest::addColumn<QGeoAreaMonitorInfo>("info");
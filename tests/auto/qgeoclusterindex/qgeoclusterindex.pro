@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeoclusterindex
+
+INCLUDEPATH += ../../../src/location/maps
+
+SOURCES += tst_qgeoclusterindex.cpp
+
+QT += location-private positioning-private testlib
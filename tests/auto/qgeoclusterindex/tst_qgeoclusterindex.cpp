@@ -0,0 +1,178 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QRandomGenerator>
+#include <QtTest/QtTest>
+
+#include "qgeoclusterindex_p.h"
+
+QT_USE_NAMESPACE
+
+class tst_QGeoClusterIndex : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void empty();
+    void levels();
+    void countsAndLeaves();
+    void invalidCoordinates();
+    void antimeridian();
+};
+
+static int totalCount(const QGeoClusterIndex &index, int level, const QVector<int> &ids)
+{
+    int count = 0;
+    for (int id : ids)
+        count += index.cluster(level, id).count;
+    return count;
+}
+
+static const QRectF world(0.0, 0.0, 1.0, 1.0);
+
+void tst_QGeoClusterIndex::empty()
+{
+    QGeoClusterIndex index;
+    QVERIFY(index.isEmpty());
+    QCOMPARE(index.levelForZoom(3), -1);
+
+    index.build(QVector<QGeoCoordinate>(), 60);
+    QVERIFY(index.isEmpty());
+    QVERIFY(index.clustersIn(0, world).isEmpty());
+}
+
+void tst_QGeoClusterIndex::levels()
+{
+    // A few pixels apart at zoom level 0, thousands of pixels apart at zoom level 10
+    const QVector<QGeoCoordinate> points = {
+        QGeoCoordinate(10, 10), QGeoCoordinate(10, 12), QGeoCoordinate(12, 10)
+    };
+    QGeoClusterIndex index;
+    index.build(points, 60, 256, 10);
+    QCOMPARE(index.levelCount(), 12);
+    QCOMPARE(index.levelForZoom(0.5), 0);
+    QCOMPARE(index.levelForZoom(7.9), 7);
+    QCOMPARE(index.levelForZoom(30), 11);
+
+    QVector<int> ids = index.clustersIn(0, world);
+    QCOMPARE(ids.size(), 1);
+    const QGeoClusterIndex::Cluster &top = index.cluster(0, ids.first());
+    QCOMPARE(top.count, 3);
+    QCOMPARE(top.row, -1);
+    QVERIFY(index.coordinate(0, ids.first()).distanceTo(QGeoCoordinate(10.7, 10.7)) < 100000);
+
+    QVector<int> rows = index.leaves(0, ids.first());
+    std::sort(rows.begin(), rows.end());
+    QCOMPARE(rows, QVector<int>({0, 1, 2}));
+
+    ids = index.clustersIn(10, world);
+    QCOMPARE(ids.size(), 3);
+    for (int id : qAsConst(ids)) {
+        QCOMPARE(index.cluster(10, id).count, 1);
+        QVERIFY(index.cluster(10, id).row >= 0);
+    }
+}
+
+void tst_QGeoClusterIndex::countsAndLeaves()
+{
+    QRandomGenerator generator(42);
+    QVector<QGeoCoordinate> points;
+    for (int i = 0; i < 2000; ++i) {
+        points << QGeoCoordinate(generator.bounded(160.0) - 80.0,
+                                 generator.bounded(360.0) - 180.0);
+    }
+    QGeoClusterIndex index;
+    index.build(points, 40);
+
+    int previous = 0;
+    for (int level = 0; level < index.levelCount(); ++level) {
+        const QVector<int> ids = index.clustersIn(level, world);
+        QCOMPARE(totalCount(index, level, ids), points.size());
+        QVERIFY(ids.size() >= previous);
+        previous = ids.size();
+
+        if (level == 4) {
+            QVector<int> rows;
+            for (int id : ids)
+                rows << index.leaves(level, id);
+            std::sort(rows.begin(), rows.end());
+            QCOMPARE(rows.size(), points.size());
+            for (int i = 0; i < rows.size(); ++i)
+                QCOMPARE(rows.at(i), i);
+        }
+    }
+    QCOMPARE(previous, points.size());
+
+    // A viewport only returns the clusters in it
+    const QRectF viewport(0.25, 0.25, 0.1, 0.1);
+    const QVector<int> ids = index.clustersIn(8, viewport);
+    QVERIFY(!ids.isEmpty());
+    int inViewport = 0;
+    for (int id = 0; id < index.clustersIn(8, world).size(); ++id) {
+        const QDoubleVector2D p = index.cluster(8, id).position;
+        if (viewport.contains(QPointF(p.x(), p.y())))
+            ++inViewport;
+    }
+    QCOMPARE(ids.size(), inViewport);
+}
+
+void tst_QGeoClusterIndex::invalidCoordinates()
+{
+    const QVector<QGeoCoordinate> points = {
+        QGeoCoordinate(), QGeoCoordinate(40, 40), QGeoCoordinate(200, 0)
+    };
+    QGeoClusterIndex index;
+    index.build(points, 60);
+    const QVector<int> ids = index.clustersIn(index.levelCount() - 1, world);
+    QCOMPARE(ids.size(), 1);
+    QCOMPARE(index.cluster(index.levelCount() - 1, ids.first()).row, 1);
+}
+
+void tst_QGeoClusterIndex::antimeridian()
+{
+    const QVector<QGeoCoordinate> points = {
+        QGeoCoordinate(0, 179), QGeoCoordinate(0, -179), QGeoCoordinate(0, 0)
+    };
+    QGeoClusterIndex index;
+    index.build(points, 20);
+
+    // A viewport centered on the antimeridian, in wrapped coordinates
+    const int level = 6;
+    QVector<int> ids = index.clustersIn(level, QRectF(0.99, 0.45, 0.02, 0.1));
+    QCOMPARE(totalCount(index, level, ids), 2);
+    ids = index.clustersIn(level, QRectF(-0.005, 0.45, 0.004, 0.1));
+    QCOMPARE(totalCount(index, level, ids), 1);
+    ids = index.clustersIn(level, QRectF(0.495, 0.45, 0.01, 0.1));
+    QCOMPARE(totalCount(index, level, ids), 1);
+    ids = index.clustersIn(level, QRectF(-0.5, 0.0, 2.0, 1.0));
+    QCOMPARE(totalCount(index, level, ids), 3);
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoClusterIndex)
+
+#include "tst_qgeoclusterindex.moc"
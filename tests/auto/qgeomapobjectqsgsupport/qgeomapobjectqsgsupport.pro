@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeomapobjectqsgsupport
+
+SOURCES += tst_qgeomapobjectqsgsupport.cpp
+
+QT += location-private positioning-private quick testlib
@@ -0,0 +1,240 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtQuick/QQuickWindow>
+#include <QtQuick/QSGNode>
+#include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeomap_p_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtLocation/private/qgeocameradata_p.h>
+#include <QtLocation/private/qgeomapobjectqsgsupport_p.h>
+#include <QtLocation/private/qmappolylineobject_p.h>
+#include <QtLocation/private/qmapiconobject_p.h>
+
+QT_USE_NAMESPACE
+
+class TestMap;
+
+// The bare minimum of QGeoMapItemsOverlay, to drive QGeoMapObjectQSGSupport
+class TestMapPrivate : public QGeoMapPrivate
+{
+    Q_DECLARE_PUBLIC(TestMap)
+public:
+    TestMapPrivate() : QGeoMapPrivate(nullptr, new QGeoProjectionWebMercator) {}
+
+    QGeoMapObjectPrivate *createMapObjectImplementation(QGeoMapObject *obj) override
+    {
+        return m_qsgSupport.createMapObjectImplementationPrivate(obj);
+    }
+    QList<QGeoMapObject *> mapObjects() const override
+    {
+        return m_qsgSupport.mapObjects();
+    }
+
+    QGeoMapObjectQSGSupport m_qsgSupport;
+
+protected:
+    void changeViewportSize(const QSize &) override { m_qsgSupport.updateObjectsGeometry(); }
+    void changeCameraData(const QGeoCameraData &) override { m_qsgSupport.updateObjectsGeometry(); }
+    void changeActiveMapType(const QGeoMapType) override { m_qsgSupport.updateObjectsGeometry(); }
+};
+
+class TestMap : public QGeoMap
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(TestMap)
+public:
+    TestMap() : QGeoMap(*new TestMapPrivate)
+    {
+        d_func()->m_qsgSupport.m_map = this;
+    }
+
+    bool createMapObjectImplementation(QGeoMapObject *obj) override
+    {
+        Q_D(TestMap);
+        return d->m_qsgSupport.createMapObjectImplementation(obj, d);
+    }
+    void removeMapObject(QGeoMapObject *obj) override
+    {
+        d_func()->m_qsgSupport.removeMapObject(obj);
+    }
+
+    QSGNode *sync(QSGNode *root, QQuickWindow *window)
+    {
+        return updateSceneGraph(root, window);
+    }
+
+    const MapObject *mapObject(QGeoMapObject *obj) const
+    {
+        for (const MapObject &mo : d_func()->m_qsgSupport.m_mapObjects) {
+            if (mo.object == obj)
+                return &mo;
+        }
+        return nullptr;
+    }
+
+protected:
+    QSGNode *updateSceneGraph(QSGNode *node, QQuickWindow *window) override
+    {
+        if (!node)
+            node = new QSGNode;
+        d_func()->m_qsgSupport.updateMapObjects(node, window);
+        return node;
+    }
+};
+
+class tst_QGeoMapObjectQSGSupport : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void panOutAndBack();
+
+private:
+    void pan(const QGeoCoordinate &center);
+    void sync();
+
+    QQuickWindow *window_ = nullptr;
+    TestMap *map_ = nullptr;
+    QSGNode *root_ = nullptr;
+    QList<QGeoMapObject *> objects_;
+};
+
+void tst_QGeoMapObjectQSGSupport::init()
+{
+    window_ = new QQuickWindow;
+    map_ = new TestMap;
+    map_->setViewportSize(QSize(256, 256));
+    pan(QGeoCoordinate(0, 0));
+}
+
+void tst_QGeoMapObjectQSGSupport::cleanup()
+{
+    qDeleteAll(objects_);
+    objects_.clear();
+    delete root_;
+    root_ = nullptr;
+    delete map_;
+    delete window_;
+}
+
+void tst_QGeoMapObjectQSGSupport::pan(const QGeoCoordinate &center)
+{
+    QGeoCameraData camera;
+    camera.setCenter(center);
+    camera.setZoomLevel(4); // about 22 degrees across
+    map_->setCameraData(camera);
+}
+
+void tst_QGeoMapObjectQSGSupport::sync()
+{
+    root_ = map_->sync(root_, window_);
+}
+
+void tst_QGeoMapObjectQSGSupport::panOutAndBack()
+{
+    auto polyline = [this](const QVariantList &path) {
+        QMapPolylineObject *o = new QMapPolylineObject;
+        o->setPath(path);
+        o->setMap(map_);
+        objects_ << o;
+        return o;
+    };
+    QGeoMapObject *line = polyline(QVariantList() << QVariant::fromValue(QGeoCoordinate(1, 1))
+                                                  << QVariant::fromValue(QGeoCoordinate(2, 2)));
+    QGeoMapObject *unindexed = polyline(QVariantList()); // an empty path has no bounding box
+    QMapIconObject *icon = new QMapIconObject;
+    icon->setCoordinate(QGeoCoordinate(1, 1));
+    icon->setMap(map_);
+    objects_ << icon;
+    sync();
+
+    const MapObject *lineMo = map_->mapObject(line);
+    const MapObject *iconMo = map_->mapObject(icon);
+    const MapObject *unindexedMo = map_->mapObject(unindexed);
+    QVERIFY(lineMo && iconMo && unindexedMo);
+    QVERIFY(lineMo->visibleNode && lineMo->visibleNode->visible());
+    QVERIFY(!lineMo->culled);
+
+    // Far away: the polyline is hidden, its geometry is left stale
+    pan(QGeoCoordinate(0, 90));
+    QVERIFY(lineMo->geometryDirty);
+    QVERIFY(!iconMo->geometryDirty);
+    QVERIFY(!unindexedMo->geometryDirty);
+    sync();
+    QVERIFY(lineMo->culled);
+    QVERIFY(!lineMo->visibleNode->visible());
+    QVERIFY(lineMo->geometryDirty);
+    QVERIFY(!iconMo->culled);
+    QVERIFY(!unindexedMo->culled);
+
+    // Panning around away from it does not touch it
+    pan(QGeoCoordinate(10, 100));
+    sync();
+    QVERIFY(lineMo->culled);
+    QVERIFY(lineMo->geometryDirty);
+
+    // Back in view: the geometry is regenerated and the node shown again
+    pan(QGeoCoordinate(0, 0));
+    QVERIFY(!lineMo->geometryDirty);
+    sync();
+    QVERIFY(!lineMo->culled);
+    QVERIFY(!lineMo->geometryDirty);
+    QVERIFY(lineMo->visibleNode->visible());
+
+    // Coming into view without a camera change: regenerated on sync
+    pan(QGeoCoordinate(0, 90));
+    sync();
+    QVERIFY(lineMo->culled);
+    QVERIFY(lineMo->geometryDirty);
+    static_cast<QMapPolylineObject *>(line)->setPath(QVariantList() << QVariant::fromValue(QGeoCoordinate(1, 89))
+                                                                    << QVariant::fromValue(QGeoCoordinate(2, 90)));
+    sync();
+    QVERIFY(!lineMo->culled);
+    QVERIFY(!lineMo->geometryDirty);
+    QVERIFY(lineMo->visibleNode->visible());
+    static_cast<QMapPolylineObject *>(line)->setPath(QVariantList() << QVariant::fromValue(QGeoCoordinate(1, 1))
+                                                                    << QVariant::fromValue(QGeoCoordinate(2, 2)));
+
+    // Hidden objects stay hidden when they come back into view
+    pan(QGeoCoordinate(0, 90));
+    sync();
+    line->setVisible(false);
+    pan(QGeoCoordinate(0, 0));
+    sync();
+    QVERIFY(!lineMo->culled);
+    QVERIFY(!lineMo->visibleNode->visible());
+}
+
+QTEST_MAIN(tst_QGeoMapObjectQSGSupport)
+
+#include "tst_qgeomapobjectqsgsupport.moc"
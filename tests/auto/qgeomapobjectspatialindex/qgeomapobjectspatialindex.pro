@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeomapobjectspatialindex
+
+INCLUDEPATH += ../../../src/location/labs
+
+SOURCES += tst_qgeomapobjectspatialindex.cpp
+
+QT += location-private positioning-private testlib
@@ -0,0 +1,200 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtPositioning/QGeoCircle>
+#include <QtLocation/private/qmapcircleobject_p.h>
+
+#include "qgeomapobjectspatialindex_p.h"
+
+#include <random>
+
+QT_USE_NAMESPACE
+
+class tst_QGeoMapObjectSpatialIndex : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void insertRemove();
+    void move();
+    void antimeridian();
+    void insertionOrder();
+    void bruteForce();
+
+private:
+    QGeoMapObject *object(int i) { return objects_.at(i); }
+
+    QList<QGeoMapObject *> objects_;
+};
+
+static QList<QGeoMapObject *> bruteForce(const QHash<QGeoMapObject *, QRectF> &bounds,
+                                         const QList<QGeoMapObject *> &order,
+                                         const QRectF &rect)
+{
+    QList<QGeoMapObject *> res;
+    for (QGeoMapObject *o : order) {
+        if (!bounds.contains(o))
+            continue;
+        const QRectF b = bounds.value(o);
+        for (double shift : {0.0, 1.0, -1.0}) {
+            const QRectF r = rect.translated(shift, 0.0);
+            if (b.left() <= r.right() && r.left() <= b.right()
+                    && b.top() <= r.bottom() && r.top() <= b.bottom()) {
+                res << o;
+                break;
+            }
+        }
+    }
+    return res;
+}
+
+void tst_QGeoMapObjectSpatialIndex::init()
+{
+    for (int i = 0; i < 2000; ++i)
+        objects_ << new QMapCircleObject;
+}
+
+void tst_QGeoMapObjectSpatialIndex::cleanup()
+{
+    qDeleteAll(objects_);
+    objects_.clear();
+}
+
+void tst_QGeoMapObjectSpatialIndex::insertRemove()
+{
+    QGeoMapObjectSpatialIndex index;
+    index.insert(object(0), QGeoCircle(QGeoCoordinate(0, 0), 1000));
+    index.insert(object(1), QGeoCircle(QGeoCoordinate(45, 90), 1000));
+    index.insert(object(2), QGeoShape()); // invalid shapes are not indexed
+    QCOMPARE(index.size(), 2);
+    QVERIFY(!index.contains(object(2)));
+
+    const QRectF atOrigin(0.5, 0.5, 0, 0);
+    QCOMPARE(index.intersecting(atOrigin), QList<QGeoMapObject *>() << object(0));
+    QVERIFY(index.intersecting(QRectF(0.1, 0.1, 0.01, 0.01)).isEmpty());
+
+    index.remove(object(0));
+    QVERIFY(index.intersecting(atOrigin).isEmpty());
+    QCOMPARE(index.size(), 1);
+
+    index.clear();
+    QCOMPARE(index.size(), 0);
+}
+
+void tst_QGeoMapObjectSpatialIndex::move()
+{
+    QGeoMapObjectSpatialIndex index;
+    index.insert(object(0), QRectF(0.1, 0.1, 0.001, 0.001));
+    index.insert(object(0), QRectF(0.7, 0.7, 0.2, 0.2)); // other level and cell
+    QCOMPARE(index.size(), 1);
+    QVERIFY(index.intersecting(QRectF(0.1005, 0.1005, 0, 0)).isEmpty());
+    QCOMPARE(index.intersecting(QRectF(0.8, 0.8, 0, 0)).size(), 1);
+
+    index.insert(object(0), QRectF(0.7, 0.7, 0.2, 0.1)); // same cell
+    QVERIFY(index.intersecting(QRectF(0.8, 0.85, 0, 0)).isEmpty());
+}
+
+void tst_QGeoMapObjectSpatialIndex::antimeridian()
+{
+    QGeoMapObjectSpatialIndex index;
+    const QGeoRectangle box(QGeoCoordinate(10, 170), QGeoCoordinate(-10, -170));
+    const QRectF bounds = QGeoMapObjectSpatialIndex::mapProjectionBounds(box);
+    QVERIFY(bounds.right() > 1.0);
+    index.insert(object(0), bounds);
+
+    QCOMPARE(index.intersecting(QRectF(0.99, 0.5, 0, 0)).size(), 1);
+    QCOMPARE(index.intersecting(QRectF(0.01, 0.5, 0, 0)).size(), 1);
+    QVERIFY(index.intersecting(QRectF(0.5, 0.5, 0, 0)).isEmpty());
+}
+
+void tst_QGeoMapObjectSpatialIndex::insertionOrder()
+{
+    QGeoMapObjectSpatialIndex index;
+    for (int i = 0; i < 10; ++i)
+        index.insert(object(i), QRectF(0.5 - i * 0.01, 0.5 - i * 0.01, i * 0.02, i * 0.02));
+
+    // moving keeps the original position in the order
+    index.insert(object(0), QRectF(0.4, 0.4, 0.2, 0.2));
+
+    QList<QGeoMapObject *> expected;
+    for (int i = 0; i < 10; ++i)
+        expected << object(i);
+    QCOMPARE(index.intersecting(QRectF(0.5, 0.5, 0, 0)), expected);
+}
+
+void tst_QGeoMapObjectSpatialIndex::bruteForce()
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const auto randomRect = [&]() {
+        const double size = std::pow(10.0, -7.0 * unit(rng)); // 1e-7 to 1
+        const double aspect = 0.5 + unit(rng);
+        return QRectF(unit(rng), unit(rng) * (1.0 - qMin(1.0, size)), size, qMin(1.0, size * aspect));
+    };
+
+    QGeoMapObjectSpatialIndex index;
+    QHash<QGeoMapObject *, QRectF> bounds;
+    for (QGeoMapObject *o : qAsConst(objects_)) {
+        const QRectF rect = randomRect();
+        index.insert(o, rect);
+        bounds.insert(o, rect);
+    }
+
+    const auto verifyQueries = [&]() {
+        for (int i = 0; i < 200; ++i) {
+            QRectF query = randomRect();
+            if (i % 2)
+                query.setSize(QSizeF(0, 0));
+            QCOMPARE(index.intersecting(query), ::bruteForce(bounds, objects_, query));
+        }
+    };
+    verifyQueries();
+
+    // move half, remove a quarter
+    for (int i = 0; i < objects_.size(); ++i) {
+        QGeoMapObject *o = object(i);
+        if (i % 4 == 0) {
+            index.remove(o);
+            bounds.remove(o);
+        } else if (i % 2) {
+            const QRectF rect = randomRect();
+            index.insert(o, rect);
+            bounds.insert(o, rect);
+        }
+    }
+    QCOMPARE(index.size(), bounds.size());
+    verifyQueries();
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoMapObjectSpatialIndex)
+
+#include "tst_qgeomapobjectspatialindex.moc"
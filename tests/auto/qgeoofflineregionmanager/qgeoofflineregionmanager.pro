@@ -0,0 +1,10 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeoofflineregionmanager
+
+INCLUDEPATH += ../../../src/location/maps
+INCLUDEPATH += ../geotestplugin
+
+SOURCES += tst_qgeoofflineregionmanager.cpp
+
+QT += location-private positioning-private testlib
@@ -0,0 +1,420 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeotiledmap_test.h"
+#include "qgeotilefetcher_test.h"
+#include <QtCore/QString>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+#include <QtTest/QSignalSpy>
+#include <QtPositioning/QGeoRectangle>
+#include <QtPositioning/QGeoCircle>
+#include <QtLocation/QGeoServiceProvider>
+#include <QtLocation/private/qgeomappingmanager_p.h>
+#include <QtLocation/private/qabstractgeotilecache_p.h>
+
+#include "qgeoofflineregionmanager_p.h"
+#include "qgeotilespec_p.h"
+#include "qgeomaptype_p.h"
+
+QT_USE_NAMESPACE
+
+class tst_QGeoOfflineRegionManager : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+
+    void wholeWorld();
+    void smallArea();
+    void crossingDateline();
+    void circle();
+    void zoomRange();
+    void invalidArea();
+
+    void downloadProgress();
+    void concurrentRequests();
+    void retries();
+    void retriesExhausted();
+    void cancel();
+    void pinning();
+    void alreadyStored();
+    void nothingToDownload();
+
+private:
+    static QSet<QGeoTileSpec> tiles(const QGeoShape &area, int minimumZoomLevel, int maximumZoomLevel);
+    void finishDownload(const QSignalSpy &finishedSpy);
+
+    QTemporaryDir m_cacheDirectory;
+    QScopedPointer<QGeoServiceProvider> m_provider;
+    QScopedPointer<QGeoTiledMapTest> m_map;
+    QGeoTiledMappingManagerEngine *m_engine = nullptr;
+    QGeoTileFetcherTest *m_fetcher = nullptr;
+    QGeoMapType m_mapType;
+    int m_maxDiskUsage = 0;
+};
+
+static QGeoRectangle worldArea()
+{
+    return QGeoRectangle(QGeoCoordinate(85.0, -180.0), QGeoCoordinate(-85.0, 180.0));
+}
+
+void tst_QGeoOfflineRegionManager::initTestCase()
+{
+#if QT_CONFIG(library)
+    // Set custom path since CI doesn't install test plugins
+#ifdef Q_OS_WIN
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../../plugins"));
+#else
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../plugins"));
+#endif
+#endif
+    QVERIFY(m_cacheDirectory.isValid());
+
+    QVariantMap parameters;
+    parameters["tileSize"] = 256;
+    parameters["cacheDirectory"] = m_cacheDirectory.path();
+    m_provider.reset(new QGeoServiceProvider("qmlgeo.test.plugin", parameters));
+    m_provider->setAllowExperimental(true);
+    QGeoMappingManager *mappingManager = m_provider->mappingManager();
+    QVERIFY2(m_provider->error() == QGeoServiceProvider::NoError, "Could not load plugin: " + m_provider->errorString().toLatin1());
+    m_map.reset(static_cast<QGeoTiledMapTest *>(mappingManager->createMap(this)));
+    QVERIFY(m_map);
+
+    m_engine = m_map->m_engine;
+    m_fetcher = static_cast<QGeoTileFetcherTest *>(m_engine->tileFetcher());
+    m_mapType = m_engine->supportedMapTypes().first();
+    m_maxDiskUsage = m_engine->tileCache()->maxDiskUsage();
+}
+
+void tst_QGeoOfflineRegionManager::init()
+{
+    if (!m_engine)
+        return;
+
+    m_fetcher->finishHeldRequests(); // left over by a failed test
+    m_fetcher->setHoldRequests(true);
+    m_fetcher->setHeldRequestError(QGeoTiledMapReply::NoError);
+    m_fetcher->setMaxRequestsPerHost(6);
+    m_fetcher->clearRequestedTiles();
+
+    QAbstractGeoTileCache *cache = m_engine->tileCache();
+    cache->clearAll();
+    cache->setCostStrategyDisk(QAbstractGeoTileCache::ByteSize);
+    cache->setMaxDiskUsage(m_maxDiskUsage);
+}
+
+// Lets the held requests finish until the download is over
+void tst_QGeoOfflineRegionManager::finishDownload(const QSignalSpy &finishedSpy)
+{
+    for (int i = 0; i < 200 && finishedSpy.isEmpty(); ++i) {
+        m_fetcher->finishHeldRequests();
+        QTest::qWait(10);
+    }
+}
+
+QSet<QGeoTileSpec> tst_QGeoOfflineRegionManager::tiles(const QGeoShape &area,
+                                                       int minimumZoomLevel, int maximumZoomLevel)
+{
+    return QGeoOfflineRegionManager::tilesForArea(area, minimumZoomLevel, maximumZoomLevel,
+                                                  QStringLiteral("test_1"), QGeoMapType(), 1);
+}
+
+void tst_QGeoOfflineRegionManager::wholeWorld()
+{
+    const QGeoRectangle world(QGeoCoordinate(85.0, -180.0), QGeoCoordinate(-85.0, 180.0));
+    const QSet<QGeoTileSpec> result = tiles(world, 1, 1);
+
+    QCOMPARE(result.size(), 4);
+    for (int x = 0; x < 2; ++x) {
+        for (int y = 0; y < 2; ++y)
+            QVERIFY(result.contains(QGeoTileSpec(QStringLiteral("test_1"), 0, 1, x, y, 1)));
+    }
+}
+
+void tst_QGeoOfflineRegionManager::smallArea()
+{
+    const QGeoRectangle area(QGeoCoordinate(11.0, 10.0), QGeoCoordinate(10.0, 11.0));
+    const QSet<QGeoTileSpec> result = tiles(area, 3, 3);
+
+    QCOMPARE(result.size(), 1);
+    const QGeoTileSpec tile = *result.cbegin();
+    QCOMPARE(tile.zoom(), 3);
+    QCOMPARE(tile.x(), 4);
+    QCOMPARE(tile.y(), 3);
+}
+
+void tst_QGeoOfflineRegionManager::crossingDateline()
+{
+    const QGeoRectangle area(QGeoCoordinate(10.0, 170.0), QGeoCoordinate(1.0, -170.0));
+    const QSet<QGeoTileSpec> result = tiles(area, 2, 2);
+
+    QSet<int> columns;
+    for (const QGeoTileSpec &tile : result)
+        columns.insert(tile.x());
+    QCOMPARE(columns, QSet<int>({ 0, 3 }));
+}
+
+void tst_QGeoOfflineRegionManager::circle()
+{
+    const QGeoCircle area(QGeoCoordinate(10.5, 10.5), 20000.0);
+    const QSet<QGeoTileSpec> result = tiles(area, 3, 3);
+
+    QCOMPARE(result.size(), 1);
+    QCOMPARE(result.cbegin()->x(), 4);
+}
+
+void tst_QGeoOfflineRegionManager::zoomRange()
+{
+    const QGeoRectangle world(QGeoCoordinate(85.0, -180.0), QGeoCoordinate(-85.0, 180.0));
+    const QSet<QGeoTileSpec> result = tiles(world, 0, 2);
+
+    QCOMPARE(result.size(), 1 + 4 + 16);
+    QVector<int> perZoom(3, 0);
+    for (const QGeoTileSpec &tile : result)
+        ++perZoom[tile.zoom()];
+    QCOMPARE(perZoom, QVector<int>({ 1, 4, 16 }));
+}
+
+void tst_QGeoOfflineRegionManager::invalidArea()
+{
+    QVERIFY(tiles(QGeoRectangle(), 0, 5).isEmpty());
+
+    const QGeoRectangle area(QGeoCoordinate(11.0, 10.0), QGeoCoordinate(10.0, 11.0));
+    QVERIFY(tiles(area, 4, 3).isEmpty());
+}
+
+void tst_QGeoOfflineRegionManager::downloadProgress()
+{
+    QGeoOfflineRegionManager manager(m_engine);
+    QSignalSpy progressSpy(&manager, &QGeoOfflineRegionManager::progress);
+    QSignalSpy finishedSpy(&manager, &QGeoOfflineRegionManager::finished);
+
+    manager.download(worldArea(), 0, 1, m_mapType);
+    QVERIFY(manager.isActive());
+    QCOMPARE(manager.totalTiles(), 1 + 4);
+    QCOMPARE(progressSpy.count(), 1);
+    QCOMPARE(progressSpy.at(0).at(0).toInt(), 0);
+    QCOMPARE(progressSpy.at(0).at(1).toInt(), 5);
+    QTRY_VERIFY(!m_fetcher->heldTiles().isEmpty());
+
+    finishDownload(finishedSpy);
+    QCOMPARE(finishedSpy.count(), 1);
+    QVERIFY(!manager.isActive());
+    QCOMPARE(manager.completedTiles(), 5);
+    QCOMPARE(manager.failedTiles(), 0);
+
+    // One step per tile
+    QCOMPARE(progressSpy.count(), 1 + 5);
+    for (int i = 0; i < progressSpy.count(); ++i) {
+        QCOMPARE(progressSpy.at(i).at(0).toInt(), i);
+        QCOMPARE(progressSpy.at(i).at(1).toInt(), 5);
+    }
+
+    // The lower zoom level first
+    QCOMPARE(m_fetcher->requestedTiles().size(), 5);
+    QCOMPARE(m_fetcher->requestedTiles().first().zoom(), 0);
+    for (const QGeoTileSpec &tile : m_fetcher->requestedTiles())
+        QVERIFY(m_engine->tileCache()->isTileStored(tile));
+}
+
+void tst_QGeoOfflineRegionManager::concurrentRequests()
+{
+    // The fetcher lets 8 prefetch requests run, the manager is the limit
+    m_fetcher->setMaxRequestsPerHost(16);
+
+    QGeoOfflineRegionManager manager(m_engine);
+    manager.setMaxConcurrentRequests(2);
+    QCOMPARE(manager.maxConcurrentRequests(), 2);
+    QSignalSpy finishedSpy(&manager, &QGeoOfflineRegionManager::finished);
+
+    manager.download(worldArea(), 2, 2, m_mapType);
+    QCOMPARE(manager.totalTiles(), 16);
+    QTRY_COMPARE(m_fetcher->heldTiles().size(), 2);
+    QTest::qWait(50);
+    QCOMPARE(m_fetcher->requestedTiles().size(), 2);
+
+    for (int completed = 1; completed <= 16; ++completed) {
+        QCOMPARE(m_fetcher->finishHeldRequests(1), 1);
+        QTRY_COMPARE(manager.completedTiles(), completed);
+        const int running = qMin(2, 16 - completed);
+        QTRY_COMPARE(m_fetcher->heldTiles().size(), running);
+        QCOMPARE(m_fetcher->requestedTiles().size(), completed + running);
+    }
+    QTRY_COMPARE(finishedSpy.count(), 1);
+}
+
+void tst_QGeoOfflineRegionManager::retries()
+{
+    QGeoOfflineRegionManager manager(m_engine);
+    QSignalSpy finishedSpy(&manager, &QGeoOfflineRegionManager::finished);
+
+    manager.download(worldArea(), 0, 0, m_mapType);
+    QTRY_COMPARE(m_fetcher->heldTiles().size(), 1);
+    const QGeoTileSpec tile = m_fetcher->heldTiles().first();
+
+    // The first attempt fails, the tile is requested again
+    m_fetcher->setHeldRequestError(QGeoTiledMapReply::CommunicationError, QStringLiteral("failure"));
+    QCOMPARE(m_fetcher->finishHeldRequests(), 1);
+    QTRY_COMPARE(m_fetcher->heldTiles().size(), 1);
+    QVERIFY(manager.isActive());
+    QCOMPARE(manager.failedTiles(), 0);
+
+    m_fetcher->setHeldRequestError(QGeoTiledMapReply::NoError);
+    finishDownload(finishedSpy);
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(manager.completedTiles(), 1);
+    QCOMPARE(manager.failedTiles(), 0);
+    QCOMPARE(m_fetcher->requestedTiles(), QList<QGeoTileSpec>({ tile, tile }));
+}
+
+void tst_QGeoOfflineRegionManager::retriesExhausted()
+{
+    QGeoOfflineRegionManager manager(m_engine);
+    QSignalSpy progressSpy(&manager, &QGeoOfflineRegionManager::progress);
+    QSignalSpy finishedSpy(&manager, &QGeoOfflineRegionManager::finished);
+
+    m_fetcher->setHeldRequestError(QGeoTiledMapReply::CommunicationError, QStringLiteral("failure"));
+    QTest::ignoreMessage(QtWarningMsg, "QGeoOfflineRegionManager: Failed to fetch tile (0,0,0): 'failure'");
+    manager.download(worldArea(), 0, 0, m_mapType);
+    finishDownload(finishedSpy);
+
+    // Tried three times, then given up on
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(m_fetcher->requestedTiles().size(), 3);
+    QCOMPARE(manager.completedTiles(), 0);
+    QCOMPARE(manager.failedTiles(), 1);
+    QCOMPARE(progressSpy.last().at(0).toInt(), 1);
+    QCOMPARE(progressSpy.last().at(1).toInt(), 1);
+    QVERIFY(!m_engine->tileCache()->isTileStored(m_fetcher->requestedTiles().first()));
+}
+
+void tst_QGeoOfflineRegionManager::cancel()
+{
+    QGeoOfflineRegionManager manager(m_engine);
+    manager.setMaxConcurrentRequests(2);
+    QSignalSpy finishedSpy(&manager, &QGeoOfflineRegionManager::finished);
+
+    manager.download(worldArea(), 2, 2, m_mapType);
+    QTRY_COMPARE(m_fetcher->heldTiles().size(), 2);
+
+    // The running requests are aborted, and nothing else is requested
+    manager.cancel();
+    QVERIFY(!manager.isActive());
+    QCOMPARE(manager.totalTiles(), 0);
+    QCOMPARE(manager.completedTiles(), 0);
+    QTRY_VERIFY(m_fetcher->heldTiles().isEmpty());
+    QCOMPARE(m_fetcher->abortedTiles().size(), 2);
+    QTest::qWait(50);
+    QCOMPARE(m_fetcher->requestedTiles().size(), 2);
+    QCOMPARE(finishedSpy.count(), 0);
+}
+
+void tst_QGeoOfflineRegionManager::pinning()
+{
+    // Room for two tiles only
+    QAbstractGeoTileCache *cache = m_engine->tileCache();
+    cache->setCostStrategyDisk(QAbstractGeoTileCache::Unitary);
+    cache->setMaxDiskUsage(2);
+
+    QGeoOfflineRegionManager manager(m_engine);
+    QSignalSpy finishedSpy(&manager, &QGeoOfflineRegionManager::finished);
+    manager.download(worldArea(), 1, 1, m_mapType);
+    finishDownload(finishedSpy);
+    QCOMPARE(finishedSpy.count(), 1);
+
+    const QList<QGeoTileSpec> region = m_fetcher->requestedTiles();
+    QCOMPARE(region.size(), 4);
+    for (const QGeoTileSpec &tile : region)
+        QVERIFY(cache->isTileStored(tile));
+
+    // Other tiles do not evict the pinned ones
+    const QGeoTileSpec &first = region.first();
+    QList<QGeoTileSpec> others;
+    for (int x = 0; x < 4; ++x) {
+        const QGeoTileSpec other(first.plugin(), first.mapId(), 3, x, 0, first.version());
+        cache->insert(other, QByteArray("tile"), QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+        others.append(other);
+    }
+    for (const QGeoTileSpec &tile : region)
+        QVERIFY(cache->isTileStored(tile));
+
+    // Removed, the region competes with the other tiles
+    manager.remove(worldArea(), 1, 1, m_mapType);
+    int stored = 0;
+    for (const QGeoTileSpec &tile : region + others)
+        stored += cache->isTileStored(tile) ? 1 : 0;
+    QVERIFY(stored <= 2);
+}
+
+void tst_QGeoOfflineRegionManager::alreadyStored()
+{
+    {
+        QGeoOfflineRegionManager manager(m_engine);
+        QSignalSpy finishedSpy(&manager, &QGeoOfflineRegionManager::finished);
+        manager.download(worldArea(), 1, 1, m_mapType);
+        finishDownload(finishedSpy);
+        QCOMPARE(finishedSpy.count(), 1);
+    }
+    m_fetcher->clearRequestedTiles();
+
+    // Nothing is fetched, and the download is over right away
+    QGeoOfflineRegionManager manager(m_engine);
+    QSignalSpy progressSpy(&manager, &QGeoOfflineRegionManager::progress);
+    QSignalSpy finishedSpy(&manager, &QGeoOfflineRegionManager::finished);
+    manager.download(worldArea(), 1, 1, m_mapType);
+    QCOMPARE(finishedSpy.count(), 1);
+    QVERIFY(!manager.isActive());
+    QCOMPARE(progressSpy.count(), 1);
+    QCOMPARE(progressSpy.at(0).at(0).toInt(), 4);
+    QCOMPARE(progressSpy.at(0).at(1).toInt(), 4);
+    QTest::qWait(50);
+    QVERIFY(m_fetcher->requestedTiles().isEmpty());
+}
+
+void tst_QGeoOfflineRegionManager::nothingToDownload()
+{
+    QGeoOfflineRegionManager manager(m_engine);
+    QSignalSpy finishedSpy(&manager, &QGeoOfflineRegionManager::finished);
+
+    manager.download(QGeoRectangle(), 0, 5, m_mapType);
+    QCOMPARE(finishedSpy.count(), 1);
+
+    // Beyond the zoom levels of the map type
+    manager.download(worldArea(), 21, 22, m_mapType);
+    QCOMPARE(finishedSpy.count(), 2);
+    QCOMPARE(manager.totalTiles(), 0);
+}
+
+QTEST_MAIN(tst_QGeoOfflineRegionManager)
+
+#include "tst_qgeoofflineregionmanager.moc"
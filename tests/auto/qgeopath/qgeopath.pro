@@ -5,4 +5,4 @@ TARGET = tst_qgeopath
 SOURCES += \
     tst_qgeopath.cpp
 
-QT += positioning testlib
+QT += positioning-private testlib
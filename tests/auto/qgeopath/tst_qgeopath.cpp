@@ -30,6 +30,8 @@
 #include <QtPositioning/QGeoCoordinate>
 #include <QtPositioning/QGeoRectangle>
 #include <QtPositioning/QGeoPath>
+#include <QtPositioning/private/qlocationutils_p.h>
+#include <QtCore/QRandomGenerator>
 
 QT_USE_NAMESPACE
 
@@ -63,6 +65,10 @@ private slots:
 
     void extendShape();
     void extendShape_data();
+
+    void nearest_data();
+    void nearest();
+    void nearestRandom();
 };
 
 void tst_QGeoPath::defaultConstructor()
@@ -413,5 +419,108 @@ void tst_QGeoPath::extendShape_data()
     QTest::newRow("Not so far away and large line") << c[0] << c[1] << c[2] << 100000.0 << QGeoCoordinate(0.8, 0.8) << true << true;
 }
 
+void tst_QGeoPath::nearest_data()
+{
+    QTest::addColumn<QList<QGeoCoordinate>>("path");
+    QTest::addColumn<QGeoCoordinate>("probe");
+    QTest::addColumn<int>("segment");
+    QTest::addColumn<QGeoCoordinate>("nearest");
+    QTest::addColumn<double>("offset");
+
+    const QList<QGeoCoordinate> equator = QList<QGeoCoordinate>()
+            << QGeoCoordinate(0, 0) << QGeoCoordinate(0, 10) << QGeoCoordinate(0, 20);
+    const double tenDegrees = equator[0].distanceTo(equator[1]);
+
+    QTest::newRow("First segment") << equator << QGeoCoordinate(1, 5) << 0
+                                   << QGeoCoordinate(0, 5) << tenDegrees / 2;
+    QTest::newRow("Second segment") << equator << QGeoCoordinate(-1, 15) << 1
+                                    << QGeoCoordinate(0, 15) << tenDegrees * 1.5;
+    QTest::newRow("Before the start") << equator << QGeoCoordinate(0, -3) << 0
+                                      << QGeoCoordinate(0, 0) << 0.0;
+    QTest::newRow("After the end") << equator << QGeoCoordinate(2, 25) << 1
+                                   << QGeoCoordinate(0, 20) << tenDegrees * 2;
+    QTest::newRow("Single coordinate") << (QList<QGeoCoordinate>() << QGeoCoordinate(10, 10))
+                                       << QGeoCoordinate(11, 11) << 0 << QGeoCoordinate(10, 10) << 0.0;
+
+    const QList<QGeoCoordinate> dateline = QList<QGeoCoordinate>()
+            << QGeoCoordinate(0, 170) << QGeoCoordinate(0, -170);
+    QTest::newRow("Across the dateline") << dateline << QGeoCoordinate(1, -175) << 0
+                                         << QGeoCoordinate(0, -175) << tenDegrees * 1.5;
+    QTest::newRow("Across the dateline, west") << dateline << QGeoCoordinate(0, 165) << 0
+                                               << QGeoCoordinate(0, 170) << 0.0;
+}
+
+void tst_QGeoPath::nearest()
+{
+    QFETCH(QList<QGeoCoordinate>, path);
+    QFETCH(QGeoCoordinate, probe);
+    QFETCH(int, segment);
+    QFETCH(QGeoCoordinate, nearest);
+    QFETCH(double, offset);
+
+    const QGeoPath p(path);
+    QCOMPARE(p.nearestSegment(probe), segment);
+    const QGeoCoordinate c = p.nearestCoordinate(probe);
+    QVERIFY(c.distanceTo(nearest) < 1e-3);
+    QVERIFY(qAbs(p.distanceTo(probe) - probe.distanceTo(nearest)) < 1e-3);
+    QVERIFY(qAbs(p.projectedOffset(probe) - offset) < 1e-3);
+
+    // contains() is a distance check against half the width
+    QGeoPath wide(path, 2 * p.distanceTo(probe) + 2.0);
+    QVERIFY(wide.contains(probe));
+    QGeoPath narrow(path, qMax(2 * p.distanceTo(probe) - 2.0, 0.0));
+    QCOMPARE(narrow.contains(probe), p.distanceTo(probe) <= 0.2);
+
+    QGeoPath empty;
+    QCOMPARE(empty.nearestSegment(probe), -1);
+    QVERIFY(!empty.nearestCoordinate(probe).isValid());
+    QVERIFY(qIsNaN(empty.distanceTo(probe)));
+    QVERIFY(qIsNaN(p.distanceTo(QGeoCoordinate())));
+}
+
+// Compares the indexed query of a long path with its segments taken one at a time
+void tst_QGeoPath::nearestRandom()
+{
+    QRandomGenerator random(7);
+    QList<QGeoCoordinate> route;
+    double latitude = 48.0;
+    double longitude = 179.0;
+    for (int i = 0; i < 2000; ++i) {
+        route << QGeoCoordinate(latitude, QLocationUtils::wrapLong(longitude));
+        latitude += 0.01 * (random.generateDouble() - 0.3);
+        longitude += 0.01 * (random.generateDouble() - 0.3);
+    }
+    QGeoPath path(route);
+
+    for (int i = 0; i < 200; ++i) {
+        const QGeoCoordinate &c = route.at(random.bounded(route.size()));
+        const QGeoCoordinate probe(c.latitude() + 0.02 * (random.generateDouble() - 0.5),
+                                   QLocationUtils::wrapLong(c.longitude() + 0.02 * (random.generateDouble() - 0.5)));
+        int segment = -1;
+        double distance = qInf();
+        for (int j = 0; j + 1 < route.size(); ++j) {
+            const double d = QGeoPath(QList<QGeoCoordinate>() << route.at(j) << route.at(j + 1)).distanceTo(probe);
+            if (d < distance) {
+                distance = d;
+                segment = j;
+            }
+        }
+        QCOMPARE(path.nearestSegment(probe), segment);
+        QCOMPARE(path.distanceTo(probe), distance);
+
+        const double offset = path.length(0, segment) + route.at(segment).distanceTo(path.nearestCoordinate(probe));
+        QVERIFY(qAbs(path.projectedOffset(probe) - offset) < 1e-6 * (offset + 1.0));
+    }
+
+    // The index follows changes to the path
+    const QGeoCoordinate far(0, 0);
+    const int last = path.nearestSegment(far);
+    path.addCoordinate(QGeoCoordinate(0.5, 0.5));
+    QVERIFY(path.nearestSegment(far) != last);
+    QCOMPARE(path.nearestSegment(far), route.size() - 1);
+    path.translate(1, 0);
+    QVERIFY(qAbs(path.distanceTo(QGeoCoordinate(1.5, 0.5))) < 1e-3);
+}
+
 QTEST_MAIN(tst_QGeoPath)
 #include "tst_qgeopath.moc"
@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeopathlevelofdetail
+
+INCLUDEPATH += ../../../src/location/declarativemaps
+
+SOURCES += tst_qgeopathlevelofdetail.cpp
+
+QT += location-private positioning-private testlib
@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "qgeopathlevelofdetail_p.h"
+
+QT_USE_NAMESPACE
+
+class tst_QGeoPathLevelOfDetail : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void endpoints();
+    void collinear();
+    void levels();
+    void closed();
+    void antimeridian();
+};
+
+static const double kTileSize = 256.0;
+
+static double mapWidth(double zoomLevel)
+{
+    return kTileSize * std::pow(2.0, zoomLevel);
+}
+
+// A zig-zag with decreasing amplitude, in mercator units
+static QList<QDoubleVector2D> zigzag(int count)
+{
+    QList<QDoubleVector2D> path;
+    for (int i = 0; i < count; ++i) {
+        const double amplitude = (i % 2 ? 1.0 : -1.0) * 0.01 / (1 << (i % 12));
+        path << QDoubleVector2D(0.4 + i * 0.0001, 0.5 + amplitude);
+    }
+    return path;
+}
+
+void tst_QGeoPathLevelOfDetail::endpoints()
+{
+    QGeoPathLevelOfDetail lod;
+    QVERIFY(lod.isEmpty());
+
+    const QList<QDoubleVector2D> path = zigzag(100);
+    lod.setPath(path);
+    QVERIFY(!lod.isEmpty());
+
+    const QList<QDoubleVector2D> &simplified = lod.path(0.0, mapWidth(0.0));
+    QVERIFY(simplified.size() >= 2);
+    QVERIFY(simplified.size() < path.size());
+    QCOMPARE(simplified.first(), path.first());
+    QCOMPARE(simplified.last(), path.last());
+}
+
+void tst_QGeoPathLevelOfDetail::collinear()
+{
+    QList<QDoubleVector2D> path;
+    for (int i = 0; i < 1000; ++i)
+        path << QDoubleVector2D(0.1 + i * 0.0005, 0.2 + i * 0.0002);
+
+    QGeoPathLevelOfDetail lod;
+    lod.setPath(path);
+    QCOMPARE(lod.path(20.0, mapWidth(20.0)).size(), 2);
+}
+
+void tst_QGeoPathLevelOfDetail::levels()
+{
+    const QList<QDoubleVector2D> path = zigzag(1000);
+    QGeoPathLevelOfDetail lod;
+    lod.setPath(path);
+
+    int previous = 0;
+    for (int zoomLevel = 0; zoomLevel <= 20; ++zoomLevel) {
+        const QList<QDoubleVector2D> &simplified = lod.path(zoomLevel, mapWidth(zoomLevel));
+        // more detail when zooming in, and vertices stay in path order
+        QVERIFY(simplified.size() >= previous);
+        for (int i = 1; i < simplified.size(); ++i)
+            QVERIFY(simplified.at(i).x() > simplified.at(i - 1).x());
+        previous = simplified.size();
+
+        // all dropped vertices are within the tolerance of the level
+        const double tolerance = 0.5 / mapWidth(QGeoPathLevelOfDetail::level(zoomLevel));
+        int kept = 0;
+        for (int i = 0; i < path.size(); ++i) {
+            if (lod.tolerance(i) >= tolerance)
+                ++kept;
+        }
+        QCOMPARE(simplified.size(), kept);
+    }
+
+    // fractional zoom levels share the simplification of the integer level
+    QCOMPARE(lod.path(5.3, mapWidth(5.3)).size(), lod.path(5.9, mapWidth(5.9)).size());
+}
+
+void tst_QGeoPathLevelOfDetail::closed()
+{
+    QList<QDoubleVector2D> ring;
+    for (int i = 0; i < 360; ++i) {
+        const double angle = qDegreesToRadians(double(i));
+        ring << QDoubleVector2D(0.5 + 0.00001 * std::cos(angle), 0.5 + 0.00001 * std::sin(angle));
+    }
+
+    QGeoPathLevelOfDetail lod;
+    lod.setPath(ring, true);
+    QCOMPARE(lod.path(0.0, mapWidth(0.0)).size(), 3);
+
+    lod.setPath(ring, false);
+    QCOMPARE(lod.path(0.0, mapWidth(0.0)).size(), 2);
+}
+
+void tst_QGeoPathLevelOfDetail::antimeridian()
+{
+    // A straight line across the antimeridian
+    QList<QDoubleVector2D> path;
+    path << QDoubleVector2D(0.98, 0.50) << QDoubleVector2D(0.99, 0.51)
+         << QDoubleVector2D(0.01, 0.53) << QDoubleVector2D(0.02, 0.54);
+
+    QGeoPathLevelOfDetail lod;
+    lod.setPath(path);
+    QVERIFY(lod.tolerance(1) < 1e-12);
+    QVERIFY(lod.tolerance(2) < 1e-12);
+    QCOMPARE(lod.path(10.0, mapWidth(10.0)).size(), 2);
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoPathLevelOfDetail)
+
+#include "tst_qgeopathlevelofdetail.moc"
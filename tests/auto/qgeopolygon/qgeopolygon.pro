@@ -5,4 +5,4 @@ TARGET = tst_qgeopolygon
 SOURCES += \
     tst_qgeopolygon.cpp
 
-QT += positioning testlib
+QT += positioning-private testlib
@@ -30,6 +30,9 @@
 #include <QtPositioning/QGeoCoordinate>
 #include <QtPositioning/QGeoRectangle>
 #include <QtPositioning/QGeoPolygon>
+#include <QtPositioning/private/qgeopolygon_p.h>
+#include <QtPositioning/private/qlocationutils_p.h>
+#include <QtCore/QRandomGenerator>
 
 QT_USE_NAMESPACE
 
@@ -56,6 +59,9 @@ private slots:
 
     void contains_data();
     void contains();
+    void containsHoles();
+    void prepared_data();
+    void prepared();
 
     void boundingGeoRectangle_data();
     void boundingGeoRectangle();
@@ -319,6 +325,91 @@ void tst_QGeoPolygon::contains()
 
     QGeoShape area = p;
     QCOMPARE(area.contains(probe), result);
+
+    QCOMPARE(QGeoPolygonPrepared(p).contains(probe), result);
+}
+
+void tst_QGeoPolygon::containsHoles()
+{
+    QGeoPolygon p(QList<QGeoCoordinate>() << QGeoCoordinate(0, 0) << QGeoCoordinate(0, 10)
+                                          << QGeoCoordinate(10, 10) << QGeoCoordinate(10, 0));
+    const QList<QGeoCoordinate> hole = QList<QGeoCoordinate>()
+            << QGeoCoordinate(4, 4) << QGeoCoordinate(4, 6) << QGeoCoordinate(6, 6) << QGeoCoordinate(6, 4);
+    QVERIFY(p.contains(QGeoCoordinate(5, 5)));
+
+    // Holes added after a query are taken into account
+    p.addHole(hole);
+    QVERIFY(!p.contains(QGeoCoordinate(5, 5)));
+    QVERIFY(p.contains(QGeoCoordinate(2, 2)));
+
+    QGeoPolygonPrepared prepared(p);
+    QVERIFY(!prepared.contains(QGeoCoordinate(5, 5)));
+    QVERIFY(prepared.contains(QGeoCoordinate(2, 2)));
+
+    p.removeHole(0);
+    QVERIFY(p.contains(QGeoCoordinate(5, 5)));
+    prepared.removeHole(0);
+    QVERIFY(prepared.contains(QGeoCoordinate(5, 5)));
+}
+
+void tst_QGeoPolygon::prepared_data()
+{
+    QTest::addColumn<QGeoCoordinate>("center");
+    QTest::addColumn<double>("radius");
+
+    QTest::newRow("equator") << QGeoCoordinate(0, 0) << 20.0;
+    QTest::newRow("antimeridian") << QGeoCoordinate(40, 179) << 15.0;
+    QTest::newRow("small") << QGeoCoordinate(-33.9, 151.2) << 0.01;
+}
+
+// Random star shaped polygons with holes, compared to the unprepared polygon
+void tst_QGeoPolygon::prepared()
+{
+    QFETCH(QGeoCoordinate, center);
+    QFETCH(double, radius);
+
+    QRandomGenerator random(42);
+    auto ring = [&](const QGeoCoordinate &c, double r, int count) {
+        QList<QGeoCoordinate> result;
+        for (int i = 0; i < count; ++i) {
+            const double angle = 2 * M_PI * i / count;
+            const double distance = r * (0.5 + 0.5 * random.generateDouble());
+            result << QGeoCoordinate(c.latitude() + distance * qSin(angle),
+                                     QLocationUtils::wrapLong(c.longitude() + distance * qCos(angle)));
+        }
+        return result;
+    };
+
+    QGeoPolygon polygon(ring(center, radius, 500));
+    polygon.addHole(ring(center, radius * 0.2, 50));
+    polygon.addHole(ring(QGeoCoordinate(center.latitude() + radius * 0.35, center.longitude()), radius * 0.1, 20));
+    QGeoPolygonPrepared prepared(polygon);
+    QCOMPARE(prepared, polygon);
+
+    auto probe = [&]() {
+        return QGeoCoordinate(center.latitude() + radius * (2 * random.generateDouble() - 1),
+                              QLocationUtils::wrapLong(center.longitude() + radius * (2 * random.generateDouble() - 1)));
+    };
+    int inside = 0;
+    for (int i = 0; i < 5000; ++i) {
+        const QGeoCoordinate c = probe();
+        const bool contains = polygon.contains(c);
+        inside += contains;
+        QCOMPARE(prepared.contains(c), contains);
+    }
+    QVERIFY(inside > 0);
+    // The vertices lie on the boundary
+    for (const QGeoCoordinate &c : polygon.path())
+        QCOMPARE(prepared.contains(c), polygon.contains(c));
+
+    // A translated copy is prepared again
+    QGeoShape shape = prepared;
+    shape.translate(1, 1);
+    polygon.translate(1, 1);
+    for (int i = 0; i < 1000; ++i) {
+        const QGeoCoordinate c = probe();
+        QCOMPARE(shape.contains(c), polygon.contains(c));
+    }
 }
 
 void tst_QGeoPolygon::boundingGeoRectangle_data()
@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeotilecachestatistics
+
+INCLUDEPATH += ../../../src/location/maps
+
+SOURCES += tst_qgeotilecachestatistics.cpp
+
+QT += location-private testlib
@@ -0,0 +1,131 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QString>
+#include <QtTest/QtTest>
+
+#include "qcache3q_p.h"
+#include "qabstractgeotilecache_p.h"
+
+QT_USE_NAMESPACE
+
+class tst_QGeoTileCacheStatistics : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void cacheCounters();
+    void resetCounters();
+    void decodeTimes();
+    void variantMap();
+};
+
+void tst_QGeoTileCacheStatistics::cacheCounters()
+{
+    QCache3Q<int, QString> cache(4);
+    for (int i = 0; i < 8; ++i)
+        QVERIFY(cache.insert(i, QSharedPointer<QString>(new QString(QString::number(i)))));
+
+    QCOMPARE(cache.insertCount(), quint64(8));
+    QVERIFY(cache.evictionCount() > 0);
+    QVERIFY(cache.totalCost() <= 4);
+
+    QVERIFY(cache.object(7));
+    QVERIFY(!cache.object(42));
+    QCOMPARE(cache.hitCount(), quint64(1));
+    QCOMPARE(cache.missCount(), quint64(1));
+
+    // Explicit removal is not an eviction
+    const quint64 evictions = cache.evictionCount();
+    cache.remove(7);
+    QCOMPARE(cache.evictionCount(), evictions);
+
+    // Too expensive objects are rejected and not counted
+    QVERIFY(!cache.insert(100, QSharedPointer<QString>(new QString), 5));
+    QCOMPARE(cache.insertCount(), quint64(8));
+}
+
+void tst_QGeoTileCacheStatistics::resetCounters()
+{
+    QCache3Q<int, QString> cache(4);
+    cache.insert(1, QSharedPointer<QString>(new QString));
+    cache.object(1);
+    cache.object(2);
+    cache.resetStats();
+
+    QCOMPARE(cache.hitCount(), quint64(0));
+    QCOMPARE(cache.missCount(), quint64(0));
+    QCOMPARE(cache.insertCount(), quint64(0));
+    QCOMPARE(cache.evictionCount(), quint64(0));
+    // Only the counters are reset
+    QVERIFY(cache.object(1));
+}
+
+void tst_QGeoTileCacheStatistics::decodeTimes()
+{
+    QGeoTileCacheStatistics stats;
+    QCOMPARE(stats.decodeTimes.size(), int(QGeoTileCacheStatistics::DecodeTimeBuckets));
+
+    stats.addDecodeTime(0);
+    stats.addDecodeTime(1);
+    stats.addDecodeTime(2);
+    stats.addDecodeTime(3);
+    stats.addDecodeTime(1000);
+    stats.addDecodeTime(Q_INT64_C(10000000));
+
+    QCOMPARE(stats.decodeTimes.at(0), quint64(2));
+    QCOMPARE(stats.decodeTimes.at(1), quint64(2));
+    QCOMPARE(stats.decodeTimes.at(9), quint64(1));
+    QCOMPARE(stats.decodeTimes.last(), quint64(1));
+    QCOMPARE(stats.decodes, quint64(6));
+    QCOMPARE(stats.totalDecodeTime, Q_INT64_C(10001006));
+}
+
+void tst_QGeoTileCacheStatistics::variantMap()
+{
+    QGeoTileCacheStatistics stats;
+    stats.memory.hits = 3;
+    stats.disk.bytesRead = 1024;
+    stats.queuedTiles = 5;
+    stats.addDecodeTime(100);
+
+    const QVariantMap map = stats.toVariantMap();
+    QCOMPARE(map.value(QStringLiteral("memory")).toMap().value(QStringLiteral("hits")).toULongLong(),
+             quint64(3));
+    QCOMPARE(map.value(QStringLiteral("disk")).toMap().value(QStringLiteral("bytesRead")).toLongLong(),
+             qint64(1024));
+    QVERIFY(map.value(QStringLiteral("texture")).toMap().contains(QStringLiteral("evictions")));
+    QCOMPARE(map.value(QStringLiteral("queuedTiles")).toInt(), 5);
+    QCOMPARE(map.value(QStringLiteral("decodes")).toULongLong(), quint64(1));
+    QCOMPARE(map.value(QStringLiteral("decodeTimes")).toList().size(),
+             int(QGeoTileCacheStatistics::DecodeTimeBuckets));
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoTileCacheStatistics)
+
+#include "tst_qgeotilecachestatistics.moc"
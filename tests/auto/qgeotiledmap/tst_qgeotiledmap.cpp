@@ -35,6 +35,7 @@
 #include <QtPositioning/private/qwebmercator_p.h>
 #include <QtLocation/QGeoServiceProvider>
 #include <QtLocation/private/qgeotiledmap_p.h>
+#include <QtLocation/private/qgeotilefetcher_p_p.h>
 #include <QtLocation/private/qgeomappingmanager_p.h>
 #include <QtLocation/private/qgeocameracapabilities_p.h>
 
@@ -53,6 +54,36 @@ public:
     QSet<QGeoTileSpec> m_tiles;
 };
 
+static QGeoTileSpec tileAt(int x, int y = 0)
+{
+    return QGeoTileSpec(QStringLiteral("qmlgeo.test.plugin"), 1, 8, x, y);
+}
+
+static QSet<QGeoTileSpec> tileSet(const QList<QGeoTileSpec> &tiles)
+{
+    return QSet<QGeoTileSpec>(tiles.cbegin(), tiles.cend());
+}
+
+static QGeoTileFetcherPrivate *fetcherPrivate(QGeoTileFetcher *fetcher)
+{
+    return static_cast<QGeoTileFetcherPrivate *>(QObjectPrivate::get(fetcher));
+}
+
+// The tiles the fetcher treats as prefetch tiles, running or queued
+static QSet<QGeoTileSpec> prefetchTiles(QGeoTileFetcher *fetcher)
+{
+    QGeoTileFetcherPrivate *d = fetcherPrivate(fetcher);
+    QMutexLocker ml(&d->queueMutex_);
+    QSet<QGeoTileSpec> tiles;
+    for (auto it = d->prefetchInFlight_.cbegin(); it != d->prefetchInFlight_.cend(); ++it)
+        tiles.insert(it.key());
+    for (const QGeoTileFetcherPrivate::QueuedTile &tile : qAsConst(d->queue_)) {
+        if (tile.prefetch && d->queued_.value(tile.spec, 0) == tile.sequence)
+            tiles.insert(tile.spec);
+    }
+    return tiles;
+}
+
 class tst_QGeoTiledMap : public QObject
 {
     Q_OBJECT
@@ -63,21 +94,33 @@ public:
 
 private:
     void waitForFetch(int count);
+    QGeoTiledMapTest *createMap();
 
 private Q_SLOTS:
     void initTestCase();
+    void cleanup();
     void fetchTiles();
     void fetchTiles_data();
+    void fetchInPriorityOrder();
+    void cancelQueuedTiles();
+    void compactQueue();
+    void perHostRequestWindow();
+    void refreshInOnePass();
+    void preemptPrefetchRequests();
+    void reclassifyPrefetchTiles();
+    void predictiveFetch();
+    void predictiveFetch_data();
 
 private:
     QScopedPointer<QGeoTiledMapTest> m_map;
     QScopedPointer<FetchTileCounter> m_tilesCounter;
     QGeoTileFetcherTest *m_fetcher;
+    QGeoMappingManager *m_mappingManager;
 
 };
 
 tst_QGeoTiledMap::tst_QGeoTiledMap():
-    m_fetcher(0)
+    m_fetcher(0), m_mappingManager(0)
 {
 }
 
@@ -103,9 +146,9 @@ void tst_QGeoTiledMap::initTestCase()
       parameters["finishRequestImmediately"] = true;
       QGeoServiceProvider *provider = new QGeoServiceProvider("qmlgeo.test.plugin",parameters);
       provider->setAllowExperimental(true);
-      QGeoMappingManager *mappingManager = provider->mappingManager();
+      m_mappingManager = provider->mappingManager();
       QVERIFY2(provider->error() == QGeoServiceProvider::NoError, "Could not load plugin: " + provider->errorString().toLatin1());
-      m_map.reset(static_cast<QGeoTiledMapTest*>(mappingManager->createMap(this)));
+      m_map.reset(static_cast<QGeoTiledMapTest*>(m_mappingManager->createMap(this)));
       QVERIFY(m_map);
       m_map->setViewportSize(QSize(256, 256));
       m_map->setActiveMapType(m_map->m_engine->supportedMapTypes().first());
@@ -114,6 +157,16 @@ void tst_QGeoTiledMap::initTestCase()
       connect(m_fetcher, SIGNAL(tileFetched(const QGeoTileSpec&)), m_tilesCounter.data(), SLOT(tileFetched(const QGeoTileSpec&)));
 }
 
+void tst_QGeoTiledMap::cleanup()
+{
+    // Let the requests left over by a test complete
+    m_fetcher->setHoldRequests(false);
+    m_fetcher->finishHeldRequests();
+    QTRY_COMPARE(m_fetcher->inFlightTileCount() + m_fetcher->queuedTileCount(), 0);
+    m_fetcher->setMaxRequestsPerHost(6);
+    m_fetcher->clearRequestedTiles();
+}
+
 void tst_QGeoTiledMap::fetchTiles()
 {
     QFETCH(double, zoomLevel);
@@ -196,6 +249,343 @@ void tst_QGeoTiledMap::fetchTiles_data()
     QTest::newRow("zoomLevel: 4.6 ,visible count: 4 : prefetch count: 4") << 4.6 << 4 << 4 + 4  + 4 << QGeoTiledMap::PrefetchTwoNeighbourLayers << 5;
 }
 
+void tst_QGeoTiledMap::fetchInPriorityOrder()
+{
+    QGeoTileFetcherTest fetcher(m_map->m_engine);
+    fetcher.setHoldRequests(true);
+    fetcher.setMaxRequestsPerHost(10);
+
+    QHash<QGeoTileSpec, double> priorities;
+    priorities.insert(tileAt(0), 3.0);
+    priorities.insert(tileAt(1), 1.0);
+    priorities.insert(tileAt(2), 2.0);
+    priorities.insert(tileAt(4), -1.0); // prefetch tiles come last anyway
+    fetcher.updateTileRequests({ tileAt(0), tileAt(1), tileAt(2), tileAt(3), tileAt(4) },
+                               QSet<QGeoTileSpec>(), priorities, { tileAt(4) });
+
+    // Queueing a tile again updates its priority
+    priorities.insert(tileAt(0), 0.5);
+    fetcher.updateTileRequests({ tileAt(0) }, QSet<QGeoTileSpec>(), priorities, QSet<QGeoTileSpec>());
+    QCOMPARE(fetcher.queuedTileCount(), 5);
+
+    // tileAt(3) has no priority, and comes first
+    QTRY_COMPARE(fetcher.requestedTiles().size(), 5);
+    QCOMPARE(fetcher.requestedTiles(),
+             QList<QGeoTileSpec>({ tileAt(3), tileAt(0), tileAt(1), tileAt(2), tileAt(4) }));
+    QCOMPARE(fetcher.queuedTileCount(), 0);
+    QCOMPARE(fetcher.inFlightTileCount(), 5);
+}
+
+void tst_QGeoTiledMap::cancelQueuedTiles()
+{
+    QGeoTileFetcherTest fetcher(m_map->m_engine);
+    fetcher.setHoldRequests(true);
+    fetcher.setMaxRequestsPerHost(20);
+    QGeoTileFetcherPrivate *d = fetcherPrivate(&fetcher);
+
+    QSet<QGeoTileSpec> kept;
+    QSet<QGeoTileSpec> cancelled;
+    for (int x = 0; x < 10; ++x)
+        (x % 2 ? cancelled : kept).insert(tileAt(x));
+
+    // Nothing is sent before the event loop runs
+    fetcher.updateTileRequests(kept + cancelled, QSet<QGeoTileSpec>());
+    QCOMPARE(fetcher.queuedTileCount(), 10);
+
+    // Cancelled tiles stay in the heap, and are skipped when popped
+    fetcher.updateTileRequests(QSet<QGeoTileSpec>(), cancelled);
+    QCOMPARE(fetcher.queuedTileCount(), 5);
+    QCOMPARE(d->queue_.size(), 10);
+
+    QTRY_COMPARE(fetcher.requestedTiles().size(), 5);
+    QCOMPARE(tileSet(fetcher.requestedTiles()), kept);
+    QVERIFY(d->queue_.isEmpty());
+    QVERIFY(fetcher.abortedTiles().isEmpty());
+
+    // The heap is dropped once nothing is queued
+    fetcher.updateTileRequests({ tileAt(20), tileAt(21) }, QSet<QGeoTileSpec>());
+    fetcher.updateTileRequests(QSet<QGeoTileSpec>(), { tileAt(20), tileAt(21) });
+    QCOMPARE(fetcher.queuedTileCount(), 0);
+    QVERIFY(d->queue_.isEmpty());
+
+    // Running requests are aborted
+    fetcher.updateTileRequests(QSet<QGeoTileSpec>(), kept);
+    QCOMPARE(tileSet(fetcher.abortedTiles()), kept);
+    QCOMPARE(fetcher.inFlightTileCount(), 0);
+    QTest::qWait(20);
+    QCOMPARE(fetcher.requestedTiles().size(), 5);
+}
+
+void tst_QGeoTiledMap::compactQueue()
+{
+    QGeoTileFetcherTest fetcher(m_map->m_engine);
+    fetcher.setHoldRequests(true);
+    fetcher.setMaxRequestsPerHost(200);
+    QGeoTileFetcherPrivate *d = fetcherPrivate(&fetcher);
+
+    QSet<QGeoTileSpec> tiles;
+    QSet<QGeoTileSpec> cancelled;
+    QHash<QGeoTileSpec, double> priorities;
+    for (int x = 0; x < 100; ++x) {
+        tiles.insert(tileAt(x));
+        priorities.insert(tileAt(x), x);
+        if (x % 10)
+            cancelled.insert(tileAt(x));
+    }
+    fetcher.updateTileRequests(tiles, QSet<QGeoTileSpec>(), priorities, QSet<QGeoTileSpec>());
+    fetcher.updateTileRequests(QSet<QGeoTileSpec>(), cancelled);
+    QCOMPARE(fetcher.queuedTileCount(), 10);
+    QCOMPARE(d->queue_.size(), 100);
+
+    // 100 entries for 10 live tiles: queueing one more drops the stale entries
+    priorities.insert(tileAt(100), -1.0);
+    fetcher.updateTileRequests({ tileAt(100) }, QSet<QGeoTileSpec>(), priorities, QSet<QGeoTileSpec>());
+    QCOMPARE(fetcher.queuedTileCount(), 11);
+    QCOMPARE(d->queue_.size(), 11);
+
+    // The live tiles are all still there, in order
+    QList<QGeoTileSpec> expected({ tileAt(100) });
+    for (int x = 0; x < 100; x += 10)
+        expected.append(tileAt(x));
+    QTRY_COMPARE(fetcher.requestedTiles().size(), 11);
+    QCOMPARE(fetcher.requestedTiles(), expected);
+}
+
+void tst_QGeoTiledMap::perHostRequestWindow()
+{
+    QGeoTileFetcherTest fetcher(m_map->m_engine);
+    fetcher.setHoldRequests(true);
+    fetcher.setHostCount(2);
+    fetcher.setMaxRequestsPerHost(2);
+
+    QSet<QGeoTileSpec> tiles;
+    for (int x = 0; x < 8; ++x)
+        tiles.insert(tileAt(x));
+    fetcher.updateTileRequests(tiles, QSet<QGeoTileSpec>());
+
+    auto runningOnHost = [&fetcher](int host) {
+        int count = 0;
+        for (const QGeoTileSpec &tile : fetcher.heldTiles())
+            count += tile.x() % 2 == host;
+        return count;
+    };
+
+    // Two requests per host
+    QTRY_COMPARE(fetcher.heldTiles().size(), 4);
+    QCOMPARE(runningOnHost(0), 2);
+    QCOMPARE(runningOnHost(1), 2);
+    QCOMPARE(fetcher.inFlightTileCount(), 4);
+    QCOMPARE(fetcher.queuedTileCount(), 4);
+    QTest::qWait(20);
+    QCOMPARE(fetcher.requestedTiles().size(), 4);
+
+    // A finished request lets one more tile of the same host through
+    for (int requested = 5; requested <= 8; ++requested) {
+        const int host = fetcher.heldTiles().first().x() % 2;
+        QCOMPARE(fetcher.finishHeldRequests(1), 1);
+        QTRY_COMPARE(fetcher.requestedTiles().size(), requested);
+        QCOMPARE(fetcher.requestedTiles().last().x() % 2, host);
+        QCOMPARE(runningOnHost(0), 2);
+        QCOMPARE(runningOnHost(1), 2);
+    }
+    QCOMPARE(fetcher.queuedTileCount(), 0);
+}
+
+void tst_QGeoTiledMap::refreshInOnePass()
+{
+    QGeoTileFetcherTest fetcher(m_map->m_engine);
+    fetcher.setHoldRequests(true);
+    fetcher.setMaxRequestsPerHost(100);
+
+    QSet<QGeoTileSpec> tiles;
+    for (int x = 0; x < 64; ++x)
+        tiles.insert(tileAt(x));
+    fetcher.updateTileRequests(tiles, QSet<QGeoTileSpec>());
+
+    // The whole batch goes out at once
+    QTRY_VERIFY(!fetcher.requestedTiles().isEmpty());
+    QCOMPARE(fetcher.requestedTiles().size(), 64);
+    QCOMPARE(fetcher.queuedTileCount(), 0);
+
+    // Pan: half of the tiles are replaced
+    QSet<QGeoTileSpec> removed;
+    QSet<QGeoTileSpec> added;
+    for (int x = 0; x < 32; ++x) {
+        removed.insert(tileAt(x));
+        added.insert(tileAt(x + 64));
+    }
+    fetcher.updateTileRequests(added, removed);
+    QCOMPARE(tileSet(fetcher.abortedTiles()), removed);
+    QCOMPARE(fetcher.queuedTileCount(), 32);
+
+    QTRY_VERIFY(fetcher.requestedTiles().size() > 64);
+    QCOMPARE(fetcher.requestedTiles().size(), 96);
+    QCOMPARE(tileSet(fetcher.requestedTiles().mid(64)), added);
+    QCOMPARE(fetcher.queuedTileCount(), 0);
+    QCOMPARE(fetcher.inFlightTileCount(), 64);
+}
+
+void tst_QGeoTiledMap::preemptPrefetchRequests()
+{
+    QGeoTileFetcherTest fetcher(m_map->m_engine);
+    fetcher.setHoldRequests(true);
+    QCOMPARE(fetcher.maxRequestsPerHost(), 6);
+
+    QSet<QGeoTileSpec> prefetch;
+    QSet<QGeoTileSpec> visible;
+    QHash<QGeoTileSpec, double> priorities;
+    for (int x = 0; x < 5; ++x) {
+        prefetch.insert(tileAt(x));
+        priorities.insert(tileAt(x), x);
+    }
+    for (int x = 10; x < 16; ++x) {
+        visible.insert(tileAt(x));
+        priorities.insert(tileAt(x), x);
+    }
+
+    // Prefetching only takes half of the window
+    fetcher.updateTileRequests(prefetch, QSet<QGeoTileSpec>(), priorities, prefetch);
+    QTRY_COMPARE(fetcher.heldTiles().size(), 3);
+    QCOMPARE(fetcher.requestedTiles(), QList<QGeoTileSpec>({ tileAt(0), tileAt(1), tileAt(2) }));
+    QCOMPARE(fetcher.queuedTileCount(), 2);
+
+    // Visible tiles fill the free slots, then take the place of the prefetch requests
+    fetcher.updateTileRequests(visible, QSet<QGeoTileSpec>(), priorities, QSet<QGeoTileSpec>());
+    QTRY_COMPARE(fetcher.requestedTiles().size(), 9);
+    QCOMPARE(fetcher.requestedTiles().mid(3),
+             QList<QGeoTileSpec>({ tileAt(10), tileAt(11), tileAt(12), tileAt(13), tileAt(14), tileAt(15) }));
+    QCOMPARE(tileSet(fetcher.abortedTiles()), QSet<QGeoTileSpec>({ tileAt(0), tileAt(1), tileAt(2) }));
+    QCOMPARE(tileSet(fetcher.heldTiles()), visible);
+
+    // The preempted tiles are queued again, as prefetch tiles
+    QCOMPARE(fetcher.queuedTileCount(), 5);
+    QCOMPARE(prefetchTiles(&fetcher), prefetch);
+
+    // Prefetching resumes once the visible tiles leave room for it
+    QCOMPARE(fetcher.finishHeldRequests(3), 3);
+    QTRY_COMPARE(fetcher.inFlightTileCount(), 3);
+    QTest::qWait(20);
+    QCOMPARE(fetcher.requestedTiles().size(), 9);
+    QCOMPARE(fetcher.finishHeldRequests(1), 1);
+    QTRY_COMPARE(fetcher.requestedTiles().size(), 10);
+    QCOMPARE(fetcher.requestedTiles().last(), tileAt(0));
+    QCOMPARE(fetcher.inFlightTileCount(), 3);
+}
+
+void tst_QGeoTiledMap::reclassifyPrefetchTiles()
+{
+    QScopedPointer<QGeoTiledMapTest> map(createMap());
+    map->setPrefetchStyle(QGeoTiledMap::PrefetchTwoNeighbourLayers);
+    m_fetcher->setHoldRequests(true);
+    m_fetcher->setMaxRequestsPerHost(200);
+
+    QGeoCameraData camera;
+    camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.5, 0.5)));
+    camera.setZoomLevel(4);
+    map->setCameraData(camera);
+    map->prefetchData();
+
+    // The visible tiles go out first
+    QTRY_VERIFY(!m_fetcher->requestedTiles().isEmpty());
+    QTRY_COMPARE(m_fetcher->queuedTileCount(), 0);
+    const QList<QGeoTileSpec> requested = m_fetcher->requestedTiles();
+    QVERIFY(requested.size() > 4);
+    for (int i = 0; i < 4; ++i) {
+        QCOMPARE(requested.at(i).zoom(), 4);
+        QVERIFY(requested.at(i).x() == 7 || requested.at(i).x() == 8);
+        QVERIFY(requested.at(i).y() == 7 || requested.at(i).y() == 8);
+    }
+    QCOMPARE(prefetchTiles(m_fetcher), tileSet(requested.mid(4)));
+
+    QSet<QGeoTileSpec> nextLayer;
+    for (const QGeoTileSpec &tile : requested) {
+        if (tile.zoom() == 5)
+            nextLayer.insert(tile);
+    }
+    QVERIFY(!nextLayer.isEmpty());
+
+    // Zooming in shows the prefetched tiles of the next layer. Their requests keep
+    // running, as visible tiles, and everything else is cancelled.
+    camera.setZoomLevel(5);
+    map->setCameraData(camera);
+    QTRY_VERIFY(!m_fetcher->abortedTiles().isEmpty());
+    QCOMPARE(tileSet(m_fetcher->abortedTiles()), tileSet(requested) - nextLayer);
+    QCOMPARE(tileSet(m_fetcher->heldTiles()), nextLayer);
+    QVERIFY(prefetchTiles(m_fetcher).isEmpty());
+    QTest::qWait(20);
+    QCOMPARE(m_fetcher->requestedTiles(), requested);
+}
+
+void tst_QGeoTiledMap::predictiveFetch()
+{
+    QFETCH(QList<double>, steps);
+    QFETCH(bool, predicted);
+
+    QScopedPointer<QGeoTiledMap> map(createMap());
+    map->setPrefetchStyle(QGeoTiledMap::PrefetchPredictive);
+    m_fetcher->setHoldRequests(true);
+    m_fetcher->setMaxRequestsPerHost(200);
+
+    // Pan east from here, by steps in tiles of zoom level 4
+    auto cameraAt = [](double step) {
+        QGeoCameraData camera;
+        camera.setCenter(QWebMercator::mercatorToCoord(QDoubleVector2D(0.3 + step / 16, 0.5)));
+        camera.setZoomLevel(4);
+        return camera;
+    };
+    map->setCameraData(cameraAt(0));
+    // Forget the camera changes made so far
+    QTest::qWait(600);
+
+    for (double step : qAsConst(steps)) {
+        map->setCameraData(cameraAt(step));
+        QTest::qWait(40);
+    }
+    QTest::qWait(50);
+
+    QCOMPARE(m_fetcher->queuedTileCount(), 0);
+    const QSet<QGeoTileSpec> prefetched = prefetchTiles(m_fetcher);
+    const QSet<QGeoTileSpec> visible = tileSet(m_fetcher->heldTiles()) - prefetched;
+    QVERIFY(!visible.isEmpty());
+    if (!predicted) {
+        QVERIFY(prefetched.isEmpty());
+        return;
+    }
+
+    // The tiles the camera is heading to, ahead of the visible ones
+    QVERIFY(!prefetched.isEmpty());
+    int visibleRight = 0;
+    for (const QGeoTileSpec &tile : visible)
+        visibleRight = qMax(visibleRight, tile.x());
+    for (const QGeoTileSpec &tile : prefetched) {
+        QCOMPARE(tile.zoom(), 4);
+        QVERIFY(tile.x() > visibleRight);
+    }
+}
+
+void tst_QGeoTiledMap::predictiveFetch_data()
+{
+    QTest::addColumn<QList<double> >("steps");
+    QTest::addColumn<bool>("predicted");
+    QTest::newRow("steady pan") << QList<double>({ 0.25, 0.5, 0.75, 1.0 }) << true;
+    QTest::newRow("stationary") << QList<double>({ 0.0, 0.0, 0.0, 0.0 }) << false;
+    QTest::newRow("reversed pan") << QList<double>({ 0.25, 0.5, 0.75, 0.5, 0.25 }) << false;
+}
+
+// A map showing a map type no other test fetches, with nothing left in the cache
+QGeoTiledMapTest *tst_QGeoTiledMap::createMap()
+{
+    m_map->m_engine->tileCache()->clearAll();
+    QGeoTiledMapTest *map = static_cast<QGeoTiledMapTest *>(m_mappingManager->createMap(this));
+    map->setViewportSize(QSize(256, 256));
+    map->setActiveMapType(map->m_engine->supportedMapTypes().at(1));
+
+    // Let the tiles shown by the default camera be fetched
+    QTest::qWaitFor([this]() { return !m_fetcher->requestedTiles().isEmpty(); });
+    m_fetcher->clearRequestedTiles();
+    return map;
+}
+
 void tst_QGeoTiledMap::waitForFetch(int count)
 {
     int timeout = 0;
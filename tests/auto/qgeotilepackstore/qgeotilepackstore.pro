@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeotilepackstore
+
+INCLUDEPATH += ../../../src/location/maps
+
+SOURCES += tst_qgeotilepackstore.cpp
+
+QT += location-private testlib
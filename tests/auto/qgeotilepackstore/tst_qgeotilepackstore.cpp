@@ -0,0 +1,213 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QString>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QFile>
+#include <QtTest/QtTest>
+
+#include "qgeotilepackstore_p.h"
+
+QT_USE_NAMESPACE
+
+class tst_QGeoTilePackStore : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void writeRead();
+    void overwrite();
+    void remove();
+    void reopen();
+    void truncatedIndex();
+    void mismatchingPack();
+    void compact();
+    void clear();
+};
+
+void tst_QGeoTilePackStore::writeRead()
+{
+    QTemporaryDir dir;
+    QGeoTilePackStore store(dir.path());
+    QVERIFY(store.open());
+
+    QVERIFY(!store.contains(QStringLiteral("osm-1-2-3-4.png")));
+    QVERIFY(store.write(QStringLiteral("osm-1-2-3-4.png"), QByteArray("tile-a")));
+    QVERIFY(store.write(QStringLiteral("osm-1-2-3-5.png"), QByteArray("tile-bb")));
+
+    QVERIFY(store.contains(QStringLiteral("osm-1-2-3-4.png")));
+    QCOMPARE(store.size(QStringLiteral("osm-1-2-3-5.png")), 7);
+    QCOMPARE(store.read(QStringLiteral("osm-1-2-3-4.png")), QByteArray("tile-a"));
+    QCOMPARE(store.read(QStringLiteral("osm-1-2-3-5.png")), QByteArray("tile-bb"));
+    QVERIFY(store.read(QStringLiteral("osm-1-2-3-6.png")).isNull());
+    QVERIFY(store.lastModified(QStringLiteral("osm-1-2-3-4.png")).isValid());
+    QCOMPARE(store.names().size(), 2);
+}
+
+void tst_QGeoTilePackStore::overwrite()
+{
+    QTemporaryDir dir;
+    QGeoTilePackStore store(dir.path());
+    QVERIFY(store.open());
+
+    QVERIFY(store.write(QStringLiteral("a.png"), QByteArray("first")));
+    QVERIFY(store.write(QStringLiteral("a.png"), QByteArray("second")));
+    QCOMPARE(store.read(QStringLiteral("a.png")), QByteArray("second"));
+    QCOMPARE(store.garbageSize(), qint64(5));
+    QCOMPARE(store.names().size(), 1);
+}
+
+void tst_QGeoTilePackStore::remove()
+{
+    QTemporaryDir dir;
+    QGeoTilePackStore store(dir.path());
+    QVERIFY(store.open());
+
+    QVERIFY(store.write(QStringLiteral("a.png"), QByteArray("aaaa")));
+    store.remove(QStringLiteral("a.png"));
+    QVERIFY(!store.contains(QStringLiteral("a.png")));
+    QCOMPARE(store.garbageSize(), qint64(4));
+
+    store.close();
+    QVERIFY(store.open());
+    QVERIFY(!store.contains(QStringLiteral("a.png")));
+}
+
+void tst_QGeoTilePackStore::reopen()
+{
+    QTemporaryDir dir;
+    {
+        QGeoTilePackStore store(dir.path());
+        QVERIFY(store.open());
+        for (int i = 0; i < 100; ++i)
+            QVERIFY(store.write(QString::number(i) + QStringLiteral(".png"), QByteArray::number(i * i)));
+    }
+
+    QGeoTilePackStore store(dir.path());
+    QVERIFY(store.open());
+    QCOMPARE(store.names().size(), 100);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(store.read(QString::number(i) + QStringLiteral(".png")), QByteArray::number(i * i));
+
+    // Tiles appended after the pack was mapped
+    QVERIFY(store.write(QStringLiteral("new.png"), QByteArray("new")));
+    QCOMPARE(store.read(QStringLiteral("new.png")), QByteArray("new"));
+}
+
+void tst_QGeoTilePackStore::truncatedIndex()
+{
+    QTemporaryDir dir;
+    {
+        QGeoTilePackStore store(dir.path());
+        QVERIFY(store.open());
+        QVERIFY(store.write(QStringLiteral("a.png"), QByteArray("aaaa")));
+        QVERIFY(store.write(QStringLiteral("b.png"), QByteArray("bbbb")));
+    }
+
+    // Simulate a crash in the middle of the last index record
+    QFile index(QDir(dir.path()).filePath(QGeoTilePackStore::indexFileName()));
+    QVERIFY(index.open(QIODevice::ReadWrite));
+    QVERIFY(index.resize(index.size() - 3));
+    index.close();
+
+    QGeoTilePackStore store(dir.path());
+    QVERIFY(store.open());
+    QCOMPARE(store.read(QStringLiteral("a.png")), QByteArray("aaaa"));
+    QVERIFY(!store.contains(QStringLiteral("b.png")));
+
+    // The store keeps working after the truncated record has been dropped
+    QVERIFY(store.write(QStringLiteral("c.png"), QByteArray("cccc")));
+    store.close();
+    QVERIFY(store.open());
+    QCOMPARE(store.read(QStringLiteral("c.png")), QByteArray("cccc"));
+}
+
+void tst_QGeoTilePackStore::mismatchingPack()
+{
+    QTemporaryDir dir;
+    {
+        QGeoTilePackStore store(dir.path());
+        QVERIFY(store.open());
+        QVERIFY(store.write(QStringLiteral("a.png"), QByteArray("aaaa")));
+    }
+
+    QFile pack(QDir(dir.path()).filePath(QGeoTilePackStore::packFileName()));
+    QVERIFY(pack.open(QIODevice::ReadWrite));
+    QVERIFY(pack.seek(4));
+    QCOMPARE(pack.write(QByteArray(4, '\xff')), qint64(4));
+    pack.close();
+
+    QGeoTilePackStore store(dir.path());
+    QVERIFY(store.open());
+    QVERIFY(store.names().isEmpty());
+}
+
+void tst_QGeoTilePackStore::compact()
+{
+    QTemporaryDir dir;
+    QGeoTilePackStore store(dir.path());
+    QVERIFY(store.open());
+
+    for (int i = 0; i < 10; ++i)
+        QVERIFY(store.write(QString::number(i) + QStringLiteral(".png"), QByteArray(100, char('a' + i))));
+    for (int i = 0; i < 10; i += 2)
+        store.remove(QString::number(i) + QStringLiteral(".png"));
+
+    const qint64 sizeBefore = store.packSize();
+    QCOMPARE(store.garbageSize(), qint64(500));
+    QVERIFY(store.compact());
+    QCOMPARE(store.garbageSize(), qint64(0));
+    QCOMPARE(store.packSize(), sizeBefore - 500);
+
+    for (int i = 1; i < 10; i += 2)
+        QCOMPARE(store.read(QString::number(i) + QStringLiteral(".png")), QByteArray(100, char('a' + i)));
+
+    store.close();
+    QVERIFY(store.open());
+    QCOMPARE(store.names().size(), 5);
+    QCOMPARE(store.read(QStringLiteral("9.png")), QByteArray(100, 'j'));
+}
+
+void tst_QGeoTilePackStore::clear()
+{
+    QTemporaryDir dir;
+    QGeoTilePackStore store(dir.path());
+    QVERIFY(store.open());
+    QVERIFY(store.write(QStringLiteral("a.png"), QByteArray("aaaa")));
+    store.clear();
+    QVERIFY(store.names().isEmpty());
+    QCOMPARE(store.garbageSize(), qint64(0));
+
+    store.close();
+    QVERIFY(store.open());
+    QVERIFY(store.names().isEmpty());
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoTilePackStore)
+
+#include "tst_qgeotilepackstore.moc"
@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeotileslabarena
+
+INCLUDEPATH += ../../../src/location/maps
+
+SOURCES += tst_qgeotileslabarena.cpp
+
+QT += location-private testlib
@@ -0,0 +1,140 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QString>
+#include <QtGui/QImage>
+#include <QtTest/QtTest>
+
+#include "qgeotileslabarena_p.h"
+
+QT_USE_NAMESPACE
+
+class tst_QGeoTileSlabArena : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void store();
+    void reuse();
+    void sizes();
+    void trim();
+    void outlivesArena();
+};
+
+static QImage tileImage(int size, QRgb color, QImage::Format format = QImage::Format_ARGB32_Premultiplied)
+{
+    QImage image(size, size, format);
+    image.fill(color);
+    return image;
+}
+
+void tst_QGeoTileSlabArena::store()
+{
+    QGeoTileSlabArena arena(4);
+    const QImage source = tileImage(256, qRgb(10, 20, 30), QImage::Format_RGB888);
+    const QImage stored = arena.store(source);
+
+    QCOMPARE(stored.size(), source.size());
+    QCOMPARE(stored.format(), QImage::Format_ARGB32_Premultiplied);
+    QCOMPARE(stored.pixel(100, 100), source.pixel(100, 100));
+    QCOMPARE(arena.usedBytes(), qint64(256 * 256 * 4));
+    QCOMPARE(arena.reservedBytes(), qint64(256 * 256 * 4 * 4));
+
+    // Copies share the slab
+    const QImage copy = stored;
+    QCOMPARE(copy.constBits(), stored.constBits());
+
+    QVERIFY(arena.store(QImage()).isNull());
+}
+
+void tst_QGeoTileSlabArena::reuse()
+{
+    QGeoTileSlabArena arena(2);
+    const uchar *bits;
+    {
+        const QImage first = arena.store(tileImage(64, qRgb(1, 2, 3)));
+        bits = first.constBits();
+    }
+    QCOMPARE(arena.usedBytes(), qint64(0));
+
+    const QImage second = arena.store(tileImage(64, qRgb(4, 5, 6)));
+    QCOMPARE(second.constBits(), bits);
+    QCOMPARE(second.pixel(0, 0), qRgb(4, 5, 6));
+
+    // A new block once the first one is full
+    const QImage third = arena.store(tileImage(64, qRgb(7, 8, 9)));
+    QCOMPARE(arena.reservedBytes(), qint64(64 * 64 * 4 * 2));
+    const QImage fourth = arena.store(tileImage(64, qRgb(7, 8, 9)));
+    QCOMPARE(arena.reservedBytes(), qint64(64 * 64 * 4 * 4));
+    QCOMPARE(arena.usedBytes(), qint64(64 * 64 * 4 * 3));
+}
+
+void tst_QGeoTileSlabArena::sizes()
+{
+    QGeoTileSlabArena arena(1);
+    const QImage small = arena.store(tileImage(256, qRgb(1, 1, 1)));
+    const QImage large = arena.store(tileImage(512, qRgb(2, 2, 2)));
+
+    QCOMPARE(arena.reservedBytes(), qint64(256 * 256 * 4 + 512 * 512 * 4));
+    QCOMPARE(small.pixel(255, 255), qRgb(1, 1, 1));
+    QCOMPARE(large.pixel(511, 511), qRgb(2, 2, 2));
+}
+
+void tst_QGeoTileSlabArena::trim()
+{
+    QGeoTileSlabArena arena(1);
+    QImage kept = arena.store(tileImage(32, qRgb(1, 1, 1)));
+    arena.store(tileImage(32, qRgb(2, 2, 2)));
+    QCOMPARE(arena.reservedBytes(), qint64(32 * 32 * 4 * 2));
+
+    arena.trim();
+    QCOMPARE(arena.reservedBytes(), qint64(32 * 32 * 4));
+    QCOMPARE(kept.pixel(0, 0), qRgb(1, 1, 1));
+
+    kept = QImage();
+    arena.trim();
+    QCOMPARE(arena.reservedBytes(), qint64(0));
+
+    // Still usable afterwards
+    QCOMPARE(arena.store(tileImage(32, qRgb(3, 3, 3))).pixel(0, 0), qRgb(3, 3, 3));
+}
+
+void tst_QGeoTileSlabArena::outlivesArena()
+{
+    QImage stored;
+    {
+        QGeoTileSlabArena arena;
+        stored = arena.store(tileImage(16, qRgb(5, 6, 7)));
+    }
+    QCOMPARE(stored.pixel(15, 15), qRgb(5, 6, 7));
+    stored = QImage();
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoTileSlabArena)
+
+#include "tst_qgeotileslabarena.moc"
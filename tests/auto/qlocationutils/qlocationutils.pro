@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qlocationutils
+
+SOURCES += tst_qlocationutils.cpp
+
+QT += positioning-private testlib
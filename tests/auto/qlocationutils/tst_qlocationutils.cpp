@@ -0,0 +1,258 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtPositioning/QGeoPositionInfo>
+#include <QtPositioning/QGeoSatelliteInfo>
+#include <QtPositioning/private/qlocationutils_p.h>
+#include <QtCore/QDateTime>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+class tst_QLocationUtils : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void checksum_data();
+    void checksum();
+    void nmeaTime_data();
+    void nmeaTime();
+    void gga();
+    void rmc();
+    void gllVtgZda();
+    void gsa();
+    void gsv();
+    void malformed();
+};
+
+// Appends the checksum of body, the sentence without $
+static QByteArray nmea(const QByteArray &body)
+{
+    int checksum = 0;
+    for (char c : body)
+        checksum ^= c;
+    return '$' + body + '*' + QByteArray::number(checksum, 16).rightJustified(2, '0').toUpper() + "\r\n";
+}
+
+void tst_QLocationUtils::checksum_data()
+{
+    QTest::addColumn<QByteArray>("sentence");
+    QTest::addColumn<bool>("valid");
+
+    const QByteArray gga = nmea("GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,");
+    QTest::newRow("upper case") << gga << true;
+    const QByteArray lowerCase = nmea("GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.0,M,,");
+    QTest::newRow("lower case") << lowerCase.left(lowerCase.indexOf('*')) + lowerCase.mid(lowerCase.indexOf('*')).toLower() << true;
+    QByteArray wrong = gga;
+    wrong[wrong.indexOf('*') + 1] = wrong.at(wrong.indexOf('*') + 1) == '0' ? '1' : '0';
+    QTest::newRow("wrong") << wrong << false;
+    QTest::newRow("not hex") << QByteArray("$GPGGA,1*G0\r\n") << false;
+    QTest::newRow("truncated") << QByteArray("$GPGGA,1*4") << false;
+    QTest::newRow("missing") << QByteArray("$GPGGA,1") << false;
+}
+
+void tst_QLocationUtils::checksum()
+{
+    QFETCH(QByteArray, sentence);
+    QFETCH(bool, valid);
+    QCOMPARE(QLocationUtils::hasValidNmeaChecksum(sentence.constData(), sentence.size()), valid);
+}
+
+void tst_QLocationUtils::nmeaTime_data()
+{
+    QTest::addColumn<QByteArray>("field");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<QTime>("time");
+
+    QTest::newRow("seconds") << QByteArray("123519") << true << QTime(12, 35, 19);
+    QTest::newRow("tenths") << QByteArray("123519.5") << true << QTime(12, 35, 19, 500);
+    QTest::newRow("hundredths") << QByteArray("123519.25") << true << QTime(12, 35, 19, 250);
+    QTest::newRow("milliseconds") << QByteArray("123519.125") << true << QTime(12, 35, 19, 125);
+    QTest::newRow("more digits") << QByteArray("123519.1259") << true << QTime(12, 35, 19, 125);
+    QTest::newRow("empty fraction") << QByteArray("123519.") << true << QTime(12, 35, 19);
+    QTest::newRow("bad fraction") << QByteArray("123519.x") << true << QTime(12, 35, 19);
+    QTest::newRow("bad hour") << QByteArray("243519") << false << QTime();
+    QTest::newRow("short") << QByteArray("12351") << false << QTime();
+    QTest::newRow("long") << QByteArray("1235190") << false << QTime();
+    QTest::newRow("letters") << QByteArray("12a519") << false << QTime();
+}
+
+void tst_QLocationUtils::nmeaTime()
+{
+    QFETCH(QByteArray, field);
+    QFETCH(bool, valid);
+    QFETCH(QTime, time);
+
+    QTime parsed;
+    QCOMPARE(QLocationUtils::getNmeaTime(field, &parsed), valid);
+    QCOMPARE(parsed, time);
+}
+
+void tst_QLocationUtils::gga()
+{
+    const QByteArray sentence = nmea("GPGGA,123519.50,4807.038,N,01131.000,W,1,08,0.9,545.4,M,46.9,M,,");
+    QGeoPositionInfo info;
+    bool hasFix = false;
+    QVERIFY(QLocationUtils::getPosInfoFromNmea(sentence.constData(), sentence.size(), &info, 2.0, &hasFix));
+    QVERIFY(hasFix);
+    QCOMPARE(info.timestamp().time(), QTime(12, 35, 19, 500));
+    QCOMPARE(info.coordinate().latitude(), 48.0 + 7.038 / 60.0);
+    QCOMPARE(info.coordinate().longitude(), -(11.0 + 31.0 / 60.0));
+    QCOMPARE(info.coordinate().altitude(), 545.4);
+    QCOMPARE(info.attribute(QGeoPositionInfo::HorizontalAccuracy), 2 * 0.9 * 2.0);
+
+    const QByteArray noFix = nmea("GPGGA,123519,,,,,0,00,,,M,,M,,");
+    info = QGeoPositionInfo();
+    QVERIFY(QLocationUtils::getPosInfoFromNmea(noFix.constData(), noFix.size(), &info, 2.0, &hasFix));
+    QVERIFY(!hasFix);
+    QVERIFY(!info.coordinate().isValid());
+    QVERIFY(!info.hasAttribute(QGeoPositionInfo::HorizontalAccuracy));
+}
+
+void tst_QLocationUtils::rmc()
+{
+    const QByteArray sentence = nmea("GPRMC,225446.33,A,4916.45,N,12311.12,W,000.5,054.7,191194,020.3,E");
+    QGeoPositionInfo info;
+    bool hasFix = false;
+    QVERIFY(QLocationUtils::getPosInfoFromNmea(sentence.constData(), sentence.size(), &info, 2.0, &hasFix));
+    QVERIFY(hasFix);
+    QCOMPARE(info.timestamp(), QDateTime(QDate(2094, 11, 19), QTime(22, 54, 46, 330), Qt::UTC));
+    QCOMPARE(info.coordinate().latitude(), 49.0 + 16.45 / 60.0);
+    QCOMPARE(info.coordinate().longitude(), -(123.0 + 11.12 / 60.0));
+    QCOMPARE(info.attribute(QGeoPositionInfo::GroundSpeed), qreal(0.5 * 1.852 / 3.6));
+    QCOMPARE(info.attribute(QGeoPositionInfo::Direction), qreal(54.7));
+    QCOMPARE(info.attribute(QGeoPositionInfo::MagneticVariation), qreal(20.3));
+
+    const QByteArray invalid = nmea("GPRMC,225446,V,,,,,,,,,");
+    info = QGeoPositionInfo();
+    QVERIFY(QLocationUtils::getPosInfoFromNmea(invalid.constData(), invalid.size(), &info, 2.0, &hasFix));
+    QVERIFY(!hasFix);
+    QVERIFY(!info.coordinate().isValid());
+    QVERIFY(!info.timestamp().date().isValid());
+}
+
+void tst_QLocationUtils::gllVtgZda()
+{
+    QGeoPositionInfo info;
+    bool hasFix = false;
+
+    const QByteArray gll = nmea("GPGLL,4916.45,S,12311.12,E,225444,A");
+    QVERIFY(QLocationUtils::getPosInfoFromNmea(gll.constData(), gll.size(), &info, 2.0, &hasFix));
+    QVERIFY(hasFix);
+    QCOMPARE(info.coordinate().latitude(), -(49.0 + 16.45 / 60.0));
+    QCOMPARE(info.coordinate().longitude(), 123.0 + 11.12 / 60.0);
+    QCOMPARE(info.timestamp().time(), QTime(22, 54, 44));
+
+    const QByteArray vtg = nmea("GPVTG,054.7,T,034.4,M,005.5,N,010.2,K");
+    info = QGeoPositionInfo();
+    QVERIFY(QLocationUtils::getPosInfoFromNmea(vtg.constData(), vtg.size(), &info, 2.0, &hasFix));
+    QVERIFY(!hasFix);
+    QCOMPARE(info.attribute(QGeoPositionInfo::Direction), qreal(54.7));
+    QCOMPARE(info.attribute(QGeoPositionInfo::GroundSpeed), qreal(10.2 / 3.6));
+
+    const QByteArray zda = nmea("GPZDA,201530.00,04,07,2002,00,00");
+    info = QGeoPositionInfo();
+    QVERIFY(QLocationUtils::getPosInfoFromNmea(zda.constData(), zda.size(), &info, 2.0, &hasFix));
+    QCOMPARE(info.timestamp(), QDateTime(QDate(2002, 7, 4), QTime(20, 15, 30), Qt::UTC));
+}
+
+void tst_QLocationUtils::gsa()
+{
+    const QByteArray sentence = nmea("GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1");
+    QGeoPositionInfo info;
+    bool hasFix = false;
+    QVERIFY(QLocationUtils::getPosInfoFromNmea(sentence.constData(), sentence.size(), &info, 2.0, &hasFix));
+    QVERIFY(hasFix);
+    QCOMPARE(info.attribute(QGeoPositionInfo::HorizontalAccuracy), 2 * 1.3 * 2.0);
+    QCOMPARE(info.attribute(QGeoPositionInfo::VerticalAccuracy), 2 * 2.1 * 2.0);
+
+    QList<int> inUse;
+    QVERIFY(QLocationUtils::getSatInUseFromNmea(sentence.constData(), sentence.size(), inUse));
+    QCOMPARE(inUse, QList<int>({4, 5, 9, 12, 24}));
+
+    // Fewer fields than the satellites in use
+    const QByteArray shortSentence = nmea("GPGSA,A,3,04,05");
+    QVERIFY(QLocationUtils::getSatInUseFromNmea(shortSentence.constData(), shortSentence.size(), inUse));
+    QCOMPARE(inUse, QList<int>({4, 5}));
+}
+
+void tst_QLocationUtils::gsv()
+{
+    const QByteArray first = nmea("GPGSV,2,1,05,01,40,083,46,02,17,308,41,12,07,344,39,14,22,228,45");
+    const QByteArray second = nmea("GPGSV,2,2,05,15,11,041,38");
+    QList<QGeoSatelliteInfo> infos;
+    QCOMPARE(QLocationUtils::getSatInfoFromNmea(first.constData(), first.size(), infos),
+             QLocationUtils::GSVPartiallyParsed);
+    QCOMPARE(infos.size(), 4);
+    QCOMPARE(QLocationUtils::getSatInfoFromNmea(second.constData(), second.size(), infos),
+             QLocationUtils::GSVFullyParsed);
+    QCOMPARE(infos.size(), 5);
+
+    QCOMPARE(infos.at(0).satelliteIdentifier(), 1);
+    QCOMPARE(infos.at(0).attribute(QGeoSatelliteInfo::Elevation), 40.0);
+    QCOMPARE(infos.at(0).attribute(QGeoSatelliteInfo::Azimuth), 83.0);
+    QCOMPARE(infos.at(0).signalStrength(), 46);
+    // The last field of a sentence is read without the checksum
+    QCOMPARE(infos.at(3).signalStrength(), 45);
+    QCOMPARE(infos.at(4).satelliteIdentifier(), 15);
+    QCOMPARE(infos.at(4).signalStrength(), 38);
+}
+
+void tst_QLocationUtils::malformed()
+{
+    QGeoPositionInfo info;
+    bool hasFix = true;
+    const QByteArray badChecksum = QByteArray("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*00\r\n");
+    QVERIFY(!QLocationUtils::getPosInfoFromNmea(badChecksum.constData(), badChecksum.size(), &info, 2.0, &hasFix));
+    QVERIFY(!hasFix);
+
+    // Fields that are not numbers are left out
+    const QByteArray garbage = nmea("GPGGA,12x519,48O7.038,N,01131.000,E,one,08,0.9.1,5e2,M,46.9,M,,");
+    QVERIFY(QLocationUtils::getPosInfoFromNmea(garbage.constData(), garbage.size(), &info, 2.0, &hasFix));
+    QVERIFY(!hasFix);
+    QVERIFY(!info.timestamp().isValid());
+    QVERIFY(!info.coordinate().isValid());
+    QVERIFY(!info.hasAttribute(QGeoPositionInfo::HorizontalAccuracy));
+
+    // Truncated sentences
+    const QByteArray truncated = nmea("GPRMC,2254");
+    info = QGeoPositionInfo();
+    QVERIFY(QLocationUtils::getPosInfoFromNmea(truncated.constData(), truncated.size(), &info, 2.0, &hasFix));
+    QVERIFY(!info.coordinate().isValid());
+    QList<QGeoSatelliteInfo> infos;
+    const QByteArray gsv = nmea("GPGSV,1,1,03,01,40");
+    QCOMPARE(QLocationUtils::getSatInfoFromNmea(gsv.constData(), gsv.size(), infos),
+             QLocationUtils::GSVFullyParsed);
+    QCOMPARE(infos.size(), 3);
+    QCOMPARE(infos.at(1).satelliteIdentifier(), 0);
+}
+
+QTEST_APPLESS_MAIN(tst_QLocationUtils)
+
+#include "tst_qlocationutils.moc"
@@ -0,0 +1,12 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qmbtilesarchive
+
+plugin.path = ../../../src/plugins/geoservices/mbtiles/
+
+SOURCES += tst_qmbtilesarchive.cpp \
+           $$plugin.path/qmbtilesarchive.cpp
+HEADERS += $$plugin.path/qmbtilesarchive.h
+INCLUDEPATH += $$plugin.path
+
+QT += sql testlib
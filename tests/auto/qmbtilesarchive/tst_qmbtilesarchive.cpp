@@ -0,0 +1,278 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QString>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QFile>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#include <QtTest/QtTest>
+
+#include "qmbtilesarchive.h"
+
+QT_USE_NAMESPACE
+
+class tst_QMBTilesArchive : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void plainLayout();
+    void deduplicatedLayout();
+    void deduplicatedIntegerIds();
+    void largeArchive();
+    void notAnArchive();
+    void missingTilesTable();
+
+private:
+    bool execute(const QString &fileName, const QStringList &statements,
+                 const QList<QVariantList> &tileRows = QList<QVariantList>(),
+                 const QString &insert = QString());
+    static QByteArray tileData(int zoom, int x, int y, int size);
+
+    QTemporaryDir *m_dir;
+};
+
+void tst_QMBTilesArchive::init()
+{
+    m_dir = new QTemporaryDir;
+}
+
+void tst_QMBTilesArchive::cleanup()
+{
+    delete m_dir;
+    m_dir = nullptr;
+}
+
+// Runs the statements, then the insert statement once for each of the tile rows
+bool tst_QMBTilesArchive::execute(const QString &fileName, const QStringList &statements,
+                                  const QList<QVariantList> &tileRows, const QString &insert)
+{
+    const QString connectionName = QStringLiteral("tst_qmbtilesarchive");
+    bool ok = true;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), connectionName);
+        db.setDatabaseName(fileName);
+        ok = db.open();
+
+        QSqlQuery query(db);
+        for (const QString &statement : statements)
+            ok = ok && query.exec(statement);
+
+        ok = ok && db.transaction();
+        if (ok && !tileRows.isEmpty()) {
+            ok = query.prepare(insert);
+            for (const QVariantList &row : tileRows) {
+                for (int i = 0; i < row.size(); ++i)
+                    query.bindValue(i, row.at(i));
+                ok = ok && query.exec();
+            }
+        }
+        ok = ok && db.commit();
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    return ok;
+}
+
+QByteArray tst_QMBTilesArchive::tileData(int zoom, int x, int y, int size)
+{
+    QByteArray data = QByteArray::number(zoom) + '/' + QByteArray::number(x) + '/' + QByteArray::number(y) + ':';
+    while (data.size() < size)
+        data.append(char(data.size() * 31 + x));
+    return data;
+}
+
+void tst_QMBTilesArchive::plainLayout()
+{
+    const QString fileName = m_dir->filePath(QStringLiteral("plain.mbtiles"));
+    QList<QVariantList> rows;
+    // tile_row counts from the south: row 0 at zoom 1 is y = 1
+    rows << QVariantList({ 0, 0, 0, tileData(0, 0, 0, 100) })
+         << QVariantList({ 1, 0, 0, tileData(1, 0, 1, 5000) })   // spills into overflow pages
+         << QVariantList({ 1, 1, 1, tileData(1, 1, 0, 70000) });
+    QVERIFY(execute(fileName,
+                    { QStringLiteral("CREATE TABLE metadata (name text, value text)"),
+                      QStringLiteral("CREATE TABLE tiles (zoom_level integer, tile_column integer, "
+                                     "tile_row integer, tile_data blob)"),
+                      QStringLiteral("CREATE UNIQUE INDEX tile_index ON tiles (zoom_level, tile_column, tile_row)"),
+                      QStringLiteral("INSERT INTO metadata VALUES ('name', 'Plain')"),
+                      QStringLiteral("INSERT INTO metadata VALUES ('format', 'jpg')") },
+                    rows,
+                    QStringLiteral("INSERT INTO tiles VALUES (?, ?, ?, ?)")));
+
+    QMBTilesArchive archive(fileName);
+    QVERIFY2(archive.open(), qPrintable(archive.errorString()));
+
+    QCOMPARE(archive.tileCount(), 3);
+    QCOMPARE(archive.minimumZoomLevel(), 0);
+    QCOMPARE(archive.maximumZoomLevel(), 1);
+    QCOMPARE(archive.metadata(QStringLiteral("name")), QStringLiteral("Plain"));
+    QCOMPARE(archive.format(), QStringLiteral("jpg"));
+
+    QCOMPARE(archive.tile(0, 0, 0), tileData(0, 0, 0, 100));
+    QCOMPARE(archive.tile(1, 0, 1), tileData(1, 0, 1, 5000));
+    QCOMPARE(archive.tile(1, 1, 0), tileData(1, 1, 0, 70000));
+
+    QVERIFY(archive.contains(1, 0, 1));
+    QVERIFY(!archive.contains(1, 0, 0));
+    QVERIFY(archive.tile(1, 0, 0).isEmpty());
+    QVERIFY(archive.tile(5, 0, 0).isEmpty());
+}
+
+void tst_QMBTilesArchive::deduplicatedLayout()
+{
+    const QString fileName = m_dir->filePath(QStringLiteral("deduplicated.mbtiles"));
+    QVERIFY(execute(fileName,
+                    { QStringLiteral("CREATE TABLE map (zoom_level INTEGER, tile_column INTEGER, "
+                                     "tile_row INTEGER, tile_id TEXT, grid_id TEXT)"),
+                      QStringLiteral("CREATE TABLE images (tile_data blob, tile_id text)"),
+                      QStringLiteral("CREATE VIEW tiles AS SELECT map.zoom_level AS zoom_level, "
+                                     "map.tile_column AS tile_column, map.tile_row AS tile_row, "
+                                     "images.tile_data AS tile_data FROM map "
+                                     "JOIN images ON images.tile_id = map.tile_id") }));
+
+    QList<QVariantList> images;
+    images << QVariantList({ tileData(0, 0, 0, 9000), QStringLiteral("sea") })
+           << QVariantList({ tileData(1, 1, 1, 300), QStringLiteral("land") });
+    QVERIFY(execute(fileName, QStringList(), images, QStringLiteral("INSERT INTO images VALUES (?, ?)")));
+
+    QList<QVariantList> map;
+    map << QVariantList({ 1, 0, 0, QStringLiteral("sea"), QVariant() })
+        << QVariantList({ 1, 0, 1, QStringLiteral("sea"), QVariant() })
+        << QVariantList({ 1, 1, 1, QStringLiteral("land"), QVariant() })
+        << QVariantList({ 1, 1, 0, QStringLiteral("missing"), QVariant() });
+    QVERIFY(execute(fileName, QStringList(), map, QStringLiteral("INSERT INTO map VALUES (?, ?, ?, ?, ?)")));
+
+    QMBTilesArchive archive(fileName);
+    QVERIFY2(archive.open(), qPrintable(archive.errorString()));
+
+    QCOMPARE(archive.tileCount(), 3);
+    QCOMPARE(archive.format(), QStringLiteral("png"));
+    QCOMPARE(archive.tile(1, 0, 0), tileData(0, 0, 0, 9000));
+    QCOMPARE(archive.tile(1, 0, 1), tileData(0, 0, 0, 9000));
+    QCOMPARE(archive.tile(1, 1, 0), tileData(1, 1, 1, 300));
+    QVERIFY(!archive.contains(1, 1, 1));
+}
+
+void tst_QMBTilesArchive::deduplicatedIntegerIds()
+{
+    // images.tile_id is an alias of the rowid, which leaves NULL in the records
+    const QString fileName = m_dir->filePath(QStringLiteral("integerids.mbtiles"));
+    QVERIFY(execute(fileName,
+                    { QStringLiteral("CREATE TABLE map (zoom_level INTEGER, tile_column INTEGER, "
+                                     "tile_row INTEGER, tile_id INTEGER)"),
+                      QStringLiteral("CREATE TABLE images (tile_id INTEGER PRIMARY KEY, tile_data blob)"),
+                      QStringLiteral("CREATE VIEW tiles AS SELECT map.zoom_level AS zoom_level, "
+                                     "map.tile_column AS tile_column, map.tile_row AS tile_row, "
+                                     "images.tile_data AS tile_data FROM map "
+                                     "JOIN images ON images.tile_id = map.tile_id") }));
+
+    QList<QVariantList> images;
+    images << QVariantList({ 7, tileData(0, 0, 0, 200) })
+           << QVariantList({ 42, tileData(1, 1, 1, 6000) });
+    QVERIFY(execute(fileName, QStringList(), images, QStringLiteral("INSERT INTO images VALUES (?, ?)")));
+
+    QList<QVariantList> map;
+    map << QVariantList({ 1, 0, 0, 7 })
+        << QVariantList({ 1, 0, 1, 42 })
+        << QVariantList({ 1, 1, 1, 7 })
+        << QVariantList({ 1, 1, 0, 3 });
+    QVERIFY(execute(fileName, QStringList(), map, QStringLiteral("INSERT INTO map VALUES (?, ?, ?, ?)")));
+
+    QMBTilesArchive archive(fileName);
+    QVERIFY2(archive.open(), qPrintable(archive.errorString()));
+
+    QCOMPARE(archive.tileCount(), 3);
+    QCOMPARE(archive.tile(1, 0, 1), tileData(0, 0, 0, 200));
+    QCOMPARE(archive.tile(1, 0, 0), tileData(1, 1, 1, 6000));
+    QCOMPARE(archive.tile(1, 1, 0), tileData(0, 0, 0, 200));
+    QVERIFY(!archive.contains(1, 1, 1));
+}
+
+void tst_QMBTilesArchive::largeArchive()
+{
+    // Enough rows for the table b-tree to grow interior pages
+    const QString fileName = m_dir->filePath(QStringLiteral("large.mbtiles"));
+    const int zoom = 5;
+    QList<QVariantList> rows;
+    for (int x = 0; x < 32; ++x) {
+        for (int row = 0; row < 32; ++row)
+            rows << QVariantList({ zoom, x, row, tileData(zoom, x, row, 200 + (x * 32 + row) % 3000) });
+    }
+    QVERIFY(execute(fileName,
+                    { QStringLiteral("CREATE TABLE tiles (zoom_level integer, tile_column integer, "
+                                     "tile_row integer, tile_data blob)") },
+                    rows,
+                    QStringLiteral("INSERT INTO tiles VALUES (?, ?, ?, ?)")));
+
+    QMBTilesArchive archive(fileName);
+    QVERIFY2(archive.open(), qPrintable(archive.errorString()));
+    QCOMPARE(archive.tileCount(), 32 * 32);
+
+    for (int x = 0; x < 32; ++x) {
+        for (int row = 0; row < 32; ++row) {
+            const int y = 31 - row;
+            QCOMPARE(archive.tile(zoom, x, y), tileData(zoom, x, row, 200 + (x * 32 + row) % 3000));
+        }
+    }
+}
+
+void tst_QMBTilesArchive::notAnArchive()
+{
+    const QString fileName = m_dir->filePath(QStringLiteral("garbage.mbtiles"));
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QByteArray(4096, 'x'));
+    file.close();
+
+    QMBTilesArchive archive(fileName);
+    QVERIFY(!archive.open());
+    QVERIFY(!archive.isOpen());
+    QVERIFY(!archive.errorString().isEmpty());
+
+    QMBTilesArchive missing(m_dir->filePath(QStringLiteral("missing.mbtiles")));
+    QVERIFY(!missing.open());
+}
+
+void tst_QMBTilesArchive::missingTilesTable()
+{
+    const QString fileName = m_dir->filePath(QStringLiteral("empty.mbtiles"));
+    QVERIFY(execute(fileName, { QStringLiteral("CREATE TABLE metadata (name text, value text)") }));
+
+    QMBTilesArchive archive(fileName);
+    QVERIFY(!archive.open());
+    QVERIFY(!archive.errorString().isEmpty());
+}
+
+QTEST_GUILESS_MAIN(tst_QMBTilesArchive)
+
+#include "tst_qmbtilesarchive.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qnmeabatchreader
+
+SOURCES += tst_qnmeabatchreader.cpp
+
+QT += positioning-private testlib
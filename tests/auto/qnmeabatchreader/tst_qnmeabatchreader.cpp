@@ -0,0 +1,168 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtPositioning/private/qnmeapositioninfosource_p.h>
+#include <QtCore/QTemporaryFile>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+class tst_QNmeaBatchReader : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void mergesEpochs();
+    void chunking();
+    void file();
+    void garbage();
+};
+
+static QByteArray nmea(const QByteArray &body)
+{
+    int checksum = 0;
+    for (char c : body)
+        checksum ^= c;
+    return '$' + body + '*' + QByteArray::number(checksum, 16).rightJustified(2, '0').toUpper() + "\r\n";
+}
+
+static QString nmeaTime(const QTime &time)
+{
+    return time.toString(QStringLiteral("hhmmss.zzz"));
+}
+
+// One RMC, GGA and GSA sentence per second, with the fix lost in the epochs divisible by 10
+static QByteArray createLog(int epochs)
+{
+    QByteArray log;
+    const QTime start(10, 0);
+    for (int i = 0; i < epochs; ++i) {
+        const QString time = nmeaTime(start.addSecs(i));
+        const QString lat = QString::number(4800 + (i % 60) * 0.5, 'f', 4);
+        const bool fix = i % 10;
+        log += nmea(QStringLiteral("GPRMC,%1,%2,%3,N,01131.000,E,1.5,90.0,010320,,")
+                    .arg(time, fix ? QStringLiteral("A") : QStringLiteral("V"), lat).toLatin1());
+        log += nmea(QStringLiteral("GPGGA,%1,%2,N,01131.000,E,%3,08,0.9,%4,M,46.9,M,,")
+                    .arg(time, lat).arg(fix ? 1 : 0).arg(500 + i).toLatin1());
+        if (i % 5 == 1)
+            log += nmea(QByteArrayLiteral("GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1"));
+    }
+    return log;
+}
+
+static QList<QGeoPositionInfo> replay(const QByteArray &log, int chunkSize, int *signalCount = nullptr)
+{
+    QNmeaBatchReader reader;
+    reader.setUserEquivalentRangeError(2.0);
+    reader.setChunkSize(chunkSize);
+    QList<QGeoPositionInfo> updates;
+    QObject::connect(&reader, &QNmeaBatchReader::positionsUpdated,
+                     [&updates](const QList<QGeoPositionInfo> &batch) { updates += batch; });
+    QSignalSpy batchSpy(&reader, &QNmeaBatchReader::positionsUpdated);
+    QSignalSpy finishedSpy(&reader, &QNmeaBatchReader::finished);
+    reader.replay(log);
+    if (signalCount)
+        *signalCount = batchSpy.count();
+    if (finishedSpy.count() != 1)
+        return QList<QGeoPositionInfo>();
+    return updates;
+}
+
+void tst_QNmeaBatchReader::mergesEpochs()
+{
+    const int epochs = 30;
+    const QList<QGeoPositionInfo> updates = replay(createLog(epochs), 1 << 20);
+
+    // The epochs without a fix are dropped
+    QCOMPARE(updates.size(), epochs - 3);
+    for (int i = 0, epoch = 0; i < updates.size(); ++i, ++epoch) {
+        if (epoch % 10 == 0)
+            ++epoch;
+        const QGeoPositionInfo &update = updates.at(i);
+        QCOMPARE(update.timestamp(), QDateTime(QDate(2020, 3, 1), QTime(10, 0).addSecs(epoch), Qt::UTC));
+        // GGA merged into RMC
+        QCOMPARE(update.coordinate().altitude(), 500.0 + epoch);
+        QCOMPARE(update.attribute(QGeoPositionInfo::GroundSpeed), qreal(1.5 * 1.852 / 3.6));
+        // The accuracies of the last GSA are carried over
+        QCOMPARE(update.attribute(QGeoPositionInfo::VerticalAccuracy), 2 * 2.1 * 2.0);
+    }
+}
+
+void tst_QNmeaBatchReader::chunking()
+{
+    const QByteArray log = createLog(500);
+    int serialSignals = 0;
+    int parallelSignals = 0;
+    const QList<QGeoPositionInfo> serial = replay(log, log.size() * 2, &serialSignals);
+    const QList<QGeoPositionInfo> parallel = replay(log, 1024, &parallelSignals);
+
+    QCOMPARE(serial.size(), 450);
+    QCOMPARE(parallel, serial);
+    // One batch for the block, one for the last epoch
+    QCOMPARE(serialSignals, 2);
+    QVERIFY(parallelSignals > serialSignals);
+    QVERIFY(parallelSignals < parallel.size());
+}
+
+void tst_QNmeaBatchReader::file()
+{
+    const QByteArray log = createLog(200);
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(log);
+    file.close();
+
+    QNmeaBatchReader reader;
+    reader.setUserEquivalentRangeError(2.0);
+    reader.setChunkSize(2048);
+    QList<QGeoPositionInfo> updates;
+    connect(&reader, &QNmeaBatchReader::positionsUpdated,
+            [&updates](const QList<QGeoPositionInfo> &batch) { updates += batch; });
+    QVERIFY(reader.replay(file.fileName()));
+    QCOMPARE(updates, replay(log, 2048));
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("QNmeaBatchReader: cannot open .*"));
+    QVERIFY(!reader.replay(file.fileName() + QStringLiteral(".missing")));
+}
+
+void tst_QNmeaBatchReader::garbage()
+{
+    QByteArray log = createLog(3);
+    log.insert(log.indexOf("$GPGGA"), QByteArray("$GPGGA,broken*00\r\nnot nmea\r\n"));
+    log.chop(1); // no trailing newline
+    const QList<QGeoPositionInfo> updates = replay(log, 1024);
+    QCOMPARE(updates.size(), 2);
+    QCOMPARE(updates.last().coordinate().altitude(), 502.0);
+
+    QVERIFY(replay(QByteArray(), 1024).isEmpty());
+}
+
+QTEST_GUILESS_MAIN(tst_QNmeaBatchReader)
+
+#include "tst_qnmeabatchreader.moc"
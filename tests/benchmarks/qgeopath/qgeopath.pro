@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qgeopath
+
+SOURCES += tst_bench_qgeopath.cpp
+
+QT += positioning-private testlib
@@ -0,0 +1,159 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtPositioning/QGeoPath>
+#include <QtPositioning/QGeoRectangle>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtCore/QRandomGenerator>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+/*
+    The segment by segment scan that QGeoPathPrivate::lineContains() did before
+    the segments got indexed, kept as the baseline to compare against.
+*/
+static bool legacyLineContains(const QGeoPath &path, const QGeoCoordinate &coordinate)
+{
+    const QList<QGeoCoordinate> &m_path = path.path();
+    const double m_leftBoundWrapped = QWebMercator::coordToMercator(path.boundingGeoRectangle().topLeft()).x();
+    double lineRadius = qMax(path.width() * 0.5, 0.2);
+
+    if (!m_path.size())
+        return false;
+    else if (m_path.size() == 1)
+        return (m_path[0].distanceTo(coordinate) <= lineRadius);
+
+    QDoubleVector2D p = QWebMercator::coordToMercator(coordinate);
+    if (p.x() < m_leftBoundWrapped)
+        p.setX(p.x() + m_leftBoundWrapped);
+
+    QDoubleVector2D a = QWebMercator::coordToMercator(m_path[0]);
+    QDoubleVector2D b;
+    if (a.x() < m_leftBoundWrapped)
+        a.setX(a.x() + m_leftBoundWrapped);
+    for (int i = 1; i < m_path.size(); i++) {
+        b = QWebMercator::coordToMercator(m_path[i]);
+        if (b.x() < m_leftBoundWrapped)
+            b.setX(b.x() + m_leftBoundWrapped);
+        if (b == a)
+            continue;
+
+        double u = ((p.x() - a.x()) * (b.x() - a.x()) + (p.y() - a.y()) * (b.y() - a.y()) ) / (b - a).lengthSquared();
+        QDoubleVector2D intersection(a.x() + u * (b.x() - a.x()) , a.y() + u * (b.y() - a.y()) );
+        QDoubleVector2D candidate = ( (p-a).length() < (p-b).length() ) ? a : b;
+        if (u > 0 && u < 1 && (p-intersection).length() < (p-candidate).length())
+            candidate = intersection;
+        if (candidate.x() > 1.0)
+            candidate.setX(candidate.x() - m_leftBoundWrapped);
+
+        if (coordinate.distanceTo(QWebMercator::mercatorToCoord(candidate)) <= lineRadius)
+            return true;
+        a = b;
+    }
+    return (m_path[0].distanceTo(coordinate) <= lineRadius);
+}
+
+class tst_bench_QGeoPath : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void contains_data();
+    void contains();
+    void nearestSegment();
+
+private:
+    QGeoPath m_route;
+    QList<QGeoCoordinate> m_probes;
+};
+
+// A 10k coordinates route meandering eastwards, probed around random points of it
+void tst_bench_QGeoPath::initTestCase()
+{
+    QRandomGenerator random(11);
+    QList<QGeoCoordinate> route;
+    double latitude = 48.0;
+    double longitude = 2.0;
+    for (int i = 0; i < 10000; ++i) {
+        route << QGeoCoordinate(latitude, longitude);
+        latitude += 0.002 * (random.generateDouble() - 0.3);
+        longitude += 0.002 * (random.generateDouble() - 0.3);
+    }
+    m_route = QGeoPath(route, 20.0);
+
+    for (int i = 0; i < 100; ++i) {
+        const QGeoCoordinate &c = route.at(random.bounded(route.size()));
+        m_probes << QGeoCoordinate(c.latitude() + 0.0005 * (random.generateDouble() - 0.5),
+                                   c.longitude() + 0.0005 * (random.generateDouble() - 0.5));
+    }
+    m_route.contains(m_probes.first()); // Builds the segment index
+}
+
+void tst_bench_QGeoPath::contains_data()
+{
+    QTest::addColumn<bool>("legacy");
+
+    QTest::newRow("indexed") << false;
+    QTest::newRow("legacy") << true;
+}
+
+void tst_bench_QGeoPath::contains()
+{
+    QFETCH(bool, legacy);
+
+    int inside = 0;
+    if (legacy) {
+        QBENCHMARK {
+            for (const QGeoCoordinate &c : qAsConst(m_probes))
+                inside += legacyLineContains(m_route, c);
+        }
+    } else {
+        QBENCHMARK {
+            for (const QGeoCoordinate &c : qAsConst(m_probes))
+                inside += m_route.contains(c);
+        }
+    }
+    QVERIFY(inside > 0);
+}
+
+void tst_bench_QGeoPath::nearestSegment()
+{
+    int segments = 0;
+    QBENCHMARK {
+        for (const QGeoCoordinate &c : qAsConst(m_probes))
+            segments += m_route.nearestSegment(c);
+    }
+    QVERIFY(segments > 0);
+}
+
+QTEST_APPLESS_MAIN(tst_bench_QGeoPath)
+
+#include "tst_bench_qgeopath.moc"
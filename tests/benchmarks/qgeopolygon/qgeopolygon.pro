@@ -0,0 +1,13 @@
+TEMPLATE = app
+CONFIG += benchmark
+TARGET = tst_bench_qgeopolygon
+
+# The legacy baseline calls clip2tri directly
+INCLUDEPATH += ../../../src/3rdparty/clipper
+INCLUDEPATH += ../../../src/3rdparty/clip2tri
+LIBS += -L$$MODULE_BASE_OUTDIR/lib -lclip2tri$$qtPlatformTargetSuffix() \
+        -lpoly2tri$$qtPlatformTargetSuffix() -lclipper$$qtPlatformTargetSuffix()
+
+SOURCES += tst_bench_qgeopolygon.cpp
+
+QT += positioning-private testlib
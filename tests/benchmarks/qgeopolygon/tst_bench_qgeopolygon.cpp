@@ -0,0 +1,176 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtPositioning/QGeoPolygon>
+#include <QtPositioning/private/qgeopolygon_p.h>
+#include <QtPositioning/private/qclipperutils_p.h>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtCore/QRandomGenerator>
+#include <QtCore/qmath.h>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+static QList<QGeoCoordinate> starRing(QRandomGenerator &random, const QGeoCoordinate &center,
+                                      double radius, int count)
+{
+    QList<QGeoCoordinate> ring;
+    ring.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const double angle = 2 * M_PI * i / count;
+        const double distance = radius * (0.5 + 0.5 * random.generateDouble());
+        ring << QGeoCoordinate(center.latitude() + distance * qSin(angle),
+                               center.longitude() + distance * qCos(angle));
+    }
+    return ring;
+}
+
+/*
+    QGeoPolygon::contains() as it was before the hole paths were cached: the outer path is
+    cached, and a QGeoPolygon is built for every hole on every query. Kept as the baseline
+    to compare against.
+*/
+class LegacyPolygon
+{
+public:
+    explicit LegacyPolygon(const QGeoPolygon &polygon)
+    {
+        m_leftBoundWrapped = QWebMercator::coordToMercator(polygon.boundingGeoRectangle().topLeft()).x();
+
+        QList<QDoubleVector2D> preservedPath;
+        for (const QGeoCoordinate &c : polygon.path()) {
+            QDoubleVector2D crd = QWebMercator::coordToMercator(c);
+            if (crd.x() < m_leftBoundWrapped)
+                crd.setX(crd.x() + 1.0);
+            preservedPath << crd;
+        }
+        m_clipperPath = QClipperUtils::qListToPath(preservedPath);
+
+        for (int i = 0; i < polygon.holesCount(); ++i)
+            m_holesList << polygon.holePath(i);
+    }
+
+    bool contains(const QGeoCoordinate &coordinate) const
+    {
+        QDoubleVector2D coord = QWebMercator::coordToMercator(coordinate);
+
+        if (coord.x() < m_leftBoundWrapped)
+            coord.setX(coord.x() + 1.0);
+
+        QtClipperLib::IntPoint intCoord = QClipperUtils::toIntPoint(coord);
+        if (!c2t::clip2tri::pointInPolygon(intCoord, m_clipperPath))
+            return false;
+
+        // else iterates the holes List checking whether the point is contained inside the holes
+        for (const QList<QGeoCoordinate> &holePath : qAsConst(m_holesList)) {
+            QGeoPolygon holePolygon;
+            holePolygon.setPath(holePath);
+            if (holePolygon.contains(coordinate))
+                return false;
+        }
+        return true;
+    }
+
+private:
+    double m_leftBoundWrapped;
+    QtClipperLib::Path m_clipperPath;
+    QList<QList<QGeoCoordinate>> m_holesList;
+};
+
+class tst_bench_QGeoPolygon : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void contains_data();
+    void contains();
+};
+
+void tst_bench_QGeoPolygon::contains_data()
+{
+    QTest::addColumn<int>("vertices");
+    QTest::addColumn<int>("holes");
+    QTest::addColumn<QString>("implementation");
+
+    const QString legacy = QStringLiteral("legacy");
+    const QString unprepared = QStringLiteral("unprepared");
+    const QString prepared = QStringLiteral("prepared");
+    QTest::newRow("100 vertices legacy") << 100 << 0 << legacy;
+    QTest::newRow("100 vertices") << 100 << 0 << unprepared;
+    QTest::newRow("100 vertices prepared") << 100 << 0 << prepared;
+    QTest::newRow("10000 vertices legacy") << 10000 << 0 << legacy;
+    QTest::newRow("10000 vertices") << 10000 << 0 << unprepared;
+    QTest::newRow("10000 vertices prepared") << 10000 << 0 << prepared;
+    QTest::newRow("10000 vertices, 20 holes legacy") << 10000 << 20 << legacy;
+    QTest::newRow("10000 vertices, 20 holes") << 10000 << 20 << unprepared;
+    QTest::newRow("10000 vertices, 20 holes prepared") << 10000 << 20 << prepared;
+}
+
+void tst_bench_QGeoPolygon::contains()
+{
+    QFETCH(int, vertices);
+    QFETCH(int, holes);
+    QFETCH(QString, implementation);
+
+    QRandomGenerator random(7);
+    const QGeoCoordinate center(45, 10);
+    QGeoPolygon polygon(starRing(random, center, 10, vertices));
+    for (int i = 0; i < holes; ++i) {
+        const double angle = 2 * M_PI * i / holes;
+        const QGeoCoordinate holeCenter(center.latitude() + 3 * qSin(angle),
+                                        center.longitude() + 3 * qCos(angle));
+        polygon.addHole(starRing(random, holeCenter, 0.8, vertices / 20));
+    }
+    if (implementation == QLatin1String("prepared"))
+        polygon = QGeoPolygonPrepared(polygon);
+
+    QList<QGeoCoordinate> probes;
+    for (int i = 0; i < 1000; ++i) {
+        probes << QGeoCoordinate(center.latitude() + 20 * random.generateDouble() - 10,
+                                 center.longitude() + 20 * random.generateDouble() - 10);
+    }
+    int inside = 0;
+    if (implementation == QLatin1String("legacy")) {
+        const LegacyPolygon legacy(polygon);
+        QBENCHMARK {
+            for (const QGeoCoordinate &c : qAsConst(probes))
+                inside += legacy.contains(c);
+        }
+    } else {
+        polygon.contains(center); // Builds the cached clipper paths
+        QBENCHMARK {
+            for (const QGeoCoordinate &c : qAsConst(probes))
+                inside += polygon.contains(c);
+        }
+    }
+    QVERIFY(inside > 0);
+}
+
+QTEST_APPLESS_MAIN(tst_bench_QGeoPolygon)
+
+#include "tst_bench_qgeopolygon.moc"
@@ -0,0 +1,302 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtPositioning/QGeoPositionInfo>
+#include <QtPositioning/private/qlocationutils_p.h>
+#include <QtCore/QDateTime>
+#include <QtTest/QtTest>
+
+#include <cstring>
+#include <math.h>
+
+QT_USE_NAMESPACE
+
+/*
+    The split() based GGA and RMC readers that getPosInfoFromNmea() used before it
+    tokenized sentences in place, with the QTime::fromString(), QByteArray::toDouble() and
+    QByteArray checksum helpers they called, kept as the baseline to compare against.
+*/
+static double legacyNmeaDegreesToDecimal(double nmeaDegrees)
+{
+    double deg;
+    double min = 100.0 * modf(nmeaDegrees / 100.0, &deg);
+    return deg + (min / 60.0);
+}
+
+static bool legacyHasValidNmeaChecksum(const char *data, int size)
+{
+    int asteriskIndex = -1;
+    for (int i = 0; i < size; ++i) {
+        if (data[i] == '*') {
+            asteriskIndex = i;
+            break;
+        }
+    }
+
+    const int CSUM_LEN = 2;
+    if (asteriskIndex < 0 || asteriskIndex + CSUM_LEN >= size)
+        return false;
+
+    // XOR byte value of all characters between '$' and '*'
+    int result = 0;
+    for (int i = 1; i < asteriskIndex; ++i)
+        result ^= data[i];
+
+    QByteArray checkSumBytes(&data[asteriskIndex + 1], 2);
+    bool ok = false;
+    int checksum = checkSumBytes.toInt(&ok,16);
+    return ok && checksum == result;
+}
+
+static bool legacyGetNmeaTime(const QByteArray &bytes, QTime *time)
+{
+    int dotIndex = bytes.indexOf('.');
+    QTime tempTime;
+
+    if (dotIndex < 0) {
+        tempTime = QTime::fromString(QString::fromLatin1(bytes.constData()),
+                                     QStringLiteral("hhmmss"));
+    } else {
+        tempTime = QTime::fromString(QString::fromLatin1(bytes.mid(0, dotIndex)),
+                                     QStringLiteral("hhmmss"));
+        bool hasMsecs = false;
+        int midLen = qMin(3, bytes.size() - dotIndex - 1);
+        int msecs = bytes.mid(dotIndex + 1, midLen).toUInt(&hasMsecs);
+        if (hasMsecs)
+            tempTime = tempTime.addMSecs(msecs*(midLen == 3 ? 1 : midLen == 2 ? 10 : 100));
+    }
+
+    if (tempTime.isValid()) {
+        *time = tempTime;
+        return true;
+    }
+    return false;
+}
+
+static bool legacyGetNmeaLatLong(const QByteArray &latString, char latDirection, const QByteArray &lngString,
+                                 char lngDirection, double *lat, double *lng)
+{
+    if ((latDirection != 'N' && latDirection != 'S')
+            || (lngDirection != 'E' && lngDirection != 'W')) {
+        return false;
+    }
+
+    bool hasLat = false;
+    bool hasLong = false;
+    double tempLat = latString.toDouble(&hasLat);
+    double tempLng = lngString.toDouble(&hasLong);
+    if (hasLat && hasLong) {
+        tempLat = legacyNmeaDegreesToDecimal(tempLat);
+        if (latDirection == 'S')
+            tempLat *= -1;
+        tempLng = legacyNmeaDegreesToDecimal(tempLng);
+        if (lngDirection == 'W')
+            tempLng *= -1;
+
+        if (QLocationUtils::isValidLat(tempLat) && QLocationUtils::isValidLong(tempLng)) {
+            *lat = tempLat;
+            *lng = tempLng;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void legacyReadGga(const char *data, int size, QGeoPositionInfo *info, double uere, bool *hasFix)
+{
+    QByteArray sentence(data, size);
+    QList<QByteArray> parts = sentence.split(',');
+    QGeoCoordinate coord;
+
+    if (hasFix && parts.count() > 6 && parts[6].count() > 0)
+        *hasFix = parts[6].toInt() > 0;
+
+    if (parts.count() > 1 && parts[1].count() > 0) {
+        QTime time;
+        if (legacyGetNmeaTime(parts[1], &time))
+            info->setTimestamp(QDateTime(QDate(), time, Qt::UTC));
+    }
+
+    if (parts.count() > 5 && parts[3].count() == 1 && parts[5].count() == 1) {
+        double lat;
+        double lng;
+        if (legacyGetNmeaLatLong(parts[2], parts[3][0], parts[4], parts[5][0], &lat, &lng)) {
+            coord.setLatitude(lat);
+            coord.setLongitude(lng);
+        }
+    }
+
+    if (parts.count() > 8 && !parts[8].isEmpty()) {
+        bool hasHdop = false;
+        double hdop = parts[8].toDouble(&hasHdop);
+        if (hasHdop)
+            info->setAttribute(QGeoPositionInfo::HorizontalAccuracy, 2 * hdop * uere);
+    }
+
+    if (parts.count() > 9 && parts[9].count() > 0) {
+        bool hasAlt = false;
+        double alt = parts[9].toDouble(&hasAlt);
+        if (hasAlt)
+            coord.setAltitude(alt);
+    }
+
+    if (coord.type() != QGeoCoordinate::InvalidCoordinate)
+        info->setCoordinate(coord);
+}
+
+static void legacyReadRmc(const char *data, int size, QGeoPositionInfo *info, bool *hasFix)
+{
+    QByteArray sentence(data, size);
+    QList<QByteArray> parts = sentence.split(',');
+    QGeoCoordinate coord;
+    QDate date;
+    QTime time;
+
+    if (hasFix && parts.count() > 2 && parts[2].count() > 0)
+        *hasFix = (parts[2][0] == 'A');
+
+    if (parts.count() > 9 && parts[9].count() == 6) {
+        date = QDate::fromString(QString::fromLatin1(parts[9]), QStringLiteral("ddMMyy"));
+        if (date.isValid())
+            date = date.addYears(100);
+        else
+            date = QDate();
+    }
+
+    if (parts.count() > 1 && parts[1].count() > 0)
+        legacyGetNmeaTime(parts[1], &time);
+
+    if (parts.count() > 6 && parts[4].count() == 1 && parts[6].count() == 1) {
+        double lat;
+        double lng;
+        if (legacyGetNmeaLatLong(parts[3], parts[4][0], parts[5], parts[6][0], &lat, &lng)) {
+            coord.setLatitude(lat);
+            coord.setLongitude(lng);
+        }
+    }
+
+    bool parsed = false;
+    double value = 0.0;
+    if (parts.count() > 7 && parts[7].count() > 0) {
+        value = parts[7].toDouble(&parsed);
+        if (parsed)
+            info->setAttribute(QGeoPositionInfo::GroundSpeed, qreal(value * 1.852 / 3.6));
+    }
+    if (parts.count() > 8 && parts[8].count() > 0) {
+        value = parts[8].toDouble(&parsed);
+        if (parsed)
+            info->setAttribute(QGeoPositionInfo::Direction, qreal(value));
+    }
+    if (parts.count() > 11 && parts[11].count() == 1
+            && (parts[11][0] == 'E' || parts[11][0] == 'W')) {
+        value = parts[10].toDouble(&parsed);
+        if (parsed) {
+            if (parts[11][0] == 'W')
+                value *= -1;
+            info->setAttribute(QGeoPositionInfo::MagneticVariation, qreal(value));
+        }
+    }
+
+    if (coord.type() != QGeoCoordinate::InvalidCoordinate)
+        info->setCoordinate(coord);
+
+    info->setTimestamp(QDateTime(date, time, Qt::UTC));
+}
+
+static bool legacyPosInfoFromNmea(const char *data, int size, QGeoPositionInfo *info, double uere,
+                                  bool *hasFix)
+{
+    if (!legacyHasValidNmeaChecksum(data, size))
+        return false;
+    const int payloadSize = int(static_cast<const char *>(memchr(data, '*', size)) - data);
+    if (data[3] == 'G' && data[4] == 'G' && data[5] == 'A')
+        legacyReadGga(data, payloadSize, info, uere, hasFix);
+    else if (data[3] == 'R' && data[4] == 'M' && data[5] == 'C')
+        legacyReadRmc(data, payloadSize, info, hasFix);
+    else
+        return false;
+    return true;
+}
+
+class tst_bench_QLocationUtils : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void posInfoFromNmea_data();
+    void posInfoFromNmea();
+    void satInfoFromNmea();
+};
+
+void tst_bench_QLocationUtils::posInfoFromNmea_data()
+{
+    QTest::addColumn<QByteArray>("sentence");
+    QTest::addColumn<bool>("legacy");
+
+    const QByteArray gga("$GPGGA,092750.000,5321.6802,N,00630.3372,W,1,8,1.03,61.7,M,55.2,M,,*76\r\n");
+    const QByteArray rmc("$GPRMC,092751.000,A,5321.6802,N,00630.3371,W,0.06,31.66,280511,,,A*45\r\n");
+    QTest::newRow("GGA") << gga << false;
+    QTest::newRow("GGA legacy") << gga << true;
+    QTest::newRow("RMC") << rmc << false;
+    QTest::newRow("RMC legacy") << rmc << true;
+    QTest::newRow("GSA") << QByteArray("$GPGSA,A,3,10,07,05,02,29,04,08,13,,,,,1.72,1.03,1.38*0A\r\n") << false;
+    QTest::newRow("VTG") << QByteArray("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48\r\n") << false;
+}
+
+void tst_bench_QLocationUtils::posInfoFromNmea()
+{
+    QFETCH(QByteArray, sentence);
+    QFETCH(bool, legacy);
+
+    QGeoPositionInfo info;
+    bool hasFix = false;
+    if (legacy) {
+        QVERIFY(legacyPosInfoFromNmea(sentence.constData(), sentence.size(), &info, 2.0, &hasFix));
+        QBENCHMARK {
+            legacyPosInfoFromNmea(sentence.constData(), sentence.size(), &info, 2.0, &hasFix);
+        }
+    } else {
+        QVERIFY(QLocationUtils::getPosInfoFromNmea(sentence.constData(), sentence.size(), &info, 2.0, &hasFix));
+        QBENCHMARK {
+            QLocationUtils::getPosInfoFromNmea(sentence.constData(), sentence.size(), &info, 2.0, &hasFix);
+        }
+    }
+}
+
+void tst_bench_QLocationUtils::satInfoFromNmea()
+{
+    const QByteArray sentence("$GPGSV,3,1,11,10,63,137,17,07,61,098,15,05,59,290,20,08,54,157,30*70\r\n");
+    QList<QGeoSatelliteInfo> infos;
+    QBENCHMARK {
+        QLocationUtils::getSatInfoFromNmea(sentence.constData(), sentence.size(), infos);
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_bench_QLocationUtils)
+
+#include "tst_bench_qlocationutils.moc"